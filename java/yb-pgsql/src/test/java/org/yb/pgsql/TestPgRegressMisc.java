@@ -28,6 +28,15 @@ public class TestPgRegressMisc extends BasePgSQLTest {
     return 1800;
   }
 
+  @Override
+  protected Map<String, String> getTServerFlags() {
+    Map<String, String> flagMap = super.getTServerFlags();
+    // Let yb_aggregates have more GROUP BY groups than a single read or merge could hold.
+    flagMap.put("ysql_max_pushdown_groups_per_read", "10");
+    flagMap.put("ysql_max_merged_groups", "20");
+    return flagMap;
+  }
+
   @Test
   public void testPgRegressMisc() throws Exception {
     runPgRegressTest("yb_misc_serial_schedule");
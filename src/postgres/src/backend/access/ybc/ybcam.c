@@ -30,6 +30,7 @@
 #include "access/relscan.h"
 #include "access/sysattr.h"
 #include "commands/dbcommands.h"
+#include "commands/explain.h"
 #include "catalog/index.h"
 #include "catalog/indexing.h"
 #include "catalog/catalog.h"
@@ -1035,6 +1036,144 @@ void ybcEndScan(YbScanDesc ybScan)
 	pfree(ybScan);
 }
 
+static void
+ybcAddDocDBStats(const YBCPgDocDBStats *source, YBCPgDocDBStats *dest)
+{
+	dest->num_tablet_reads += source->num_tablet_reads;
+	dest->num_seeks += source->num_seeks;
+	dest->num_nexts += source->num_nexts;
+	dest->num_skipped_entries += source->num_skipped_entries;
+	dest->num_intents_scanned += source->num_intents_scanned;
+	dest->block_cache_hits += source->block_cache_hits;
+	dest->block_cache_misses += source->block_cache_misses;
+	dest->bloom_checks += source->bloom_checks;
+	dest->bloom_useful += source->bloom_useful;
+	dest->sst_files_touched += source->sst_files_touched;
+}
+
+void
+ybcAccumDocDBStats(YBCPgStatement handle, ResourceOwner owner, YbDocDBScanStats *stats)
+{
+	YBCPgDocDBStats current;
+	const YBCPgDocDBStats *tablet_stats;
+	int			num_tablet_stats;
+	int			i;
+
+	HandleYBStmtStatusWithOwner(YBCPgDmlGetDocDBStats(handle, &current), handle, owner);
+	ybcAddDocDBStats(&current, &stats->total);
+
+	HandleYBStmtStatusWithOwner(YBCPgDmlGetDocDBTabletStats(handle,
+															&tablet_stats,
+															&num_tablet_stats),
+								handle,
+								owner);
+	for (i = 0; i < num_tablet_stats; ++i)
+	{
+		YBCPgDocDBStats *dest = NULL;
+		ListCell   *lc;
+
+		/* Tablets of the scan are few, so linear search is good enough. */
+		foreach(lc, stats->tablets)
+		{
+			YBCPgDocDBStats *entry = (YBCPgDocDBStats *) lfirst(lc);
+
+			if (strcmp(entry->tablet_id, tablet_stats[i].tablet_id) == 0)
+			{
+				dest = entry;
+				break;
+			}
+		}
+		if (dest == NULL)
+		{
+			dest = (YBCPgDocDBStats *) palloc0(sizeof(YBCPgDocDBStats));
+			dest->tablet_id = pstrdup(tablet_stats[i].tablet_id);
+			stats->tablets = lappend(stats->tablets, dest);
+		}
+		ybcAddDocDBStats(&tablet_stats[i], dest);
+	}
+}
+
+static void
+ybcExplainDocDBStatsEntry(const YBCPgDocDBStats *stats, ExplainState *es)
+{
+	if (es->format == EXPLAIN_FORMAT_TEXT)
+	{
+		appendStringInfoSpaces(es->str, es->indent * 2);
+		if (stats->tablet_id != NULL)
+			appendStringInfo(es->str, "DocDB Tablet %s:\n", stats->tablet_id);
+		else
+			appendStringInfoString(es->str, "DocDB:\n");
+		appendStringInfoSpaces(es->str, es->indent * 2 + 2);
+		appendStringInfo(es->str,
+						 "reads=" UINT64_FORMAT " seeks=" UINT64_FORMAT
+						 " nexts=" UINT64_FORMAT " skipped=" UINT64_FORMAT
+						 " intents=" UINT64_FORMAT "\n",
+						 stats->num_tablet_reads, stats->num_seeks, stats->num_nexts,
+						 stats->num_skipped_entries, stats->num_intents_scanned);
+		appendStringInfoSpaces(es->str, es->indent * 2 + 2);
+		appendStringInfo(es->str,
+						 "block cache hit=" UINT64_FORMAT " miss=" UINT64_FORMAT
+						 " bloom checked=" UINT64_FORMAT " useful=" UINT64_FORMAT
+						 " sst files=" UINT64_FORMAT "\n",
+						 stats->block_cache_hits, stats->block_cache_misses,
+						 stats->bloom_checks, stats->bloom_useful, stats->sst_files_touched);
+	}
+	else
+	{
+		if (stats->tablet_id != NULL)
+			ExplainPropertyText("Tablet Id", stats->tablet_id, es);
+		ExplainPropertyInteger("Reads", NULL, stats->num_tablet_reads, es);
+		ExplainPropertyInteger("Seeks", NULL, stats->num_seeks, es);
+		ExplainPropertyInteger("Nexts", NULL, stats->num_nexts, es);
+		ExplainPropertyInteger("Skipped Entries", NULL, stats->num_skipped_entries, es);
+		ExplainPropertyInteger("Intents Scanned", NULL, stats->num_intents_scanned, es);
+		ExplainPropertyInteger("Block Cache Hits", NULL, stats->block_cache_hits, es);
+		ExplainPropertyInteger("Block Cache Misses", NULL, stats->block_cache_misses, es);
+		ExplainPropertyInteger("Bloom Checks", NULL, stats->bloom_checks, es);
+		ExplainPropertyInteger("Bloom Useful", NULL, stats->bloom_useful, es);
+		ExplainPropertyInteger("SST Files", NULL, stats->sst_files_touched, es);
+	}
+}
+
+void
+ybcExplainDocDBStats(const YbDocDBScanStats *stats, YBCPgStatement handle, ResourceOwner owner,
+					 ExplainState *es)
+{
+	YbDocDBScanStats all;
+	ListCell   *lc;
+
+	/* Copy the tablet entries, so adding the current statement does not change stats. */
+	all.total = stats->total;
+	all.tablets = NIL;
+	foreach(lc, stats->tablets)
+	{
+		YBCPgDocDBStats *entry = (YBCPgDocDBStats *) palloc(sizeof(YBCPgDocDBStats));
+
+		*entry = *(YBCPgDocDBStats *) lfirst(lc);
+		all.tablets = lappend(all.tablets, entry);
+	}
+	if (handle != NULL)
+		ybcAccumDocDBStats(handle, owner, &all);
+
+	ExplainOpenGroup("DocDB", "DocDB", true, es);
+	ybcExplainDocDBStatsEntry(&all.total, es);
+
+	ExplainOpenGroup("Tablets", "Tablets", false, es);
+	if (es->format == EXPLAIN_FORMAT_TEXT)
+		es->indent++;
+	foreach(lc, all.tablets)
+	{
+		ExplainOpenGroup("Tablet", NULL, true, es);
+		ybcExplainDocDBStatsEntry((YBCPgDocDBStats *) lfirst(lc), es);
+		ExplainCloseGroup("Tablet", NULL, true, es);
+	}
+	if (es->format == EXPLAIN_FORMAT_TEXT)
+		es->indent--;
+	ExplainCloseGroup("Tablets", "Tablets", false, es);
+
+	ExplainCloseGroup("DocDB", "DocDB", true, es);
+}
+
 static bool
 heaptuple_matches_key(HeapTuple tup,
 					  TupleDesc tupdesc,
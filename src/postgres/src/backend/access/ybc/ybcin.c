@@ -231,8 +231,18 @@ ybcinbeginscan(Relation rel, int nkeys, int norderbys)
 void 
 ybcinrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,	ScanKey orderbys, int norderbys)
 {
+	YbDocDBScanStats docdb_stats;
+
+	memset(&docdb_stats, 0, sizeof(docdb_stats));
 	if (scan->opaque)
 	{
+		YbScanDesc prev = (YbScanDesc) scan->opaque;
+
+		/* Keep statistics of the previous scan, EXPLAIN ANALYZE reports all the loops. */
+		docdb_stats = prev->docdb_stats;
+		if (prev->exec_params && prev->exec_params->collect_docdb_stats && prev->handle)
+			ybcAccumDocDBStats(prev->handle, prev->stmt_owner, &docdb_stats);
+
 		/* For rescan, end the previous scan. */
 		ybcinendscan(scan);
 		scan->opaque = NULL;
@@ -241,9 +251,23 @@ ybcinrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,	ScanKey orderbys
 	YbScanDesc ybScan = ybcBeginScan(scan->heapRelation, scan->indexRelation, scan->xs_want_itup,
 																	 nscankeys, scankey);
 	ybScan->index = scan->indexRelation;
+	ybScan->docdb_stats = docdb_stats;
 	scan->opaque = ybScan;
 }
 
+/*
+ * Show DocDB statistics of the index scan in EXPLAIN ANALYZE.
+ */
+void
+ybcinexplain(IndexScanDesc scan, struct ExplainState *es)
+{
+	YbScanDesc ybscan = (YbScanDesc) scan->opaque;
+
+	if (ybscan == NULL)
+		return;
+	ybcExplainDocDBStats(&ybscan->docdb_stats, ybscan->handle, ybscan->stmt_owner, es);
+}
+
 /*
  * Processing the following SELECT.
  *   SELECT data FROM heapRelation WHERE rowid IN
@@ -14,6 +14,8 @@
 #include "postgres.h"
 
 #include "access/xact.h"
+#include "access/ybcin.h"
+#include "catalog/pg_am.h"
 #include "catalog/pg_collation.h"
 #include "catalog/pg_type.h"
 #include "commands/createas.h"
@@ -40,6 +42,8 @@
 #include "utils/typcache.h"
 #include "utils/xml.h"
 
+#include "pg_yb_utils.h"
+
 
 /* Hook for plugins to get control in ExplainOneQuery() */
 ExplainOneQuery_hook_type ExplainOneQuery_hook = NULL;
@@ -93,6 +97,8 @@ static void show_grouping_set_keys(PlanState *planstate,
 					   List *ancestors, ExplainState *es);
 static void show_group_keys(GroupState *gstate, List *ancestors,
 				ExplainState *es);
+static void show_yb_pushdown_group_keys(AggState *astate, List *ancestors,
+							ExplainState *es);
 static void show_sort_group_keys(PlanState *planstate, const char *qlabel,
 					 int nkeys, AttrNumber *keycols,
 					 Oid *sortOperators, Oid *collations, bool *nullsFirst,
@@ -105,6 +111,7 @@ static void show_sort_info(SortState *sortstate, ExplainState *es);
 static void show_hash_info(HashState *hashstate, ExplainState *es);
 static void show_tidbitmap_info(BitmapHeapScanState *planstate,
 					ExplainState *es);
+static void show_yb_docdb_stats(IndexScanDesc scandesc, ExplainState *es);
 static void show_instrumentation_count(const char *qlabel, int which,
 						   PlanState *planstate, ExplainState *es);
 static void show_foreignscan_info(ForeignScanState *fsstate, ExplainState *es);
@@ -1518,6 +1525,7 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			if (plan->qual)
 				show_instrumentation_count("Rows Removed by Filter", 1,
 										   planstate, es);
+			show_yb_docdb_stats(((IndexScanState *) planstate)->iss_ScanDesc, es);
 			break;
 		case T_IndexOnlyScan:
 			show_scan_qual(((IndexOnlyScan *) plan)->indexqual,
@@ -1534,6 +1542,7 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			if (es->analyze)
 				ExplainPropertyFloat("Heap Fetches", NULL,
 									 planstate->instrument->ntuples2, 0, es);
+			show_yb_docdb_stats(((IndexOnlyScanState *) planstate)->ioss_ScanDesc, es);
 			break;
 		case T_BitmapIndexScan:
 			show_scan_qual(((BitmapIndexScan *) plan)->indexqualorig,
@@ -1750,6 +1759,8 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			break;
 		case T_Agg:
 			show_agg_keys(castNode(AggState, planstate), ancestors, es);
+			show_yb_pushdown_group_keys(castNode(AggState, planstate),
+										ancestors, es);
 			show_upper_qual(plan->qual, "Filter", planstate, ancestors, es);
 			if (plan->qual)
 				show_instrumentation_count("Rows Removed by Filter", 1,
@@ -2148,6 +2159,28 @@ show_agg_keys(AggState *astate, List *ancestors,
 	}
 }
 
+/*
+ * Show the grouping columns of a hashed aggregation, that are pushed down to
+ * DocDB along with its aggregates.
+ */
+static void
+show_yb_pushdown_group_keys(AggState *astate, List *ancestors,
+							ExplainState *es)
+{
+	Agg		   *plan = (Agg *) astate->ss.ps.plan;
+
+	if (!astate->yb_pushdown_supported || astate->aggstrategy != AGG_HASHED)
+		return;
+
+	/* The key columns refer to the tlist of the child plan */
+	ancestors = lcons(astate, ancestors);
+	show_sort_group_keys(outerPlanState(astate), "Pushed Down Group Key",
+						 plan->numCols, plan->grpColIdx,
+						 NULL, NULL, NULL,
+						 ancestors, es);
+	ancestors = list_delete_first(ancestors);
+}
+
 static void
 show_grouping_sets(PlanState *planstate, Agg *agg,
 				   List *ancestors, ExplainState *es)
@@ -2666,6 +2699,19 @@ show_tidbitmap_info(BitmapHeapScanState *planstate, ExplainState *es)
 	}
 }
 
+/*
+ * Show DocDB statistics of a YugaByte index scan, if requested by yb_explain_docdb_stats
+ */
+static void
+show_yb_docdb_stats(IndexScanDesc scandesc, ExplainState *es)
+{
+	if (!es->analyze || !yb_explain_docdb_stats || scandesc == NULL ||
+		scandesc->indexRelation->rd_rel->relam != LSM_AM_OID)
+		return;
+
+	ybcinexplain(scandesc, es);
+}
+
 /*
  * If it's EXPLAIN ANALYZE, show instrumentation information for a plan node
  *
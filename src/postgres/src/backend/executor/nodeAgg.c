@@ -241,6 +241,8 @@
 #include "utils/tuplesort.h"
 #include "utils/datum.h"
 
+#include "pg_yb_utils.h"
+
 
 static void select_current_set(AggState *aggstate, int setno, bool is_hash);
 static void initialize_phase(AggState *aggstate, int newphase);
@@ -296,8 +298,15 @@ static int find_compatible_pertrans(AggState *aggstate, Aggref *newagg,
 						 Oid aggserialfn, Oid aggdeserialfn,
 						 Datum initValue, bool initValueIsNull,
 						 List *transnos);
+static void initialize_hash_entry(AggState *aggstate, TupleHashTable hashtable,
+					  TupleHashEntry entry);
 static void yb_agg_pushdown_supported(AggState *aggstate);
+static bool yb_agg_group_by_pushdown_supported(AggState *aggstate);
 static void yb_agg_pushdown(AggState *aggstate);
+static void yb_agg_combine_pushdown_results(AggState *aggstate,
+								TupleTableSlot *slot, int first_attno,
+								AggStatePerGroup pergroup);
+static void yb_agg_fill_hash_table(AggState *aggstate);
 
 
 /*
@@ -1477,29 +1486,35 @@ lookup_hash_entry(AggState *aggstate)
 	entry = LookupTupleHashEntry(perhash->hashtable, hashslot, &isnew);
 
 	if (isnew)
-	{
-		AggStatePerGroup pergroup;
-		int			transno;
+		initialize_hash_entry(aggstate, perhash->hashtable, entry);
 
-		pergroup = (AggStatePerGroup)
-			MemoryContextAlloc(perhash->hashtable->tablecxt,
-							   sizeof(AggStatePerGroupData) * aggstate->numtrans);
-		entry->additional = pergroup;
+	return entry;
+}
 
-		/*
-		 * Initialize aggregates for new tuple group, lookup_hash_entries()
-		 * already has selected the relevant grouping set.
-		 */
-		for (transno = 0; transno < aggstate->numtrans; transno++)
-		{
-			AggStatePerTrans pertrans = &aggstate->pertrans[transno];
-			AggStatePerGroup pergroupstate = &pergroup[transno];
+/*
+ * Allocate and initialize the transition states of a new hashtable entry.
+ * The caller must have selected the relevant grouping set.
+ */
+static void
+initialize_hash_entry(AggState *aggstate, TupleHashTable hashtable,
+					  TupleHashEntry entry)
+{
+	AggStatePerGroup pergroup;
+	int			transno;
 
-			initialize_aggregate(aggstate, pertrans, pergroupstate);
-		}
-	}
+	pergroup = (AggStatePerGroup)
+		MemoryContextAlloc(hashtable->tablecxt,
+						   sizeof(AggStatePerGroupData) * aggstate->numtrans);
+	entry->additional = pergroup;
 
-	return entry;
+	/* Initialize aggregates for new tuple group. */
+	for (transno = 0; transno < aggstate->numtrans; transno++)
+	{
+		AggStatePerTrans pertrans = &aggstate->pertrans[transno];
+		AggStatePerGroup pergroupstate = &pergroup[transno];
+
+		initialize_aggregate(aggstate, pertrans, pergroupstate);
+	}
 }
 
 /*
@@ -1536,17 +1551,26 @@ yb_agg_pushdown_supported(AggState *aggstate)
 	/* Initially set pushdown supported to false. */
 	aggstate->yb_pushdown_supported = false;
 
-	/* Phase 0 is a dummy phase, so there should be two phases. */
-	if (aggstate->numphases != 2)
-		return;
+	if (aggstate->aggstrategy == AGG_HASHED)
+	{
+		/* GROUP BY of a single grouping set, computed per group by DocDB. */
+		if (!yb_agg_group_by_pushdown_supported(aggstate))
+			return;
+	}
+	else
+	{
+		/* Phase 0 is a dummy phase, so there should be two phases. */
+		if (aggstate->numphases != 2)
+			return;
 
-	/* Plain agg strategy. */
-	if (aggstate->phase->aggstrategy != AGG_PLAIN)
-		return;
+		/* Plain agg strategy. */
+		if (aggstate->phase->aggstrategy != AGG_PLAIN)
+			return;
 
-	/* No GROUP BY. */
-	if (aggstate->phase->numsets != 0)
-		return;
+		/* No GROUP BY. */
+		if (aggstate->phase->numsets != 0)
+			return;
+	}
 
 	/* Foreign scan outer plan. */
 	if (!IsA(outerPlanState(aggstate), ForeignScanState))
@@ -1631,6 +1655,67 @@ yb_agg_pushdown_supported(AggState *aggstate)
 	aggstate->yb_pushdown_supported = true;
 }
 
+/*
+ * Evaluates whether the grouping columns of a hashed aggregation could be
+ * pushed down to DocDB along with the aggregates.
+ */
+static bool
+yb_agg_group_by_pushdown_supported(AggState *aggstate)
+{
+	AggStatePerHash perhash;
+	List	   *outerTlist;
+	int			i;
+
+	if (!yb_enable_group_by_pushdown)
+		return false;
+
+	/* A single hashed grouping set, no GROUPING SETS, CUBE or ROLLUP. */
+	if (aggstate->numphases != 1 || aggstate->num_hashes != 1)
+		return false;
+
+	perhash = &aggstate->perhash[0];
+
+	/*
+	 * Only the grouping columns are stored in the hash table, so the result
+	 * rows of DocDB, that have just the grouping columns and the aggregates,
+	 * contain everything needed to project the groups.
+	 */
+	if (perhash->numCols == 0 || perhash->numhashGrpCols != perhash->numCols)
+		return false;
+
+	/*
+	 * The scan returns the pushed down results as is, so the outer plan must
+	 * not project them into its own target list.
+	 */
+	if (outerPlanState(aggstate)->ps_ProjInfo != NULL)
+		return false;
+
+	outerTlist = outerPlanState(aggstate)->plan->targetlist;
+	for (i = 0; i < perhash->numCols; i++)
+	{
+		TargetEntry *tle = list_nth_node(TargetEntry, outerTlist,
+										 perhash->hashGrpColIdxInput[i] - 1);
+		Var		   *var;
+
+		/* Only group by simple columns of the scanned table. */
+		if (!IsA(tle->expr, Var))
+			return false;
+
+		var = castNode(Var, tle->expr);
+		if (var->varattno <= 0)
+			return false;
+
+		/*
+		 * DocDB groups rows by equality of encoded values, that matches
+		 * postgres equality of types that are allowed to be YB keys.
+		 */
+		if (!YBCDataTypeIsValidForKey(var->vartype))
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * Populates aggregate pushdown information in the YB foreign scan state.
  */
@@ -1648,6 +1733,123 @@ yb_agg_pushdown(AggState *aggstate)
 		pushdown_aggs = lappend(pushdown_aggs, aggref);
 	}
 	scan_state->yb_fdw_aggs = pushdown_aggs;
+
+	if (aggstate->aggstrategy == AGG_HASHED)
+	{
+		AggStatePerHash perhash = &aggstate->perhash[0];
+		List	   *outerTlist = outerPlanState(aggstate)->plan->targetlist;
+		List	   *group_by = NIL;
+		int			i;
+
+		for (i = 0; i < perhash->numCols; i++)
+		{
+			TargetEntry *tle = list_nth_node(TargetEntry, outerTlist,
+											 perhash->hashGrpColIdxInput[i] - 1);
+
+			group_by = lappend(group_by, tle->expr);
+		}
+		scan_state->yb_fdw_group_by = group_by;
+	}
+}
+
+/*
+ * Combines aggregate results returned by DocDB, starting at first_attno of
+ * the slot, into the transition states of pergroup. There is one result per
+ * aggno.
+ */
+static void
+yb_agg_combine_pushdown_results(AggState *aggstate, TupleTableSlot *slot,
+								int first_attno, AggStatePerGroup pergroup)
+{
+	AggStatePerAgg peragg = aggstate->peragg;
+	int			aggno;
+
+	for (aggno = 0; aggno < aggstate->numaggs; aggno++)
+	{
+		MemoryContext oldContext;
+		int transno = peragg[aggno].transno;
+		Aggref *aggref = peragg[aggno].aggref;
+		char *func_name = get_func_name(aggref->aggfnoid);
+		AggStatePerGroup pergroupstate = &pergroup[transno];
+		AggStatePerTrans pertrans = &aggstate->pertrans[transno];
+		FunctionCallInfo fcinfo = &pertrans->transfn_fcinfo;
+		Datum value = slot->tts_values[first_attno + aggno];
+		bool isnull = slot->tts_isnull[first_attno + aggno];
+
+		if (strcmp(func_name, "count") == 0)
+		{
+			/*
+			 * Sum results from each response for COUNT. It is safe to do this
+			 * directly on the datum as it is guaranteed to be an int64.
+			 */
+			oldContext = MemoryContextSwitchTo(
+				aggstate->curaggcontext->ecxt_per_tuple_memory);
+			pergroupstate->transValue += value;
+			MemoryContextSwitchTo(oldContext);
+		}
+		else
+		{
+			/* Set slot result as argument, then advance the transition function. */
+			fcinfo->arg[1] = value;
+			fcinfo->argnull[1] = isnull;
+			advance_transition_function(aggstate, pertrans, pergroupstate);
+		}
+	}
+}
+
+/*
+ * ExecAgg for hashed case with aggregates pushed down to DocDB: read partial
+ * aggregates of groups and combine them in the hash table.
+ *
+ * Each input row contains the grouping columns followed by the aggregates.
+ * Partial aggregates of the same group could come in multiple rows, e.g.
+ * from different tablets.
+ */
+static void
+yb_agg_fill_hash_table(AggState *aggstate)
+{
+	AggStatePerHash perhash = &aggstate->perhash[0];
+	TupleTableSlot *hashslot = perhash->hashslot;
+	int			numGroupCols = perhash->numCols;
+
+	select_current_set(aggstate, 0, true);
+
+	for (;;)
+	{
+		TupleTableSlot *outerslot;
+		TupleHashEntry entry;
+		bool		isnew;
+		int			i;
+
+		outerslot = fetch_input_tuple(aggstate);
+		if (TupIsNull(outerslot))
+			break;
+
+		Assert(outerslot->tts_nvalid == numGroupCols + aggstate->numaggs);
+
+		ExecClearTuple(hashslot);
+		for (i = 0; i < numGroupCols; i++)
+		{
+			hashslot->tts_values[i] = outerslot->tts_values[i];
+			hashslot->tts_isnull[i] = outerslot->tts_isnull[i];
+		}
+		ExecStoreVirtualTuple(hashslot);
+
+		entry = LookupTupleHashEntry(perhash->hashtable, hashslot, &isnew);
+		if (isnew)
+			initialize_hash_entry(aggstate, perhash->hashtable, entry);
+
+		yb_agg_combine_pushdown_results(aggstate, outerslot, numGroupCols,
+										(AggStatePerGroup) entry->additional);
+
+		/* Reset per-input-tuple context after each tuple */
+		ResetExprContext(aggstate->tmpcontext);
+	}
+
+	aggstate->table_filled = true;
+	/* Initialize to walk the hash table */
+	select_current_set(aggstate, 0, true);
+	ResetTupleHashIterator(perhash->hashtable, &perhash->hashiter);
 }
 
 /*
@@ -1692,7 +1894,12 @@ ExecAgg(PlanState *pstate)
 		{
 			case AGG_HASHED:
 				if (!node->table_filled)
-					agg_fill_hash_table(node);
+				{
+					if (node->yb_pushdown_supported)
+						yb_agg_fill_hash_table(node);
+					else
+						agg_fill_hash_table(node);
+				}
 				/* FALLTHROUGH */
 			case AGG_MIXED:
 				result = agg_retrieve_hash_table(node);
@@ -1898,38 +2105,8 @@ agg_retrieve_direct(AggState *aggstate)
 
 				Assert(aggstate->numaggs == outerslot->tts_nvalid);
 
-				for (aggno = 0; aggno < aggstate->numaggs; aggno++)
-				{
-					MemoryContext oldContext;
-					int transno = peragg[aggno].transno;
-					Aggref *aggref = aggstate->peragg[aggno].aggref;
-					char *func_name = get_func_name(aggref->aggfnoid);
-					AggStatePerGroup pergroup = pergroups[currentSet];
-					AggStatePerGroup pergroupstate = &pergroup[transno];
-					AggStatePerTrans pertrans = &aggstate->pertrans[transno];
-					FunctionCallInfo fcinfo = &pertrans->transfn_fcinfo;
-					Datum value = outerslot->tts_values[aggno];
-					bool isnull = outerslot->tts_isnull[aggno];
-
-					if (strcmp(func_name, "count") == 0)
-					{
-						/*
-						 * Sum results from each response for COUNT. It is safe to do this
-						 * directly on the datum as it is guaranteed to be an int64.
-						 */
-						oldContext = MemoryContextSwitchTo(
-							aggstate->curaggcontext->ecxt_per_tuple_memory);
-						pergroupstate->transValue += value;
-						MemoryContextSwitchTo(oldContext);
-					}
-					else
-					{
-						/* Set slot result as argument, then advance the transition function. */
-						fcinfo->arg[1] = value;
-						fcinfo->argnull[1] = isnull;
-						advance_transition_function(aggstate, pertrans, pergroupstate);
-					}
-				}
+				yb_agg_combine_pushdown_results(aggstate, outerslot, 0,
+												pergroups[currentSet]);
 
 				/* Reset per-input-tuple context after each tuple */
 				ResetExprContext(tmpcontext);
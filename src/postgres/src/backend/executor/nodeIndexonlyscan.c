@@ -118,6 +118,9 @@ IndexOnlyNext(IndexOnlyScanState *node)
 	 */
 	if (IsYugaByteEnabled()) {
 		scandesc->yb_exec_params = &estate->yb_exec_params;
+		/* Collect DocDB statistics only when they are going to be shown by EXPLAIN ANALYZE. */
+		scandesc->yb_exec_params->collect_docdb_stats =
+			yb_explain_docdb_stats && node->ss.ps.instrument != NULL;
 
 		// TODO(hector) Add row marks for INDEX_ONLY_SCAN
 		scandesc->yb_exec_params->rowmark = -1;
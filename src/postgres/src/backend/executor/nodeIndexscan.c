@@ -133,6 +133,9 @@ IndexNext(IndexScanState *node)
 	 */
 	if (IsYugaByteEnabled()) {
 		scandesc->yb_exec_params = &estate->yb_exec_params;
+		/* Collect DocDB statistics only when they are going to be shown by EXPLAIN ANALYZE. */
+		scandesc->yb_exec_params->collect_docdb_stats =
+			yb_explain_docdb_stats && node->ss.ps.instrument != NULL;
 		// Add row marks.
 		scandesc->yb_exec_params->rowmark = -1;
 		ListCell   *l;
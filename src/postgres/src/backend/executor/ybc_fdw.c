@@ -238,6 +238,7 @@ typedef struct YbFdwExecState
 	ResourceOwner	stmt_owner;
 	YBCPgExecParameters *exec_params; /* execution control parameters for YugaByte */
 	bool is_exec_done; /* Each statement should be executed exactly one time */
+	YbDocDBScanStats docdb_stats; /* DocDB statistics of statements freed by rescans */
 } YbFdwExecState;
 
 /*
@@ -280,6 +281,10 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 		break;
 	}
 
+	/* Collect DocDB statistics only when they are going to be shown by EXPLAIN ANALYZE. */
+	ybc_state->exec_params->collect_docdb_stats =
+		yb_explain_docdb_stats && node->ss.ps.instrument != NULL;
+
 	ybc_state->is_exec_done = false;
 
 	/* Set the current syscatalog version (will check that we are up to date) */
@@ -375,6 +380,34 @@ ybcSetupScanTargets(ForeignScanState *node)
 	}
 	else
 	{
+		/*
+		 * Set grouping column targets, followed by aggregate scan targets, so
+		 * each result row holds the partial aggregates of one group.
+		 */
+		foreach(lc, node->yb_fdw_group_by)
+		{
+			Var *var = lfirst_node(Var, lc);
+			Form_pg_attribute attr = TupleDescAttr(tupdesc, var->varattno - 1);
+			YBCPgTypeAttrs type_attrs = {attr->atttypmod};
+			YBCPgExpr target = YBCNewColumnRef(ybc_state->handle,
+											   var->varattno,
+											   attr->atttypid,
+											   &type_attrs);
+			YBCPgExpr group_by = YBCNewColumnRef(ybc_state->handle,
+												 var->varattno,
+												 attr->atttypid,
+												 &type_attrs);
+
+			HandleYBStmtStatusWithOwner(YBCPgDmlAppendTarget(ybc_state->handle,
+															 target),
+										ybc_state->handle,
+										ybc_state->stmt_owner);
+			HandleYBStmtStatusWithOwner(YBCPgDmlAppendGroupBy(ybc_state->handle,
+															  group_by),
+										ybc_state->handle,
+										ybc_state->stmt_owner);
+		}
+
 		/* Set aggregate scan targets. */
 		foreach(lc, node->yb_fdw_aggs)
 		{
@@ -442,7 +475,8 @@ ybcSetupScanTargets(ForeignScanState *node)
 		 * tupledesc that only includes the number of attributes. Switch to per-query memory from
 		 * per-tuple memory so the slot persists across iterations.
 		 */
-		TupleDesc target_tupdesc = CreateTemplateTupleDesc(list_length(node->yb_fdw_aggs),
+		TupleDesc target_tupdesc = CreateTemplateTupleDesc(list_length(node->yb_fdw_group_by) +
+														   list_length(node->yb_fdw_aggs),
 														   false /* hasoid */);
 		ExecInitScanTupleSlot(estate, &node->ss, target_tupdesc);
 	}
@@ -548,12 +582,18 @@ static void
 ybcReScanForeignScan(ForeignScanState *node)
 {
 	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
+	YbDocDBScanStats docdb_stats = ybc_state->docdb_stats;
+
+	/* Keep statistics of the previous select, EXPLAIN ANALYZE reports all the loops. */
+	if (ybc_state->exec_params->collect_docdb_stats && ybc_state->handle)
+		ybcAccumDocDBStats(ybc_state->handle, ybc_state->stmt_owner, &docdb_stats);
 
 	/* Clear (delete) the previous select */
 	ybcFreeStatementObject(ybc_state);
 
 	/* Re-allocate and execute the select. */
 	ybcBeginForeignScan(node, 0 /* eflags */);
+	((YbFdwExecState *) node->fdw_state)->docdb_stats = docdb_stats;
 }
 
 /*
@@ -567,6 +607,22 @@ ybcEndForeignScan(ForeignScanState *node)
 	ybcFreeStatementObject(ybc_state);
 }
 
+/*
+ * ybcExplainForeignScan
+ *		Show DocDB statistics of the scan in EXPLAIN ANALYZE
+ */
+static void
+ybcExplainForeignScan(ForeignScanState *node, ExplainState *es)
+{
+	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
+
+	/* Statistics are available only when the scan was executed with collection enabled. */
+	if (!es->analyze || !yb_explain_docdb_stats || ybc_state == NULL)
+		return;
+
+	ybcExplainDocDBStats(&ybc_state->docdb_stats, ybc_state->handle, ybc_state->stmt_owner, es);
+}
+
 /* ------------------------------------------------------------------------- */
 /*  FDW declaration */
 
@@ -587,8 +643,9 @@ ybc_fdw_handler()
 	fdwroutine->ReScanForeignScan  = ybcReScanForeignScan;
 	fdwroutine->EndForeignScan     = ybcEndForeignScan;
 
+	fdwroutine->ExplainForeignScan = ybcExplainForeignScan;
+
 	/* TODO: These are optional but we should support them eventually. */
-	/* fdwroutine->ExplainForeignScan = ybcExplainForeignScan; */
 	/* fdwroutine->AnalyzeForeignTable = ybcAnalyzeForeignTable; */
 	/* fdwroutine->IsForeignScanParallelSafe = ybcIsForeignScanParallelSafe; */
 
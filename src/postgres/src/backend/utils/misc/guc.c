@@ -1845,6 +1845,26 @@ static struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"yb_explain_docdb_stats", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Show DocDB statistics of YugaByte scans in EXPLAIN ANALYZE."),
+			NULL
+		},
+		&yb_explain_docdb_stats,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"yb_enable_group_by_pushdown", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Push down aggregates of hashed GROUP BY plans over YugaByte tables to DocDB."),
+			NULL
+		},
+		&yb_enable_group_by_pushdown,
+		true,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"data_sync_retry", PGC_POSTMASTER, ERROR_HANDLING_OPTIONS,
 			gettext_noop("Whether to continue running after a failure to sync data files."),
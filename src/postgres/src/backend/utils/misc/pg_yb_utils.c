@@ -739,6 +739,10 @@ YBRaiseNotSupportedSignal(const char *msg, int issue_no, int signal_level)
 
 bool yb_debug_mode = false;
 
+bool yb_explain_docdb_stats = false;
+
+bool yb_enable_group_by_pushdown = true;
+
 const char*
 YBDatumToString(Datum datum, Oid typid)
 {
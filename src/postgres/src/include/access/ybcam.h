@@ -37,6 +37,17 @@
 #include "pg_yb_utils.h"
 #include "executor/ybcExpr.h"
 
+/*
+ * DocDB statistics of the YugaByte statements executed by a scan, shown by EXPLAIN ANALYZE when
+ * yb_explain_docdb_stats is set. Statements are deleted on rescan, so their statistics are
+ * accumulated here.
+ */
+typedef struct YbDocDBScanStats
+{
+	YBCPgDocDBStats total;
+	List	   *tablets;		/* palloc'd YBCPgDocDBStats of each tablet */
+} YbDocDBScanStats;
+
 /*
  * SCAN PLAN - Two structures.
  * - "struct YbScanPlanData" contains variables that are used during preparing statement.
@@ -88,6 +99,9 @@ typedef struct YbScanDescData
 	 *   execution in YB tablet server.
 	 */
 	YBCPgExecParameters *exec_params;
+
+	/* DocDB statistics of the statements deleted by rescans. */
+	YbDocDBScanStats docdb_stats;
 } YbScanDescData;
 
 typedef struct YbScanDescData *YbScanDesc;
@@ -134,6 +148,15 @@ IndexTuple ybc_getnext_indextuple(YbScanDesc ybScan, bool is_forward_scan, bool
 
 void ybcEndScan(YbScanDesc ybScan);
 
+/* Add DocDB statistics of the statement to stats. */
+extern void ybcAccumDocDBStats(YBCPgStatement handle, ResourceOwner owner,
+							   YbDocDBScanStats *stats);
+
+/* Show DocDB statistics of a scan, together with statistics of the current statement if any. */
+struct ExplainState;
+extern void ybcExplainDocDBStats(const YbDocDBScanStats *stats, YBCPgStatement handle,
+								 ResourceOwner owner, struct ExplainState *es);
+
 /* Number of rows assumed for a YB table if no size estimates exist */
 #define YBC_DEFAULT_NUM_ROWS  1000
 
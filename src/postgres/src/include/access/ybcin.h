@@ -62,4 +62,7 @@ extern void ybcinrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 extern bool ybcingettuple(IndexScanDesc scan, ScanDirection dir);
 extern void ybcinendscan(IndexScanDesc scan);
 
+struct ExplainState;
+extern void ybcinexplain(IndexScanDesc scan, struct ExplainState *es);
+
 #endif							/* YBCINDEX_H */
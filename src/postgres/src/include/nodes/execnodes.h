@@ -1671,6 +1671,8 @@ typedef struct ForeignScanState
 
 	/* YB specific attributes. */
 	List	   *yb_fdw_aggs;	/* aggregate pushdown information */
+	List	   *yb_fdw_group_by;	/* grouping columns (Vars) of pushed down
+									 * aggregates, returned before them */
 } ForeignScanState;
 
 /* ----------------
@@ -294,6 +294,18 @@ void YBRaiseNotSupportedSignal(const char *msg, int issue_no, int signal_level);
  */
 extern bool yb_debug_mode;
 
+/**
+ * YSQL variable that can be used to show DocDB statistics of scans in EXPLAIN ANALYZE.
+ * e.g. 'SET yb_explain_docdb_stats=true'.
+ */
+extern bool yb_explain_docdb_stats;
+
+/**
+ * YSQL variable that can be used to compute aggregates of hashed GROUP BY plans in DocDB.
+ * e.g. 'SET yb_enable_group_by_pushdown=false'.
+ */
+extern bool yb_enable_group_by_pushdown;
+
 /*
  * Get a string representation of a datum (given its type).
  */
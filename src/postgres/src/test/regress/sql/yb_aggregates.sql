@@ -60,3 +60,60 @@ SELECT COUNT(*), COUNT(a) FROM ybaggtest2;
 
 -- Verify MAX/MIN respect NULL values.
 SELECT MAX(a), MIN(a) FROM ybaggtest2;
+
+--
+-- Test GROUP BY pushdown returns the same groups as aggregation in postgres.
+--
+CREATE TABLE ybaggtest3 (
+    id         int PRIMARY KEY,
+    k          int,
+    v          int
+);
+
+INSERT INTO ybaggtest3 SELECT s, s % 5, s FROM generate_series(1, 100) AS s;
+INSERT INTO ybaggtest3 VALUES (101, NULL, 7), (102, NULL, NULL);
+
+-- Use hashed aggregation, the only strategy GROUP BY is pushed down with.
+SET enable_sort = off;
+
+SET yb_enable_group_by_pushdown = off;
+SELECT k, COUNT(*), COUNT(v), SUM(v), MIN(v), MAX(v) FROM ybaggtest3 GROUP BY k ORDER BY k;
+SELECT k, SUM(v) FROM ybaggtest3 GROUP BY k HAVING COUNT(v) > 1 ORDER BY k;
+
+SET yb_enable_group_by_pushdown = on;
+SELECT k, COUNT(*), COUNT(v), SUM(v), MIN(v), MAX(v) FROM ybaggtest3 GROUP BY k ORDER BY k;
+SELECT k, SUM(v) FROM ybaggtest3 GROUP BY k HAVING COUNT(v) > 1 ORDER BY k;
+
+-- The scan returns one row per group instead of the rows of the table.
+EXPLAIN (VERBOSE, COSTS OFF) SELECT k, COUNT(*), SUM(v) FROM ybaggtest3 GROUP BY k;
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+    SELECT k, COUNT(*), SUM(v) FROM ybaggtest3 GROUP BY k;
+
+SET yb_enable_group_by_pushdown = off;
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+    SELECT k, COUNT(*), SUM(v) FROM ybaggtest3 GROUP BY k;
+SET yb_enable_group_by_pushdown = on;
+
+-- More groups than ysql_max_pushdown_groups_per_read and ysql_max_merged_groups, that
+-- TestPgRegressMisc lowers to 10 and 20. Reads are paged by groups, and partial rows of a group
+-- could be returned more than once, so they are combined by postgres.
+CREATE TABLE ybaggtest4 (
+    id         int PRIMARY KEY,
+    k          int,
+    v          int
+);
+
+INSERT INTO ybaggtest4 SELECT s, s % 200, s FROM generate_series(1, 1000) AS s;
+
+EXPLAIN (COSTS OFF) SELECT k, COUNT(*), SUM(v), MIN(v), MAX(v) FROM ybaggtest4 GROUP BY k;
+SELECT COUNT(*), SUM(cnt), SUM(total)
+    FROM (SELECT k, COUNT(*) AS cnt, SUM(v) AS total FROM ybaggtest4 GROUP BY k) AS g;
+-- Group k has rows with v = k + 200 * i for i in [0, 4], group 0 has v = 200 * i for i in [1, 5].
+SELECT k, COUNT(*), SUM(v), MIN(v), MAX(v) FROM ybaggtest4 GROUP BY k
+    HAVING COUNT(*) <> 5 OR MAX(v) - MIN(v) <> 800 OR SUM(v) <> 5 * MIN(v) + 2000;
+SELECT k, COUNT(*), SUM(v), MIN(v), MAX(v) FROM ybaggtest4 GROUP BY k ORDER BY k LIMIT 3;
+
+DROP TABLE ybaggtest4;
+
+RESET yb_enable_group_by_pushdown;
+RESET enable_sort;
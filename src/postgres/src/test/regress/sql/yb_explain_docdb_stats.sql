@@ -0,0 +1,44 @@
+--
+-- DocDB statistics shown by EXPLAIN ANALYZE when yb_explain_docdb_stats is set.
+--
+CREATE TABLE docdb_stats_test(k int PRIMARY KEY, v int) SPLIT INTO 2 TABLETS;
+CREATE INDEX docdb_stats_test_v ON docdb_stats_test(v);
+INSERT INTO docdb_stats_test SELECT i, i FROM generate_series(1, 100) i;
+
+-- Summarizes DocDB statistics of the top plan node of the query. Counters that depend on the
+-- state of the storage are only checked to be positive.
+CREATE FUNCTION explain_docdb_stats(query text) RETURNS text AS $$
+DECLARE
+  plan json;
+  stats json;
+BEGIN
+  EXECUTE 'EXPLAIN (ANALYZE, FORMAT JSON) ' || query INTO plan;
+  plan := plan->0->'Plan';
+  stats := plan->'DocDB';
+  IF stats IS NULL THEN
+    RETURN (plan->>'Node Type') || ': no stats';
+  END IF;
+  RETURN format('%s: reads=%s tablets=%s tablet_reads=%s seeks=%s',
+                plan->>'Node Type',
+                stats->>'Reads',
+                json_array_length(stats->'Tablets'),
+                (SELECT sum((t->>'Reads')::bigint) FROM json_array_elements(stats->'Tablets') t),
+                CASE WHEN (stats->>'Seeks')::bigint > 0 THEN 'positive' ELSE 'zero' END);
+END;
+$$ LANGUAGE plpgsql;
+
+-- Statistics are not shown by default.
+SELECT explain_docdb_stats('SELECT * FROM docdb_stats_test');
+
+SET yb_explain_docdb_stats = on;
+-- Sequential scan reads all tablets.
+SELECT explain_docdb_stats('SELECT * FROM docdb_stats_test');
+-- Primary key lookup reads a single tablet.
+SELECT explain_docdb_stats('SELECT * FROM docdb_stats_test WHERE k = 5');
+-- Secondary index lookup reads the index, then the table.
+SELECT explain_docdb_stats('SELECT * FROM docdb_stats_test WHERE v = 5');
+SELECT explain_docdb_stats('SELECT v FROM docdb_stats_test WHERE v = 5');
+
+RESET yb_explain_docdb_stats;
+DROP FUNCTION explain_docdb_stats(text);
+DROP TABLE docdb_stats_test;
@@ -120,8 +120,13 @@ AsyncRpc::AsyncRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
       ops_(std::move(data->ops)),
       start_(MonoTime::Now()),
       async_rpc_metrics_(data->batcher->async_rpc_metrics()) {
-  mutable_retrier()->mutable_controller()->set_allow_local_calls_in_curr_thread(
-      data->allow_local_calls_in_curr_thread);
+  auto* controller = mutable_retrier()->mutable_controller();
+  controller->set_allow_local_calls_in_curr_thread(data->allow_local_calls_in_curr_thread);
+  controller->set_priority(batcher_->rpc_priority());
+  // Attribute calls of untagged sessions to the namespace of the accessed table, so tablet servers
+  // share the service fairly across databases.
+  controller->set_tenant(
+      !batcher_->rpc_tenant().empty() ? batcher_->rpc_tenant() : table()->name().namespace_name());
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
   }
@@ -46,6 +46,8 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/rpc_header.pb.h"
+
 #include "yb/util/async_util.h"
 #include "yb/util/atomic.h"
 #include "yb/util/debug-util.h"
@@ -194,6 +196,15 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   double RejectionScore(int attempt_num);
 
+  void SetRpcQos(rpc::RpcPriority priority, const std::string& tenant) {
+    rpc_priority_ = priority;
+    rpc_tenant_ = tenant;
+  }
+
+  rpc::RpcPriority rpc_priority() const { return rpc_priority_; }
+
+  const std::string& rpc_tenant() const { return rpc_tenant_; }
+
   // This is a status error string used when there are multiple errors that need to be fetched
   // from the error collector.
   static const std::string kErrorReachingOutToTServersMsg;
@@ -321,6 +332,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   RejectionScoreSourcePtr rejection_score_source_;
 
+  // Used by tablet servers for QoS scheduling of the RPCs of this batch.
+  rpc::RpcPriority rpc_priority_ = rpc::RpcPriority::NORMAL_PRIORITY;
+  std::string rpc_tenant_;
+
   DISALLOW_COPY_AND_ASSIGN(Batcher);
 };
 
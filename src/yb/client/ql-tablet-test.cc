@@ -36,6 +36,8 @@
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master.h"
 
+#include "yb/rocksdb/table_properties.h"
+
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_retention_policy.h"
 
@@ -77,6 +79,7 @@ DECLARE_uint64(sst_files_soft_limit);
 DECLARE_int32(timestamp_history_retention_interval_sec);
 DECLARE_int32(raft_heartbeat_interval_ms);
 DECLARE_int32(history_cutoff_propagation_interval_ms);
+DECLARE_bool(ycql_enable_packed_row);
 
 namespace yb {
 namespace client {
@@ -1127,5 +1130,201 @@ TEST_F(QLTabletTest, HistoryCutoff) {
   ASSERT_NO_FATALS(VerifyHistoryCutoff(cluster_.get(), &committed_history_cutoff, "Final"));
 }
 
+// Check that SST files whose records are all expired by the table TTL are dropped by compaction,
+// while files with live records, and files of tables without TTL, are kept.
+TEST_F(QLTabletTest, DropExpiredFiles) {
+  constexpr int kNumRows = 10;
+  const auto kTtl = 1s * kTimeMultiplier;
+
+  FLAGS_timestamp_history_retention_interval_sec = 0;
+  FLAGS_history_cutoff_propagation_interval_ms = 100;
+
+  YBSchemaBuilder builder;
+  builder.AddColumn(kKeyColumn)->Type(INT32)->HashPrimaryKey()->NotNull();
+  builder.AddColumn(kValueColumn)->Type(INT32);
+  TableProperties table_properties;
+  table_properties.SetDefaultTimeToLive(
+      std::chrono::duration_cast<std::chrono::milliseconds>(kTtl).count());
+  builder.SetTableProperties(table_properties);
+  ASSERT_OK(table1_.Create(kTable1Name, 1, client_.get(), &builder));
+
+  CreateTable(kTable2Name, &table2_, 1);
+
+  auto count_files = [this](const YBTableName& table_name) {
+    std::vector<size_t> result;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+      if (peer->tablet()->metadata()->table_name() == table_name.table_name()) {
+        result.push_back(peer->tablet()->TEST_db()->GetLiveFilesMetaData().size());
+      }
+    }
+    return result;
+  };
+
+  FillTable(0, kNumRows, table1_);
+  FillTable(0, kNumRows, table2_);
+  ASSERT_OK(cluster_->FlushTablets());
+
+  std::this_thread::sleep_for(kTtl * 2);
+
+  FillTable(kNumRows, 2 * kNumRows, table1_);
+  FillTable(kNumRows, 2 * kNumRows, table2_);
+  ASSERT_OK(cluster_->FlushTablets());
+
+  // The file with expired rows is dropped, while the file with fresh rows is kept.
+  ASSERT_OK(WaitFor([&count_files] {
+    auto files = count_files(kTable1Name);
+    return !files.empty() && std::all_of(files.begin(), files.end(), [](size_t num_files) {
+      return num_files == 1;
+    });
+  }, 30s * kTimeMultiplier, "Expired files dropped"));
+  VerifyTable(kNumRows, 2 * kNumRows, table1_);
+  {
+    auto session = CreateSession();
+    for (int i = 0; i != kNumRows; ++i) {
+      ASSERT_FALSE(GetValue(session, i, table1_).is_initialized()) << "i: " << i;
+    }
+  }
+
+  // Table without TTL keeps all of its files.
+  for (auto num_files : count_files(kTable2Name)) {
+    ASSERT_EQ(2, num_files);
+  }
+  VerifyTable(0, 2 * kNumRows, table2_);
+}
+
+// Check that SST files are written with the compression set in the table properties, and that the
+// compression changed by ALTER TABLE is used after the tablets are reopened.
+TEST_F(QLTabletTest, TableCompression) {
+  constexpr int kNumRows = 100;
+
+  auto create_table = [this](TableCompressionPB compression, const YBTableName& table_name,
+                             TableHandle* table) {
+    YBSchemaBuilder builder;
+    builder.AddColumn(kKeyColumn)->Type(INT32)->HashPrimaryKey()->NotNull();
+    builder.AddColumn(kValueColumn)->Type(INT32);
+    TableProperties table_properties;
+    table_properties.SetCompression(compression);
+    builder.SetTableProperties(table_properties);
+    return table->Create(table_name, 1, client_.get(), &builder);
+  };
+
+  // Returns the number of SST files of the first table for each compression.
+  auto count_compressions = [this] {
+    std::map<std::string, size_t> result;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+      if (peer->tablet()->metadata()->table_name() != kTable1Name.table_name()) {
+        continue;
+      }
+      rocksdb::TablePropertiesCollection properties;
+      CHECK_OK(peer->tablet()->TEST_db()->GetPropertiesOfAllTables(&properties));
+      for (const auto& file_and_properties : properties) {
+        ++result[file_and_properties.second->compression_name];
+      }
+    }
+    return result;
+  };
+
+  const size_t num_replicas = cluster_->num_tablet_servers();
+  ASSERT_OK(create_table(TableCompressionPB::TABLE_COMPRESSION_LZ4, kTable1Name, &table1_));
+  FillTable(0, kNumRows, table1_);
+  ASSERT_OK(cluster_->FlushTablets());
+  auto compressions = count_compressions();
+  ASSERT_EQ(1U, compressions.size()) << yb::ToString(compressions);
+  ASSERT_EQ(num_replicas, compressions["LZ4"]);
+
+  // ZSTD is not available in this build, so such tables are rejected.
+  ASSERT_NOK(create_table(TableCompressionPB::TABLE_COMPRESSION_ZSTD, kTable2Name, &table2_));
+
+  {
+    TableProperties table_properties;
+    table_properties.SetCompression(TableCompressionPB::TABLE_COMPRESSION_NONE);
+    std::unique_ptr<YBTableAlterer> table_alterer(client_->NewTableAlterer(kTable1Name));
+    ASSERT_OK(table_alterer->SetTableProperties(table_properties)->Alter());
+  }
+  ASSERT_OK(cluster_->RestartSync());
+
+  FillTable(kNumRows, 2 * kNumRows, table1_);
+  ASSERT_OK(cluster_->FlushTablets());
+  compressions = count_compressions();
+  ASSERT_EQ(2U, compressions.size()) << yb::ToString(compressions);
+  ASSERT_EQ(num_replicas, compressions["LZ4"]);
+  ASSERT_EQ(num_replicas, compressions["NoCompression"]);
+  VerifyTable(0, 2 * kNumRows, table1_);
+}
+
+// Rows inserted with all regular columns are packed. Check that updates of packed rows, compaction
+// and adding a column by ALTER TABLE work as with regular rows.
+TEST_F(QLTabletTest, PackedRow) {
+  constexpr int kNumRows = 10;
+  const std::string kNewColumn = "new_val";
+
+  FLAGS_ycql_enable_packed_row = true;
+  FLAGS_timestamp_history_retention_interval_sec = 0;
+  FLAGS_history_cutoff_propagation_interval_ms = 100;
+
+  CreateTable(kTable1Name, &table1_, /* num_tablets= */ 1);
+  FillTable(0, kNumRows, table1_);
+
+  {
+    auto session = CreateSession();
+    for (int i = 0; i < kNumRows; i += 2) {
+      const auto op = table1_.NewUpdateOp();
+      auto* const req = op->mutable_request();
+      QLAddInt32HashValue(req, i);
+      table1_.AddInt32ColumnValue(req, kValueColumn, -i);
+      ASSERT_OK(session->ApplyAndFlush(op));
+      ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+    }
+  }
+
+  auto verify = [this, kNumRows] {
+    auto session = CreateSession();
+    for (int i = 0; i != kNumRows; ++i) {
+      auto value = GetValue(session, i, table1_);
+      ASSERT_TRUE(value.is_initialized()) << "i: " << i;
+      ASSERT_EQ(i % 2 == 0 ? -i : ValueForKey(i), *value) << "i: " << i;
+    }
+  };
+
+  ASSERT_NO_FATALS(verify());
+  ASSERT_OK(cluster_->FlushTablets());
+  ASSERT_OK(cluster_->CompactTablets());
+  ASSERT_NO_FATALS(verify());
+
+  std::unique_ptr<YBTableAlterer> table_alterer(client_->NewTableAlterer(kTable1Name));
+  table_alterer->AddColumn(kNewColumn)->Type(INT32);
+  ASSERT_OK(table_alterer->timeout(MonoDelta::FromSeconds(60))->Alter());
+  ASSERT_OK(table1_.Open(kTable1Name, client_.get()));
+
+  // Rows packed with the previous schema version are read with the new column missing.
+  ASSERT_NO_FATALS(verify());
+  {
+    auto session = CreateSession();
+    for (int i = 0; i != kNumRows; ++i) {
+      const auto op = client::CreateReadOp(i, table1_, kNewColumn);
+      ASSERT_OK(session->ApplyAndFlush(op));
+      auto rowblock = RowsResult(op.get()).GetRowBlock();
+      ASSERT_EQ(1, rowblock->row_count()) << "i: " << i;
+      ASSERT_TRUE(rowblock->row(0).column(0).IsNull()) << "i: " << i;
+    }
+  }
+
+  // Rows packed with the new schema version are read together with rows packed before ALTER.
+  {
+    auto session = CreateSession();
+    for (int i = kNumRows; i != 2 * kNumRows; ++i) {
+      const auto op = table1_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+      auto* const req = op->mutable_request();
+      QLAddInt32HashValue(req, i);
+      table1_.AddInt32ColumnValue(req, kValueColumn, ValueForKey(i));
+      table1_.AddInt32ColumnValue(req, kNewColumn, i);
+      ASSERT_OK(session->ApplyAndFlush(op));
+      ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+    }
+  }
+  ASSERT_NO_FATALS(verify());
+  VerifyTable(kNumRows, 2 * kNumRows, table1_);
+}
+
 } // namespace client
 } // namespace yb
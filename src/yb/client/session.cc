@@ -202,6 +202,7 @@ internal::Batcher& YBSession::Batcher() {
       batcher_->SetTimeout(timeout_);
     }
     batcher_->SetRejectionScoreSource(rejection_score_source_);
+    batcher_->SetRpcQos(rpc_priority_, rpc_tenant_);
     if (hybrid_time_for_write_.is_valid()) {
       batcher_->WriteWithHybridTime(hybrid_time_for_write_);
     }
@@ -285,5 +286,13 @@ void YBSession::SetForceConsistentRead(ForceConsistentRead value) {
   }
 }
 
+void YBSession::SetRpcQos(rpc::RpcPriority priority, const std::string& tenant) {
+  rpc_priority_ = priority;
+  rpc_tenant_ = tenant;
+  if (batcher_) {
+    batcher_->SetRpcQos(priority, tenant);
+  }
+}
+
 } // namespace client
 } // namespace yb
@@ -21,6 +21,8 @@
 #include "yb/common/common_fwd.h"
 #include "yb/common/hybrid_time.h"
 
+#include "yb/rpc/rpc_header.pb.h"
+
 #include "yb/util/async_util.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
@@ -114,6 +116,15 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // Changed transaction used by this session.
   void SetTransaction(YBTransactionPtr transaction);
 
+  // Whether operations of this session are executed in the context of a transaction.
+  bool HasTransaction() const {
+    return transaction_ != nullptr;
+  }
+
+  const YBTransactionPtr& transaction() const {
+    return transaction_;
+  }
+
   // Set the timeout for writes made in this session.
   void SetTimeout(MonoDelta timeout);
 
@@ -249,6 +260,11 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   void SetRejectionScoreSource(RejectionScoreSourcePtr rejection_score_source);
 
+  // Sets priority and tenant of RPCs sent to tablet servers by this session, used for QoS
+  // scheduling of calls, see rpc_enable_qos. RPCs of a session without tenant are attributed to
+  // the namespace of the table they access.
+  void SetRpcQos(rpc::RpcPriority priority, const std::string& tenant);
+
  private:
   friend class YBClient;
   friend class internal::Batcher;
@@ -262,6 +278,8 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   YBTransactionPtr transaction_;
   bool allow_local_calls_in_curr_thread_ = true;
   bool force_consistent_read_ = false;
+  rpc::RpcPriority rpc_priority_ = rpc::RpcPriority::NORMAL_PRIORITY;
+  std::string rpc_tenant_;
 
   // Lock protecting flushed_batchers_.
   mutable simple_spinlock lock_;
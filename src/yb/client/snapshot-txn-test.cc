@@ -41,6 +41,9 @@ DECLARE_int32(inject_load_transaction_delay_ms);
 DECLARE_int32(inject_status_resolver_delay_ms);
 DECLARE_int32(log_min_seconds_to_retain);
 DECLARE_uint64(max_transactions_in_status_request);
+DECLARE_bool(enable_wait_queues);
+DECLARE_int32(wait_queue_max_wait_ms);
+DECLARE_int32(tablet_server_svc_num_threads);
 
 namespace yb {
 namespace client {
@@ -558,6 +561,67 @@ TEST_F(SnapshotTxnTest, HotRow) {
   }
 }
 
+class WaitQueuesSnapshotTxnTest : public SnapshotTxnTest {
+ protected:
+  void SetUp() override {
+    FLAGS_enable_wait_queues = true;
+    FLAGS_wait_queue_max_wait_ms = 60000;
+    // Much fewer threads serving writes than contending writers. So a waiting transaction that
+    // holds a thread would prevent transactions it waits for from being committed.
+    FLAGS_tablet_server_svc_num_threads = 4;
+    SnapshotTxnTest::SetUp();
+  }
+};
+
+// Many transactions concurrently increment the same row, waiting for each other in the wait
+// queue instead of failing with conflict.
+TEST_F_EX(SnapshotTxnTest, HotRowWithWaitQueues, WaitQueuesSnapshotTxnTest) {
+  constexpr int kWriters = 32;
+  constexpr int kIncrementsPerWriter = RegularBuildVsSanitizers(10, 3);
+  constexpr int kKey = 42;
+
+  ASSERT_OK(WriteRow(CreateSession(), kKey, 0));
+
+  std::atomic<int> committed{0};
+  std::atomic<int> failed{0};
+  TestThreadHolder thread_holder;
+  for (int i = 0; i != kWriters; ++i) {
+    thread_holder.AddThreadFunctor([this, &committed, &failed, &stop = thread_holder.stop_flag()] {
+      int left = kIncrementsPerWriter;
+      while (left > 0 && !stop.load(std::memory_order_acquire)) {
+        auto txn = CreateTransaction();
+        auto session = CreateSession(txn);
+        auto op = Increment(&table_, session, kKey);
+        auto status = ResultToStatus(op);
+        if (status.ok()) {
+          status = session->FlushFuture().get();
+        }
+        if (status.ok() && !(*op)->succeeded()) {
+          status = STATUS_FORMAT(RuntimeError, "Increment failed: $0", (*op)->response());
+        }
+        if (status.ok()) {
+          status = txn->CommitFuture().get();
+        }
+        if (status.ok()) {
+          ++committed;
+          --left;
+        } else {
+          LOG(INFO) << "Increment failed: " << status;
+          ++failed;
+        }
+      }
+    });
+  }
+
+  ASSERT_OK(WaitFor([&committed] {
+    return committed.load() == kWriters * kIncrementsPerWriter;
+  }, 120s * kTimeMultiplier, "All increments committed"));
+  thread_holder.Stop();
+
+  LOG(INFO) << "Committed: " << committed.load() << ", failed: " << failed.load();
+  ASSERT_EQ(kWriters * kIncrementsPerWriter, ASSERT_RESULT(SelectRow(CreateSession(), kKey)));
+}
+
 struct KeyToCheck {
   int value;
   KeyToCheck* next = nullptr;
@@ -482,7 +482,7 @@ class YBPgsqlReadOp : public YBPgsqlOp {
   // Also sets the hash_code and max_hash_code in the request.
   CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
-  const YBConsistencyLevel yb_consistency_level() {
+  const YBConsistencyLevel yb_consistency_level() const {
     return yb_consistency_level_;
   }
 
@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_expr.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class QLTableRowTest : public YBTest {
+};
+
+TEST_F(QLTableRowTest, AllocAndClear) {
+  const ColumnId col1(kFirstColumnId + 1);
+  const ColumnId col2(kFirstColumnId + 5);
+
+  QLTableRow row;
+  ASSERT_TRUE(row.IsEmpty());
+  row.AllocColumn(col1).value.set_int32_value(1);
+  row.AllocColumn(col2).value.set_string_value("two");
+  ASSERT_EQ(2U, row.ColumnCount());
+  ASSERT_TRUE(row.IsColumnSpecified(col1));
+  ASSERT_FALSE(row.IsColumnSpecified(kFirstColumnId + 2));
+  ASSERT_EQ(1, row.GetValue(col1)->int32_value());
+  ASSERT_EQ("two", row.GetValue(col2)->string_value());
+
+  // Values of the previous row must not leak into the next one when storage is reused.
+  row.Clear();
+  ASSERT_TRUE(row.IsEmpty());
+  ASSERT_FALSE(row.IsColumnSpecified(col1));
+  auto& column = row.AllocColumn(col2);
+  ASSERT_EQ(QLValuePB::VALUE_NOT_SET, column.value.value_case());
+  ASSERT_EQ(0, column.ttl_seconds);
+  ASSERT_EQ(QLTableColumn::kUninitializedWriteTime, column.write_time);
+  ASSERT_EQ(1U, row.ColumnCount());
+}
+
+TEST_F(QLTableRowTest, OverflowColumns) {
+  // Ids that do not fit the flat storage are still supported.
+  const ColumnId large_col(kFirstColumnId + 100000);
+  const ColumnId small_col(kFirstColumnId);
+
+  QLTableRow row;
+  row.AllocColumn(large_col).value.set_int64_value(42);
+  row.AllocColumn(small_col).value.set_int64_value(7);
+  ASSERT_EQ(2U, row.ColumnCount());
+  ASSERT_EQ(42, row.GetValue(large_col)->int64_value());
+
+  QLTableRow copy;
+  ASSERT_OK(copy.CopyColumn(large_col, row));
+  ASSERT_OK(copy.CopyColumn(small_col, row));
+  ASSERT_TRUE(copy.MatchColumn(large_col, row));
+  ASSERT_TRUE(copy.MatchColumn(small_col, row));
+
+  copy.ClearValue(small_col);
+  ASSERT_FALSE(copy.MatchColumn(small_col, row));
+  ASSERT_TRUE(copy.IsColumnSpecified(small_col));
+
+  row.Clear();
+  ASSERT_TRUE(row.IsEmpty());
+  ASSERT_FALSE(row.IsColumnSpecified(large_col));
+}
+
+}  // namespace yb
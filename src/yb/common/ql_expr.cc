@@ -4,6 +4,8 @@
 
 #include "yb/common/ql_expr.h"
 
+#include <algorithm>
+
 #include "yb/common/ql_bfunc.h"
 #include "yb/common/ql_value.h"
 #include "yb/common/jsonb.h"
@@ -580,13 +582,26 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const PgsqlConditionPB& condition,
 
 //--------------------------------------------------------------------------------------------------
 
-const QLValuePB* QLTableRow::GetColumn(ColumnIdRep col_id) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
-    return nullptr;
+void QLTableRow::Clear() {
+  if (num_assigned_ != 0) {
+    std::fill(assigned_.begin(), assigned_.end(), false);
+    num_assigned_ = 0;
+  }
+  overflow_columns_.clear();
+}
+
+const QLTableColumn* QLTableRow::FindColumn(ColumnIdRep col_id) const {
+  const size_t index = FlatIndex(col_id);
+  if (index == kMaxFlatColumns) {
+    auto it = overflow_columns_.find(col_id);
+    return it != overflow_columns_.end() ? &it->second : nullptr;
   }
+  return index < assigned_.size() && assigned_[index] ? &values_[index] : nullptr;
+}
 
-  return &col_iter->second.value;
+const QLValuePB* QLTableRow::GetColumn(ColumnIdRep col_id) const {
+  const auto* column = FindColumn(col_id);
+  return column ? &column->value : nullptr;
 }
 
 CHECKED_STATUS QLTableRow::ReadColumn(ColumnIdRep col_id, QLExprResultWriter result_writer) const {
@@ -603,23 +618,23 @@ CHECKED_STATUS QLTableRow::ReadColumn(ColumnIdRep col_id, QLExprResultWriter res
 CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subcol,
                                                  const QLValuePB& index_arg,
                                                  QLExprResultWriter result_writer) const {
-  const auto& col_iter = col_map_.find(subcol.column_id());
-  if (col_iter == col_map_.end()) {
+  const auto* value = GetColumn(subcol.column_id());
+  if (value == nullptr) {
     // Not exists.
     result_writer.SetNull();
     return Status::OK();
-  } else if (col_iter->second.value.has_map_value()) {
+  } else if (value->has_map_value()) {
     // map['key']
-    auto& map = col_iter->second.value.map_value();
+    auto& map = value->map_value();
     for (int i = 0; i < map.keys_size(); i++) {
       if (map.keys(i) == index_arg) {
         result_writer.SetExisting(&map.values(i));
         return Status::OK();
       }
     }
-  } else if (col_iter->second.value.has_list_value()) {
+  } else if (value->has_list_value()) {
     // list[index]
-    auto& list = col_iter->second.value.list_value();
+    auto& list = value->list_value();
     if (index_arg.has_int32_value()) {
       int list_index = index_arg.int32_value();
       if (list_index >= 0 && list_index < list.elems_size()) {
@@ -634,95 +649,126 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
 }
 
 CHECKED_STATUS QLTableRow::GetTTL(ColumnIdRep col_id, int64_t *ttl_seconds) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *ttl_seconds = col_iter->second.ttl_seconds;
+  *ttl_seconds = column->ttl_seconds;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetWriteTime(ColumnIdRep col_id, int64_t *write_time) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  DCHECK_NE(QLTableColumn::kUninitializedWriteTime, col_iter->second.write_time);
-  *write_time = col_iter->second.write_time;
+  DCHECK_NE(QLTableColumn::kUninitializedWriteTime, column->write_time);
+  *write_time = column->write_time;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetValue(ColumnIdRep col_id, QLValue *column) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* value = GetColumn(col_id);
+  if (value == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *column = std::move(col_iter->second.value);
+  *column = *value;
   return Status::OK();
 }
 
 boost::optional<const QLValuePB&> QLTableRow::GetValue(ColumnIdRep col_id) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* value = GetColumn(col_id);
+  if (value == nullptr) {
     return boost::none;
   }
-  return col_iter->second.value;
+  return *value;
 }
 
 bool QLTableRow::IsColumnSpecified(ColumnIdRep col_id) const {
-  return col_map_.find(col_id) != col_map_.end();
+  return FindColumn(col_id) != nullptr;
 }
 
 void QLTableRow::ClearValue(ColumnIdRep col_id) {
-  col_map_[col_id].value.Clear();
+  AllocColumn(col_id).value.Clear();
 }
 
 bool QLTableRow::MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const {
-  auto this_iter = col_map_.find(col_id);
-  auto source_iter = source.col_map_.find(col_id);
-  if (this_iter != col_map_.end() && source_iter != source.col_map_.end()) {
-    return this_iter->second.value == source_iter->second.value;
-  }
-  if (this_iter != col_map_.end() || source_iter != source.col_map_.end()) {
-    return false;
+  const auto* this_value = GetColumn(col_id);
+  const auto* source_value = source.GetColumn(col_id);
+  if (this_value != nullptr && source_value != nullptr) {
+    return *this_value == *source_value;
   }
-  return true;
+  return this_value == nullptr && source_value == nullptr;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id) {
-  return col_map_[col_id];
+  const size_t index = FlatIndex(col_id);
+  if (index == kMaxFlatColumns) {
+    return overflow_columns_[col_id];
+  }
+  if (index >= values_.size()) {
+    values_.resize(index + 1);
+    assigned_.resize(index + 1, false);
+  }
+  auto& column = values_[index];
+  if (!assigned_[index]) {
+    // The slot could hold a value of the previous row, reset it as if it was just allocated.
+    assigned_[index] = true;
+    ++num_assigned_;
+    column.value.Clear();
+    column.ttl_seconds = 0;
+    column.write_time = QLTableColumn::kUninitializedWriteTime;
+  }
+  return column;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValue& ql_value) {
-  col_map_[col_id].value = ql_value.value();
-  return col_map_[col_id];
+  auto& column = AllocColumn(col_id);
+  column.value = ql_value.value();
+  return column;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValuePB& ql_value) {
-  col_map_[col_id].value = ql_value;
-  return col_map_[col_id];
+  auto& column = AllocColumn(col_id);
+  column.value = ql_value;
+  return column;
 }
 
 CHECKED_STATUS QLTableRow::CopyColumn(ColumnIdRep col_id,
                                       const QLTableRow& source) {
-  auto col_iter = source.col_map_.find(col_id);
-  if (col_iter != source.col_map_.end()) {
-    col_map_[col_id] = col_iter->second;
+  const auto* source_column = source.FindColumn(col_id);
+  if (source_column != nullptr) {
+    AllocColumn(col_id) = *source_column;
   }
   return Status::OK();
 }
 
+std::string QLTableRow::ToString() const {
+  std::string ret;
+  ret.append("{ ");
+  for (size_t index = 0; index != values_.size(); ++index) {
+    if (assigned_[index]) {
+      ret += Format("$0: $1 ", kFirstColumnId.rep() + index, values_[index]);
+    }
+  }
+  for (const auto& entry : overflow_columns_) {
+    ret += Format("$0: $1 ", entry.first, entry.second);
+  }
+  ret.append("}");
+  return ret;
+}
+
 std::string QLTableRow::ToString(const Schema& schema) const {
   std::string ret;
   ret.append("{ ");
 
   for (size_t col_idx = 0; col_idx < schema.num_columns(); col_idx++) {
-    auto it = col_map_.find(schema.column_id(col_idx));
-    if (it != col_map_.end() && it->second.value.value_case() != QLValuePB::VALUE_NOT_SET) {
-      ret += it->second.value.ShortDebugString();
+    const auto* value = GetColumn(schema.column_id(col_idx));
+    if (value != nullptr && value->value_case() != QLValuePB::VALUE_NOT_SET) {
+      ret += value->ShortDebugString();
     } else {
       ret += "null";
     }
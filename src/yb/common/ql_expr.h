@@ -77,6 +77,12 @@ class QLExprResultWriter {
   QLExprResult* result_;
 };
 
+// A row of column values, as read by a rowwise iterator or assembled by a write operation.
+//
+// Column ids of a table are assigned sequentially starting from kFirstColumnId, so values are kept
+// in a flat vector indexed by the column id, which avoids hashing and a node allocation per column.
+// Clear() only resets the assigned flags, so a row reused across NextRow() calls keeps its storage.
+// Ids beyond kMaxFlatColumns, which should be rare, are kept in a map.
 class QLTableRow {
  public:
   // Public types.
@@ -90,16 +96,16 @@ class QLTableRow {
 
   // Check if row is empty (no column).
   bool IsEmpty() const {
-    return col_map_.empty();
+    return num_assigned_ == 0 && overflow_columns_.empty();
   }
 
   // Get column count.
   size_t ColumnCount() const {
-    return col_map_.size();
+    return num_assigned_ + overflow_columns_.size();
   }
 
   // Clear the row.
-  void Clear() { col_map_.clear(); }
+  void Clear();
 
   // Compare column value between two rows.
   bool MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const;
@@ -161,20 +167,38 @@ class QLTableRow {
 
   // For testing only (no status check).
   const QLTableColumn& TestValue(ColumnIdRep col_id) const {
-    return col_map_.at(col_id);
+    auto* column = FindColumn(col_id);
+    CHECK(column) << "Column " << col_id << " not found";
+    return *column;
   }
   const QLTableColumn& TestValue(const ColumnId& col) const {
-    return col_map_.at(col.rep());
+    return TestValue(col.rep());
   }
 
-  std::string ToString() const {
-    return yb::ToString(col_map_);
-  }
+  std::string ToString() const;
 
   std::string ToString(const Schema& schema) const;
 
  private:
-  std::unordered_map<ColumnIdRep, QLTableColumn> col_map_;
+  // Number of columns whose values are kept in the flat vector.
+  static constexpr size_t kMaxFlatColumns = 1024;
+
+  // Returns the column with the given id, or nullptr if it is not assigned.
+  const QLTableColumn* FindColumn(ColumnIdRep col_id) const;
+
+  // Returns the position of the column in the flat vector, or kMaxFlatColumns if it does not fit.
+  static size_t FlatIndex(ColumnIdRep col_id) {
+    const auto index = static_cast<size_t>(col_id) - static_cast<size_t>(kFirstColumnId.rep());
+    return col_id >= kFirstColumnId.rep() && index < kMaxFlatColumns ? index : kMaxFlatColumns;
+  }
+
+  // Values of the columns with ids in [kFirstColumnId, kFirstColumnId + kMaxFlatColumns), the
+  // value of a column is only meaningful if it is marked in assigned_.
+  std::vector<QLTableColumn> values_;
+  std::vector<bool> assigned_;
+  size_t num_assigned_ = 0;
+
+  std::unordered_map<ColumnIdRep, QLTableColumn> overflow_columns_;
 };
 
 class QLExprExecutor {
@@ -122,4 +122,16 @@ bool RequireRead(const QLWriteRequestPB& request, const Schema& schema) {
   return RequireReadForExpressions(request) || has_user_timestamp || is_range_operation;
 }
 
+void AddDocDBStats(const DocDBStatsPB& source, DocDBStatsPB* dest) {
+  dest->set_num_seeks(dest->num_seeks() + source.num_seeks());
+  dest->set_num_nexts(dest->num_nexts() + source.num_nexts());
+  dest->set_num_skipped_entries(dest->num_skipped_entries() + source.num_skipped_entries());
+  dest->set_num_intents_scanned(dest->num_intents_scanned() + source.num_intents_scanned());
+  dest->set_block_cache_hits(dest->block_cache_hits() + source.block_cache_hits());
+  dest->set_block_cache_misses(dest->block_cache_misses() + source.block_cache_misses());
+  dest->set_bloom_checks(dest->bloom_checks() + source.bloom_checks());
+  dest->set_bloom_useful(dest->bloom_useful() + source.bloom_useful());
+  dest->set_sst_files_touched(dest->sst_files_touched() + source.sst_files_touched());
+}
+
 } // namespace yb
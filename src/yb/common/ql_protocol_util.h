@@ -95,6 +95,9 @@ bool RequireRead(const QLWriteRequestPB& request, const Schema& schema);
 // Does this write request perform a range operation (e.g. range delete)?
 bool IsRangeOperation(const QLWriteRequestPB& request, const Schema& schema);
 
+// Adds counters of source to dest, leaving dest tablet_id intact.
+void AddDocDBStats(const DocDBStatsPB& source, DocDBStatsPB* dest);
+
 } // namespace yb
 
 #endif // YB_COMMON_QL_PROTOCOL_UTIL_H
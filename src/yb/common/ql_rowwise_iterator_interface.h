@@ -80,6 +80,12 @@ class YQLRowwiseIteratorIf {
     return STATUS(NotSupported, "This iterator cannot seek by tuple id");
   }
 
+  // Seeks to the given tuple by its id, where the id is known to be greater than the id of any
+  // tuple read since the last SeekTuple. See DocRowwiseIterator for details.
+  virtual Result<bool> SeekTupleForward(const Slice& tuple_id) {
+    return SeekTuple(tuple_id);
+  }
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
@@ -473,6 +473,56 @@ TEST(TestSchema, TestTableProperties) {
   ASSERT_FALSE(properties3.HasDefaultTimeToLive());
 }
 
+TEST(TestSchema, TestTableCompressionProperties) {
+  TableProperties properties;
+  ASSERT_EQ(TableCompressionPB::TABLE_COMPRESSION_DEFAULT, properties.compression());
+  ASSERT_FALSE(properties.compression_level());
+
+  TablePropertiesPB pb;
+  properties.ToTablePropertiesPB(&pb);
+  ASSERT_FALSE(pb.has_compression());
+  ASSERT_FALSE(pb.has_compression_level());
+
+  properties.SetCompression(TableCompressionPB::TABLE_COMPRESSION_ZSTD);
+  properties.SetCompressionLevel(9);
+  properties.ToTablePropertiesPB(&pb);
+  auto properties2 = TableProperties::FromTablePropertiesPB(pb);
+  ASSERT_EQ(TableCompressionPB::TABLE_COMPRESSION_ZSTD, properties2.compression());
+  ASSERT_EQ(9, *properties2.compression_level());
+
+  TablePropertiesPB alter_pb;
+  alter_pb.set_compression(TableCompressionPB::TABLE_COMPRESSION_LZ4);
+  properties2.AlterFromTablePropertiesPB(alter_pb);
+  ASSERT_EQ(TableCompressionPB::TABLE_COMPRESSION_LZ4, properties2.compression());
+  ASSERT_EQ(9, *properties2.compression_level());
+
+  properties2.Reset();
+  ASSERT_EQ(TableCompressionPB::TABLE_COMPRESSION_DEFAULT, properties2.compression());
+  ASSERT_FALSE(properties2.compression_level());
+}
+
+TEST(TestSchema, TestTableBloomFilterProperties) {
+  TableProperties properties;
+  ASSERT_FALSE(properties.bloom_filter_range_components());
+
+  TablePropertiesPB pb;
+  properties.ToTablePropertiesPB(&pb);
+  ASSERT_FALSE(pb.has_bloom_filter_range_components());
+
+  properties.SetBloomFilterRangeComponents(2);
+  properties.ToTablePropertiesPB(&pb);
+  auto properties2 = TableProperties::FromTablePropertiesPB(pb);
+  ASSERT_EQ(2, *properties2.bloom_filter_range_components());
+
+  TablePropertiesPB alter_pb;
+  alter_pb.set_bloom_filter_range_components(0);
+  properties2.AlterFromTablePropertiesPB(alter_pb);
+  ASSERT_EQ(0, *properties2.bloom_filter_range_components());
+
+  properties2.Reset();
+  ASSERT_FALSE(properties2.bloom_filter_range_components());
+}
+
 #ifdef NDEBUG
 TEST(TestKeyEncoder, BenchmarkSimpleKey) {
   faststring fs;
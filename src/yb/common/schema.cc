@@ -97,6 +97,15 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   }
   pb->set_is_ysql_catalog_table(is_ysql_catalog_table_);
   pb->set_is_backfilling(is_backfilling_);
+  if (compression_ != TableCompressionPB::TABLE_COMPRESSION_DEFAULT) {
+    pb->set_compression(compression_);
+  }
+  if (compression_level_) {
+    pb->set_compression_level(*compression_level_);
+  }
+  if (bloom_filter_range_components_) {
+    pb->set_bloom_filter_range_components(*bloom_filter_range_components_);
+  }
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -128,6 +137,15 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_is_backfilling()) {
     table_properties.SetIsBackfilling(pb.is_backfilling());
   }
+  if (pb.has_compression()) {
+    table_properties.SetCompression(pb.compression());
+  }
+  if (pb.has_compression_level()) {
+    table_properties.SetCompressionLevel(pb.compression_level());
+  }
+  if (pb.has_bloom_filter_range_components()) {
+    table_properties.SetBloomFilterRangeComponents(pb.bloom_filter_range_components());
+  }
   return table_properties;
 }
 
@@ -156,6 +174,15 @@ void TableProperties::AlterFromTablePropertiesPB(const TablePropertiesPB& pb) {
   if (pb.has_is_backfilling()) {
     SetIsBackfilling(pb.is_backfilling());
   }
+  if (pb.has_compression()) {
+    SetCompression(pb.compression());
+  }
+  if (pb.has_compression_level()) {
+    SetCompressionLevel(pb.compression_level());
+  }
+  if (pb.has_bloom_filter_range_components()) {
+    SetBloomFilterRangeComponents(pb.bloom_filter_range_components());
+  }
 }
 
 void TableProperties::Reset() {
@@ -168,6 +195,9 @@ void TableProperties::Reset() {
   num_tablets_ = 0;
   is_ysql_catalog_table_ = false;
   is_backfilling_ = false;
+  compression_ = TableCompressionPB::TABLE_COMPRESSION_DEFAULT;
+  compression_level_.reset();
+  bloom_filter_range_components_.reset();
 }
 
 string TableProperties::ToString() const {
@@ -180,6 +210,15 @@ string TableProperties::ToString() const {
   if (HasCopartitionTableId()) {
     result += Format("copartition_table_id: $0 ", copartition_table_id_);
   }
+  if (compression_ != TableCompressionPB::TABLE_COMPRESSION_DEFAULT) {
+    result += Format("compression: $0 ", TableCompressionPB_Name(compression_));
+  }
+  if (compression_level_) {
+    result += Format("compression_level: $0 ", *compression_level_);
+  }
+  if (bloom_filter_range_components_) {
+    result += Format("bloom_filter_range_components: $0 ", *bloom_filter_range_components_);
+  }
   return result + Format(
       "consistency_level: $0 is_ysql_catalog_table: $1 }",
       consistency_level_,
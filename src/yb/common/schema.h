@@ -458,6 +458,20 @@ class TableProperties {
 
   void SetIsBackfilling(bool is_backfilling) { is_backfilling_ = is_backfilling; }
 
+  TableCompressionPB compression() const { return compression_; }
+
+  void SetCompression(TableCompressionPB compression) { compression_ = compression; }
+
+  const boost::optional<int32_t>& compression_level() const { return compression_level_; }
+
+  void SetCompressionLevel(int32_t compression_level) { compression_level_ = compression_level; }
+
+  const boost::optional<int32_t>& bloom_filter_range_components() const {
+    return bloom_filter_range_components_;
+  }
+
+  void SetBloomFilterRangeComponents(int32_t value) { bloom_filter_range_components_ = value; }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const;
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb);
@@ -480,6 +494,9 @@ class TableProperties {
   bool use_mangled_column_name_ = false;
   int num_tablets_ = 0;
   bool is_ysql_catalog_table_ = false;
+  TableCompressionPB compression_ = TableCompressionPB::TABLE_COMPRESSION_DEFAULT;
+  boost::optional<int32_t> compression_level_;
+  boost::optional<int32_t> bloom_filter_range_components_;
 };
 
 typedef uint32_t PgTableOid;
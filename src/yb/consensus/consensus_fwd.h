@@ -47,6 +47,11 @@ typedef std::vector<ConsensusRoundPtr> ConsensusRounds;
 class ConsensusServiceProxy;
 typedef std::unique_ptr<ConsensusServiceProxy> ConsensusServiceProxyPtr;
 
+class MultiRaftHeartbeatBatcher;
+typedef std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcherPtr;
+
+class MultiRaftManager;
+
 class LeaderElection;
 typedef scoped_refptr<LeaderElection> LeaderElectionPtr;
 
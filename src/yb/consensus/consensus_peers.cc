@@ -48,6 +48,8 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/log_util.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/gutil/map-util.h"
@@ -55,6 +57,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/periodic.h"
+#include "yb/rpc/rpc_metrics.h"
 #include "yb/tablet/tablet_error.h"
 #include "yb/tserver/tserver.pb.h"
 #include "yb/tserver/tserver_error.h"
@@ -83,6 +86,19 @@ DEFINE_int32(max_wait_for_processresponse_before_closing_ms,
              "finish before returning proceding to close the Peer and return");
 TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, false,
+            "If true, status-only consensus requests (heartbeats) sent to the same tablet server "
+            "are coalesced into MultiRaftUpdateConsensus RPCs. Should only be enabled once all "
+            "tablet servers in the cluster support this RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, advanced);
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, runtime);
+
+DEFINE_string(consensus_ops_compression_type, "none",
+              "Codec used to compress operations sent to followers: none, snappy, zlib, lz4 or "
+              "zstd. Operations are sent compressed only to followers that reported support of "
+              "compressed operations, other followers receive them uncompressed.");
+TAG_FLAG(consensus_ops_compression_type, advanced);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -125,7 +141,9 @@ Peer::Peer(
       queue_(queue),
       raft_pool_token_(raft_pool_token),
       consensus_(consensus),
-      messenger_(messenger) {}
+      messenger_(messenger),
+      ops_compression_type_(
+          log::LogCompressionTypeFromString(FLAGS_consensus_ops_compression_type)) {}
 
 void Peer::SetTermForTest(int term) {
   response_.set_responder_term(term);
@@ -310,10 +328,30 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   // condition. When rest of this function is running in parallel to ProcessResponse.
   msgs_holder.ReleaseOps();
 
+  if (ops_compression_type_ != log::CompressionTypePB::NO_COMPRESSION &&
+      peer_supports_compressed_ops_ && request_.ops_size() > 0) {
+    CompressOps();
+  }
+
+  if (!req_has_ops && trigger_mode == RequestTriggerMode::kAlwaysSend) {
+    proxy_->UpdateHeartbeatAsync(&request_, &response_, &controller_,
+                                 std::bind(&Peer::ProcessResponseWithStatus, retain_self, _1));
+    return;
+  }
+
   proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
                       std::bind(&Peer::ProcessResponse, retain_self));
 }
 
+void Peer::CompressOps() {
+  request_.mutable_compressed_ops()->Reserve(request_.ops_size());
+  for (const auto& op : request_.ops()) {
+    *request_.add_compressed_ops() = *queue_->CompressedOp(op, ops_compression_type_);
+  }
+  // Ops are shared with the log cache, so they are released without being deleted.
+  request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), nullptr /* elements */);
+}
+
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
   std::unique_lock<simple_spinlock> lock(peer_lock_);
 
@@ -325,10 +363,14 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
 }
 
 void Peer::ProcessResponse() {
+  ProcessResponseWithStatus(controller_.status());
+}
+
+void Peer::ProcessResponseWithStatus(const Status& status) {
   request_.mutable_ops()->ExtractSubrange(0, request_.ops().size(), nullptr /* elements */);
+  request_.clear_compressed_ops();
 
   DCHECK(performing_mutex_.is_locked()) << "Got a response when nothing was pending";
-  Status status = controller_.status();
   controller_.Reset();
 
   auto performing_lock = LockPerforming(std::adopt_lock);
@@ -401,6 +443,7 @@ void Peer::ProcessResponse() {
   }
 
   failed_attempts_ = 0;
+  peer_supports_compressed_ops_ = response_.supports_compressed_ops();
   bool more_pending = queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_);
 
   if (more_pending) {
@@ -499,8 +542,11 @@ Peer::~Peer() {
   CHECK_EQ(state_, kPeerClosed) << "Peer cannot be implicitly closed";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           MultiRaftHeartbeatBatcherPtr multi_raft_batcher,
+                           rpc::RpcMetrics* rpc_metrics)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      multi_raft_batcher_(std::move(multi_raft_batcher)), rpc_metrics_(rpc_metrics) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -509,9 +555,23 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
                                rpc::RpcController* controller,
                                const rpc::ResponseCallback& callback) {
   controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  if (rpc_metrics_ && rpc_metrics_->consensus_updates_sent_individually) {
+    rpc_metrics_->consensus_updates_sent_individually->Increment();
+  }
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+void RpcPeerProxy::UpdateHeartbeatAsync(const ConsensusRequestPB* request,
+                                        ConsensusResponsePB* response,
+                                        rpc::RpcController* controller,
+                                        const StdStatusCallback& callback) {
+  if (multi_raft_batcher_ && FLAGS_enable_multi_raft_heartbeat_batcher) {
+    multi_raft_batcher_->AddRequestToBatch(*request, response, callback);
+    return;
+  }
+  PeerProxy::UpdateHeartbeatAsync(request, response, controller, callback);
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -544,13 +604,21 @@ void RpcPeerProxy::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* req
 RpcPeerProxy::~RpcPeerProxy() {}
 
 RpcPeerProxyFactory::RpcPeerProxyFactory(
-    Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from)
-    : messenger_(messenger), proxy_cache_(proxy_cache), from_(std::move(from)) {}
+    Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from,
+    MultiRaftManager* multi_raft_manager)
+    : messenger_(messenger), proxy_cache_(proxy_cache), from_(std::move(from)),
+      multi_raft_manager_(multi_raft_manager) {}
 
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  MultiRaftHeartbeatBatcherPtr multi_raft_batcher;
+  if (multi_raft_manager_) {
+    multi_raft_batcher = multi_raft_manager_->AddOrGetBatcher(hostport);
+  }
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(multi_raft_batcher),
+      messenger_ ? &messenger_->rpc_metrics() : nullptr);
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
@@ -40,6 +40,7 @@
 
 #include "yb/consensus/consensus_fwd.h"
 #include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/log.pb.h"
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/consensus_util.h"
 
@@ -52,6 +53,7 @@
 #include "yb/util/net/net_util.h"
 #include "yb/util/semaphore.h"
 #include "yb/util/status.h"
+#include "yb/util/status_callback.h"
 
 namespace yb {
 class HostPort;
@@ -175,10 +177,17 @@ class Peer : public std::enable_shared_from_this<Peer> {
  private:
   void SendNextRequest(RequestTriggerMode trigger_mode);
 
+  // Replaces ops of request_ with their compressed form, that is shared with the log cache.
+  void CompressOps();
+
   // Signals that a response was received from the peer. This method does response handling that
   // requires IO or may block.
   void ProcessResponse();
 
+  // Same as above, for requests whose outcome is not reported through controller_, i.e.
+  // heartbeats that were sent as a part of a MultiRaftUpdateConsensus batch.
+  void ProcessResponseWithStatus(const Status& status);
+
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
   //
@@ -218,6 +227,13 @@ class Peer : public std::enable_shared_from_this<Peer> {
   ConsensusRequestPB request_;
   ConsensusResponsePB response_;
 
+  // Codec used to compress ops sent to the peer.
+  const log::CompressionTypePB ops_compression_type_;
+
+  // Whether the peer reported that it accepts compressed ops. Ops are sent uncompressed until the
+  // first successful response, so peers running older versions never receive compressed ops.
+  bool peer_supports_compressed_ops_ = false;
+
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
   StartRemoteBootstrapResponsePB rb_response_;
@@ -263,6 +279,17 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Sends a status-only request (heartbeat), asynchronously, to a remote peer. Implementations
+  // may coalesce it with heartbeats of other Raft groups sent to the same server, so the outcome
+  // of the call is passed to 'callback' instead of being stored in 'controller'.
+  virtual void UpdateHeartbeatAsync(const ConsensusRequestPB* request,
+                                    ConsensusResponsePB* response,
+                                    rpc::RpcController* controller,
+                                    const StdStatusCallback& callback) {
+    UpdateAsync(request, RequestTriggerMode::kAlwaysSend, response, controller,
+                [controller, callback] { callback(controller->status()); });
+  }
+
   // Sends a RequestConsensusVote to a remote peer.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
@@ -313,7 +340,12 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  // 'multi_raft_batcher' is used to coalesce heartbeats with the ones of other Raft groups sent
+  // to the same server, it could be null. 'rpc_metrics' counts UpdateConsensus requests sent in
+  // their own RPC, it could be null.
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               MultiRaftHeartbeatBatcherPtr multi_raft_batcher = nullptr,
+               rpc::RpcMetrics* rpc_metrics = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -321,6 +353,11 @@ class RpcPeerProxy : public PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) override;
 
+  virtual void UpdateHeartbeatAsync(const ConsensusRequestPB* request,
+                                    ConsensusResponsePB* response,
+                                    rpc::RpcController* controller,
+                                    const StdStatusCallback& callback) override;
+
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
@@ -346,12 +383,16 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  MultiRaftHeartbeatBatcherPtr multi_raft_batcher_;
+  rpc::RpcMetrics* rpc_metrics_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
 class RpcPeerProxyFactory : public PeerProxyFactory {
  public:
-  RpcPeerProxyFactory(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from);
+  // 'multi_raft_manager' could be null, in which case heartbeats are never batched.
+  RpcPeerProxyFactory(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from,
+                      MultiRaftManager* multi_raft_manager = nullptr);
 
   PeerProxyPtr NewProxy(const RaftPeerPB& peer_pb) override;
 
@@ -363,6 +404,7 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
   rpc::Messenger* messenger_ = nullptr;
   rpc::ProxyCache* const proxy_cache_;
   const CloudInfoPB from_;
+  MultiRaftManager* const multi_raft_manager_;
 };
 
 // Query the consensus service at last known host/port that is specified in 'remote_peer' and set
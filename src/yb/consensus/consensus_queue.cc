@@ -1090,6 +1090,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     }
 
     UpdateAllReplicatedOpId(&queue_state_.all_replicated_op_id);
+    log_cache_.DropCompressedOpsThrough(queue_state_.all_replicated_op_id.index());
 
     auto evict_op = std::min(
         queue_state_.all_replicated_op_id.index(), GetCDCConsumerOpIdToEvict().index);
@@ -353,6 +353,12 @@ class PeerMessageQueue {
   // Start memory tracking of following operations in case they are still present in our caches.
   void TrackOperationsMemory(const OpIds& op_ids);
 
+  // See LogCache::CompressedOp.
+  std::shared_ptr<const std::string> CompressedOp(
+      const ReplicateMsg& msg, log::CompressionTypePB type) {
+    return log_cache_.CompressedOp(msg, type);
+  }
+
   const server::ClockPtr& clock() const {
     return clock_;
   }
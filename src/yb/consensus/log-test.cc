@@ -47,10 +47,12 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/random.h"
+#include "yb/util/random_util.h"
 
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
+DECLARE_int32(log_min_batch_size_to_compress);
 DECLARE_int32(log_min_segments_to_retain);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
@@ -807,6 +809,77 @@ TEST_F(LogTest, TestWriteManyBatches) {
   }
 }
 
+// Tests that entry batches written to compressed segments are read back.
+TEST_F(LogTest, CompressEntryBatch) {
+  google::FlagSaver flag_saver;
+  FLAGS_log_min_batch_size_to_compress = 0;
+
+  std::string compressible;
+  for (int i = 0; i != 1000; ++i) {
+    compressible += "0123456789";
+  }
+  std::string incompressible(compressible.size(), 0);
+  Random rng(SeedRandom());
+  RandomString(&incompressible[0], incompressible.size(), &rng);
+  for (const auto* name : {"snappy", "zlib", "lz4", "zstd"}) {
+    SCOPED_TRACE(name);
+    const auto type = LogCompressionTypeFromString(name);
+    if (type == CompressionTypePB::NO_COMPRESSION) {
+      LOG(INFO) << "Compression is not supported: " << name;
+      continue;
+    }
+    for (const auto* data : {&compressible, &incompressible}) {
+      const bool expect_compressed = data == &compressible;
+      std::string output;
+      CompressEntryBatch(type, *data, &output);
+      ASSERT_FALSE(output.empty());
+      ASSERT_EQ(expect_compressed ? type : CompressionTypePB::NO_COMPRESSION,
+                static_cast<CompressionTypePB>(output[0]));
+      if (expect_compressed) {
+        ASSERT_LT(output.size(), data->size());
+      }
+
+      Slice slice(output);
+      faststring buffer;
+      ASSERT_OK(UncompressEntryBatch(&slice, &buffer));
+      ASSERT_EQ(*data, slice.ToBuffer());
+    }
+  }
+}
+
+TEST_F(LogTest, TestCompressedSegments) {
+  google::FlagSaver flag_saver;
+  FLAGS_log_min_batch_size_to_compress = 0;
+  options_.compression_type = CompressionTypePB::SNAPPY_COMPRESSION;
+  BuildLog();
+
+  // Values are compressible, so batches are actually written compressed.
+  const int kNumBatches = 20;
+  for (int i = 0; i != kNumBatches; ++i) {
+    OpId opid = MakeOpId(1, current_index_);
+    AppendReplicateBatch(opid, opid, {TupleForAppend(i, 0, std::string(1000, 'x'))});
+    current_index_ += 1;
+  }
+  OpId opid = MakeOpId(1, current_index_);
+  ASSERT_OK(AppendNoOps(&opid, kNumBatches));
+  ASSERT_OK(log_->Close());
+
+  std::unique_ptr<LogReader> reader;
+  ASSERT_OK(LogReader::Open(fs_manager_->env(), nullptr, kTestTablet, tablet_wal_path_,
+                            fs_manager_->uuid(), nullptr, &reader));
+  std::vector<scoped_refptr<ReadableLogSegment>> segments;
+  ASSERT_OK(reader->GetSegmentsSnapshot(&segments));
+
+  size_t num_entries = 0;
+  for (const auto& segment : segments) {
+    ASSERT_EQ(CompressionTypePB::SNAPPY_COMPRESSION, segment->header().compression_type());
+    auto read_entries = segment->ReadEntries();
+    ASSERT_OK(read_entries.status);
+    num_entries += read_entries.entries.size();
+  }
+  ASSERT_EQ(2 * kNumBatches, num_entries);
+}
+
 // This tests that querying LogReader works.
 // This sets up a reader with some segments to query which amount to the
 // following:
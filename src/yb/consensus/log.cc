@@ -73,6 +73,7 @@
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/util/shared_lock.h"
+#include "yb/util/wait_state.h"
 
 using namespace yb::size_literals;  // NOLINT.
 using namespace std::literals;  // NOLINT.
@@ -227,6 +228,7 @@ Status Log::Appender::Init() {
 }
 
 void Log::Appender::ProcessBatch(LogEntryBatch* entry_batch) {
+  ScopedWaitActivity activity("WAL append", log_->tablet_id());
   // A callback function to TaskStream is expected to process the accumulated batch of entries.
   if (entry_batch == nullptr) {
     // Here, we do sync and call callbacks.
@@ -707,6 +709,7 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
+        ScopedWaitState wait_state(WaitStateCode::kWalSync);
         RETURN_NOT_OK(active_segment_->Sync());
       }
     }
@@ -1098,6 +1101,9 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  if (options_.compression_type != CompressionTypePB::NO_COMPRESSION) {
+    header.set_compression_type(options_.compression_type);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
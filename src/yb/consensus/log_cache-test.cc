@@ -43,6 +43,7 @@
 #include "yb/consensus/consensus-test-util.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_cache.h"
+#include "yb/consensus/log_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/bind_helpers.h"
 #include "yb/gutil/stl_util.h"
@@ -202,6 +203,49 @@ TEST_F(LogCacheTest, TestAppendAndGetMessages) {
 }
 
 
+// Tests that compressed form of a cached operation is computed once and accounted in cache size.
+TEST_F(LogCacheTest, TestCompressedOpIsCached) {
+  constexpr auto kType = log::CompressionTypePB::SNAPPY;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 2, 1_KB));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(2, read_result.messages.size());
+  const auto& msg = *read_result.messages[0];
+  const auto size_before = cache_->metrics_.size->value();
+  auto compressed = cache_->CompressedOp(msg, kType);
+  ASSERT_EQ(cache_->metrics_.size->value(), size_before + compressed->size());
+  ASSERT_EQ(compressed, cache_->CompressedOp(msg, kType));
+  ASSERT_EQ(cache_->metrics_.size->value(), size_before + compressed->size());
+
+  Slice data(*compressed);
+  faststring buffer;
+  ASSERT_OK(log::UncompressEntryBatch(&data, &buffer));
+  ReplicateMsg uncompressed;
+  ASSERT_TRUE(uncompressed.ParseFromArray(data.data(), data.size()));
+  ASSERT_EQ(msg.SerializeAsString(), uncompressed.SerializeAsString());
+
+  // Operation that is not in the cache is compressed, but not kept.
+  cache_->EvictThroughOp(1);
+  ASSERT_NE(compressed, cache_->CompressedOp(msg, kType));
+  read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(2, read_result.messages.size());
+  const auto& disk_msg = *read_result.messages[0];
+  ASSERT_NE(cache_->CompressedOp(disk_msg, kType), cache_->CompressedOp(disk_msg, kType));
+
+  // Compressed form is dropped when all peers have received the operation, and is not kept after
+  // that.
+  const auto& cached_msg = *read_result.messages[1];
+  const auto size_without_compressed = cache_->metrics_.size->value();
+  compressed = cache_->CompressedOp(cached_msg, kType);
+  ASSERT_EQ(compressed, cache_->CompressedOp(cached_msg, kType));
+  ASSERT_EQ(cache_->metrics_.size->value(), size_without_compressed + compressed->size());
+  cache_->DropCompressedOpsThrough(cached_msg.id().index());
+  ASSERT_EQ(cache_->metrics_.size->value(), size_without_compressed);
+  ASSERT_NE(compressed, cache_->CompressedOp(cached_msg, kType));
+  ASSERT_EQ(cache_->metrics_.size->value(), size_without_compressed);
+}
+
 // Ensure that the cache always yields at least one message,
 // even if that message is larger than the batch size. This ensures
 // that we don't get "stuck" in the case that a large message enters
@@ -43,6 +43,7 @@
 
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_util.h"
 #include "yb/consensus/consensus_util.h"
 
 #include "yb/gutil/bind.h"
@@ -512,10 +513,15 @@ void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
     return;
   }
 
+  ConsumeMemoryUnlocked(mem_required);
+}
+
+void LogCache::ConsumeMemoryUnlocked(int64_t mem_required) {
+  DCHECK(lock_.is_locked());
   // Try to consume the memory. If it can't be consumed, we may need to evict.
   if (!tracker_->TryConsume(mem_required)) {
-    int spare = tracker_->SpareCapacity();
-    int need_to_free = mem_required - spare;
+    int64_t spare = tracker_->SpareCapacity();
+    int64_t need_to_free = mem_required - spare;
     VLOG_WITH_PREFIX_UNLOCKED(1)
         << "Memory limit would be exceeded trying to append "
         << HumanReadableNumBytes::ToString(mem_required)
@@ -531,6 +537,64 @@ void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
   }
 }
 
+std::shared_ptr<const std::string> LogCache::CompressedOp(
+    const ReplicateMsg& msg, log::CompressionTypePB type) {
+  const auto index = msg.id().index();
+  // Entry could be replaced or evicted while we compress, so it is looked up again after that.
+  auto find_entry = [this, index, &msg]() -> CacheEntry* {
+    auto it = cache_.find(index);
+    return it != cache_.end() && it->second.msg.get() == &msg ? &it->second : nullptr;
+  };
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    auto* entry = find_entry();
+    if (entry && entry->compressed && entry->compression_type == type) {
+      return entry->compressed;
+    }
+  }
+
+  auto compressed = std::make_shared<std::string>();
+  log::CompressEntryBatch(type, msg.SerializeAsString(), compressed.get());
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  auto* entry = find_entry();
+  // Operation that was received by all peers is not kept compressed, since it is not sent anymore.
+  if (entry && !entry->compressed && index > compressed_dropped_through_index_) {
+    const int64_t size = compressed->size();
+    entry->compressed = compressed;
+    entry->compression_type = type;
+    entry->mem_usage += size;
+    metrics_.size->IncrementBy(size);
+    if (entry->tracked) {
+      // Could evict the entry.
+      ConsumeMemoryUnlocked(size);
+    }
+  }
+  return compressed;
+}
+
+void LogCache::DropCompressedOpsThrough(int64_t index) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  if (index <= compressed_dropped_through_index_) {
+    return;
+  }
+  for (auto it = cache_.upper_bound(compressed_dropped_through_index_);
+       it != cache_.end() && static_cast<int64_t>(it->first) <= index; ++it) {
+    auto& entry = it->second;
+    if (!entry.compressed) {
+      continue;
+    }
+    const int64_t size = entry.compressed->size();
+    entry.compressed.reset();
+    entry.mem_usage -= size;
+    metrics_.size->DecrementBy(size);
+    if (entry.tracked) {
+      tracker_->Release(size);
+    }
+  }
+  compressed_dropped_through_index_ = index;
+}
+
 #define INSTANTIATE_METRIC(x, ...) \
   x(BOOST_PP_CAT(METRIC_log_cache_, x).Instantiate(metric_entity, ## __VA_ARGS__))
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
@@ -39,6 +39,7 @@
 
 #include "yb/consensus/consensus_fwd.h"
 #include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/log.pb.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/macros.h"
@@ -170,6 +171,17 @@ class LogCache {
   // Start memory tracking of following operations in case they are still present in cache.
   void TrackOperationsMemory(const OpIds& op_ids);
 
+  // Returns msg serialized and compressed with specified codec, as sent to peers in compressed_ops.
+  // When msg is in the cache, its compressed form is kept with the cache entry, so an operation is
+  // compressed once for all peers and retries.
+  std::shared_ptr<const std::string> CompressedOp(
+      const ReplicateMsg& msg, log::CompressionTypePB type);
+
+  // Drops compressed forms of operations through the specified index, that were received by all
+  // peers. Operations stay in the cache until evicted, e.g. for CDC, so their compressed forms are
+  // released earlier.
+  void DropCompressedOpsThrough(int64_t index);
+
  private:
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
@@ -185,6 +197,11 @@ class LogCache {
 
     // Did we start memory tracking for this entry.
     bool tracked = false;
+
+    // Compressed form of msg, see CompressedOp. Its size is included in mem_usage, until it is
+    // dropped by DropCompressedOpsThrough.
+    std::shared_ptr<const std::string> compressed;
+    log::CompressionTypePB compression_type = log::CompressionTypePB::NO_COMPRESSION;
   };
 
   // Try to evict the oldest operations from the queue, stopping either when
@@ -196,6 +213,10 @@ class LogCache {
   // given message.
   void AccountForMessageRemovalUnlocked(const CacheEntry& entry);
 
+  // Consumes memory of tracked operations, evicting old operations when the memory limit is
+  // exceeded.
+  void ConsumeMemoryUnlocked(int64_t mem_required);
+
   // Return a string with stats
   std::string StatsStringUnlocked() const;
 
@@ -242,6 +263,10 @@ class LogCache {
   // log.  Protected by lock_.
   int64_t min_pinned_op_index_;
 
+  // Compressed forms of operations with index <= this one are not kept, see
+  // DropCompressedOpsThrough. Protected by lock_.
+  int64_t compressed_dropped_through_index_ = 0;
+
   // Pointer to a parent memtracker for all log caches. This exists to compute server-wide cache
   // size and enforce a server-wide memory limit.  When the first instance of a log cache is
   // created, a new entry is added to MemTracker's static map; subsequent entries merely increment
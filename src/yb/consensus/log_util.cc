@@ -43,17 +43,22 @@
 #include "yb/consensus/opid_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/casts.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 
+#include "yb/rocksdb/util/compression.h"
+
 #include "yb/util/coding-inl.h"
 #include "yb/util/coding.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/enums.h"
 #include "yb/util/env_util.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/size_literals.h"
 
@@ -79,6 +84,16 @@ DEFINE_int32(bytes_durable_wal_write_mb, 1,
              "If 0 fsysnc() is not called.");
 TAG_FLAG(bytes_durable_wal_write_mb, stable);
 
+DEFINE_string(log_compression_type, "none",
+              "Codec used to compress entry batches of new WAL segments: none, snappy, zlib, lz4 "
+              "or zstd. Compressed segments cannot be read by versions that do not support WAL "
+              "compression.");
+TAG_FLAG(log_compression_type, advanced);
+
+DEFINE_int32(log_min_batch_size_to_compress, 256,
+             "Entry batches smaller than this number of bytes are written to WAL uncompressed.");
+TAG_FLAG(log_min_batch_size_to_compress, advanced);
+
 DEFINE_bool(log_preallocate_segments, true,
             "Whether the WAL should preallocate the entire segment before writing to it");
 TAG_FLAG(log_preallocate_segments, advanced);
@@ -127,6 +142,132 @@ const int kLogMinorVersion = 0;
 // Maximum log segment header/footer size, in bytes (8 MB).
 const uint32_t kLogSegmentMaxHeaderOrFooterSize = 8 * 1024 * 1024;
 
+namespace {
+
+rocksdb::CompressionType ToRocksDbCompressionType(CompressionTypePB type) {
+  switch (type) {
+    case CompressionTypePB::NO_COMPRESSION: return rocksdb::kNoCompression;
+    case CompressionTypePB::SNAPPY_COMPRESSION: return rocksdb::kSnappyCompression;
+    case CompressionTypePB::ZLIB_COMPRESSION: return rocksdb::kZlibCompression;
+    case CompressionTypePB::LZ4_COMPRESSION: return rocksdb::kLZ4Compression;
+    case CompressionTypePB::ZSTD_COMPRESSION: return rocksdb::kZSTDNotFinalCompression;
+  }
+  FATAL_INVALID_ENUM_VALUE(CompressionTypePB, type);
+}
+
+} // namespace
+
+CompressionTypePB LogCompressionTypeFromString(const std::string& name) {
+  static const std::pair<const char*, CompressionTypePB> kNames[] = {
+    {"none", CompressionTypePB::NO_COMPRESSION},
+    {"snappy", CompressionTypePB::SNAPPY_COMPRESSION},
+    {"zlib", CompressionTypePB::ZLIB_COMPRESSION},
+    {"lz4", CompressionTypePB::LZ4_COMPRESSION},
+    {"zstd", CompressionTypePB::ZSTD_COMPRESSION},
+  };
+  for (const auto& entry : kNames) {
+    if (name == entry.first) {
+      if (!rocksdb::CompressionTypeSupported(ToRocksDbCompressionType(entry.second))) {
+        YB_LOG_FIRST_N(WARNING, 1) << "WAL compression " << name << " is not supported by this "
+                                   << "build, WAL will be written uncompressed";
+        return CompressionTypePB::NO_COMPRESSION;
+      }
+      return entry.second;
+    }
+  }
+  LOG(DFATAL) << "Unknown WAL compression type: " << name;
+  return CompressionTypePB::NO_COMPRESSION;
+}
+
+void CompressEntryBatch(CompressionTypePB type, const Slice& data, std::string* output) {
+  output->clear();
+  if (data.size() >= implicit_cast<size_t>(FLAGS_log_min_batch_size_to_compress)) {
+    const auto input = data.cdata();
+    const auto length = data.size();
+    const rocksdb::CompressionOptions options;
+    // Some of the compressors overwrite their output, so the compression type is prepended after
+    // compression.
+    std::string compressed_data;
+    bool compressed = false;
+    switch (type) {
+      case CompressionTypePB::NO_COMPRESSION:
+        break;
+      case CompressionTypePB::SNAPPY_COMPRESSION:
+        compressed = rocksdb::Snappy_Compress(options, input, length, &compressed_data);
+        break;
+      case CompressionTypePB::ZLIB_COMPRESSION:
+        compressed = rocksdb::Zlib_Compress(options, 2, input, length, &compressed_data);
+        break;
+      case CompressionTypePB::LZ4_COMPRESSION:
+        compressed = rocksdb::LZ4_Compress(options, 2, input, length, &compressed_data);
+        break;
+      case CompressionTypePB::ZSTD_COMPRESSION:
+        compressed = rocksdb::ZSTD_Compress(options, input, length, &compressed_data);
+        break;
+    }
+    // Keep the batch compressed only if it saves at least 1/8 of its size.
+    if (compressed && compressed_data.size() + 1 < length - length / 8) {
+      output->reserve(compressed_data.size() + 1);
+      output->push_back(static_cast<char>(type));
+      output->append(compressed_data);
+      return;
+    }
+  }
+  output->reserve(data.size() + 1);
+  output->push_back(static_cast<char>(CompressionTypePB::NO_COMPRESSION));
+  output->append(data.cdata(), data.size());
+}
+
+Status UncompressEntryBatch(Slice* data, faststring* buffer) {
+  if (data->empty()) {
+    return STATUS(Corruption, "Missing compression type of log entry batch");
+  }
+  const auto type = static_cast<CompressionTypePB>(data->consume_byte());
+  if (type == CompressionTypePB::NO_COMPRESSION) {
+    return Status::OK();
+  }
+
+  const auto input = data->cdata();
+  const auto length = data->size();
+  std::unique_ptr<char[]> uncompressed;
+  int uncompressed_size = 0;
+  switch (type) {
+    case CompressionTypePB::NO_COMPRESSION:
+      break;
+    case CompressionTypePB::SNAPPY_COMPRESSION: {
+      size_t size = 0;
+      if (!rocksdb::Snappy_GetUncompressedLength(input, length, &size)) {
+        return STATUS(Corruption, "Bad snappy compressed log entry batch");
+      }
+      buffer->resize(size);
+      if (!rocksdb::Snappy_Uncompress(input, length, pointer_cast<char*>(buffer->data()))) {
+        return STATUS(Corruption, "Bad snappy compressed log entry batch");
+      }
+      *data = Slice(buffer->data(), size);
+      return Status::OK();
+    }
+    case CompressionTypePB::ZLIB_COMPRESSION:
+      uncompressed.reset(rocksdb::Zlib_Uncompress(input, length, &uncompressed_size, 2));
+      break;
+    case CompressionTypePB::LZ4_COMPRESSION:
+      uncompressed.reset(rocksdb::LZ4_Uncompress(input, length, &uncompressed_size, 2));
+      break;
+    case CompressionTypePB::ZSTD_COMPRESSION:
+      uncompressed.reset(rocksdb::ZSTD_Uncompress(input, length, &uncompressed_size));
+      break;
+    default:
+      return STATUS_FORMAT(Corruption, "Unknown compression type of log entry batch: $0",
+                           static_cast<int>(type));
+  }
+  if (!uncompressed) {
+    return STATUS_FORMAT(Corruption, "Failed to uncompress log entry batch of type $0",
+                         CompressionTypePB_Name(type));
+  }
+  buffer->assign_copy(pointer_cast<uint8_t*>(uncompressed.get()), uncompressed_size);
+  *data = Slice(buffer->data(), buffer->size());
+  return Status::OK();
+}
+
 LogOptions::LogOptions()
     : segment_size_bytes(FLAGS_log_segment_size_bytes == 0 ? FLAGS_log_segment_size_mb * 1_MB
                                                            : FLAGS_log_segment_size_bytes),
@@ -135,6 +276,7 @@ LogOptions::LogOptions()
                                      MonoDelta::FromMilliseconds(
                                          FLAGS_interval_durable_wal_write_ms) : MonoDelta()),
       bytes_durable_wal_write_mb(FLAGS_bytes_durable_wal_write_mb),
+      compression_type(LogCompressionTypeFromString(FLAGS_log_compression_type)),
       preallocate_segments(FLAGS_log_preallocate_segments),
       async_preallocate_segments(FLAGS_log_async_preallocate_segments),
       env(Env::Default()) {
@@ -821,16 +963,25 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
                                          header.msg_crc, read_crc));
   }
 
+  const auto entry_batch_size = entry_batch_slice.size();
+  faststring uncompressed_buffer;
+  if (header_.compression_type() != CompressionTypePB::NO_COMPRESSION) {
+    RETURN_NOT_OK_PREPEND(UncompressEntryBatch(&entry_batch_slice, &uncompressed_buffer),
+                          Substitute("Could not read entry at offset $0 in $1", *offset, path_));
+  }
+  RETURN_NOT_OK(ParseEntryBatch(entry_batch_slice, entry_batch));
 
+  *offset += entry_batch_size;
+  return Status::OK();
+}
+
+Status ReadableLogSegment::ParseEntryBatch(const Slice& data, LogEntryBatchPB* entry_batch) {
   LogEntryBatchPB read_entry_batch;
-  s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+  Status s = pb_util::ParseFromArray(&read_entry_batch, data.data(), data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
 
-  *offset += entry_batch_slice.size();
   entry_batch->Swap(&read_entry_batch);
   return Status::OK();
 }
@@ -896,9 +1047,14 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
+  Slice data = entry_batch_data;
+  if (header_.compression_type() != CompressionTypePB::NO_COMPRESSION) {
+    CompressEntryBatch(header_.compression_type(), entry_batch_data, &compression_buffer_);
+    data = compression_buffer_;
+  }
   uint8_t header_buf[kEntryHeaderSize];
 
   // First encode the length of the message.
@@ -95,6 +95,9 @@ struct LogOptions {
   // If non-zero, call fsync on a call to Append() if more than given amount of data to sync.
   int32_t bytes_durable_wal_write_mb;
 
+  // Codec used to compress entry batches of new segments.
+  CompressionTypePB compression_type;
+
   // Whether to fallocate segments before writing to them.
   bool preallocate_segments;
 
@@ -334,6 +337,9 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
                                 faststring* tmp_buf,
                                 LogEntryBatchPB* entry_batch);
 
+  // Parses an uncompressed log entry batch into 'entry_batch'.
+  CHECKED_STATUS ParseEntryBatch(const Slice& data, LogEntryBatchPB* entry_batch);
+
   void UpdateReadableToOffset(int64_t readable_to_offset);
 
   const std::string path_;
@@ -394,7 +400,7 @@ class WritableLogSegment {
   }
 
   // Appends the provided batch of data, including a header
-  // and checksum.
+  // and checksum. The data is compressed if the segment header specifies a compression type.
   // Makes sure that the log segment has not been closed.
   CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data);
 
@@ -461,6 +467,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Buffer reused for compressed entry batches.
+  std::string compression_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
@@ -481,6 +490,18 @@ CHECKED_STATUS CheckRelevantPathsAreODirectWritable();
 // Modify durable wal write flag depending on the value of FLAGS_require_durable_wal_write.
 CHECKED_STATUS ModifyDurableWriteFlagIfNotODirect();
 
+// Returns the codec with the specified name: none, snappy, zlib, lz4 or zstd. Codecs that are not
+// supported by this build are replaced with NO_COMPRESSION.
+CompressionTypePB LogCompressionTypeFromString(const std::string& name);
+
+// Compresses the entry batch 'data' to 'output', prefixed with the codec byte.
+// Falls back to storing the batch uncompressed when it is small or does not compress well.
+void CompressEntryBatch(CompressionTypePB type, const Slice& data, std::string* output);
+
+// Strips the codec byte from 'data' and uncompresses the rest, using 'buffer' for uncompressed
+// data when necessary.
+CHECKED_STATUS UncompressEntryBatch(Slice* data, faststring* buffer);
+
 }  // namespace log
 }  // namespace yb
 
@@ -0,0 +1,158 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_metrics.h"
+
+#include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_uint64(multi_raft_heartbeat_window_ms, 5,
+              "Maximum amount of time a heartbeat waits for other heartbeats addressed to the same "
+              "server before the batch containing it is sent.");
+TAG_FLAG(multi_raft_heartbeat_window_ms, advanced);
+
+DEFINE_uint64(multi_raft_batch_size, 0,
+              "Maximum number of heartbeats sent in a single MultiRaftUpdateConsensus RPC. "
+              "0 means the batch is only limited by multi_raft_heartbeat_window_ms.");
+TAG_FLAG(multi_raft_batch_size, advanced);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    const HostPort& hostport, rpc::ProxyCache* proxy_cache, rpc::Messenger* messenger)
+    : messenger_(messenger),
+      consensus_proxy_(std::make_unique<ConsensusServiceProxy>(proxy_cache, hostport)) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() = default;
+
+void MultiRaftHeartbeatBatcher::AddRequestToBatch(
+    const ConsensusRequestPB& request, ConsensusResponsePB* response,
+    StdStatusCallback callback) {
+  MultiRaftConsensusDataPtr data_to_send;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_batch_) {
+      current_batch_ = std::make_shared<MultiRaftConsensusData>();
+      schedule_flush = true;
+    }
+    current_batch_->batch_req.add_consensus_request()->CopyFrom(request);
+    current_batch_->response_callback_data.push_back({response, std::move(callback)});
+    auto batch_size = FLAGS_multi_raft_batch_size;
+    if (batch_size > 0 && current_batch_->response_callback_data.size() >= batch_size) {
+      data_to_send = std::move(current_batch_);
+      current_batch_ = nullptr;
+      schedule_flush = false;
+    } else if (schedule_flush) {
+      data_to_send = current_batch_;
+    }
+  }
+
+  if (!schedule_flush) {
+    if (data_to_send) {
+      SendBatchRequest(data_to_send);
+    }
+    return;
+  }
+
+  std::weak_ptr<MultiRaftHeartbeatBatcher> weak_self = shared_from_this();
+  auto task_id = messenger_->ScheduleOnReactor(
+      [weak_self, data_to_send](const Status& status) {
+        auto self = weak_self.lock();
+        if (self) {
+          self->FlushBatch(data_to_send);
+        }
+      },
+      MonoDelta::FromMilliseconds(FLAGS_multi_raft_heartbeat_window_ms), SOURCE_LOCATION(),
+      nullptr /* messenger */);
+  if (task_id == rpc::kInvalidTaskId) {
+    // The messenger is shutting down, send what we have right away so callers are not left
+    // waiting for a flush that will never happen.
+    FlushBatch(data_to_send);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::FlushBatch(const MultiRaftConsensusDataPtr& data) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_batch_ != data) {
+      return;
+    }
+    current_batch_ = nullptr;
+  }
+  SendBatchRequest(data);
+}
+
+void MultiRaftHeartbeatBatcher::SendBatchRequest(const MultiRaftConsensusDataPtr& data) {
+  const auto& counter = messenger_->rpc_metrics().consensus_updates_sent_batched;
+  if (counter) {
+    counter->IncrementBy(data->response_callback_data.size());
+  }
+  data->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  consensus_proxy_->MultiRaftUpdateConsensusAsync(
+      data->batch_req, &data->batch_resp, &data->controller,
+      std::bind(&MultiRaftHeartbeatBatcher::MultiRaftUpdateHeartbeatResponseCallback,
+                shared_from_this(), data));
+}
+
+void MultiRaftHeartbeatBatcher::MultiRaftUpdateHeartbeatResponseCallback(
+    const MultiRaftConsensusDataPtr& data) {
+  auto status = data->controller.status();
+  auto& responses = *data->batch_resp.mutable_consensus_response();
+  if (status.ok() && responses.size() != data->response_callback_data.size()) {
+    status = STATUS_FORMAT(
+        Corruption, "Got $0 responses to a batch of $1 heartbeats",
+        responses.size(), data->response_callback_data.size());
+    LOG(DFATAL) << status;
+  }
+
+  for (size_t i = 0; i != data->response_callback_data.size(); ++i) {
+    auto& callback_data = data->response_callback_data[i];
+    if (status.ok()) {
+      callback_data.response->Swap(responses.Mutable(i));
+    }
+    callback_data.callback(status);
+  }
+}
+
+MultiRaftManager::MultiRaftManager(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache)
+    : messenger_(messenger), proxy_cache_(proxy_cache) {
+}
+
+MultiRaftManager::~MultiRaftManager() = default;
+
+MultiRaftHeartbeatBatcherPtr MultiRaftManager::AddOrGetBatcher(const HostPort& hostport) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& weak_batcher = batchers_[hostport];
+  auto batcher = weak_batcher.lock();
+  if (!batcher) {
+    batcher = std::make_shared<MultiRaftHeartbeatBatcher>(hostport, proxy_cache_, messenger_);
+    weak_batcher = batcher;
+  }
+  return batcher;
+}
+
+} // namespace consensus
+} // namespace yb
@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/consensus/consensus_fwd.h"
+#include "yb/consensus/consensus.pb.h"
+
+#include "yb/rpc/rpc_controller.h"
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/net/net_util.h"
+#include "yb/util/status_callback.h"
+
+namespace yb {
+namespace consensus {
+
+// Coalesces status-only UpdateConsensus requests (heartbeats) sent by Raft leaders on this server
+// to followers on a single remote server into MultiRaftUpdateConsensus RPCs.
+//
+// A batch is sent when it reaches FLAGS_multi_raft_batch_size requests, or once
+// FLAGS_multi_raft_heartbeat_window_ms elapse after the first request was added, whichever comes
+// first. Each caller gets its own response and is notified through its own callback, so the
+// per-tablet heartbeat semantics (leader lease, failure detection) are unchanged.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  MultiRaftHeartbeatBatcher(
+      const HostPort& hostport, rpc::ProxyCache* proxy_cache, rpc::Messenger* messenger);
+
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds a copy of 'request' to the current batch. 'response' must stay valid until 'callback' is
+  // invoked with the status of the batch RPC.
+  void AddRequestToBatch(
+      const ConsensusRequestPB& request, ConsensusResponsePB* response,
+      StdStatusCallback callback);
+
+ private:
+  struct ResponseCallbackData {
+    ConsensusResponsePB* response;
+    StdStatusCallback callback;
+  };
+
+  struct MultiRaftConsensusData {
+    MultiRaftConsensusRequestPB batch_req;
+    MultiRaftConsensusResponsePB batch_resp;
+    rpc::RpcController controller;
+    std::vector<ResponseCallbackData> response_callback_data;
+  };
+
+  typedef std::shared_ptr<MultiRaftConsensusData> MultiRaftConsensusDataPtr;
+
+  // Sends 'data' if it is still the current batch, i.e. it was not already flushed because of its
+  // size.
+  void FlushBatch(const MultiRaftConsensusDataPtr& data);
+
+  void SendBatchRequest(const MultiRaftConsensusDataPtr& data);
+
+  void MultiRaftUpdateHeartbeatResponseCallback(const MultiRaftConsensusDataPtr& data);
+
+  rpc::Messenger* const messenger_;
+  ConsensusServiceProxyPtr consensus_proxy_;
+
+  std::mutex mutex_;
+  MultiRaftConsensusDataPtr current_batch_;
+};
+
+// Node level owner of MultiRaftHeartbeatBatcher instances, one per remote server. Batchers are
+// shared by the peer proxies of all Raft groups whose followers live on that server.
+class MultiRaftManager {
+ public:
+  MultiRaftManager(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache);
+
+  ~MultiRaftManager();
+
+  MultiRaftHeartbeatBatcherPtr AddOrGetBatcher(const HostPort& hostport);
+
+ private:
+  rpc::Messenger* const messenger_;
+  rpc::ProxyCache* const proxy_cache_;
+
+  std::mutex mutex_;
+  // Batchers are owned by the peer proxies that use them, so entries for servers that no longer
+  // host any followers of our leaders expire on their own.
+  std::unordered_map<HostPort, std::weak_ptr<MultiRaftHeartbeatBatcher>, HostPortHash> batchers_;
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
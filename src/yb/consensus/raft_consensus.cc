@@ -46,6 +46,7 @@
 #include "yb/consensus/consensus_peers.h"
 #include "yb/consensus/leader_election.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/log_util.h"
 #include "yb/consensus/peer_manager.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/consensus/replica_state.h"
@@ -66,6 +67,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/dns_resolver.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/random.h"
 #include "yb/util/random_util.h"
 #include "yb/util/threadpool.h"
@@ -210,6 +212,26 @@ using std::weak_ptr;
 using strings::Substitute;
 using tserver::TabletServerErrorPB;
 
+namespace {
+
+// Replaces compressed_ops of the request with uncompressed ops.
+Status UncompressOps(ConsensusRequestPB* request) {
+  if (!request->ops().empty()) {
+    return STATUS(InvalidArgument, "Request has both ops and compressed ops");
+  }
+  faststring buffer;
+  request->mutable_ops()->Reserve(request->compressed_ops_size());
+  for (const auto& compressed_op : request->compressed_ops()) {
+    Slice data(compressed_op);
+    RETURN_NOT_OK_PREPEND(log::UncompressEntryBatch(&data, &buffer), "Bad compressed op");
+    RETURN_NOT_OK(pb_util::ParseFromArray(request->add_ops(), data.data(), data.size()));
+  }
+  request->clear_compressed_ops();
+  return Status::OK();
+}
+
+} // namespace
+
 shared_ptr<RaftConsensus> RaftConsensus::Create(
     const ConsensusOptions& options,
     std::unique_ptr<ConsensusMetadata> cmeta,
@@ -226,9 +248,10 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
     TableType table_type,
     ThreadPool* raft_pool,
     RetryableRequests* retryable_requests,
+    MultiRaftManager* multi_raft_manager,
     const yb::OpId& split_op_id) {
   auto rpc_factory = std::make_unique<RpcPeerProxyFactory>(
-      messenger, proxy_cache, local_peer_pb.cloud_info());
+      messenger, proxy_cache, local_peer_pb.cloud_info(), multi_raft_manager);
 
   // The message queue that keeps track of which operations need to be replicated
   // where.
@@ -1171,6 +1194,11 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
                                 "is set to true.");
   }
 
+  response->set_supports_compressed_ops(true);
+  if (request->compressed_ops_size() > 0) {
+    RETURN_NOT_OK(UncompressOps(request));
+  }
+
   auto reject_mode = reject_mode_.load(std::memory_order_acquire);
   if (reject_mode != RejectMode::kNone) {
     if (reject_mode == RejectMode::kAll ||
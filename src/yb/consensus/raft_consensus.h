@@ -112,6 +112,7 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     TableType table_type,
     ThreadPool* raft_pool,
     RetryableRequests* retryable_requests,
+    MultiRaftManager* multi_raft_manager,
     const yb::OpId& split_op_id);
 
   // Creates RaftConsensus.
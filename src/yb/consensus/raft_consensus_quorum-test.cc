@@ -62,6 +62,8 @@
 
 DECLARE_int32(raft_heartbeat_interval_ms);
 DECLARE_bool(enable_leader_failure_detection);
+DECLARE_string(consensus_ops_compression_type);
+DECLARE_int32(log_min_batch_size_to_compress);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -607,6 +609,26 @@ TEST_F(RaftConsensusQuorumTest, TestConsensusContinuesIfAMinorityFallsBehind) {
   VerifyLogs(2, 0, 1);
 }
 
+// Tests that operations sent to followers in compressed form are replicated and committed.
+TEST_F(RaftConsensusQuorumTest, TestCompressedOps) {
+  google::FlagSaver flag_saver;
+  FLAGS_consensus_ops_compression_type = "snappy";
+  FLAGS_log_min_batch_size_to_compress = 0;
+
+  const int kLeaderIdx = 2;
+  ASSERT_OK(BuildAndStartConfig(3));
+
+  OpId last_replicate;
+  vector<scoped_refptr<ConsensusRound> > rounds;
+  REPLICATE_SEQUENCE_OF_MESSAGES(
+      10, kLeaderIdx, WAIT_FOR_ALL_REPLICAS, COMMIT_ONE_BY_ONE, &last_replicate, &rounds);
+
+  for (int i = 0; i != kLeaderIdx; ++i) {
+    WaitForCommitIfNotAlreadyPresent(last_replicate, i, kLeaderIdx);
+  }
+  VerifyLogs(2, 0, 1);
+}
+
 TEST_F(RaftConsensusQuorumTest, TestConsensusStopsIfAMajorityFallsBehind) {
   // Constants with the indexes of peers with certain roles,
   // since peers don't change roles in this test.
@@ -30,6 +30,7 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/metrics.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/wait_state.h"
 #include "yb/util/yb_pg_errcodes.h"
 
 using namespace std::literals;
@@ -102,9 +103,11 @@ class ConflictResolver {
   ConflictResolver(const DocDB& doc_db,
                    TransactionStatusManager* status_manager,
                    PartialRangeKeyIntents partial_range_key_intents,
-                   ConflictResolverContext* context)
+                   ConflictResolverContext* context,
+                   WaitQueue* wait_queue = nullptr)
       : doc_db_(doc_db), status_manager_(*status_manager), request_scope_(status_manager),
-        partial_range_key_intents_(partial_range_key_intents), context_(*context) {}
+        partial_range_key_intents_(partial_range_key_intents), context_(*context),
+        wait_queue_(wait_queue) {}
 
   PartialRangeKeyIntents partial_range_key_intents() {
     return partial_range_key_intents_;
@@ -127,9 +130,29 @@ class ConflictResolver {
     return status_manager_.FillPriorities(inout);
   }
 
-  CHECKED_STATUS Resolve() {
+  CHECKED_STATUS Resolve(WaitQueue::WaiterPtr* waiter = nullptr) {
+    ScopedWaitState wait_state(WaitStateCode::kConflictResolution);
     RETURN_NOT_OK(context_.ReadConflicts(this));
-    return ResolveConflicts();
+    auto status = ResolveConflicts();
+    if (waiter_) {
+      if (status.ok() && !blockers_.empty()) {
+        *waiter = std::move(waiter_);
+        return Status::OK();
+      }
+      wait_queue_->Unregister(waiter_);
+    }
+    return status;
+  }
+
+  // Whether conflict with transaction of higher priority could be resolved by waiting for it.
+  bool CanWait() const {
+    return wait_queue_ != nullptr;
+  }
+
+  // Sets transactions of higher priority, that transaction waiter_id should wait for.
+  void SetBlockers(const TransactionId& waiter_id, std::vector<TransactionId> blockers) {
+    waiter_id_ = waiter_id;
+    blockers_ = std::move(blockers);
   }
 
   // Reads conflicts for specified intent from DB.
@@ -238,6 +261,21 @@ class ConflictResolver {
 
       RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
 
+      if (!blockers_.empty()) {
+        if (waiter_) {
+          // Blockers are still running after we were registered, so should wait for them.
+          // Blockers that finished before registration will never be signaled, so waiter should
+          // not count them.
+          wait_queue_->RetainBlockers(waiter_, blockers_);
+          return Status::OK();
+        }
+        // Register before checking status of blockers once again, so we don't miss blocker that
+        // finishes concurrently.
+        waiter_ = wait_queue_->Register(waiter_id_, blockers_);
+        blockers_.clear();
+        continue;
+      }
+
       RETURN_NOT_OK(AbortTransactions());
 
       RETURN_NOT_OK(Cleanup());
@@ -370,6 +408,10 @@ class ConflictResolver {
   ConflictResolverContext& context_;
   TransactionIdSet conflicts_;
   std::vector<TransactionData> transactions_;
+  WaitQueue* wait_queue_;
+  TransactionId waiter_id_ = TransactionId::Nil();
+  std::vector<TransactionId> blockers_;
+  WaitQueue::WaiterPtr waiter_;
 };
 
 Result<boost::optional<DocKeyHash>> FetchDocKeyHash(const Slice& encoded_key) {
@@ -438,10 +480,13 @@ class StrongConflictChecker {
   CHECKED_STATUS Check(const Slice& intent_key) {
     const auto hash = VERIFY_RESULT(FetchDocKeyHash(intent_key));
     if (PREDICT_FALSE(!value_iter_.Initialized() || hash != value_iter_hash_)) {
+      // The iterator is reused for all intents with the same hash, so bloom filters could be used
+      // only for keys with hashed components. Bloom filters of range partitioned tables are built
+      // on range components, that differ between such intents.
       value_iter_ = CreateRocksDBIterator(
           resolver_.doc_db().regular,
           resolver_.doc_db().key_bounds,
-          BloomFilterMode::USE_BLOOM_FILTER,
+          hash ? BloomFilterMode::USE_BLOOM_FILTER : BloomFilterMode::DONT_USE_BLOOM_FILTER,
           intent_key,
           rocksdb::kDefaultQueryId);
       value_iter_hash_ = hash;
@@ -592,14 +637,19 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
         (*transactions)[i].priority = ids_and_priorities[i].second;
       }
     }
+    std::vector<TransactionId> blockers;
     for (auto& transaction : *transactions) {
       auto their_priority = transaction.priority;
       if (our_priority < their_priority) {
-        return MakeConflictStatus(
-            metadata_.transaction_id, transaction.id, "higher priority", conflicts_metric_);
+        if (!resolver->CanWait()) {
+          return MakeConflictStatus(
+              metadata_.transaction_id, transaction.id, "higher priority", conflicts_metric_);
+        }
+        blockers.push_back(transaction.id);
       }
     }
     fetched_metadata_for_transactions_ = true;
+    resolver->SetBlockers(metadata_.transaction_id, std::move(blockers));
 
     return Status::OK();
   }
@@ -742,12 +792,16 @@ Status ResolveTransactionConflicts(const DocOperations& doc_ops,
                                    const DocDB& doc_db,
                                    PartialRangeKeyIntents partial_range_key_intents,
                                    TransactionStatusManager* status_manager,
-                                   Counter* conflicts_metric) {
+                                   Counter* conflicts_metric,
+                                   WaitQueue* wait_queue,
+                                   WaitQueue::WaiterPtr* waiter) {
   DCHECK(hybrid_time.is_valid());
+  DCHECK_EQ(wait_queue == nullptr, waiter == nullptr);
   TransactionConflictResolverContext context(
       doc_ops, write_batch, hybrid_time, read_time, conflicts_metric);
-  ConflictResolver resolver(doc_db, status_manager, partial_range_key_intents, &context);
-  return resolver.Resolve();
+  ConflictResolver resolver(
+      doc_db, status_manager, partial_range_key_intents, &context, wait_queue);
+  return resolver.Resolve(waiter);
 }
 
 Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
@@ -17,6 +17,7 @@
 #include "yb/docdb/docdb_fwd.h"
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/value_type.h"
+#include "yb/docdb/wait_queue.h"
 
 #include "yb/util/result.h"
 
@@ -46,6 +47,11 @@ namespace docdb {
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
 // conflicts_metric - transaction_conflicts metric to update.
+// wait_queue - when specified, conflict with transactions of higher priority does not fail.
+//              Instead the transaction is registered in wait_queue, *waiter is set and OK is
+//              returned. The caller should release its locks, and retry after *waiter is
+//              resumed, see WaitQueue::WaitAsync.
+// waiter - receives waiter registered in wait_queue, should be specified with wait_queue.
 CHECKED_STATUS ResolveTransactionConflicts(const DocOperations& doc_ops,
                                            const KeyValueWriteBatchPB& write_batch,
                                            HybridTime resolution_ht,
@@ -53,7 +59,9 @@ CHECKED_STATUS ResolveTransactionConflicts(const DocOperations& doc_ops,
                                            const DocDB& doc_db,
                                            PartialRangeKeyIntents partial_range_key_intents,
                                            TransactionStatusManager* status_manager,
-                                           Counter* conflicts_metric);
+                                           Counter* conflicts_metric,
+                                           WaitQueue* wait_queue = nullptr,
+                                           WaitQueue::WaiterPtr* waiter = nullptr);
 
 // Resolves conflicts for doc operations.
 // Read all intents that could conflict with provided doc_ops.
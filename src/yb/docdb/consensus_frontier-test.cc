@@ -44,7 +44,7 @@ TEST_F(ConsensusFrontierTest, TestUpdates) {
     EXPECT_TRUE(frontier.Equals(frontier));
     EXPECT_EQ(
         "{ op_id: 0.0 hybrid_time: <invalid> history_cutoff: <invalid> "
-            "hybrid_time_filter: <invalid> }",
+            "hybrid_time_filter: <invalid> max_value_level_ttl_expiration_time: <invalid> }",
         frontier.ToString());
     EXPECT_TRUE(frontier.IsUpdateValid(frontier, UpdateUserValueType::kLargest));
     EXPECT_TRUE(frontier.IsUpdateValid(frontier, UpdateUserValueType::kSmallest));
@@ -57,7 +57,7 @@ TEST_F(ConsensusFrontierTest, TestUpdates) {
     ConsensusFrontier frontier{{1, 1}, 1000_usec_ht, 500_usec_ht};
     EXPECT_EQ(
         "{ op_id: 1.1 hybrid_time: { physical: 1000 } history_cutoff: { physical: 500 } "
-             "hybrid_time_filter: <invalid> }",
+             "hybrid_time_filter: <invalid> max_value_level_ttl_expiration_time: <invalid> }",
         frontier.ToString());
     ConsensusFrontier higher_idx{{1, 2}, 1000_usec_ht, 500_usec_ht};
     ConsensusFrontier higher_ht{{1, 1}, 1001_usec_ht, 500_usec_ht};
@@ -114,26 +114,61 @@ TEST_F(ConsensusFrontierTest, TestUpdates) {
   pb.mutable_op_id()->set_index(0);
   EXPECT_EQ(
       PbToString(pb),
-      "{ op_id: 0.0 hybrid_time: <min> history_cutoff: <invalid> hybrid_time_filter: <invalid> }");
+      "{ op_id: 0.0 hybrid_time: <min> history_cutoff: <invalid> hybrid_time_filter: <invalid> "
+          "max_value_level_ttl_expiration_time: <max> }");
 
   pb.mutable_op_id()->set_term(2);
   pb.mutable_op_id()->set_index(3);
   EXPECT_EQ(
       PbToString(pb),
-      "{ op_id: 2.3 hybrid_time: <min> history_cutoff: <invalid> hybrid_time_filter: <invalid> }");
+      "{ op_id: 2.3 hybrid_time: <min> history_cutoff: <invalid> hybrid_time_filter: <invalid> "
+          "max_value_level_ttl_expiration_time: <max> }");
 
   pb.set_hybrid_time(100000);
   EXPECT_EQ(
       PbToString(pb),
       "{ op_id: 2.3 hybrid_time: { physical: 24 logical: 1696 } history_cutoff: <invalid> "
-          "hybrid_time_filter: <invalid> }");
+          "hybrid_time_filter: <invalid> max_value_level_ttl_expiration_time: <max> }");
 
   pb.set_history_cutoff(200000);
   EXPECT_EQ(
         PbToString(pb),
         "{ op_id: 2.3 hybrid_time: { physical: 24 logical: 1696 } "
             "history_cutoff: { physical: 48 logical: 3392 } "
-            "hybrid_time_filter: <invalid> }");
+            "hybrid_time_filter: <invalid> max_value_level_ttl_expiration_time: <max> }");
+
+  // Files without value level TTL records are stored with kMin, that is restored as invalid.
+  pb.set_max_value_level_ttl_expiration_time(HybridTime::kMin.ToUint64());
+  EXPECT_EQ(
+        PbToString(pb),
+        "{ op_id: 2.3 hybrid_time: { physical: 24 logical: 1696 } "
+            "history_cutoff: { physical: 48 logical: 3392 } "
+            "hybrid_time_filter: <invalid> max_value_level_ttl_expiration_time: <invalid> }");
+}
+
+TEST_F(ConsensusFrontierTest, ValueLevelTtlExpirationTime) {
+  ConsensusFrontier frontier{{1, 1}, 1000_usec_ht, 500_usec_ht};
+  ConsensusFrontier with_ttl{{1, 2}, 1001_usec_ht, 500_usec_ht};
+  with_ttl.set_max_value_level_ttl_expiration_time(2000_usec_ht);
+
+  frontier.Update(with_ttl, UpdateUserValueType::kLargest);
+  EXPECT_EQ(2000_usec_ht, frontier.max_value_level_ttl_expiration_time());
+
+  // Invalid value means that there are no value level TTL records, so it does not change anything.
+  frontier.Update(ConsensusFrontier{{1, 3}, 1002_usec_ht, 500_usec_ht},
+                  UpdateUserValueType::kLargest);
+  EXPECT_EQ(2000_usec_ht, frontier.max_value_level_ttl_expiration_time());
+
+  google::protobuf::Any any;
+  frontier.ToPB(&any);
+  ConsensusFrontier restored;
+  restored.FromPB(any);
+  EXPECT_TRUE(restored.Equals(frontier));
+
+  ConsensusFrontier without_ttl{{1, 1}, 1000_usec_ht, 500_usec_ht};
+  without_ttl.ToPB(&any);
+  restored.FromPB(any);
+  EXPECT_TRUE(restored.Equals(without_ttl));
 }
 
 }  // namespace docdb
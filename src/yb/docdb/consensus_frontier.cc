@@ -24,7 +24,8 @@ ConsensusFrontier::~ConsensusFrontier() {
 bool ConsensusFrontier::Equals(const UserFrontier& pre_rhs) const {
   const ConsensusFrontier& rhs = down_cast<const ConsensusFrontier&>(pre_rhs);
   return op_id_ == rhs.op_id_ && ht_ == rhs.ht_ && history_cutoff_ == rhs.history_cutoff_ &&
-         hybrid_time_filter_ == rhs.hybrid_time_filter_;
+         hybrid_time_filter_ == rhs.hybrid_time_filter_ &&
+         max_value_level_ttl_expiration_time_ == rhs.max_value_level_ttl_expiration_time_;
 }
 
 void ConsensusFrontier::ToPB(google::protobuf::Any* any) const {
@@ -35,6 +36,11 @@ void ConsensusFrontier::ToPB(google::protobuf::Any* any) const {
   if (hybrid_time_filter_.is_valid()) {
     pb.set_hybrid_time_filter(hybrid_time_filter_.ToUint64());
   }
+  // Absence of the field means that the expiration time is unknown, so files without value level
+  // TTL records are stored with kMin.
+  pb.set_max_value_level_ttl_expiration_time(
+      max_value_level_ttl_expiration_time_.is_valid()
+          ? max_value_level_ttl_expiration_time_.ToUint64() : HybridTime::kMin.ToUint64());
   any->PackFrom(pb);
 }
 
@@ -49,6 +55,14 @@ void ConsensusFrontier::FromPB(const google::protobuf::Any& any) {
   } else {
     hybrid_time_filter_ = HybridTime();
   }
+  if (pb.has_max_value_level_ttl_expiration_time()) {
+    max_value_level_ttl_expiration_time_ = HybridTime(pb.max_value_level_ttl_expiration_time());
+    if (max_value_level_ttl_expiration_time_ == HybridTime::kMin) {
+      max_value_level_ttl_expiration_time_ = HybridTime();
+    }
+  } else {
+    max_value_level_ttl_expiration_time_ = HybridTime::kMax;
+  }
 }
 
 void ConsensusFrontier::FromOpIdPBDeprecated(const OpIdPB& pb) {
@@ -57,8 +71,9 @@ void ConsensusFrontier::FromOpIdPBDeprecated(const OpIdPB& pb) {
 
 std::string ConsensusFrontier::ToString() const {
   return yb::Format(
-      "{ op_id: $0 hybrid_time: $1 history_cutoff: $2 hybrid_time_filter: $3 }",
-      op_id_, ht_, history_cutoff_, hybrid_time_filter_);
+      "{ op_id: $0 hybrid_time: $1 history_cutoff: $2 hybrid_time_filter: $3 "
+          "max_value_level_ttl_expiration_time: $4 }",
+      op_id_, ht_, history_cutoff_, hybrid_time_filter_, max_value_level_ttl_expiration_time_);
 }
 
 namespace {
@@ -104,6 +119,9 @@ void ConsensusFrontier::Update(
   UpdateField(&op_id_, rhs.op_id_, update_type);
   UpdateField(&ht_, rhs.ht_, update_type);
   UpdateField(&history_cutoff_, rhs.history_cutoff_, update_type);
+  UpdateField(
+      &max_value_level_ttl_expiration_time_, rhs.max_value_level_ttl_expiration_time_,
+      update_type);
   // Reset filter after compaction.
   hybrid_time_filter_ = HybridTime();
 }
@@ -74,6 +74,13 @@ class ConsensusFrontier : public rocksdb::UserFrontier {
     hybrid_time_filter_ = value;
   }
 
+  HybridTime max_value_level_ttl_expiration_time() const {
+    return max_value_level_ttl_expiration_time_;
+  }
+  void set_max_value_level_ttl_expiration_time(HybridTime value) {
+    max_value_level_ttl_expiration_time_ = value;
+  }
+
  private:
   OpId op_id_;
   HybridTime ht_;
@@ -84,6 +91,12 @@ class ConsensusFrontier : public rocksdb::UserFrontier {
   HybridTime history_cutoff_;
 
   HybridTime hybrid_time_filter_;
+
+  // Maximal expiration time of records with an explicit value level TTL. Invalid means that there
+  // are no such records, kMax means that some record never expires or that it is unknown (e.g.
+  // for files written before this field was introduced). Only the largest frontier of this
+  // parameter is being used.
+  HybridTime max_value_level_ttl_expiration_time_;
 };
 
 typedef rocksdb::UserFrontiersBase<ConsensusFrontier> ConsensusFrontiers;
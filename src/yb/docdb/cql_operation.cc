@@ -24,6 +24,7 @@
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_util.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/primitive_value_util.h"
 
 #include "yb/util/bfpg/tserver_opcodes.h"
@@ -42,6 +43,12 @@ DEFINE_bool(ycql_consistent_transactional_paging, false,
             "be stale. The latter is preferable for long scans. The data returned for the first "
             "page of results is never stale regardless of this flag.");
 
+DEFINE_bool(ycql_enable_packed_row, false,
+            "Whether YCQL inserts that set all regular columns of a row should store them in a "
+            "single packed value instead of a key/value pair per column.");
+TAG_FLAG(ycql_enable_packed_row, runtime);
+TAG_FLAG(ycql_enable_packed_row, advanced);
+
 DECLARE_bool(trace_docdb_calls);
 
 namespace yb {
@@ -764,6 +771,59 @@ Status QLWriteOperation::ApplyForRegularColumns(const QLColumnValuePB& column_va
   return Status::OK();
 }
 
+Result<bool> QLWriteOperation::ApplyPackedInsert(const DocOperationApplyData& data,
+                                                 const QLTableRow& existing_row,
+                                                 QLTableRow* new_row) {
+  // Packed row has the same TTL and write time for all columns.
+  if (!FLAGS_ycql_enable_packed_row || !encoded_pk_doc_key_ || request_.has_ttl() ||
+      request_.has_user_timestamp_usec()) {
+    return false;
+  }
+
+  // Packed row is equivalent to records of all its columns, so QL insert could be packed only when
+  // it sets all regular columns.
+  int num_regular_columns = 0;
+  for (size_t i = schema_.num_key_columns(); i < schema_.num_columns(); ++i) {
+    if (!schema_.column(i).is_static()) {
+      ++num_regular_columns;
+    }
+  }
+  if (request_.column_values_size() != num_regular_columns) {
+    return false;
+  }
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id() || !column_value.json_args().empty() ||
+        !column_value.subscript_args().empty() ||
+        GetTSWriteInstruction(column_value.expr()) != bfql::TSOpcode::kScalarInsert) {
+      return false;
+    }
+    const auto& column = VERIFY_RESULT_REF(
+        schema_.column_by_id(ColumnId(column_value.column_id())));
+    if (column.is_static() || (column.type()->IsParametric() && !column.type()->IsFrozen())) {
+      return false;
+    }
+  }
+
+  RowPacker packer(request_.schema_version());
+  for (const auto& column_value : request_.column_values()) {
+    const ColumnId column_id(column_value.column_id());
+    const auto& column = VERIFY_RESULT_REF(schema_.column_by_id(column_id));
+    QLExprResult expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), existing_row, expr_result.Writer()));
+    packer.AddValue(
+        column_id, PrimitiveValue::FromQLValuePB(expr_result.Value(), column.sorting_type()));
+    if (update_indexes_) {
+      new_row->AllocColumn(column_id, expr_result.Value());
+    }
+  }
+
+  RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+      DocPath(encoded_pk_doc_key_.as_slice(),
+              PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow)),
+      Value(packer.Complete()), data.read_time, data.deadline, request_.query_id()));
+  return true;
+}
+
 Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
   QLTableRow existing_row;
   if (request_.has_if_expr()) {
@@ -850,6 +910,12 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
         RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
             sub_path, value, data.read_time, data.deadline, request_.query_id()));
       }
+      if (is_insert && VERIFY_RESULT(ApplyPackedInsert(data, existing_row, &new_row))) {
+        if (update_indexes_) {
+          RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
+        }
+        break;
+      }
 
       for (const auto& column_value : request_.column_values()) {
         if (!column_value.has_column_id()) {
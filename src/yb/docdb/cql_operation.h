@@ -134,6 +134,12 @@ class QLWriteOperation :
       IntentAwareIterator* iter, const SubDocKey& sub_doc_key,
       HybridTime min_hybrid_time);
 
+  // Writes all regular columns of an insert as a single packed row. Returns false, without writing
+  // anything, when the insert could not be packed.
+  Result<bool> ApplyPackedInsert(const DocOperationApplyData& data,
+                                 const QLTableRow& existing_row,
+                                 QLTableRow* new_row);
+
   CHECKED_STATUS DeleteRow(const DocPath& row_path, DocWriteBatch* doc_write_batch,
                            const ReadHybridTime& read_ht, CoarseTimePoint deadline);
 
@@ -433,6 +433,67 @@ TEST_F(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+std::string EncodeRangeSubDocKey(
+    const std::string& first_range_key, int64_t second_range_key, const std::string& sub_key) {
+  DocKey dk(PrimitiveValues(first_range_key, second_range_key));
+  return SubDocKey(dk, PrimitiveValue(sub_key),
+      HybridTime::FromMicros(12345L)).Encode().AsStringRef();
+}
+
+TEST_F(DocKeyTest, TestRangeKeyMatching) {
+  DocDbAwareFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr, 1 /* max_range_components */);
+  ASSERT_STRNE("DocKeyHashedComponentsFilter", policy.Name());
+  std::string keys[] = { "foo", "bar", "test" };
+  std::string absent_key = "fake";
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  for (const auto& key : keys) {
+    builder->AddKey(policy.GetKeyTransformer()->Transform(EncodeRangeSubDocKey(key, 1, "a")));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& sub_doc_key_str) {
+    return reader->MayMatch(policy.GetKeyTransformer()->Transform(sub_doc_key_str));
+  };
+
+  for (const auto &key : keys) {
+    ASSERT_TRUE(may_match(EncodeRangeSubDocKey(key, 1, "a"))) << "Key: " << key;
+    // Only the first range component is used for filtering.
+    ASSERT_TRUE(may_match(EncodeRangeSubDocKey(key, 2, "b"))) << "Key: " << key;
+  }
+  ASSERT_FALSE(may_match(EncodeRangeSubDocKey(absent_key, 1, "a"))) << "Key: " << absent_key;
+
+  // Keys with hashed components are still filtered by them.
+  ASSERT_EQ(policy.GetKeyTransformer()->Transform(EncodeSimpleSubDocKey("foo")),
+            policy.GetKeyTransformer()->Transform(
+                EncodeSimpleSubDocKeyWithDifferentNonHashPart("foo")));
+}
+
+TEST_F(DocKeyTest, TestFilterKeyComponentsEqual) {
+  auto encode = [](std::vector<PrimitiveValue> range_components) {
+    return DocKey(std::move(range_components)).Encode();
+  };
+  auto foo1 = encode({PrimitiveValue("foo"), PrimitiveValue(1)});
+  auto foo2 = encode({PrimitiveValue("foo"), PrimitiveValue(2)});
+  auto bar1 = encode({PrimitiveValue("bar"), PrimitiveValue(1)});
+  auto foo_lowest = encode({PrimitiveValue("foo"), PrimitiveValue(ValueType::kLowest)});
+  auto lowest = encode({PrimitiveValue(ValueType::kLowest)});
+
+  ASSERT_TRUE(ASSERT_RESULT(FilterKeyComponentsEqual(foo1, foo2, 1)));
+  ASSERT_FALSE(ASSERT_RESULT(FilterKeyComponentsEqual(foo1, foo2, 2)));
+  ASSERT_FALSE(ASSERT_RESULT(FilterKeyComponentsEqual(foo1, bar1, 1)));
+  ASSERT_TRUE(ASSERT_RESULT(FilterKeyComponentsEqual(foo1, foo_lowest, 1)));
+  // Special values do not belong to any filter key.
+  ASSERT_FALSE(ASSERT_RESULT(FilterKeyComponentsEqual(foo1, foo_lowest, 2)));
+  ASSERT_FALSE(ASSERT_RESULT(FilterKeyComponentsEqual(lowest, lowest, 1)));
+  // Without range components in filter, keys without hash have the same filter key.
+  ASSERT_TRUE(ASSERT_RESULT(FilterKeyComponentsEqual(foo1, bar1, 0)));
+}
+
 TEST_F(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
@@ -977,8 +977,73 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   }
 };
 
+// Decodes up to max_components range components of key without hashed components.
+// Returns pointer to the end of the last successfully decoded component, or nullptr if key has
+// hashed components. Number of decoded components is stored to num_decoded, when it is not null.
+Result<const uint8_t*> DecodeFirstRangeComponents(
+    Slice key, size_t max_components, size_t* num_decoded = nullptr) {
+  DocKeyDecoder decoder(key);
+  RETURN_NOT_OK(decoder.DecodeCotableId());
+  RETURN_NOT_OK(decoder.DecodePgtableId());
+  if (VERIFY_RESULT(decoder.DecodeHashCode(AllowSpecial::kTrue))) {
+    return nullptr;
+  }
+  auto end = decoder.left_input().data();
+  size_t i = 0;
+  for (; i != max_components; ++i) {
+    auto has_value = decoder.HasPrimitiveValue();
+    if (!has_value.ok() || !*has_value ||
+        !decoder.DecodePrimitiveValue(AllowSpecial::kFalse).ok()) {
+      break;
+    }
+    end = decoder.left_input().data();
+  }
+  if (num_decoded) {
+    *num_decoded = i;
+  }
+  return end;
+}
+
+// Keys with hashed components are transformed to their hashed part, the same way as
+// HashedComponentsExtractor does. Other keys are transformed to their first max_components range
+// components.
+class RangeComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  explicit RangeComponentsExtractor(size_t max_components) : max_components_(max_components) {}
+  RangeComponentsExtractor(const RangeComponentsExtractor&) = delete;
+  RangeComponentsExtractor& operator=(const RangeComponentsExtractor&) = delete;
+
+  Slice Transform(Slice key) const override {
+    auto end = DecodeFirstRangeComponents(key, max_components_);
+    if (!end.ok() || !*end) {
+      return HashedComponentsExtractor::GetInstance().Transform(key);
+    }
+    return Slice(key.data(), *end);
+  }
+
+ private:
+  const size_t max_components_;
+};
+
 } // namespace
 
+DocDbAwareFilterPolicy::DocDbAwareFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t max_range_components)
+    : max_range_components_(max_range_components) {
+  builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
+      filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
+  if (max_range_components) {
+    range_components_extractor_.reset(new RangeComponentsExtractor(max_range_components));
+    // Filters built for a different number of range components are not compatible, so the number
+    // is a part of the name. Filters with unknown name are ignored by readers.
+    name_ = Format("DocKeyRangeComponentsFilter$0", max_range_components);
+  } else {
+    name_ = "DocKeyHashedComponentsFilter";
+  }
+}
+
+DocDbAwareFilterPolicy::~DocDbAwareFilterPolicy() = default;
+
 
 void DocDbAwareFilterPolicy::CreateFilter(
     const rocksdb::Slice* keys, int n, std::string* dst) const {
@@ -1005,6 +1070,9 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
 }
 
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
+  if (range_components_extractor_) {
+    return range_components_extractor_.get();
+  }
   return &HashedComponentsExtractor::GetInstance();
 }
 
@@ -1215,6 +1283,29 @@ Result<bool> HashedComponentsEqual(const Slice& lhs, const Slice& rhs) {
   return rhs_decoder.GroupEnded();
 }
 
+Result<bool> FilterKeyComponentsEqual(
+    const Slice& lhs, const Slice& rhs, size_t max_range_components) {
+  if (max_range_components == 0) {
+    return HashedComponentsEqual(lhs, rhs);
+  }
+  size_t num_decoded = 0;
+  auto lhs_end = VERIFY_RESULT(DecodeFirstRangeComponents(lhs, max_range_components, &num_decoded));
+  if (!lhs_end) {
+    return HashedComponentsEqual(lhs, rhs);
+  }
+  // Keys with fewer range components could match stored keys having different filter keys.
+  if (num_decoded != max_range_components) {
+    return false;
+  }
+  auto rhs_end = VERIFY_RESULT(DecodeFirstRangeComponents(rhs, max_range_components));
+  if (!rhs_end) {
+    return false;
+  }
+  const size_t lhs_size = lhs_end - lhs.data();
+  return lhs_size == static_cast<size_t>(rhs_end - rhs.data()) &&
+         strings::memeq(lhs.data(), rhs.data(), lhs_size);
+}
+
 bool DocKeyBelongsTo(Slice doc_key, const Schema& schema) {
   bool has_table_id = !doc_key.empty() &&
       (doc_key[0] == ValueTypeAsChar::kTableId || doc_key[0] == ValueTypeAsChar::kPgTableOid);
@@ -430,6 +430,12 @@ Result<bool> ClearRangeComponents(KeyBytes* out, AllowSpecial allow_special = Al
 
 Result<bool> HashedComponentsEqual(const Slice& lhs, const Slice& rhs);
 
+// Returns true if both keys have the same bloom filter key for DocDbAwareFilterPolicy with
+// specified max_range_components. I.e. hashed components are equal for keys with hash, otherwise
+// first max_range_components range components are present, non special and equal in both keys.
+Result<bool> FilterKeyComponentsEqual(
+    const Slice& lhs, const Slice& rhs, size_t max_range_components);
+
 bool DocKeyBelongsTo(Slice doc_key, const Schema& schema);
 
 // Consumes single primitive value from start of slice.
@@ -817,14 +823,18 @@ std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
 // This filter policy only takes into account hashed components of keys for filtering.
+// When max_range_components is not zero, keys without hashed components, i.e. keys of range
+// partitioned tables, are filtered by their first max_range_components range components instead.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  DocDbAwareFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, size_t max_range_components = 0);
+
+  ~DocDbAwareFilterPolicy();
+
+  const char* Name() const override { return name_.c_str(); }
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  size_t max_range_components() const { return max_range_components_; }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -840,6 +850,10 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
 
  private:
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
+  // Null when only hashed components are used for filtering.
+  std::unique_ptr<const KeyTransformer> range_components_extractor_;
+  size_t max_range_components_;
+  std::string name_;
 };
 
 // Optional inclusive lower bound and exclusive upper bound for keys served by DocDB.
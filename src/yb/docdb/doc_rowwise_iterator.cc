@@ -31,10 +31,18 @@
 #include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 
+#include "yb/util/flag_tags.h"
+
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
 using std::string;
 
+DEFINE_bool(docdb_direct_row_decoding, true,
+            "Decode rows of projections that have only columns stored as single values directly "
+            "into the row, without building an intermediate SubDocument.");
+TAG_FLAG(docdb_direct_row_decoding, runtime);
+TAG_FLAG(docdb_direct_row_decoding, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -486,6 +494,22 @@ DocRowwiseIterator::DocRowwiseIterator(
     projection_subkeys_.emplace_back(projection.column_id(i));
   }
   std::sort(projection_subkeys_.begin(), projection_subkeys_.end());
+  read_projected_columns_ = FLAGS_docdb_direct_row_decoding;
+  for (size_t i = projection_.num_key_columns(); i < projection.num_columns(); i++) {
+    if (projection.column(i).type()->HasComplexValues()) {
+      read_projected_columns_ = false;
+      break;
+    }
+  }
+  if (read_projected_columns_) {
+    projection_subkey_indexes_.reserve(projection_subkeys_.size());
+    for (const auto& subkey : projection_subkeys_) {
+      projection_subkey_indexes_.push_back(
+          subkey.value_type() == ValueType::kColumnId
+              ? projection_.find_column_by_id(subkey.GetColumnId()) : -1);
+    }
+    projected_values_.resize(projection.num_columns());
+  }
   deadline_info_.emplace(deadline);
 }
 
@@ -560,7 +584,8 @@ Status DocRowwiseIterator::DoInit(const T& doc_spec) {
   // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
   const bool is_fixed_point_get =
       !lower_doc_key.empty() &&
-      VERIFY_RESULT(HashedComponentsEqual(lower_doc_key, upper_doc_key));
+      VERIFY_RESULT(FilterKeyComponentsEqual(
+          lower_doc_key, upper_doc_key, BloomFilterRangeComponents(doc_db_.regular)));
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER
                                        : BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
@@ -714,7 +739,20 @@ Result<bool> DocRowwiseIterator::HasNext() const {
       &table_tombstone_time_,
     };
     data.deadline_info = deadline_info_.get_ptr();
-    has_next_status_ = GetSubDocument(db_iter_.get(), data, &projection_subkeys_);
+    data.schema_version = schema_version_;
+    if (read_projected_columns_) {
+      liveness_column_found_ = false;
+      for (auto& value : projected_values_) {
+        value.found = false;
+      }
+      has_next_status_ = GetProjectedColumns(
+          db_iter_.get(), data, projection_subkeys_,
+          [this](size_t index, const ProjectedColumnValue& value) {
+        return StoreProjectedValue(index, value);
+      });
+    } else {
+      has_next_status_ = GetSubDocument(db_iter_.get(), data, &projection_subkeys_);
+    }
     RETURN_NOT_OK(has_next_status_);
     // After this, the iter should be positioned right after the subdocument.
 
@@ -819,6 +857,29 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
         "range", &decoder, table_row));
   }
 
+  if (read_projected_columns_) {
+    for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
+      const auto& column_id = projection.column_id(i);
+      const int index = &projection == &projection_
+          ? static_cast<int>(i) : projection_.find_column_by_id(column_id);
+      QLTableColumn& column = table_row->AllocColumn(column_id);
+      // Columns that are not part of the iterator projection are never read, so they are null.
+      auto* value = index >= 0 ? &projected_values_[index] : nullptr;
+      if (value && value->found) {
+        // Swap keeps the allocated buffers of both values for reuse.
+        column.value.Swap(&value->column.value);
+        column.ttl_seconds = value->column.ttl_seconds;
+        column.write_time = value->column.write_time;
+      } else {
+        SetNull(&column.value);
+        column.ttl_seconds = -1;
+        column.write_time = QLTableColumn::kUninitializedWriteTime;
+      }
+    }
+    row_ready_ = false;
+    return Status::OK();
+  }
+
   for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
     const auto& column_id = projection.column_id(i);
     const auto ql_type = projection.column(i).type();
@@ -837,7 +898,27 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   return Status::OK();
 }
 
+Status DocRowwiseIterator::StoreProjectedValue(
+    size_t index, const ProjectedColumnValue& value) const {
+  const int projection_index = projection_subkey_indexes_[index];
+  if (projection_index < 0) {
+    liveness_column_found_ = true;
+    return Status::OK();
+  }
+  auto& projected_value = projected_values_[projection_index];
+  RETURN_NOT_OK(PrimitiveValue::DecodeToQLValuePB(
+      value.encoded_value, projection_.column(projection_index).type(),
+      &projected_value.column.value));
+  projected_value.found = true;
+  projected_value.column.ttl_seconds = value.ttl_seconds;
+  projected_value.column.write_time = value.write_time;
+  return Status::OK();
+}
+
 bool DocRowwiseIterator::LivenessColumnExists() const {
+  if (read_projected_columns_) {
+    return liveness_column_found_;
+  }
   const SubDocument* subdoc = row_.GetChild(
       PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
   return subdoc != nullptr && subdoc->value_type() != ValueType::kInvalid;
@@ -873,13 +954,21 @@ Result<Slice> DocRowwiseIterator::GetTupleId() const {
 }
 
 Result<bool> DocRowwiseIterator::SeekTuple(const Slice& tuple_id) {
+  return DoSeekTuple(tuple_id, false /* forward */);
+}
+
+Result<bool> DocRowwiseIterator::SeekTupleForward(const Slice& tuple_id) {
+  return DoSeekTuple(tuple_id, true /* forward */);
+}
+
+Result<bool> DocRowwiseIterator::DoSeekTuple(const Slice& tuple_id, bool forward) {
   // If cotable id / pgtable id is present in the table schema, then
   // we need to prepend it in the tuple key to seek.
   if (schema_.has_cotable_id() || schema_.has_pgtable_id()) {
     uint32_t size = schema_.has_pgtable_id() ? sizeof(PgTableOid) : kUuidSize;
     if (!tuple_key_) {
       tuple_key_.emplace();
-      tuple_key_->Reserve(1 + size + tuple_id.size());
+      tuple_key_->Reserve(1 + size + tuple_id.size() + kMaxBytesPerEncodedHybridTime + 1);
 
       if (schema_.has_cotable_id()) {
         std::string bytes;
@@ -894,7 +983,13 @@ Result<bool> DocRowwiseIterator::SeekTuple(const Slice& tuple_id) {
       tuple_key_->Truncate(1 + size);
     }
     tuple_key_->AppendRawBytes(tuple_id);
-    db_iter_->Seek(*tuple_key_);
+    if (forward) {
+      db_iter_->SeekForward(&*tuple_key_);
+    } else {
+      db_iter_->Seek(*tuple_key_);
+    }
+  } else if (forward) {
+    db_iter_->SeekForward(tuple_id);
   } else {
     db_iter_->Seek(tuple_id);
   }
@@ -20,9 +20,11 @@
 #include "yb/rocksdb/db.h"
 
 #include "yb/common/hybrid_time.h"
+#include "yb/common/ql_expr.h"
 #include "yb/common/ql_rowwise_iterator_interface.h"
 #include "yb/common/ql_scanspec.h"
 #include "yb/common/read_hybrid_time.h"
+#include "yb/docdb/docdb_fwd.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/doc_ql_scanspec.h"
@@ -107,13 +109,26 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // the cotable id.
   Result<bool> SeekTuple(const Slice& tuple_id) override;
 
+  // Same as SeekTuple, but the caller guarantees that tuple_id is greater than the id of any tuple
+  // read since the last SeekTuple, so the underlying iterator could move forward without reseeking
+  // when the tuple is close to the current position.
+  Result<bool> SeekTupleForward(const Slice& tuple_id) override;
+
   // Retrieves the next key to read after the iterator finishes for the given page.
   CHECKED_STATUS GetNextReadSubDocKey(SubDocKey* sub_doc_key) const override;
 
+  // Schema version used by the reader. Packed rows written with a newer schema version could not
+  // be decoded, so the read fails with TryAgain for them.
+  void set_schema_version(uint32_t schema_version) {
+    schema_version_ = schema_version;
+  }
+
  private:
   template <class T>
   CHECKED_STATUS DoInit(const T& spec);
 
+  Result<bool> DoSeekTuple(const Slice& tuple_id, bool forward);
+
   Result<bool> InitScanChoices(
       const DocQLScanSpec& doc_spec, const KeyBytes& lower_doc_key, const KeyBytes& upper_doc_key);
 
@@ -157,6 +172,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // Read next row into a value map using the specified projection.
   CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override;
 
+  // Decodes value of the index-th entry of projection_subkeys_, read by GetProjectedColumns, into
+  // projected_values_.
+  CHECKED_STATUS StoreProjectedValue(size_t index, const ProjectedColumnValue& value) const;
+
   const Schema& projection_;
   // Used to maintain ownership of projection_.
   // Separate field is used since ownership could be optional.
@@ -169,6 +188,8 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   bool is_forward_scan_ = true;
 
+  boost::optional<uint32_t> schema_version_;
+
   const CoarseTimePoint deadline_;
 
   const ReadHybridTime read_time_;
@@ -212,6 +233,23 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   mutable std::vector<PrimitiveValue> projection_subkeys_;
 
+  // Whether all non key columns of the projection are stored as single values, so HasNext reads
+  // them with GetProjectedColumns into projected_values_ instead of building row_.
+  bool read_projected_columns_ = false;
+
+  // Projection index of each entry of projection_subkeys_, -1 for the liveness column.
+  std::vector<int> projection_subkey_indexes_;
+
+  struct ProjectedValue {
+    bool found = false;
+    QLTableColumn column;
+  };
+
+  // Values of the current row, indexed by projection column index. Reused between rows.
+  mutable std::vector<ProjectedValue> projected_values_;
+
+  mutable bool liveness_column_found_ = false;
+
   // Used for keeping track of errors in HasNext.
   mutable Status has_next_status_;
 
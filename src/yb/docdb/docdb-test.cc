@@ -63,6 +63,9 @@ using namespace std::chrono_literals;
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
 DECLARE_bool(docdb_sort_weak_intents_in_tests);
+DECLARE_int32(rocksdb_max_subcompactions);
+DECLARE_uint64(universal_compaction_min_subcompaction_size_bytes);
+DECLARE_int64(db_block_size_bytes);
 
 #define ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(str) ASSERT_NO_FATALS(AssertDocDbDebugDumpStrEq(str))
 
@@ -2772,6 +2775,48 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(10); HT{ physical: 2000 w: 1 }]
   }
 }
 
+// Index blocks of a large row provide split keys inside of it, while its tombstone precedes all
+// of its records. So the row tombstone and the values it overrides are processed by different
+// subcompactions, unless boundaries are aligned to rows.
+TEST_F(DocDBTest, SubcompactionBoundariesAlignedToRows) {
+  google::FlagSaver flag_saver;
+  FLAGS_rocksdb_max_subcompactions = 4;
+  FLAGS_universal_compaction_min_subcompaction_size_bytes = 1;
+  FLAGS_db_block_size_bytes = 256;
+  ASSERT_OK(ReinitDBOptions());
+
+  constexpr int kNumRows = 10;
+  constexpr int kDeletedRow = kNumRows / 2;
+  constexpr int kNumColumns = 20;
+  constexpr int kNumDeletedRowColumns = 200;
+  const std::string value(100, 'x');
+  for (int row = 0; row != kNumRows; ++row) {
+    const KeyBytes encoded_doc_key(DocKey(PrimitiveValues(Format("row$0", row))).Encode());
+    const int num_columns = row == kDeletedRow ? kNumDeletedRowColumns : kNumColumns;
+    for (int column = 0; column != num_columns; ++column) {
+      ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue(ColumnId(column))),
+                             PrimitiveValue(value), 1000_usec_ht));
+    }
+    if (row == kDeletedRow) {
+      ASSERT_OK(DeleteSubDoc(DocPath(encoded_doc_key), 2000_usec_ht));
+    }
+  }
+
+  FullyCompactHistoryBefore(3000_usec_ht);
+
+  std::vector<rocksdb::LiveFileMetaData> files;
+  rocksdb()->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1U) << "Compaction was not split into subcompactions";
+
+  const auto dump = DocDBDebugDumpToStr();
+  ASSERT_EQ(dump.find(Format("\"row$0\"", kDeletedRow)), std::string::npos) << dump;
+  for (int row = 0; row != kNumRows; ++row) {
+    if (row != kDeletedRow) {
+      ASSERT_NE(dump.find(Format("\"row$0\"", row)), std::string::npos) << dump;
+    }
+  }
+}
+
 TEST_F(DocDBTest, StaticColumnCompaction) {
   const DocKey hk(0, PrimitiveValues("h1")); // hash key
   const DocKey pk1(hk.hash(), hk.hashed_group(), PrimitiveValues("r1")); // primary key
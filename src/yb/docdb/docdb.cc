@@ -34,6 +34,7 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
@@ -781,6 +782,178 @@ void SeekToLowerBound(const SliceKeyBound& lower_bound, IntentAwareIterator* ite
   }
 }
 
+// Returns remaining TTL in seconds of a value read at read_ht, or -1 if the value does not expire.
+int64_t RemainingTtlSeconds(const Expiration& exp, HybridTime write_ht, HybridTime read_ht) {
+  if (exp.ttl == Value::kMaxTtl) {
+    return -1;
+  }
+  int64_t time_since_write_seconds = (
+      server::HybridClock::GetPhysicalValueMicros(read_ht) -
+      server::HybridClock::GetPhysicalValueMicros(write_ht)) /
+      MonoTime::kMicrosecondsPerSecond;
+  return std::max(static_cast<int64_t>(0),
+      exp.ttl.ToMilliseconds() / MonoTime::kMillisecondsPerSecond - time_since_write_seconds);
+}
+
+// Returns write time of a value, that is used by CQL. Choose the user supplied timestamp if
+// present.
+int64_t WriteTimeMicros(HybridTime write_ht, UserTimeMicros user_timestamp) {
+  return user_timestamp == Value::kInvalidUserTimestamp
+      ? write_ht.GetPhysicalValueMicros()
+      : user_timestamp;
+}
+
+// Fills TTL and write time of a primitive value read at read_ht, that are used by CQL.
+void SetTtlAndWriteTime(
+    const Expiration& exp, HybridTime write_ht, HybridTime read_ht, UserTimeMicros user_timestamp,
+    PrimitiveValue* value) {
+  // TODO: the ttl_seconds in primitive value is currently only in use for CQL. At some
+  // point streamline by refactoring CQL to use the mutable Expiration in GetSubDocumentData.
+  value->SetTtl(RemainingTtlSeconds(exp, write_ht, read_ht));
+  value->SetWriteTime(WriteTimeMicros(write_ht, user_timestamp));
+}
+
+// Packed row of a document, stored as the value of its kPackedRow system column, see packed_row.h.
+//
+// Packed row does not overwrite column records of the document. A column record overrides the value
+// of the column in the packed row, when it was written after the packed row. The only exception is
+// a CQL write with user timestamp lower than the write time of the packed row: the writer compares
+// user timestamp with the latest record of the column, so it does not see the packed row, and such
+// a write would have been skipped if the row was not packed.
+class DocPackedRow {
+ public:
+  // Decodes the packed row written at write_time. Packed rows written with a schema version newer
+  // than the schema version of the reader are rejected. Expired packed row has no columns, but still
+  // overrides column records written before it.
+  CHECKED_STATUS Init(
+      const Value& value, DocHybridTime write_time, Expiration exp, HybridTime read_ht,
+      const boost::optional<uint32_t>& schema_version) {
+    SCHECK_EQ(value.value_type(), ValueType::kPackedRow, Corruption, "Packed row expected");
+    write_time_ = write_time;
+    const auto write_ht = write_time.hybrid_time();
+    if (write_ht >= exp.write_ht) {
+      if (value.ttl() != Value::kMaxTtl) {
+        exp.write_ht = write_ht;
+        exp.ttl = value.ttl();
+      } else if (exp.ttl.IsNegative()) {
+        exp.ttl = -exp.ttl;
+      }
+    }
+    if (exp.write_ht == HybridTime::kMin) {
+      exp.write_ht = write_ht;
+    }
+    exp_ = exp;
+    RETURN_NOT_OK(HasExpiredTTL(exp.write_ht, exp.ttl, read_ht, &expired_));
+    if (expired_) {
+      return Status::OK();
+    }
+    row_ = VERIFY_RESULT(PackedRow::Decode(value.primitive_value().GetPackedRow()));
+    if (schema_version && row_.schema_version() > *schema_version) {
+      return STATUS_FORMAT(
+          TryAgain, "Packed row written with schema version $0, that is newer than read schema "
+                    "version $1", row_.schema_version(), *schema_version);
+    }
+    return Status::OK();
+  }
+
+  DocHybridTime write_time() const {
+    return write_time_;
+  }
+
+  bool HasColumns() const {
+    return !expired_ && row_.num_columns() != 0;
+  }
+
+  // Returns true if the latest record of a column, written after the packed row with the specified
+  // user timestamp, overrides the value of the column in the packed row.
+  bool IsOverriddenBy(UserTimeMicros user_timestamp) const {
+    return user_timestamp == Value::kInvalidUserTimestamp ||
+           user_timestamp >= write_time_.hybrid_time().GetPhysicalValueMicros();
+  }
+
+  // Returns value of the column stored in the packed row, or invalid subdocument if the row does
+  // not contain it.
+  Result<SubDocument> ColumnValue(const PrimitiveValue& subkey, HybridTime read_ht) const {
+    PrimitiveValue value;
+    if (expired_ || subkey.value_type() != ValueType::kColumnId ||
+        !VERIFY_RESULT(row_.GetPrimitiveValue(subkey.GetColumnId(), &value))) {
+      return SubDocument(ValueType::kInvalid);
+    }
+    SetTtlAndWriteTime(
+        exp_, write_time_.hybrid_time(), read_ht, Value::kInvalidUserTimestamp, &value);
+    return SubDocument(value);
+  }
+
+  // Same as ColumnValue, but does not decode the value. Returns false if the row does not contain
+  // the column.
+  bool EncodedColumnValue(
+      const PrimitiveValue& subkey, HybridTime read_ht, ProjectedColumnValue* value) const {
+    if (expired_ || subkey.value_type() != ValueType::kColumnId) {
+      return false;
+    }
+    auto encoded_value = row_.GetValue(subkey.GetColumnId());
+    if (!encoded_value) {
+      return false;
+    }
+    value->encoded_value = *encoded_value;
+    value->ttl_seconds = RemainingTtlSeconds(exp_, write_time_.hybrid_time(), read_ht);
+    value->write_time = WriteTimeMicros(write_time_.hybrid_time(), Value::kInvalidUserTimestamp);
+    return true;
+  }
+
+  // Adds columns of the packed row, except overridden_columns, to the object subdocument.
+  CHECKED_STATUS AddColumns(
+      const std::vector<ColumnId>& overridden_columns, HybridTime read_ht,
+      SubDocument* result) const {
+    if (expired_) {
+      return Status::OK();
+    }
+    Status status;
+    row_.ForEachColumn([&](ColumnId column_id, const Slice& encoded_value) {
+      if (!status.ok() ||
+          std::find(overridden_columns.begin(), overridden_columns.end(), column_id) !=
+              overridden_columns.end()) {
+        return;
+      }
+      PrimitiveValue value;
+      status = value.DecodeFromValue(encoded_value);
+      if (status.ok()) {
+        SetTtlAndWriteTime(
+            exp_, write_time_.hybrid_time(), read_ht, Value::kInvalidUserTimestamp, &value);
+        result->SetChildPrimitive(PrimitiveValue(column_id), value);
+      }
+    });
+    return status;
+  }
+
+ private:
+  PackedRow row_;
+  DocHybridTime write_time_;
+  Expiration exp_;
+  bool expired_ = false;
+};
+
+// Looks for a packed row of the document doc_key, written after max_overwrite_ht. The iterator is
+// left positioned at the latest record of the kPackedRow column, or after it. So it should be
+// called after system columns are read, and before regular columns are read.
+CHECKED_STATUS FindPackedRow(
+    IntentAwareIterator* iter, const Slice& doc_key, DocHybridTime max_overwrite_ht,
+    const GetSubDocumentData& data, boost::optional<DocPackedRow>* packed_row) {
+  KeyBytes packed_row_key(doc_key);
+  PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow).AppendToKey(&packed_row_key);
+  DocHybridTime write_time = max_overwrite_ht;
+  Slice encoded_value;
+  RETURN_NOT_OK(iter->FindLatestRecord(packed_row_key, &write_time, &encoded_value));
+  if (write_time == max_overwrite_ht) {
+    return Status::OK();
+  }
+  Value value;
+  RETURN_NOT_OK(value.Decode(encoded_value));
+  packed_row->emplace();
+  return (**packed_row).Init(
+      value, write_time, data.exp, iter->read_time().read, data.schema_version);
+}
+
 // This function does not assume that object init_markers are present. If no init marker is present,
 // or if a tombstone is found at some level, it still looks for subkeys inside it if they have
 // larger timestamps.
@@ -803,6 +976,10 @@ CHECKED_STATUS BuildSubDocument(
     int64* num_values_observed) {
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
+  // Packed row of the document, when subdocument_key is a row that was packed, and columns that
+  // have records overriding its values.
+  boost::optional<DocPackedRow> packed_row;
+  std::vector<ColumnId> overridden_columns;
   while (iter->valid()) {
     if (data.deadline_info && data.deadline_info->CheckAndSetDeadlinePassed()) {
       return STATUS(Expired, "Deadline for query passed.");
@@ -837,9 +1014,28 @@ CHECKED_STATUS BuildSubDocument(
     Value doc_value;
     RETURN_NOT_OK(doc_value.Decode(value));
     ValueType value_type = doc_value.value_type();
+    if (value_type == ValueType::kPackedRow && key != data.subdocument_key) {
+      // Packed row is stored at the kPackedRow column of the row, i.e. we are building the row.
+      // Its columns are added after all column records are processed.
+      packed_row.emplace();
+      RETURN_NOT_OK(packed_row->Init(
+          doc_value, write_time, data.exp, iter->read_time().read, data.schema_version));
+      if (packed_row->HasColumns() && !IsObjectType(data.result->value_type())) {
+        *data.result = SubDocument();
+      }
+      // Column records written before the packed row are overridden by it.
+      if (low_ts < write_time) {
+        low_ts = write_time;
+      }
+      VLOG(3) << "SeekPastSubKey: " << SubDocKey::DebugSliceToString(key);
+      iter->SeekPastSubKey(key);
+      continue;
+    }
     if (key == data.subdocument_key) {
       if (write_time == DocHybridTime::kMin)
         return STATUS(Corruption, "No hybrid timestamp found on entry");
+      data.found_own_record = true;
+      data.own_record_user_timestamp = doc_value.user_timestamp();
 
       // We may need to update the TTL in individual columns.
       if (write_time.hybrid_time() >= data.exp.write_ht) {
@@ -895,26 +1091,9 @@ CHECKED_STATUS BuildSubDocument(
           return STATUS_FORMAT(Corruption,
               "Expected primitive value type, got $0", value_type);
         }
-        // TODO: the ttl_seconds in primitive value is currently only in use for CQL. At some
-        // point streamline by refactoring CQL to use the mutable Expiration in GetSubDocumentData.
-        if (data.exp.ttl == Value::kMaxTtl) {
-          doc_value.mutable_primitive_value()->SetTtl(-1);
-        } else {
-          int64_t time_since_write_seconds = (
-              server::HybridClock::GetPhysicalValueMicros(iter->read_time().read) -
-              server::HybridClock::GetPhysicalValueMicros(write_time.hybrid_time())) /
-              MonoTime::kMicrosecondsPerSecond;
-          int64_t ttl_seconds = std::max(static_cast<int64_t>(0),
-              data.exp.ttl.ToMilliseconds() /
-              MonoTime::kMillisecondsPerSecond - time_since_write_seconds);
-          doc_value.mutable_primitive_value()->SetTtl(ttl_seconds);
-        }
-        // Choose the user supplied timestamp if present.
-        const UserTimeMicros user_timestamp = doc_value.user_timestamp();
-        doc_value.mutable_primitive_value()->SetWriteTime(
-            user_timestamp == Value::kInvalidUserTimestamp
-            ? write_time.hybrid_time().GetPhysicalValueMicros()
-            : doc_value.user_timestamp());
+        SetTtlAndWriteTime(
+            data.exp, write_time.hybrid_time(), iter->read_time().read, doc_value.user_timestamp(),
+            doc_value.mutable_primitive_value());
         if (!data.high_index->CanInclude(current_values_observed)) {
           iter->SeekOutOfSubDoc(&key_copy);
           return Status::OK();
@@ -933,10 +1112,21 @@ CHECKED_STATUS BuildSubDocument(
     //       We'll get into an infinite recursion then.
     {
       IntentAwareIteratorPrefixScope prefix_scope(key, iter);
-      RETURN_NOT_OK(BuildSubDocument(
-          iter, data.Adjusted(key, &descendant), low_ts,
-          num_values_observed));
-
+      auto descendant_data = data.Adjusted(key, &descendant);
+      RETURN_NOT_OK(BuildSubDocument(iter, descendant_data, low_ts, num_values_observed));
+      if (packed_row && descendant_data.found_own_record) {
+        Slice temp = key;
+        temp.remove_prefix(data.subdocument_key.size());
+        PrimitiveValue child;
+        RETURN_NOT_OK(child.DecodeFromKey(&temp));
+        if (temp.empty() && child.value_type() == ValueType::kColumnId) {
+          if (!packed_row->IsOverriddenBy(descendant_data.own_record_user_timestamp)) {
+            // Value from the packed row is used instead.
+            continue;
+          }
+          overridden_columns.push_back(child.GetColumnId());
+        }
+      }
     }
     if (descendant.value_type() == ValueType::kInvalid) {
       // The document was not found in this level (maybe a tombstone was encountered).
@@ -998,9 +1188,120 @@ CHECKED_STATUS BuildSubDocument(
     }
   }
 
+  if (packed_row) {
+    RETURN_NOT_OK(packed_row->AddColumns(overridden_columns, iter->read_time().read, data.result));
+  }
+
+  return Status::OK();
+}
+
+// Checks for a table tombstone, which is an ancestor of the document at the ID level. Currently,
+// this is only supported for YSQL colocated tables. Since iterators only ever pertain to one table,
+// there is no need to create a prefix scope here.
+CHECKED_STATUS CheckTableTombstone(
+    IntentAwareIterator* db_iter, const GetSubDocumentData& data, const Slice& key_slice,
+    DocHybridTime* max_overwrite_ht) {
+  if (data.table_tombstone_time && *data.table_tombstone_time == DocHybridTime::kInvalid) {
+    // Only check for table tombstones if the table is colocated, as signified by the prefix of
+    // kPgTableOid.
+    // TODO: adjust when fixing issue #3551
+    if (key_slice[0] == ValueTypeAsChar::kPgTableOid) {
+      // Seek to the ID level to look for a table tombstone.  Since this seek is expensive, cache
+      // the result in data.table_tombstone_time to avoid double seeking for the lifetime of the
+      // DocRowwiseIterator.
+      DocKey empty_key;
+      RETURN_NOT_OK(empty_key.DecodeFrom(key_slice, DocKeyPart::UP_TO_ID));
+      db_iter->Seek(empty_key);
+      Value doc_value = Value(PrimitiveValue(ValueType::kInvalid));
+      RETURN_NOT_OK(FindLastWriteTime(
+          db_iter,
+          empty_key.Encode(),
+          max_overwrite_ht,
+          &data.exp,
+          &doc_value));
+      if (doc_value.value_type() == ValueType::kTombstone) {
+        SCHECK_NE(*max_overwrite_ht, DocHybridTime::kInvalid, Corruption,
+                  "Invalid hybrid time for table tombstone");
+        *data.table_tombstone_time = *max_overwrite_ht;
+      } else {
+        *data.table_tombstone_time = DocHybridTime::kMin;
+      }
+    } else {
+      *data.table_tombstone_time = DocHybridTime::kMin;
+    }
+  } else if (data.table_tombstone_time) {
+    // Use the cached result.  Don't worry about exp as YSQL does not support TTL, yet.
+    *max_overwrite_ht = *data.table_tombstone_time;
+  }
   return Status::OK();
 }
 
+// Resolves the value of a column that is stored as a single value, i.e. the latest record of
+// column_key written at or after low_ts, the same way BuildSubDocument does for primitive values.
+// The iterator is expected to be positioned at column_key. Returns true if a record of the column
+// was found, in this case value is set to the column value, or its encoded_value is empty if the
+// column was deleted or has expired. The value is not decoded and points into the iterator, so it
+// is valid until the iterator is moved. Records that do not override value of the column in
+// packed_row are ignored.
+Result<bool> ReadColumnValue(
+    IntentAwareIterator* iter, const Slice& column_key, DocHybridTime low_ts, Expiration exp,
+    const DocPackedRow* packed_row, DeadlineInfo* deadline_info, ProjectedColumnValue* value) {
+  while (iter->valid()) {
+    if (deadline_info && deadline_info->CheckAndSetDeadlinePassed()) {
+      return STATUS(Expired, "Deadline for query passed.");
+    }
+    auto key_data = VERIFY_RESULT(iter->FetchKey());
+    if (low_ts > key_data.write_time) {
+      // Column was overwritten at the row level after this record was written.
+      return false;
+    }
+    if (key_data.key != column_key) {
+      // Ignore nested records, column is expected to be stored as a single value.
+      iter->SeekPastSubKey(key_data.key);
+      continue;
+    }
+    if (key_data.write_time == DocHybridTime::kMin) {
+      return STATUS(Corruption, "No hybrid timestamp found on entry");
+    }
+    const auto write_ht = key_data.write_time.hybrid_time();
+    // Only control fields are decoded here, the value itself is decoded by the caller.
+    Value control_fields;
+    Slice encoded_value = iter->value();
+    RETURN_NOT_OK(control_fields.DecodeControlFields(&encoded_value));
+    if (packed_row && !packed_row->IsOverriddenBy(control_fields.user_timestamp())) {
+      return false;
+    }
+
+    if (write_ht >= exp.write_ht) {
+      // We want to keep the default TTL otherwise.
+      if (control_fields.ttl() != Value::kMaxTtl) {
+        exp.write_ht = write_ht;
+        exp.ttl = control_fields.ttl();
+      } else if (exp.ttl.IsNegative()) {
+        exp.ttl = -exp.ttl;
+      }
+    }
+    if (exp.write_ht == HybridTime::kMin) {
+      exp.write_ht = write_ht;
+    }
+    bool has_expired = false;
+    RETURN_NOT_OK(HasExpiredTTL(exp.write_ht, exp.ttl, iter->read_time().read, &has_expired));
+    const auto value_type = DecodeValueType(encoded_value);
+    if (has_expired || value_type == ValueType::kTombstone) {
+      value->encoded_value = Slice();
+      return true;
+    }
+    if (!IsPrimitiveValueType(value_type)) {
+      return STATUS_FORMAT(Corruption, "Expected primitive value type, got $0", value_type);
+    }
+    value->encoded_value = encoded_value;
+    value->ttl_seconds = RemainingTtlSeconds(exp, write_ht, iter->read_time().read);
+    value->write_time = WriteTimeMicros(write_ht, control_fields.user_timestamp());
+    return true;
+  }
+  return false;
+}
+
 }  // namespace
 
 yb::Status FindLastWriteTime(
@@ -1123,41 +1424,8 @@ yb::Status GetSubDocument(
   // corresponding most recent write time in exp, and the general most recent overwrite time in
   // max_overwrite_ht.
   //
-  // First, check for an ancestor at the ID level: a table tombstone.  Currently, this is only
-  // supported for YSQL colocated tables.  Since iterators only ever pertain to one table, there is
-  // no need to create a prefix scope here.
-  if (data.table_tombstone_time && *data.table_tombstone_time == DocHybridTime::kInvalid) {
-    // Only check for table tombstones if the table is colocated, as signified by the prefix of
-    // kPgTableOid.
-    // TODO: adjust when fixing issue #3551
-    if (key_slice[0] == ValueTypeAsChar::kPgTableOid) {
-      // Seek to the ID level to look for a table tombstone.  Since this seek is expensive, cache
-      // the result in data.table_tombstone_time to avoid double seeking for the lifetime of the
-      // DocRowwiseIterator.
-      DocKey empty_key;
-      RETURN_NOT_OK(empty_key.DecodeFrom(key_slice, DocKeyPart::UP_TO_ID));
-      db_iter->Seek(empty_key);
-      Value doc_value = Value(PrimitiveValue(ValueType::kInvalid));
-      RETURN_NOT_OK(FindLastWriteTime(
-          db_iter,
-          empty_key.Encode(),
-          &max_overwrite_ht,
-          &data.exp,
-          &doc_value));
-      if (doc_value.value_type() == ValueType::kTombstone) {
-        SCHECK_NE(max_overwrite_ht, DocHybridTime::kInvalid, Corruption,
-                  "Invalid hybrid time for table tombstone");
-        *data.table_tombstone_time = max_overwrite_ht;
-      } else {
-        *data.table_tombstone_time = DocHybridTime::kMin;
-      }
-    } else {
-      *data.table_tombstone_time = DocHybridTime::kMin;
-    }
-  } else if (data.table_tombstone_time) {
-    // Use the cached result.  Don't worry about exp as YSQL does not support TTL, yet.
-    max_overwrite_ht = *data.table_tombstone_time;
-  }
+  // First, check for an ancestor at the ID level: a table tombstone.
+  RETURN_NOT_OK(CheckTableTombstone(db_iter, data, key_slice, &max_overwrite_ht));
   // Second, check the descendants of the ID level.
   IntentAwareIteratorPrefixScope prefix_scope(key_slice, db_iter);
   if (seek_fwd_suffices) {
@@ -1222,6 +1490,13 @@ yb::Status GetSubDocument(
     }
     return Status::OK();
   }
+  // Columns of a packed row are used when there are no newer records for them. Packed row is
+  // looked up before the first regular column, since system columns precede regular ones.
+  const bool is_row = dockey_size == data.subdocument_key.size();
+  bool packed_row_checked = false;
+  boost::optional<DocPackedRow> packed_row;
+  DocHybridTime columns_low_ts = max_overwrite_ht;
+
   // Seed key_bytes with the subdocument key. For each subkey in the projection, build subdocument
   // and reuse key_bytes while appending the subkey.
   *data.result = SubDocument();
@@ -1234,6 +1509,14 @@ yb::Status GetSubDocument(
     // Append subkey to subdocument key. Reserve extra kMaxBytesPerEncodedHybridTime + 1 bytes in
     // key_bytes to avoid the internal buffer from getting reallocated and moved by SeekForward()
     // appending the hybrid time, thereby invalidating the buffer pointer saved by prefix_scope.
+    if (is_row && !packed_row_checked && subkey.value_type() == ValueType::kColumnId) {
+      packed_row_checked = true;
+      RETURN_NOT_OK(FindPackedRow(
+          db_iter, data.subdocument_key, max_overwrite_ht, data, &packed_row));
+      if (packed_row) {
+        columns_low_ts = packed_row->write_time();
+      }
+    }
     subkey.AppendToKey(&key_bytes);
     key_bytes.Reserve(key_bytes.size() + kMaxBytesPerEncodedHybridTime + 1);
     // This seek is to initialize the iterator for BuildSubDocument call.
@@ -1241,9 +1524,13 @@ yb::Status GetSubDocument(
     db_iter->SeekForward(&key_bytes);
     SubDocument descendant(ValueType::kInvalid);
     int64 num_values_observed = 0;
+    auto descendant_data = data.Adjusted(key_bytes, &descendant);
     RETURN_NOT_OK(BuildSubDocument(
-        db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
-        &num_values_observed));
+        db_iter, descendant_data, columns_low_ts, &num_values_observed));
+    if (packed_row && (!descendant_data.found_own_record ||
+                       !packed_row->IsOverriddenBy(descendant_data.own_record_user_timestamp))) {
+      descendant = VERIFY_RESULT(packed_row->ColumnValue(subkey, db_iter->read_time().read));
+    }
     *data.doc_found = descendant.value_type() != ValueType::kInvalid;
     data.result->SetChild(subkey, std::move(descendant));
 
@@ -1257,6 +1544,72 @@ yb::Status GetSubDocument(
   return Status::OK();
 }
 
+yb::Status GetProjectedColumns(
+    IntentAwareIterator *db_iter,
+    const GetSubDocumentData& data,
+    const std::vector<PrimitiveValue>& projection,
+    const ProjectedColumnCallback& column_callback) {
+  *data.doc_found = false;
+  DocHybridTime max_overwrite_ht(DocHybridTime::kMin);
+  const Slice key_slice = data.subdocument_key;
+  auto dockey_size = VERIFY_RESULT(DocKey::EncodedSize(key_slice, DocKeyPart::WHOLE_DOC_KEY));
+  SCHECK_EQ(dockey_size, key_slice.size(), InvalidArgument,
+            "Projected columns could be read only for a whole document");
+
+  RETURN_NOT_OK(CheckTableTombstone(db_iter, data, key_slice, &max_overwrite_ht));
+
+  IntentAwareIteratorPrefixScope prefix_scope(key_slice, db_iter);
+  db_iter->SeekForward(key_slice);
+  Value doc_value = Value(PrimitiveValue(ValueType::kInvalid));
+  RETURN_NOT_OK(FindLastWriteTime(db_iter, key_slice, &max_overwrite_ht, &data.exp, &doc_value));
+
+  // Packed row is looked up before the first regular column, since system columns precede them.
+  bool packed_row_checked = false;
+  boost::optional<DocPackedRow> packed_row;
+  DocHybridTime columns_low_ts = max_overwrite_ht;
+
+  KeyBytes key_bytes;
+  key_bytes.Reserve(key_slice.size() + kMaxBytesPerEncodedHybridTime + 32);
+  key_bytes.AppendRawBytes(key_slice);
+  ProjectedColumnValue column_value;
+  for (size_t i = 0; i != projection.size(); ++i) {
+    const PrimitiveValue& subkey = projection[i];
+    if (!packed_row_checked && subkey.value_type() == ValueType::kColumnId) {
+      packed_row_checked = true;
+      RETURN_NOT_OK(FindPackedRow(db_iter, key_slice, max_overwrite_ht, data, &packed_row));
+      if (packed_row) {
+        columns_low_ts = packed_row->write_time();
+      }
+    }
+    // See GetSubDocument for why the extra space is reserved.
+    subkey.AppendToKey(&key_bytes);
+    key_bytes.Reserve(key_bytes.size() + kMaxBytesPerEncodedHybridTime + 1);
+    {
+      IntentAwareIteratorPrefixScope column_prefix_scope(key_bytes, db_iter);
+      db_iter->SeekForward(&key_bytes);
+      bool found = VERIFY_RESULT(ReadColumnValue(
+          db_iter, key_bytes, columns_low_ts, data.exp, packed_row.get_ptr(), data.deadline_info,
+          &column_value));
+      if (!found && packed_row) {
+        // Column was not updated after the row was packed.
+        if (packed_row->EncodedColumnValue(subkey, db_iter->read_time().read, &column_value)) {
+          *data.doc_found = true;
+          RETURN_NOT_OK(column_callback(i, column_value));
+        }
+      } else if (found && !column_value.encoded_value.empty()) {
+        *data.doc_found = true;
+        RETURN_NOT_OK(column_callback(i, column_value));
+      }
+    }
+    key_bytes.Truncate(key_slice.size());
+  }
+
+  // Make sure the iterator is placed outside the whole document in the end.
+  key_bytes.AppendValueType(ValueType::kMaxByte);
+  db_iter->SeekForward(&key_bytes);
+  return Status::OK();
+}
+
 // Note: Do not use if also retrieving other value, as some work will be repeated.
 // Assumes every value has a TTL, and the TTL is stored in the row with this key.
 // Also observe that tombstone checking only works because we assume the key has
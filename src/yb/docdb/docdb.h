@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include <boost/function.hpp>
+#include <boost/optional.hpp>
 
 #include "yb/docdb/docdb_fwd.h"
 #include "yb/rocksdb/db.h"
@@ -376,6 +377,14 @@ struct GetSubDocumentData {
   // Hybrid time of latest table tombstone.  Used by colocated tables to compare with the write
   // times of records belonging to the table.
   DocHybridTime* table_tombstone_time;
+  // Set when a record of subdocument_key itself, not older than the lower time bound, was found,
+  // together with the user timestamp of this record. Used to check whether the value of a column
+  // in a packed row was overridden, e.g. by a tombstone.
+  mutable bool found_own_record = false;
+  mutable UserTimeMicros own_record_user_timestamp = Value::kInvalidUserTimestamp;
+  // Schema version used by the reader. Packed rows written with a newer schema version are
+  // rejected, because the reader could not interpret their columns.
+  boost::optional<uint32_t> schema_version;
 
   GetSubDocumentData Adjusted(
       const Slice& subdoc_key, SubDocument* result_, bool* doc_found_ = nullptr) const {
@@ -388,6 +397,7 @@ struct GetSubDocumentData {
     result.low_index = low_index;
     result.high_index = high_index;
     result.limit = limit;
+    result.schema_version = schema_version;
     return result;
   }
 
@@ -448,6 +458,33 @@ yb::Status GetSubDocument(
     const std::vector<PrimitiveValue>* projection = nullptr,
     SeekFwdSuffices seek_fwd_suffices = SeekFwdSuffices::kTrue);
 
+// Value of a column read by GetProjectedColumns.
+struct ProjectedColumnValue {
+  // Column value in value encoding, without control fields, see PrimitiveValue::DecodeFromValue.
+  // Points into the iterator or the packed row, so it is valid only during the callback.
+  Slice encoded_value;
+  // Remaining TTL in seconds, or -1 if the value does not expire.
+  int64_t ttl_seconds;
+  // User supplied timestamp of the write, or its physical time in microseconds.
+  int64_t write_time;
+};
+
+// Invoked by GetProjectedColumns for each projected column that has a value, with the index of the
+// column in the projection and its value. So the caller could decode the value straight to the
+// format it needs, e.g. with PrimitiveValue::DecodeToQLValuePB.
+typedef boost::function<Status(size_t, const ProjectedColumnValue&)> ProjectedColumnCallback;
+
+// Same as GetSubDocument with projection, but for projections where every column is stored as a
+// single value, i.e. does not have subkeys. Each column value is resolved in place from the
+// iterator (overwrites, tombstones, TTL and packed rows) and passed to column_callback, instead of
+// building the SubDocument tree. data.subdocument_key should be a DocKey, data.result is not used.
+// *data.doc_found is set to true if any projected column exists or the row was packed.
+yb::Status GetProjectedColumns(
+    IntentAwareIterator *db_iter,
+    const GetSubDocumentData& data,
+    const std::vector<PrimitiveValue>& projection,
+    const ProjectedColumnCallback& column_callback);
+
 // This version of GetSubDocument creates a new iterator every time. This is not recommended for
 // multiple calls to subdocs that are sequential or near each other, in e.g. doc_rowwise_iterator.
 // low_subkey and high_subkey are optional ranges that we can specify for the subkeys to ensure
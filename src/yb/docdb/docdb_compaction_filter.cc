@@ -18,11 +18,13 @@
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/string_util.h"
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -34,18 +36,40 @@ using rocksdb::CompactionFilter;
 using rocksdb::VectorToString;
 using rocksdb::FilterDecision;
 
+DEFINE_bool(docdb_drop_expired_sst_files, true,
+            "Whether SST files of tables with default TTL, whose records are all expired, should "
+            "be dropped without reading them.");
+TAG_FLAG(docdb_drop_expired_sst_files, runtime);
+
+DEFINE_bool(docdb_compaction_merge_packed_rows, true,
+            "Whether major compactions should merge column records, written after a packed row "
+            "at or below the history cutoff, into the packed row.");
+TAG_FLAG(docdb_compaction_merge_packed_rows, runtime);
+
 namespace yb {
 namespace docdb {
 
+namespace {
+
+const std::string& EncodedPackedRowSubKey() {
+  static const std::string result =
+      PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow).ToKeyBytes().data();
+  return result;
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(
     HistoryRetentionDirective retention,
     IsMajorCompaction is_major_compaction,
-    const KeyBounds* key_bounds)
+    const KeyBounds* key_bounds,
+    MergePackedRowValues merge_packed_row_values)
     : retention_(std::move(retention)),
       key_bounds_(key_bounds),
-      is_major_compaction_(is_major_compaction) {
+      is_major_compaction_(is_major_compaction),
+      merge_packed_row_values_(merge_packed_row_values) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -103,6 +127,19 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   RETURN_NOT_OK(SubDocKey::DecodeDocKeyAndSubKeyEnds(key, &sub_key_ends_));
   const size_t new_stack_size = sub_key_ends_.size();
 
+  if (packed_row_) {
+    if (Slice(key.data(), sub_key_ends_[0]) != packed_row_->doc_key) {
+      if (packed_row_->merging && packed_row_->output_delayed) {
+        // Packed row is written by the compaction before the next output record.
+        completing_packed_row_ = std::move(packed_row_);
+      }
+      packed_row_.reset();
+    } else if (packed_row_->merging && !packed_row_->output_delayed) {
+      // Compaction did not delay output of the packed row, so it could not be updated anymore.
+      packed_row_->merging = false;
+    }
+  }
+
   // Remove overwrite hybrid_times for components that are no longer relevant for the current
   // SubDocKey.
   overwrite_.resize(min(overwrite_.size(), num_shared_components));
@@ -154,6 +191,12 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
     return FilterDecision::kDiscard;
   }
 
+  // Column records written before the packed row of the row are not visible.
+  if (packed_row_ && !isTtlRow && ht < packed_row_->doc_ht && sub_key_ends_.size() > 1 &&
+      key[sub_key_ends_[0]] == ValueTypeAsChar::kColumnId) {
+    return FilterDecision::kDiscard;
+  }
+
   // Every subdocument was fully overwritten at least at the time any of its parents was fully
   // overwritten.
   if (overwrite_.size() < new_stack_size - 1) {
@@ -234,6 +277,13 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   }
   AssignPrevSubDocKey(key.cdata(), same_bytes);
 
+  if (value_type == ValueType::kPackedRow && IsPackedRowKey(key)) {
+    // The latest packed row of the row at or below the history cutoff.
+    packed_row_.emplace();
+    packed_row_->doc_key.assign(key.cdata(), sub_key_ends_[0]);
+    packed_row_->doc_ht = ht;
+  }
+
   // If the entry has the TTL flag, delete the entry.
   if (isTtlRow) {
     within_merge_block_ = true;
@@ -257,7 +307,9 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
     // This is consistent with the condition we're testing for deletes at the bottom of the function
     // because ht_at_or_below_cutoff is implied by has_expired.
     if (is_major_compaction_ && !retention_.retain_delete_markers_in_major_compaction) {
-      return FilterDecision::kDiscard;
+      return HandlePackedRow(
+          key, ht, existing_value, expiration, FilterDecision::kDiscard, new_value,
+          value_changed);
     }
 
     // During minor compactions, expired values are written back as tombstones because removing the
@@ -294,10 +346,149 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   // compactions. However, we do need to update the overwrite hybrid time stack in this case (as we
   // just did), because this deletion (tombstone) entry might be the only reason for cleaning up
   // more entries appearing at earlier hybrid times.
-  return value_type == ValueType::kTombstone && is_major_compaction_ &&
-                 !retention_.retain_delete_markers_in_major_compaction
-             ? FilterDecision::kDiscard
-             : FilterDecision::kKeep;
+  return HandlePackedRow(
+      key, ht, existing_value, expiration,
+      value_type == ValueType::kTombstone && is_major_compaction_ &&
+          !retention_.retain_delete_markers_in_major_compaction
+              ? FilterDecision::kDiscard
+              : FilterDecision::kKeep,
+      new_value, value_changed);
+}
+
+Result<FilterDecision> DocDBCompactionFilter::HandlePackedRow(
+    const Slice& key, DocHybridTime ht, const Slice& existing_value, Expiration expiration,
+    FilterDecision decision, std::string* new_value, bool* value_changed) {
+  if (!packed_row_) {
+    return decision;
+  }
+
+  if (IsPackedRowKey(key)) {
+    // The packed row itself.
+    if (decision == FilterDecision::kKeep && !*value_changed && is_major_compaction_ &&
+        FLAGS_docdb_compaction_merge_packed_rows && expiration.ttl == Value::kMaxTtl &&
+        retention_.table_ttl.Equals(Value::kMaxTtl)) {
+      RETURN_NOT_OK(StartPackedRowMerge(key, existing_value));
+    }
+    return decision;
+  }
+
+  // Only column records could override values of the packed row. Subkeys of collections are not
+  // merged, packed rows are not used for tables with such columns.
+  if (sub_key_ends_.size() != 2 || key[sub_key_ends_[0]] != ValueTypeAsChar::kColumnId) {
+    return decision;
+  }
+
+  ValueType value_type;
+  MonoDelta ttl;
+  UserTimeMicros user_timestamp;
+  RETURN_NOT_OK(Value::DecodePrimitiveValueType(
+      existing_value, &value_type, nullptr /* merge_flags */, &ttl, &user_timestamp));
+  // See DocPackedRow in docdb.cc, readers ignore such records.
+  if (user_timestamp != Value::kInvalidUserTimestamp &&
+      user_timestamp < packed_row_->doc_ht.hybrid_time().GetPhysicalValueMicros()) {
+    return decision;
+  }
+
+  Slice column_id_slice(key.data() + sub_key_ends_[0] + 1, key.data() + sub_key_ends_[1]);
+  ColumnId column_id;
+  RETURN_NOT_OK(ColumnId::FromInt64(
+      VERIFY_RESULT(util::FastDecodeSignedVarInt(&column_id_slice)), &column_id));
+
+  if (decision == FilterDecision::kDiscard) {
+    // Column was deleted or has expired.
+    if (packed_row_->merging) {
+      packed_row_->changed = packed_row_->columns.erase(column_id) != 0 || packed_row_->changed;
+      return decision;
+    }
+    // Packed row is written as is, so the tombstone is required to override its value.
+    *new_value = Value::EncodedTombstone();
+    *value_changed = true;
+    return FilterDecision::kKeep;
+  }
+
+  if (packed_row_->merging && merge_packed_row_values_ && !*value_changed &&
+      ttl == Value::kMaxTtl &&
+      user_timestamp == Value::kInvalidUserTimestamp && IsPrimitiveValueType(value_type) &&
+      value_type != ValueType::kTombstone) {
+    Slice encoded_value = existing_value;
+    Value value;
+    RETURN_NOT_OK(value.DecodeControlFields(&encoded_value));
+    packed_row_->columns[column_id] = encoded_value.ToBuffer();
+    packed_row_->changed = true;
+    return FilterDecision::kDiscard;
+  }
+
+  return decision;
+}
+
+Status DocDBCompactionFilter::StartPackedRowMerge(const Slice& key, const Slice& existing_value) {
+  Value value;
+  RETURN_NOT_OK(value.Decode(existing_value));
+  auto packed_row = VERIFY_RESULT(PackedRow::Decode(value.primitive_value().GetPackedRow()));
+  Slice encoded_value = existing_value;
+  Value control_fields;
+  RETURN_NOT_OK(control_fields.DecodeControlFields(&encoded_value));
+  packed_row_->control_fields.assign(existing_value.cdata(), encoded_value.cdata());
+  packed_row_->merging = true;
+  packed_row_->key.assign(key.cdata(), key.size());
+  packed_row_->schema_version = packed_row.schema_version();
+  packed_row.ForEachColumn([this](ColumnId column_id, const Slice& encoded_value) {
+    // Values of deleted columns are removed from the packed row.
+    if (retention_.deleted_cols->count(column_id)) {
+      packed_row_->changed = true;
+    } else {
+      packed_row_->columns.emplace(column_id, encoded_value.ToBuffer());
+    }
+  });
+  return Status::OK();
+}
+
+bool DocDBCompactionFilter::DelayOutput(const Slice& user_key) {
+  if (!packed_row_ || !packed_row_->merging || packed_row_->output_delayed ||
+      user_key != packed_row_->key) {
+    return false;
+  }
+  packed_row_->output_delayed = true;
+  return true;
+}
+
+void DocDBCompactionFilter::CompleteDelayedOutput(std::string* value) {
+  auto& packed_row = completing_packed_row_ ? completing_packed_row_ : packed_row_;
+  DCHECK(packed_row && packed_row->merging && packed_row->output_delayed);
+  if (!packed_row) {
+    return;
+  }
+  packed_row->merging = false;
+  const bool changed = packed_row->changed;
+  std::map<ColumnId, std::string> columns;
+  columns.swap(packed_row->columns);
+  const auto schema_version = packed_row->schema_version;
+  std::string control_fields;
+  control_fields.swap(packed_row->control_fields);
+  completing_packed_row_.reset();
+  if (!changed) {
+    return;
+  }
+  if (!Slice(*value).starts_with(control_fields)) {
+    // Should not happen, the value is kept unchanged after the merge is started. Output the
+    // original record in this case, as done for other values that could not be decoded.
+    LOG(DFATAL) << "Delayed packed row value does not match the merged one: "
+                << Slice(*value).ToDebugHexString();
+    return;
+  }
+  RowPacker packer(schema_version);
+  for (const auto& column : columns) {
+    packer.AddEncodedValue(column.first, column.second);
+  }
+  // Control fields of the packed row are preserved.
+  value->resize(control_fields.size());
+  value->append(packer.Complete().ToValue());
+}
+
+bool DocDBCompactionFilter::IsPackedRowKey(const Slice& key) const {
+  return sub_key_ends_.size() == 2 &&
+         Slice(key.data() + sub_key_ends_[0], key.data() + sub_key_ends_[1]) ==
+             EncodedPackedRowSubKey();
 }
 
 void DocDBCompactionFilter::AssignPrevSubDocKey(
@@ -321,8 +512,10 @@ const char* DocDBCompactionFilter::Name() const {
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds)
-    : retention_policy_(std::move(retention_policy)), key_bounds_(key_bounds) {
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds,
+    MergePackedRowValues merge_packed_row_values)
+    : retention_policy_(std::move(retention_policy)), key_bounds_(key_bounds),
+      merge_packed_row_values_(merge_packed_row_values) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -333,7 +526,34 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
   return std::make_unique<DocDBCompactionFilter>(
       retention_policy_->GetRetentionDirective(),
       IsMajorCompaction(context.is_full_compaction),
-      key_bounds_);
+      key_bounds_,
+      merge_packed_row_values_);
+}
+
+unique_ptr<rocksdb::CompactionFileFilter>
+    DocDBCompactionFilterFactory::CreateCompactionFileFilter(bool for_compaction) {
+  if (!FLAGS_docdb_drop_expired_sst_files) {
+    return nullptr;
+  }
+  // History cutoff should be committed only when files are actually dropped. It is not decreased,
+  // so files expired at the proposed cutoff are also expired at the committed one.
+  auto retention = for_compaction ? retention_policy_->GetRetentionDirective()
+                                  : retention_policy_->ProposedRetentionDirective();
+  if (!retention.history_cutoff.is_valid() || retention.history_cutoff == HybridTime::kMin ||
+      retention.table_ttl.Equals(Value::kMaxTtl)) {
+    return nullptr;
+  }
+  return std::make_unique<DocDBCompactionFileFilter>(std::move(retention));
+}
+
+Slice DocDBCompactionFilterFactory::SubcompactionBoundary(const Slice& user_key) {
+  // The filter drops records overridden by tombstones of the same row, so a row should not be split
+  // between subcompactions.
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return Slice();
+  }
+  return Slice(user_key.data(), *doc_key_size);
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
@@ -342,6 +562,99 @@ const char* DocDBCompactionFilterFactory::Name() const {
 
 // ------------------------------------------------------------------------------------------------
 
+DocDBCompactionFileFilter::DocDBCompactionFileFilter(HistoryRetentionDirective retention)
+    : retention_(std::move(retention)) {
+}
+
+FilterDecision DocDBCompactionFileFilter::Filter(const rocksdb::UserFrontier* largest_frontier) {
+  if (!largest_frontier) {
+    return FilterDecision::kKeep;
+  }
+  const auto& frontier = down_cast<const ConsensusFrontier&>(*largest_frontier);
+  if (!frontier.hybrid_time().is_valid()) {
+    return FilterDecision::kKeep;
+  }
+  auto value_level_expiration = frontier.max_value_level_ttl_expiration_time();
+  if (value_level_expiration.is_valid() && value_level_expiration > retention_.history_cutoff) {
+    return FilterDecision::kKeep;
+  }
+  bool has_expired = false;
+  auto status = HasExpiredTTL(
+      frontier.hybrid_time(), retention_.table_ttl, retention_.history_cutoff, &has_expired);
+  if (!status.ok() || !has_expired) {
+    return FilterDecision::kKeep;
+  }
+  VLOG(2) << "Expired file, frontier: " << frontier.ToString() << ", history cutoff: "
+          << retention_.history_cutoff << ", table TTL: " << retention_.table_ttl;
+  return FilterDecision::kDiscard;
+}
+
+namespace {
+
+class ValueLevelTtlExpirationCalculator : public rocksdb::WriteBatch::Handler {
+ public:
+  explicit ValueLevelTtlExpirationCalculator(HybridTime write_time) : write_time_(write_time) {}
+
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    Value decoded_value;
+    Slice control_fields = value;
+    if (!decoded_value.DecodeControlFields(&control_fields).ok()) {
+      // Could not determine TTL of this record, so assume that it never expires.
+      result_ = HybridTime::kMax;
+      return Status::OK();
+    }
+    if (!decoded_value.has_ttl()) {
+      return Status::OK();
+    }
+    const auto& ttl = decoded_value.ttl();
+    if (ttl.Equals(Value::kResetTtl)) {
+      result_ = HybridTime::kMax;
+      return Status::OK();
+    }
+    auto expiration = write_time_.AddDelta(ttl);
+    result_.MakeAtLeast(expiration < write_time_ ? HybridTime::kMax : expiration);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Frontiers(const rocksdb::UserFrontiers& frontiers) override {
+    return Status::OK();
+  }
+
+  bool Continue() override {
+    return result_ != HybridTime::kMax;
+  }
+
+  HybridTime result() const { return result_; }
+
+ private:
+  const HybridTime write_time_;
+  HybridTime result_;
+};
+
+} // namespace
+
+HybridTime MaxValueLevelTtlExpirationTime(
+    const rocksdb::WriteBatch& write_batch, HybridTime write_time) {
+  if (!write_time.is_valid()) {
+    return HybridTime::kMax;
+  }
+  ValueLevelTtlExpirationCalculator calculator(write_time);
+  if (!write_batch.Iterate(&calculator).ok()) {
+    return HybridTime::kMax;
+  }
+  return calculator.result();
+}
+
+// ------------------------------------------------------------------------------------------------
+
 HistoryRetentionDirective ManualHistoryRetentionPolicy::GetRetentionDirective() {
   std::lock_guard<std::mutex> lock(deleted_cols_mtx_);
   return {history_cutoff_.load(std::memory_order_acquire),
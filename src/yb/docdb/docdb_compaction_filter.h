@@ -15,16 +15,19 @@
 #define YB_DOCDB_DOCDB_COMPACTION_FILTER_H
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <vector>
 
 #include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
 
 #include "yb/gutil/thread_annotations.h"
 #include "yb/util/strongly_typed_bool.h"
 
 #include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/write_batch.h"
 
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
@@ -37,6 +40,9 @@ namespace docdb {
 
 YB_STRONGLY_TYPED_BOOL(IsMajorCompaction);
 YB_STRONGLY_TYPED_BOOL(ShouldRetainDeleteMarkersInMajorCompaction);
+// Whether values of column records could be merged into packed rows. Merged column gets write time
+// of the packed row, so it is not done for YCQL tables, where column write time is visible.
+YB_STRONGLY_TYPED_BOOL(MergePackedRowValues);
 
 struct Expiration;
 
@@ -63,7 +69,8 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   DocDBCompactionFilter(
       HistoryRetentionDirective retention,
       IsMajorCompaction is_major_compaction,
-      const KeyBounds* key_bounds);
+      const KeyBounds* key_bounds,
+      MergePackedRowValues merge_packed_row_values = MergePackedRowValues::kTrue);
 
   ~DocDBCompactionFilter() override;
   rocksdb::FilterDecision Filter(
@@ -80,6 +87,11 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   // ConsensusFrontier, so that it can be persisted in RocksDB metadata and recovered on bootstrap.
   rocksdb::UserFrontierPtr GetLargestUserFrontier() const override;
 
+  // Output of a packed row that is merged with newer column records is delayed until all records
+  // of the row are processed.
+  bool DelayOutput(const Slice& user_key) override;
+  void CompleteDelayedOutput(std::string* value) override;
+
  private:
   // Assigns prev_subdoc_key_ from memory addressed by data. The length of key is taken from
   // sub_key_ends_ and same_bytes are reused.
@@ -90,9 +102,22 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
       int level, const Slice& key, const Slice& existing_value, std::string* new_value,
       bool* value_changed);
 
+  // Updates decision made for a record at or below the history cutoff, taking into account the
+  // packed row of the row that is being compacted. See packed_row_ for details.
+  Result<rocksdb::FilterDecision> HandlePackedRow(
+      const Slice& key, DocHybridTime ht, const Slice& existing_value, Expiration expiration,
+      rocksdb::FilterDecision decision, std::string* new_value, bool* value_changed);
+
+  // Returns true if the key, that was just decoded into sub_key_ends_, is a key of packed row.
+  bool IsPackedRowKey(const Slice& key) const;
+
+  // Starts merging newer column records into the packed row stored in the value.
+  CHECKED_STATUS StartPackedRowMerge(const Slice& key, const Slice& existing_value);
+
   const HistoryRetentionDirective retention_;
   const KeyBounds* key_bounds_;
   const IsMajorCompaction is_major_compaction_;
+  const MergePackedRowValues merge_packed_row_values_;
 
   std::vector<char> prev_subdoc_key_;
 
@@ -142,32 +167,94 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
 
   std::vector<OverwriteData> overwrite_;
 
+  // The latest packed row, written at or below the history cutoff, of the row that is being
+  // compacted. Column records written before it are not visible, so they are removed.
+  //
+  // During a major compaction, column records written after it at or below the history cutoff are
+  // merged into it: output of the packed row is delayed, values of the columns are moved to the
+  // packed row, and deleted or expired columns are removed from it. Column records could not be
+  // merged into the packed row, when its output was not delayed or was already completed, in this
+  // case tombstones that override its values are kept.
+  struct PackedRowData {
+    // Encoded document key of the row.
+    std::string doc_key;
+    DocHybridTime doc_ht;
+
+    // Whether the packed row is being merged with column records.
+    bool merging = false;
+    bool output_delayed = false;
+    bool changed = false;
+    // Key of the packed row record.
+    std::string key;
+    uint32_t schema_version = 0;
+    // Encoded control fields of the packed row value, preserved when the row is repacked.
+    std::string control_fields;
+    // Encoded values of the columns.
+    std::map<ColumnId, std::string> columns;
+  };
+
+  boost::optional<PackedRowData> packed_row_;
+  // Packed row of the previous row, that is still being merged, because its output was not
+  // completed yet.
+  boost::optional<PackedRowData> completing_packed_row_;
+
   // We use this to only log a message that the filter is being used once on the first call to
   // the Filter function.
   bool filter_usage_logged_ = false;
   bool within_merge_block_ = false;
 };
 
+// Drops whole SST files of a table with default TTL, when all records of the file are expired at
+// the history cutoff. Expiration is determined using the largest ConsensusFrontier of the file:
+// its hybrid time plus table TTL, and maximal expiration time of records with value level TTL.
+class DocDBCompactionFileFilter : public rocksdb::CompactionFileFilter {
+ public:
+  explicit DocDBCompactionFileFilter(HistoryRetentionDirective retention);
+
+  rocksdb::FilterDecision Filter(const rocksdb::UserFrontier* largest_frontier) override;
+
+ private:
+  const HistoryRetentionDirective retention_;
+};
+
+// Returns maximal expiration time of records with explicit value level TTL in the write batch,
+// assuming that all of them were written at write_time. Returns invalid hybrid time when there
+// are no such records, and kMax when some record never expires.
+HybridTime MaxValueLevelTtlExpirationTime(
+    const rocksdb::WriteBatch& write_batch, HybridTime write_time);
+
 // A strategy for deciding how the history of old database operations should be retained during
 // compactions. We may implement this differently in production and in tests.
 class HistoryRetentionPolicy {
  public:
   virtual ~HistoryRetentionPolicy() = default;
+
+  // Returns directive for a compaction. History cutoff of the returned directive is considered
+  // committed, i.e. reads below it are not allowed after this call.
   virtual HistoryRetentionDirective GetRetentionDirective() = 0;
+
+  // Returns directive that GetRetentionDirective would return now, but does not commit its
+  // history cutoff. Used to check whether compaction is needed.
+  virtual HistoryRetentionDirective ProposedRetentionDirective() = 0;
 };
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(
-      std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds);
+  DocDBCompactionFilterFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds,
+      MergePackedRowValues merge_packed_row_values = MergePackedRowValues::kTrue);
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
+  std::unique_ptr<rocksdb::CompactionFileFilter> CreateCompactionFileFilter(
+      bool for_compaction) override;
+  Slice SubcompactionBoundary(const Slice& user_key) override;
   const char* Name() const override;
 
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
   const KeyBounds* key_bounds_;
+  const MergePackedRowValues merge_packed_row_values_;
 };
 
 // A history retention policy that can be configured manually. Useful in tests. This class is
@@ -176,6 +263,10 @@ class ManualHistoryRetentionPolicy : public HistoryRetentionPolicy {
  public:
   HistoryRetentionDirective GetRetentionDirective() override;
 
+  HistoryRetentionDirective ProposedRetentionDirective() override {
+    return GetRetentionDirective();
+  }
+
   void SetHistoryCutoff(HybridTime history_cutoff);
 
   void AddDeletedColumn(ColumnId col);
@@ -21,6 +21,7 @@ namespace docdb {
 
 class ConsensusFrontier;
 class DocPath;
+class DocDBStatistics;
 class DocWriteBatch;
 class IntentAwareIterator;
 class KeyValueWriteBatchPB;
@@ -28,6 +29,7 @@ class QLWriteOperation;
 class PgsqlWriteOperation;
 
 struct DocDB;
+struct ProjectedColumnValue;
 
 YB_STRONGLY_TYPED_BOOL(PartialRangeKeyIntents);
 
@@ -13,9 +13,11 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
 #include <thread>
 #include <memory>
 
+#include "yb/common/schema.h"
 #include "yb/common/transaction.h"
 
 #include "yb/rocksdb/memtablerep.h"
@@ -71,6 +73,9 @@ DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximum number of key range subcompactions a large compaction is split into. "
+             "Subcompactions run in parallel in the priority thread pool.");
 DEFINE_int32(rocksdb_max_write_buffer_number, 2,
              "Maximum number of write buffers that are built up in memory.");
 
@@ -94,6 +99,11 @@ DEFINE_int32(memstore_size_mb, 128,
 
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_int32(range_key_bloom_filter_components, -1,
+             "Number of leading range key components used by bloom filters of range partitioned "
+             "tables. -1 to use all range key components, 0 to use bloom filters for hash "
+             "partitioned tables only. Overridden by the bloom_filter_range_components table "
+             "property.");
 DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
@@ -107,6 +117,10 @@ DEFINE_int32(num_reserved_small_compaction_threads, -1, "Number of reserved smal
 DEFINE_bool(enable_ondisk_compression, true,
             "Determines whether SSTable compression is enabled or not.");
 
+DEFINE_string(db_compression_type, "snappy",
+              "Compression of SST files of tables that do not set compression in their table "
+              "properties: none, snappy, lz4, zstd or zlib.");
+
 DEFINE_int32(priority_thread_pool_size, -1,
              "Max running workers in compaction thread pool. "
              "If -1 and max_background_compactions is specified - use max_background_compactions. "
@@ -260,6 +274,38 @@ namespace {
 
 std::mutex rocksdb_flags_mutex;
 
+rocksdb::CompressionType CompressionTypeFromString(const std::string& name) {
+  static const std::pair<const char*, rocksdb::CompressionType> kNames[] = {
+    {"none", rocksdb::kNoCompression},
+    {"snappy", rocksdb::kSnappyCompression},
+    {"lz4", rocksdb::kLZ4Compression},
+    {"zstd", rocksdb::kZSTDNotFinalCompression},
+    {"zlib", rocksdb::kZlibCompression},
+  };
+  for (const auto& entry : kNames) {
+    if (name == entry.first) {
+      return entry.second;
+    }
+  }
+  LOG(DFATAL) << "Unknown SST compression type: " << name;
+  return rocksdb::kSnappyCompression;
+}
+
+// Falls back to Snappy, or to no compression, if the requested codec is not available in this
+// build.
+rocksdb::CompressionType SupportedCompressionType(
+    rocksdb::CompressionType type, const std::string& log_prefix) {
+  if (rocksdb::CompressionTypeSupported(type)) {
+    return type;
+  }
+  auto fallback = rocksdb::Snappy_Supported() ? rocksdb::kSnappyCompression
+                                              : rocksdb::kNoCompression;
+  YB_LOG_EVERY_N_SECS(WARNING, 60)
+      << log_prefix << rocksdb::CompressionTypeToString(type) << " compression is not supported "
+      << "by this build, using " << rocksdb::CompressionTypeToString(fallback);
+  return fallback;
+}
+
 // Auto initialize some of the RocksDB flags that are defaulted to -1.
 void AutoInitRocksDBFlags(rocksdb::Options* options) {
   const int kNumCpus = base::NumCPUs();
@@ -373,8 +419,105 @@ rocksdb::InternalIterator* WrapIterator(
   return iterator;
 }
 
+// Returns the codec of the table compression, or none if the table uses the default compression.
+Result<boost::optional<rocksdb::CompressionType>> TableCompressionType(
+    TableCompressionPB compression) {
+  switch (compression) {
+    case TableCompressionPB::TABLE_COMPRESSION_DEFAULT:
+      return boost::none;
+    case TableCompressionPB::TABLE_COMPRESSION_NONE:
+      return rocksdb::kNoCompression;
+    case TableCompressionPB::TABLE_COMPRESSION_SNAPPY:
+      return rocksdb::kSnappyCompression;
+    case TableCompressionPB::TABLE_COMPRESSION_LZ4:
+      return rocksdb::kLZ4Compression;
+    case TableCompressionPB::TABLE_COMPRESSION_ZSTD:
+      return rocksdb::kZSTDNotFinalCompression;
+    case TableCompressionPB::TABLE_COMPRESSION_ZLIB:
+      return rocksdb::kZlibCompression;
+  }
+  return STATUS_FORMAT(
+      InvalidArgument, "Unknown table compression: $0", static_cast<int>(compression));
+}
+
+} // namespace
+
+Status CheckTableCompressionSupported(const TableProperties& table_properties) {
+  auto type = VERIFY_RESULT(TableCompressionType(table_properties.compression()));
+  if (type && !rocksdb::CompressionTypeSupported(*type)) {
+    return STATUS_FORMAT(
+        InvalidArgument, "$0 compression is not supported",
+        rocksdb::CompressionTypeToString(*type));
+  }
+  return Status::OK();
+}
+
+void SetTableCompressionOptions(
+    const TableProperties& table_properties, const std::string& log_prefix,
+    rocksdb::Options* options) {
+  if (table_properties.compression_level()) {
+    options->compression_opts.level = *table_properties.compression_level();
+  }
+  auto type = TableCompressionType(table_properties.compression());
+  if (!type.ok()) {
+    LOG(DFATAL) << log_prefix << type.status();
+    return;
+  }
+  if (*type) {
+    // Tables with unsupported compression are rejected by the master, so fallback could happen only
+    // for tables created before, or when tablet servers are built without the codec.
+    options->compression = SupportedCompressionType(**type, log_prefix);
+  }
+}
+
+namespace {
+
+// Returns the number of range components that bloom filters of the table should be built on,
+// according to its table properties and flags.
+size_t ConfiguredBloomFilterRangeComponents(const Schema& schema) {
+  if (!FLAGS_use_docdb_aware_bloom_filter || schema.num_hash_key_columns() != 0 ||
+      schema.has_cotable_id() || schema.has_pgtable_id()) {
+    return 0;
+  }
+  const auto& table_value = schema.table_properties().bloom_filter_range_components();
+  const int32_t value = table_value ? *table_value : FLAGS_range_key_bloom_filter_components;
+  if (value == 0) {
+    return 0;
+  }
+  if (value < 0) {
+    return schema.num_range_key_columns();
+  }
+  return std::min<size_t>(value, schema.num_range_key_columns());
+}
+
 } // namespace
 
+size_t BloomFilterRangeComponents(rocksdb::DB* db) {
+  auto* table_options = static_cast<rocksdb::BlockBasedTableOptions*>(
+      db->GetOptions().table_factory->GetOptions());
+  if (!table_options) {
+    return 0;
+  }
+  auto* policy = dynamic_cast<const DocDbAwareFilterPolicy*>(table_options->filter_policy.get());
+  return policy ? policy->max_range_components() : 0;
+}
+
+void SetTableBloomFilterOptions(const Schema& schema, rocksdb::Options* options) {
+  auto num_range_components = ConfiguredBloomFilterRangeComponents(schema);
+  if (num_range_components == 0) {
+    return;
+  }
+  auto* table_options = static_cast<rocksdb::BlockBasedTableOptions*>(
+      options->table_factory->GetOptions());
+  if (!table_options) {
+    return;
+  }
+  rocksdb::BlockBasedTableOptions new_table_options = *table_options;
+  new_table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
+      new_table_options.filter_block_size * 8, options->info_log.get(), num_range_components));
+  options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(new_table_options));
+}
+
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& log_prefix,
     const shared_ptr<rocksdb::Statistics>& statistics,
@@ -405,8 +548,9 @@ void InitRocksDBOptions(
     options->num_reserved_small_compaction_threads = FLAGS_num_reserved_small_compaction_threads;
   }
 
-  options->compression = rocksdb::Snappy_Supported() && FLAGS_enable_ondisk_compression
-      ? rocksdb::kSnappyCompression : rocksdb::kNoCompression;
+  options->compression = FLAGS_enable_ondisk_compression
+      ? SupportedCompressionType(CompressionTypeFromString(FLAGS_db_compression_type), log_prefix)
+      : rocksdb::kNoCompression;
 
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
@@ -468,6 +612,7 @@ void InitRocksDBOptions(
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
+    options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
     if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
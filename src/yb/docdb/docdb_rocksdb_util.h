@@ -32,6 +32,10 @@
 #include "yb/util/slice.h"
 
 namespace yb {
+
+class Schema;
+class TableProperties;
+
 namespace docdb {
 
 class IntentAwareIterator;
@@ -77,6 +81,8 @@ enum class BloomFilterMode {
 // It is only allowed to use bloom filters on scans within the same hashed components of the key,
 // because BloomFilterAwareIterator relies on it and ignores SST file completely if there are no
 // keys with the same hashed components as key specified for seek operation.
+// For keys without hashed components, the scan should stay within the same first
+// BloomFilterRangeComponents(db) range components, see FilterKeyComponentsEqual.
 // Note: bloom_filter_mode should be specified explicitly to avoid using it incorrectly by default.
 // user_key_for_filter is used with BloomFilterMode::USE_BLOOM_FILTER to exclude SST files which
 // have the same hashed components as (Sub)DocKey encoded in user_key_for_filter.
@@ -113,6 +119,27 @@ void InitRocksDBOptions(
     const std::shared_ptr<rocksdb::Statistics>& statistics,
     const tablet::TabletOptions& tablet_options);
 
+// Returns an error if the compression set in the table properties is not supported by this build.
+CHECKED_STATUS CheckTableCompressionSupported(const TableProperties& table_properties);
+
+// Overrides the compression of 'options' with the compression set in the table properties, if any.
+// It is called when the tablet opens its RocksDB, so a compression changed by ALTER TABLE applies
+// to SST files written after the next tablet open, e.g. after a tablet server restart. Existing
+// files are rewritten with the new compression only by compactions.
+void SetTableCompressionOptions(
+    const TableProperties& table_properties, const std::string& log_prefix,
+    rocksdb::Options* options);
+
+// Returns the number of leading range components used by bloom filters installed to db, or 0 if
+// they are not built on range key components. Readers should use it instead of the table properties
+// or flags, that could have changed after the db was opened.
+size_t BloomFilterRangeComponents(rocksdb::DB* db);
+
+// Switches bloom filters of 'options' to range key components for range partitioned tables. The
+// number of components is taken from the bloom_filter_range_components table property, or from the
+// range_key_bloom_filter_components flag when the property is not set.
+void SetTableBloomFilterOptions(const Schema& schema, rocksdb::Options* options);
+
 // Sets logs prefix for RocksDB options. This will also reinitialize options->info_log.
 void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix);
 
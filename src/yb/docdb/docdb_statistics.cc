@@ -0,0 +1,47 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/docdb_statistics.h"
+
+namespace yb {
+namespace docdb {
+
+DocDBStatistics::DocDBStatistics()
+    : start_perf_context_(rocksdb::perf_context),
+      start_docdb_perf_context_(docdb_perf_context()) {
+}
+
+void DocDBStatistics::CopyToPB(DocDBStatsPB* stats) const {
+  const auto& perf_context = rocksdb::perf_context;
+  const auto& start = start_perf_context_;
+  stats->set_num_seeks(perf_context.iter_seek_count - start.iter_seek_count);
+  stats->set_num_nexts(
+      perf_context.iter_next_count - start.iter_next_count +
+      perf_context.iter_prev_count - start.iter_prev_count);
+  stats->set_num_skipped_entries(
+      perf_context.internal_key_skipped_count - start.internal_key_skipped_count +
+      perf_context.internal_delete_skipped_count - start.internal_delete_skipped_count);
+  stats->set_num_intents_scanned(
+      docdb_perf_context().intents_scanned - start_docdb_perf_context_.intents_scanned);
+  stats->set_block_cache_hits(perf_context.block_cache_hit_count - start.block_cache_hit_count);
+  stats->set_block_cache_misses(perf_context.block_read_count - start.block_read_count);
+  const auto bloom_useful = perf_context.bloom_sst_miss_count - start.bloom_sst_miss_count;
+  stats->set_bloom_checks(
+      perf_context.bloom_sst_hit_count - start.bloom_sst_hit_count + bloom_useful);
+  stats->set_bloom_useful(bloom_useful);
+  stats->set_sst_files_touched(
+      perf_context.new_table_iterator_count - start.new_table_iterator_count);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,59 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOCDB_STATISTICS_H
+#define YB_DOCDB_DOCDB_STATISTICS_H
+
+#include "yb/common/common.pb.h"
+
+#include "yb/rocksdb/perf_context.h"
+
+namespace yb {
+namespace docdb {
+
+// Thread local counters of DocDB operations, complementing rocksdb::perf_context.
+struct DocDBPerfContext {
+  // Number of intents examined by intent aware iterators.
+  uint64_t intents_scanned = 0;
+};
+
+inline DocDBPerfContext& docdb_perf_context() {
+  static thread_local DocDBPerfContext context;
+  return context;
+}
+
+// Collects storage level statistics of a read request, see DocDBStatsPB.
+//
+// Statistics are calculated from thread local counters, so the request should be executed by the
+// thread that created this object, between its creation and the call to CopyToPB.
+//
+// The counters are maintained whether statistics are requested or not. Each of them costs a thread
+// local increment per iterator operation, the same as other rocksdb::perf_context counters, while
+// requesting statistics only adds copies of the contexts. In builds with NPERF_CONTEXT the rocksdb
+// counters are compiled out, so the corresponding statistics are zero.
+class DocDBStatistics {
+ public:
+  DocDBStatistics();
+
+  // Fills stats with counters accumulated since this object was created.
+  void CopyToPB(DocDBStatsPB* stats) const;
+
+ private:
+  const rocksdb::PerfContext start_perf_context_;
+  const DocDBPerfContext start_docdb_perf_context_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_DOCDB_STATISTICS_H
@@ -18,12 +18,17 @@
 #include "yb/common/ql_value.h"
 #include "yb/common/transaction-test-util.h"
 
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_statistics.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
+
+#include "yb/rocksdb/statistics.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -32,6 +37,8 @@
 #include "yb/util/test_util.h"
 
 DECLARE_bool(docdb_sort_weak_intents_in_tests);
+DECLARE_bool(docdb_direct_row_decoding);
+DECLARE_int32(range_key_bloom_filter_components);
 
 namespace yb {
 namespace docdb {
@@ -48,6 +55,8 @@ class DocRowwiseIteratorTest : public DocDBTestBase {
   static const KeyBytes kEncodedDocKey2;
   static const Schema kSchemaForIteratorTests;
   static Schema kProjectionForIteratorTests;
+  static const PrimitiveValue kLivenessColumn;
+  static const PrimitiveValue kPackedRowColumn;
 
   void SetUp() override {
     FLAGS_docdb_sort_weak_intents_in_tests = true;
@@ -83,6 +92,12 @@ const Schema DocRowwiseIteratorTest::kSchemaForIteratorTests({
 
 Schema DocRowwiseIteratorTest::kProjectionForIteratorTests;
 
+const PrimitiveValue DocRowwiseIteratorTest::kLivenessColumn =
+    PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn);
+
+const PrimitiveValue DocRowwiseIteratorTest::kPackedRowColumn =
+    PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow);
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
   // Row 1
   // We don't need any seeks for writes, where column values are primitives.
@@ -1218,5 +1233,454 @@ TEST_F(DocRowwiseIteratorTest, ScanWithinTheSameTxn) {
   ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
 }
 
+TEST_F(DocRowwiseIteratorTest, SeekTupleForward) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  const KeyBytes missing_doc_key(DocKey(PrimitiveValues("row4", 44444)).Encode());
+
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key3, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row3_c"), HybridTime::FromMicros(1000)));
+
+  const Schema &projection = kProjectionForIteratorTests;
+  DocRowwiseIterator iter(
+      projection, kSchemaForIteratorTests, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  QLTableRow row;
+  QLValue value;
+
+  // Look up rows in key order, skipping row2, the way a batched index lookup does.
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTuple(kEncodedDocKey1.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ("row1_c", value.string_value());
+
+  row.Clear();
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTupleForward(encoded_doc_key3.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ("row3_c", value.string_value());
+
+  ASSERT_FALSE(ASSERT_RESULT(iter.SeekTupleForward(missing_doc_key.AsSlice())));
+
+  // A regular seek can move the iterator back.
+  row.Clear();
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTuple(kEncodedDocKey2.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ("row2_c", value.string_value());
+}
+
+TEST_F(DocRowwiseIteratorTest, PackedRow) {
+  // Column record written before the packed row is overridden by it.
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c_old"), 500_usec_ht));
+
+  RowPacker packer(/* schema_version = */ 0);
+  packer.AddValue(30_ColId, PrimitiveValue("row1_c"));
+  packer.AddValue(40_ColId, PrimitiveValue(10000));
+  packer.AddValue(50_ColId, PrimitiveValue("row1_e"));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kLivenessColumn), PrimitiveValue(),
+      1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kPackedRowColumn), packer.Complete(),
+      1000_usec_ht));
+
+  // Column updates written after the packed row take precedence over its values.
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000), 2000_usec_ht));
+  ASSERT_OK(DeleteSubDoc(DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)), 3000_usec_ht));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  QLTableRow row;
+  QLValue value;
+
+  google::FlagSaver flag_saver;
+  for (bool direct_decoding : {true, false}) {
+    FLAGS_docdb_direct_row_decoding = direct_decoding;
+    {
+      DocRowwiseIterator iter(
+          projection, schema, kNonTransactionalOperationContext, doc_db(),
+          CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(1500));
+      ASSERT_OK(iter.Init());
+
+      ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+      ASSERT_OK(iter.NextRow(&row));
+
+      ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+      ASSERT_EQ("row1_c", value.string_value());
+
+      ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+      ASSERT_EQ(10000, value.int64_value());
+
+      ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+      ASSERT_EQ("row1_e", value.string_value());
+
+      ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+    }
+
+    {
+      DocRowwiseIterator iter(
+          projection, schema, kNonTransactionalOperationContext, doc_db(),
+          CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(5000));
+      ASSERT_OK(iter.Init());
+
+      ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+      ASSERT_OK(iter.NextRow(&row));
+
+      ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+      ASSERT_EQ("row1_c", value.string_value());
+
+      ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+      ASSERT_EQ(20000, value.int64_value());
+
+      ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+      ASSERT_TRUE(value.IsNull());
+
+      ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+    }
+  }
+}
+
+// Columns requested by NextRow, that are not in the iterator projection, should be null even when
+// the output row already has values for them. Rows decoded from SubDocument leave such columns
+// as is, so only direct decoding is checked.
+TEST_F(DocRowwiseIteratorTest, ColumnsOutsideProjection) {
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row1_e"), 1000_usec_ht));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  Schema projection;
+  ASSERT_OK(schema.CreateProjectionByNames({"c", "d"}, &projection));
+
+  google::FlagSaver flag_saver;
+  FLAGS_docdb_direct_row_decoding = true;
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  QLTableRow row;
+  QLValue value;
+  row.AllocColumn(50_ColId).value.set_string_value("stale");
+  ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+  ASSERT_OK(iter.NextRow(kProjectionForIteratorTests, &row));
+
+  ASSERT_OK(row.GetValue(30_ColId, &value));
+  ASSERT_EQ("row1_c", value.string_value());
+
+  ASSERT_OK(row.GetValue(40_ColId, &value));
+  ASSERT_TRUE(value.IsNull());
+
+  ASSERT_OK(row.GetValue(50_ColId, &value));
+  ASSERT_TRUE(value.IsNull());
+
+  ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+}
+
+TEST_F(DocRowwiseIteratorTest, PackedRowUserTimestamp) {
+  RowPacker packer(/* schema_version = */ 0);
+  packer.AddValue(30_ColId, PrimitiveValue("row1_c"));
+  packer.AddValue(40_ColId, PrimitiveValue(10000));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kLivenessColumn), PrimitiveValue(),
+      1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kPackedRowColumn), packer.Complete(),
+      1000_usec_ht));
+
+  // Writes with user timestamp lower than write time of the packed row would have been skipped,
+  // if the row was not packed.
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      Value(PrimitiveValue("row1_c_skipped"), Value::kMaxTtl, /* user_timestamp = */ 500),
+      2000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      Value(PrimitiveValue(20000), Value::kMaxTtl, /* user_timestamp = */ 1500),
+      2000_usec_ht));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(5000));
+  ASSERT_OK(iter.Init());
+
+  QLTableRow row;
+  QLValue value;
+  ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+  ASSERT_OK(iter.NextRow(&row));
+
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ("row1_c", value.string_value());
+
+  ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+  ASSERT_EQ(20000, value.int64_value());
+
+  ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+  ASSERT_TRUE(value.IsNull());
+}
+
+// Packed row written before ALTER TABLE is read with the new schema.
+TEST_F(DocRowwiseIteratorTest, PackedRowSchemaVersion) {
+  // Version 1 of the schema had column 60, that was dropped, and did not have column 50, that was
+  // added in version 2.
+  RowPacker packer(/* schema_version = */ 1);
+  packer.AddValue(30_ColId, PrimitiveValue("row1_c"));
+  packer.AddValue(40_ColId, PrimitiveValue(10000));
+  packer.AddValue(60_ColId, PrimitiveValue("row1_dropped"));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kLivenessColumn), PrimitiveValue(),
+      1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kPackedRowColumn), packer.Complete(),
+      1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row1_e"), 2000_usec_ht));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  QLTableRow row;
+  QLValue value;
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(5000));
+    iter.set_schema_version(2);
+    ASSERT_OK(iter.Init());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ("row1_c", value.string_value());
+
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(10000, value.int64_value());
+
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_EQ("row1_e", value.string_value());
+
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+  }
+
+  {
+    // Reader that still uses the schema version preceding the packed row could not interpret it.
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(5000));
+    iter.set_schema_version(0);
+    ASSERT_OK(iter.Init());
+
+    auto result = iter.HasNext();
+    ASSERT_NOK(result);
+    ASSERT_TRUE(result.status().IsTryAgain()) << result.status();
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, PackedRowCompaction) {
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c_old"), 500_usec_ht));
+
+  RowPacker packer(/* schema_version = */ 0);
+  packer.AddValue(30_ColId, PrimitiveValue("row1_c"));
+  packer.AddValue(40_ColId, PrimitiveValue(10000));
+  packer.AddValue(50_ColId, PrimitiveValue("row1_e"));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kLivenessColumn), PrimitiveValue(),
+      1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, kPackedRowColumn), packer.Complete(),
+      1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000), 2000_usec_ht));
+  ASSERT_OK(DeleteSubDoc(DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)), 3000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c_new"), 4000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey2, PrimitiveValue(40_ColId)),
+      PrimitiveValue(30000), 2000_usec_ht));
+
+  FullyCompactHistoryBefore(3500_usec_ht);
+
+  // Records written before the packed row are removed, records written after it at or below the
+  // history cutoff are merged into it.
+  auto dump = DocDBDebugDumpToStr();
+  ASSERT_EQ(dump.find("row1_c_old"), std::string::npos) << dump;
+  ASSERT_EQ(dump.find("ColumnId(40); HT{ physical: 2000 }]) -> 20000"), std::string::npos)
+      << dump;
+  ASSERT_EQ(dump.find("ColumnId(50)"), std::string::npos) << dump;
+  ASSERT_NE(dump.find("row1_c_new"), std::string::npos) << dump;
+  ASSERT_NE(dump.find("-> 30000"), std::string::npos) << dump;
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  QLTableRow row;
+  QLValue value;
+
+  for (auto read_time : {3500, 5000}) {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(read_time));
+    ASSERT_OK(iter.Init());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ(read_time < 4000 ? "row1_c" : "row1_c_new", value.string_value());
+
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(20000, value.int64_value());
+
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_TRUE(value.IsNull());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(30000, value.int64_value());
+
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, RangeKeyBloomFilter) {
+  constexpr int kNumFiles = 4;
+  constexpr int kRowsPerFile = 3;
+
+  // Bloom filters on both range components, requested by the table property.
+  Schema schema = kSchemaForIteratorTests;
+  schema.mutable_table_properties()->SetBloomFilterRangeComponents(2);
+  FLAGS_range_key_bloom_filter_components = 0;
+  SetTableBloomFilterOptions(schema, &rocksdb_options_);
+  ASSERT_OK(DisableCompactions());
+  ASSERT_EQ(2U, BloomFilterRangeComponents(rocksdb()));
+
+  // Each file has its own value of the second range component, so rows with the same first
+  // component are spread over all files.
+  for (int file = 0; file != kNumFiles; ++file) {
+    for (int row = 0; row != kRowsPerFile; ++row) {
+      ASSERT_OK(SetPrimitive(
+          DocPath(DocKey(PrimitiveValues(Format("row$0", row), file)).Encode(),
+                  PrimitiveValue(30_ColId)),
+          PrimitiveValue(Format("value$0_$1", row, file)), HybridTime::FromMicros(1000)));
+    }
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+  ASSERT_EQ(kNumFiles, static_cast<int>(rocksdb()->GetCurrentVersionNumSSTFiles()));
+
+  // Readers should use the filters installed to the DB, even when the flag changes.
+  FLAGS_range_key_bloom_filter_components = -1;
+
+  const Schema &projection = kProjectionForIteratorTests;
+  auto* statistics = options().statistics.get();
+  QLTableRow row;
+  QLValue value;
+
+  // Point read should skip all files except the one that contains the row.
+  {
+    const auto useful_before = statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+    DocQLScanSpec spec(schema, DocKey(PrimitiveValues("row1", 2)), rocksdb::kDefaultQueryId);
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init(spec));
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ("value1_2", value.string_value());
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_EQ(kNumFiles - 1, static_cast<int>(
+        statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL) - useful_before));
+  }
+
+  // Scan by the first range component should not use bloom filters and return rows from all files.
+  {
+    const auto checked_before = statistics->getTickerCount(rocksdb::BLOOM_FILTER_CHECKED);
+    DocQLScanSpec spec(schema, DocKey(PrimitiveValues("row1")), rocksdb::kDefaultQueryId);
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init(spec));
+    for (int file = 0; file != kNumFiles; ++file) {
+      ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+      ASSERT_OK(iter.NextRow(&row));
+      ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+      ASSERT_EQ(Format("value1_$0", file), value.string_value());
+    }
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_EQ(checked_before, statistics->getTickerCount(rocksdb::BLOOM_FILTER_CHECKED));
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, DocDBStatistics) {
+  constexpr int kNumFiles = 4;
+  constexpr int kRowsPerFile = 3;
+
+  Schema schema = kSchemaForIteratorTests;
+  schema.mutable_table_properties()->SetBloomFilterRangeComponents(2);
+  SetTableBloomFilterOptions(schema, &rocksdb_options_);
+  ASSERT_OK(DisableCompactions());
+
+  for (int file = 0; file != kNumFiles; ++file) {
+    for (int row = 0; row != kRowsPerFile; ++row) {
+      ASSERT_OK(SetPrimitive(
+          DocPath(DocKey(PrimitiveValues(Format("row$0", row), file)).Encode(),
+                  PrimitiveValue(30_ColId)),
+          PrimitiveValue(Format("value$0_$1", row, file)), HybridTime::FromMicros(1000)));
+    }
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  const Schema &projection = kProjectionForIteratorTests;
+  QLTableRow row;
+
+  // Point read checks bloom filters of all files, and only one of them could contain the row.
+  {
+    DocDBStatistics statistics;
+    DocQLScanSpec spec(schema, DocKey(PrimitiveValues("row1", 2)), rocksdb::kDefaultQueryId);
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init(spec));
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+
+    DocDBStatsPB stats;
+    statistics.CopyToPB(&stats);
+    ASSERT_GT(stats.num_seeks(), 0U);
+    ASSERT_GE(stats.bloom_useful(), static_cast<uint64_t>(kNumFiles - 1));
+    ASSERT_GT(stats.bloom_checks(), stats.bloom_useful());
+  }
+
+  // Full scan steps over all rows of all files.
+  {
+    DocDBStatistics statistics;
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init());
+    int num_rows = 0;
+    while (ASSERT_RESULT(iter.HasNext())) {
+      ASSERT_OK(iter.NextRow(&row));
+      ++num_rows;
+    }
+    ASSERT_EQ(kNumFiles * kRowsPerFile, num_rows);
+
+    DocDBStatsPB stats;
+    statistics.CopyToPB(&stats);
+    ASSERT_GT(stats.num_seeks(), 0U);
+    ASSERT_GT(stats.num_nexts(), 0U);
+    ASSERT_GE(stats.sst_files_touched(), static_cast<uint64_t>(kNumFiles));
+    ASSERT_GT(stats.block_cache_hits() + stats.block_cache_misses(), 0U);
+    ASSERT_EQ(0U, stats.bloom_checks());
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
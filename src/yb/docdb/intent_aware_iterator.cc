@@ -24,6 +24,7 @@
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_statistics.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/value.h"
@@ -731,6 +732,7 @@ void IntentAwareIterator::SeekToSuitableIntent() {
       break;
     }
     ProcessIntent();
+    ++docdb_perf_context().intents_scanned;
     if (!status_.ok()) {
       return;
     }
@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include <algorithm>
+
+#include "yb/util/fast_varint.h"
+
+namespace yb {
+namespace docdb {
+
+void RowPacker::AddValue(ColumnId column_id, const PrimitiveValue& value) {
+  if (value.value_type() == ValueType::kTombstone) {
+    return;
+  }
+  DCHECK(IsPrimitiveValueType(value.value_type())) << value.ToString();
+  values_.emplace_back(column_id, value.ToValue());
+}
+
+void RowPacker::AddEncodedValue(ColumnId column_id, const Slice& encoded_value) {
+  values_.emplace_back(column_id, encoded_value.ToBuffer());
+}
+
+PrimitiveValue RowPacker::Complete() {
+  std::sort(values_.begin(), values_.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+
+  std::string result;
+  util::FastAppendUnsignedVarIntToStr(schema_version_, &result);
+  util::FastAppendUnsignedVarIntToStr(values_.size(), &result);
+  for (const auto& value : values_) {
+    util::FastAppendUnsignedVarIntToStr(value.first.rep(), &result);
+    util::FastAppendUnsignedVarIntToStr(value.second.size(), &result);
+  }
+  for (const auto& value : values_) {
+    result.append(value.second);
+  }
+  values_.clear();
+  return PrimitiveValue::PackedRow(std::move(result));
+}
+
+Result<PackedRow> PackedRow::Decode(const Slice& packed) {
+  PackedRow result;
+  result.data_.assign(packed.cdata(), packed.size());
+  Slice input(result.data_);
+  result.schema_version_ = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input));
+  const auto num_columns = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input));
+  result.columns_.reserve(num_columns);
+  for (size_t i = 0; i != num_columns; ++i) {
+    const auto column_id = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input));
+    const auto size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input));
+    result.columns_.push_back(Column{ColumnId(static_cast<ColumnIdRep>(column_id)), 0, size});
+  }
+  for (auto& column : result.columns_) {
+    if (input.size() < column.size) {
+      return STATUS_FORMAT(
+          Corruption, "Not enough data for value of column $0 in packed row: $1 < $2",
+          column.id, input.size(), column.size);
+    }
+    column.offset = input.cdata() - result.data_.data();
+    input.remove_prefix(column.size);
+  }
+  if (!input.empty()) {
+    return STATUS_FORMAT(Corruption, "Extra $0 bytes at the end of packed row", input.size());
+  }
+  return result;
+}
+
+boost::optional<Slice> PackedRow::GetValue(ColumnId column_id) const {
+  auto it = std::lower_bound(
+      columns_.begin(), columns_.end(), column_id, [](const Column& column, ColumnId id) {
+    return column.id < id;
+  });
+  if (it == columns_.end() || it->id != column_id) {
+    return boost::none;
+  }
+  return Slice(data_.data() + it->offset, it->size);
+}
+
+Result<bool> PackedRow::GetPrimitiveValue(ColumnId column_id, PrimitiveValue* out) const {
+  auto value = GetValue(column_id);
+  if (!value) {
+    return false;
+  }
+  RETURN_NOT_OK(out->DecodeFromValue(*value));
+  return true;
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H
+#define YB_DOCDB_PACKED_ROW_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
+
+#include "yb/common/schema.h"
+
+#include "yb/docdb/primitive_value.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Packed row stores all non key columns written by a single insert in one RocksDB value, instead
+// of a separate key/value pair per column. The value is written to the kPackedRow system column of
+// the row, next to the regular liveness column, so the insert takes strong intents only on those
+// two columns and a weak intent on the row, like a regular insert does.
+//
+// Packed row is equivalent to records of all its columns written at its hybrid time. It does not
+// overwrite records of the row's columns: readers use the value of a column from the packed row,
+// unless the column has a record written after the packed row, and ignore column records written
+// before it. See DocPackedRow in docdb.cc for details. Major compactions merge column records
+// written after the packed row back into it, see DocDBCompactionFilter.
+//
+// Encoding, after ValueType::kPackedRow:
+//   varint schema version
+//   varint number of columns
+//   for each column in increasing column id order: varint column id, varint encoded value size
+//   encoded values of all columns in the same order, see PrimitiveValue::ToValue.
+//
+// Null columns are not stored. Column ids are stored explicitly, so the row could be decoded
+// without the schema of the version it was written with.
+class RowPacker {
+ public:
+  explicit RowPacker(uint32_t schema_version) : schema_version_(schema_version) {}
+
+  // Adds value of the column to the row. Tombstone (null) values are skipped.
+  void AddValue(ColumnId column_id, const PrimitiveValue& value);
+
+  // Adds already encoded value of the column to the row.
+  void AddEncodedValue(ColumnId column_id, const Slice& encoded_value);
+
+  // Returns packed row value and resets the packer.
+  PrimitiveValue Complete();
+
+ private:
+  uint32_t schema_version_;
+  std::vector<std::pair<ColumnId, std::string>> values_;
+};
+
+// Provides access to column values of a packed row. Owns a copy of the encoded row.
+class PackedRow {
+ public:
+  // Decodes packed row payload, i.e. value without the kPackedRow value type.
+  static Result<PackedRow> Decode(const Slice& packed);
+
+  uint32_t schema_version() const { return schema_version_; }
+
+  size_t num_columns() const { return columns_.size(); }
+
+  // Returns encoded value of the column, or none if the row does not contain it.
+  boost::optional<Slice> GetValue(ColumnId column_id) const;
+
+  // Decodes value of the column into out. Returns false if the row does not contain it.
+  Result<bool> GetPrimitiveValue(ColumnId column_id, PrimitiveValue* out) const;
+
+  template <class F>
+  void ForEachColumn(const F& f) const {
+    for (const auto& column : columns_) {
+      f(column.id, Slice(data_.data() + column.offset, column.size));
+    }
+  }
+
+ private:
+  struct Column {
+    ColumnId id;
+    size_t offset;
+    size_t size;
+  };
+
+  uint32_t schema_version_ = 0;
+  std::string data_;
+  boost::container::small_vector<Column, 16> columns_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PACKED_ROW_H
@@ -22,11 +22,13 @@
 
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/primitive_value_util.h"
 
 #include "yb/util/flag_tags.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/trace.h"
+#include "yb/util/write_buffer.h"
 
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
@@ -36,6 +38,24 @@ DECLARE_int64(retryable_rpc_single_call_timeout_ms);
 DEFINE_double(ysql_scan_timeout_multiplier, 0.5,
               "YSQL read scan timeout multipler of retryable_rpc_single_call_timeout_ms.");
 
+DEFINE_int32(ysql_index_lookup_batch_size, 1024,
+             "Number of base table rows to look up at a time when scanning a YSQL secondary index. "
+             "The looked up rows are sorted by ybctid and read in a single forward pass over the "
+             "base table. Values <= 1 look up each row separately in index order.");
+TAG_FLAG(ysql_index_lookup_batch_size, advanced);
+
+DEFINE_bool(ysql_enable_packed_row, false,
+            "Whether YSQL inserts should store all non key columns of a row in a single packed "
+            "value instead of a key/value pair per column.");
+TAG_FLAG(ysql_enable_packed_row, runtime);
+TAG_FLAG(ysql_enable_packed_row, advanced);
+
+DEFINE_int32(ysql_max_pushdown_groups_per_read, 10000,
+             "Max number of groups a GROUP BY read keeps partial aggregates for. When it is "
+             "reached, the read returns the groups seen so far with a paging state, and the "
+             "remaining rows are aggregated by the next read.");
+TAG_FLAG(ysql_max_pushdown_groups_per_read, advanced);
+
 DEFINE_test_flag(int32, TEST_slowdown_pgsql_aggregate_read_ms, 0,
                  "If set > 0, slows down the response to pgsql aggregate read by this amount.");
 
@@ -147,6 +167,12 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
       Value(PrimitiveValue()),
       data.read_time, data.deadline, request_.stmt_id()));
 
+  // Upsert could overwrite only some columns of an existing row, so it is never packed.
+  boost::optional<RowPacker> packer;
+  if (FLAGS_ysql_enable_packed_row && !is_upsert) {
+    packer.emplace(request_.schema_version());
+  }
+
   for (const auto& column_value : request_.column_values()) {
     // Get the column.
     if (!column_value.has_column_id()) {
@@ -165,12 +191,26 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
     const SubDocument sub_doc =
         SubDocument::FromQLValuePB(expr_result.Value(), column.sorting_type());
 
+    if (packer) {
+      packer->AddValue(column_id, sub_doc);
+      continue;
+    }
+
     // Inserting into specified column.
     DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column_id));
     RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
         sub_path, sub_doc, data.read_time, data.deadline, request_.stmt_id()));
   }
 
+  if (packer) {
+    static const PrimitiveValue kPackedRowColumnId =
+        PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRow);
+
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        DocPath(encoded_doc_key_.as_slice(), kPackedRowColumnId), Value(packer->Complete()),
+        data.read_time, data.deadline, request_.stmt_id()));
+  }
+
   RETURN_NOT_OK(PopulateResultSet(table_row));
 
   response_->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
@@ -405,13 +445,16 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
                                            const ReadHybridTime& read_time,
                                            const Schema& schema,
                                            const Schema *index_schema,
-                                           faststring *result_buffer,
+                                           WriteBuffer *result_buffer,
                                            HybridTime *restart_read_ht) {
   size_t fetched_rows = 0;
   // Reserve space for fetched rows count.
+  const size_t row_count_pos = result_buffer->size();
   pggate::PgWire::WriteInt64(0, result_buffer);
-  auto se = ScopeExit([&fetched_rows, result_buffer] {
-    NetworkByteOrder::Store64(result_buffer->data(), fetched_rows);
+  auto se = ScopeExit([&fetched_rows, result_buffer, row_count_pos] {
+    char row_count[sizeof(uint64_t)];
+    NetworkByteOrder::Store64(row_count, fetched_rows);
+    result_buffer->Write(row_count_pos, row_count, sizeof(row_count));
   });
   VLOG(4) << "Read, read time: " << read_time << ", txn: " << txn_op_context_;
 
@@ -473,55 +516,68 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
   // Fetching data.
   int match_count = 0;
   QLTableRow row;
-  while (fetched_rows < row_count_limit && VERIFY_RESULT(iter->HasNext()) &&
-         !scan_time_exceeded) {
-
-    row.Clear();
-
-    // If there is an index request, fetch ybbasectid from the index and use it as ybctid
-    // to fetch from the base table. Otherwise, fetch from the base table directly.
-    if (request_.has_index_request()) {
-      RETURN_NOT_OK(iter->NextRow(&row));
-      const auto& tuple_id = row.GetValue(ybbasectid_id);
-      SCHECK_NE(tuple_id, boost::none, Corruption, "ybbasectid not found in index row");
-      if (!VERIFY_RESULT(table_iter_->SeekTuple(tuple_id->binary_value()))) {
-        DocKey doc_key;
-        RETURN_NOT_OK(doc_key.DecodeFrom(tuple_id->binary_value()));
-        return STATUS_FORMAT(Corruption, "ybctid $0 not found in indexed table", doc_key);
+  if (request_.has_index_request() && FLAGS_ysql_index_lookup_batch_size > 1) {
+    // Look up base table rows a batch at a time. The batch never exceeds the remaining row limit,
+    // so every fetched index row is processed before paging and the index iterator position stays
+    // valid for the paging state.
+    std::vector<QLTableRow> rows;
+    while (fetched_rows < row_count_limit && !scan_time_exceeded && !GroupLimitReached()) {
+      const size_t batch_size = std::min<size_t>(
+          FLAGS_ysql_index_lookup_batch_size, row_count_limit - fetched_rows);
+      RETURN_NOT_OK(FetchIndexedRows(iter, projection, ybbasectid_id, batch_size, &rows));
+      if (rows.empty()) {
+        break;
       }
-      row.Clear();
-      RETURN_NOT_OK(table_iter_->NextRow(projection, &row));
-    } else {
-      RETURN_NOT_OK(iter->NextRow(projection, &row));
+      for (const QLTableRow& indexed_row : rows) {
+        if (VERIFY_RESULT(EvalRow(indexed_row, &fetched_rows, result_buffer))) {
+          match_count++;
+        }
+      }
+      const MonoDelta elapsed_time = MonoTime::Now().GetDeltaSince(start_time);
+      scan_time_exceeded = elapsed_time.ToMilliseconds() > scan_time_limit;
     }
+  } else {
+    while (fetched_rows < row_count_limit && !scan_time_exceeded && !GroupLimitReached() &&
+           VERIFY_RESULT(iter->HasNext())) {
 
-    // Match the row with the where condition before adding to the row block.
-    bool is_match = true;
-    if (request_.has_where_expr()) {
-      QLExprResult match;
-      RETURN_NOT_OK(EvalExpr(request_.where_expr(), row, match.Writer()));
-      is_match = match.Value().bool_value();
-    }
-    if (is_match) {
-      match_count++;
-      if (request_.is_aggregate()) {
-        RETURN_NOT_OK(EvalAggregate(row));
+      row.Clear();
+
+      // If there is an index request, fetch ybbasectid from the index and use it as ybctid
+      // to fetch from the base table. Otherwise, fetch from the base table directly.
+      if (request_.has_index_request()) {
+        RETURN_NOT_OK(iter->NextRow(&row));
+        const auto& tuple_id = row.GetValue(ybbasectid_id);
+        SCHECK_NE(tuple_id, boost::none, Corruption, "ybbasectid not found in index row");
+        if (!VERIFY_RESULT(table_iter_->SeekTuple(tuple_id->binary_value()))) {
+          DocKey doc_key;
+          RETURN_NOT_OK(doc_key.DecodeFrom(tuple_id->binary_value()));
+          return STATUS_FORMAT(Corruption, "ybctid $0 not found in indexed table", doc_key);
+        }
+        row.Clear();
+        RETURN_NOT_OK(table_iter_->NextRow(projection, &row));
       } else {
-        RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
-        ++fetched_rows;
+        RETURN_NOT_OK(iter->NextRow(projection, &row));
       }
-    }
 
-    // Check every row_count_limit matches whether we've exceeded our scan time.
-    if (match_count % row_count_limit == 0) {
-      const MonoDelta elapsed_time = MonoTime::Now().GetDeltaSince(start_time);
-      scan_time_exceeded = elapsed_time.ToMilliseconds() > scan_time_limit;
+      if (VERIFY_RESULT(EvalRow(row, &fetched_rows, result_buffer))) {
+        match_count++;
+      }
+
+      // Check every row_count_limit matches whether we've exceeded our scan time.
+      if (match_count % row_count_limit == 0) {
+        const MonoDelta elapsed_time = MonoTime::Now().GetDeltaSince(start_time);
+        scan_time_exceeded = elapsed_time.ToMilliseconds() > scan_time_limit;
+      }
     }
   }
 
   if (request_.is_aggregate() && match_count > 0) {
-    RETURN_NOT_OK(PopulateAggregate(row, result_buffer));
-    ++fetched_rows;
+    if (request_.group_by_exprs_size() > 0) {
+      fetched_rows += VERIFY_RESULT(PopulateGroupAggregates(result_buffer));
+    } else {
+      RETURN_NOT_OK(PopulateAggregate(row, result_buffer));
+      ++fetched_rows;
+    }
   }
 
   if (PREDICT_FALSE(FLAGS_TEST_slowdown_pgsql_aggregate_read_ms > 0) && request_.is_aggregate()) {
@@ -534,7 +590,8 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
   }
   *restart_read_ht = iter->RestartReadHt();
 
-  RETURN_NOT_OK(SetPagingStateIfNecessary(iter, fetched_rows, row_count_limit, scan_time_exceeded));
+  RETURN_NOT_OK(SetPagingStateIfNecessary(
+      iter, fetched_rows, row_count_limit, scan_time_exceeded || GroupLimitReached()));
 
   return fetched_rows;
 }
@@ -543,7 +600,7 @@ Result<size_t> PgsqlReadOperation::ExecuteBatch(const common::YQLStorageIf& ql_s
                                                 CoarseTimePoint deadline,
                                                 const ReadHybridTime& read_time,
                                                 const Schema& schema,
-                                                faststring *result_buffer,
+                                                WriteBuffer *result_buffer,
                                                 HybridTime *restart_read_ht) {
   Schema projection;
   RETURN_NOT_OK(CreateProjection(schema, request_.column_refs(), &projection));
@@ -572,6 +629,66 @@ Result<size_t> PgsqlReadOperation::ExecuteBatch(const common::YQLStorageIf& ql_s
   return row_count;
 }
 
+Result<bool> PgsqlReadOperation::EvalRow(const QLTableRow& table_row,
+                                         size_t* fetched_rows,
+                                         WriteBuffer *result_buffer) {
+  // Match the row with the where condition before adding to the row block.
+  if (request_.has_where_expr()) {
+    QLExprResult match;
+    RETURN_NOT_OK(EvalExpr(request_.where_expr(), table_row, match.Writer()));
+    if (!match.Value().bool_value()) {
+      return false;
+    }
+  }
+  if (request_.is_aggregate()) {
+    RETURN_NOT_OK(EvalAggregate(table_row));
+  } else {
+    RETURN_NOT_OK(PopulateResultSet(table_row, result_buffer));
+    ++*fetched_rows;
+  }
+  return true;
+}
+
+Status PgsqlReadOperation::FetchIndexedRows(common::YQLRowwiseIteratorIf* index_iter,
+                                            const Schema& projection,
+                                            const ColumnId& ybbasectid_id,
+                                            size_t batch_size,
+                                            std::vector<QLTableRow>* rows) {
+  // Collect the ybctids of the next batch of index rows, remembering their position in index
+  // order.
+  std::vector<std::pair<std::string, size_t>> tuple_ids;
+  tuple_ids.reserve(batch_size);
+  QLTableRow index_row;
+  while (tuple_ids.size() < batch_size && VERIFY_RESULT(index_iter->HasNext())) {
+    index_row.Clear();
+    RETURN_NOT_OK(index_iter->NextRow(&index_row));
+    const auto& tuple_id = index_row.GetValue(ybbasectid_id);
+    SCHECK_NE(tuple_id, boost::none, Corruption, "ybbasectid not found in index row");
+    tuple_ids.emplace_back(tuple_id->binary_value(), tuple_ids.size());
+  }
+
+  // Read the base table rows in key order, so that consecutive lookups move the table iterator
+  // forward and hit the same data blocks instead of doing a random seek per index row. The rows
+  // are placed back at their index position so the output order is unchanged.
+  std::sort(tuple_ids.begin(), tuple_ids.end());
+  rows->resize(tuple_ids.size());
+  bool first = true;
+  for (const auto& entry : tuple_ids) {
+    const bool found = first ? VERIFY_RESULT(table_iter_->SeekTuple(entry.first))
+                             : VERIFY_RESULT(table_iter_->SeekTupleForward(entry.first));
+    if (!found) {
+      DocKey doc_key;
+      RETURN_NOT_OK(doc_key.DecodeFrom(entry.first));
+      return STATUS_FORMAT(Corruption, "ybctid $0 not found in indexed table", doc_key);
+    }
+    first = false;
+    QLTableRow& row = (*rows)[entry.second];
+    row.Clear();
+    RETURN_NOT_OK(table_iter_->NextRow(projection, &row));
+  }
+  return Status::OK();
+}
+
 Status PgsqlReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                                      size_t fetched_rows,
                                                      const size_t row_count_limit,
@@ -597,7 +714,7 @@ Status PgsqlReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIte
 }
 
 Status PgsqlReadOperation::PopulateResultSet(const QLTableRow& table_row,
-                                             faststring *result_buffer) {
+                                             WriteBuffer *result_buffer) {
   QLExprResult result;
   for (const PgsqlExpressionPB& expr : request_.targets()) {
     RETURN_NOT_OK(EvalExpr(expr, table_row, result.Writer()));
@@ -617,6 +734,10 @@ Status PgsqlReadOperation::GetTupleId(QLValue *result) const {
 }
 
 Status PgsqlReadOperation::EvalAggregate(const QLTableRow& table_row) {
+  if (request_.group_by_exprs_size() > 0) {
+    return EvalGroupAggregate(table_row);
+  }
+
   if (aggr_result_.empty()) {
     int column_count = request_.targets().size();
     aggr_result_.resize(column_count);
@@ -630,7 +751,7 @@ Status PgsqlReadOperation::EvalAggregate(const QLTableRow& table_row) {
 }
 
 Status PgsqlReadOperation::PopulateAggregate(const QLTableRow& table_row,
-                                             faststring *result_buffer) {
+                                             WriteBuffer *result_buffer) {
   int column_count = request_.targets().size();
   for (int rscol_index = 0; rscol_index < column_count; rscol_index++) {
     RETURN_NOT_OK(pggate::WriteColumn(aggr_result_[rscol_index].Value(), result_buffer));
@@ -638,6 +759,51 @@ Status PgsqlReadOperation::PopulateAggregate(const QLTableRow& table_row,
   return Status::OK();
 }
 
+Status PgsqlReadOperation::EvalGroupAggregate(const QLTableRow& table_row) {
+  // Encode the grouping values into the hash key. Each value is prefixed by its size so that
+  // different sequences of values, including NULLs, never produce the same key.
+  std::string group_key;
+  QLExprResult group_value;
+  for (const PgsqlExpressionPB& expr : request_.group_by_exprs()) {
+    RETURN_NOT_OK(EvalExpr(expr, table_row, group_value.Writer()));
+    const QLValuePB& value = group_value.Value();
+    const uint32_t value_size = value.ByteSize();
+    group_key.append(reinterpret_cast<const char*>(&value_size), sizeof(value_size));
+    value.AppendToString(&group_key);
+  }
+
+  auto it = group_index_.find(group_key);
+  if (it == group_index_.end()) {
+    it = group_index_.emplace(std::move(group_key), group_aggr_results_.size()).first;
+    group_aggr_results_.emplace_back(request_.targets().size());
+  }
+
+  auto& aggr_results = group_aggr_results_[it->second];
+  int aggr_index = 0;
+  for (const PgsqlExpressionPB& expr : request_.targets()) {
+    QLExprResult& aggr_result = aggr_results[aggr_index++];
+    RETURN_NOT_OK(EvalExpr(expr, table_row, aggr_result.Writer()));
+    // Grouping column targets may refer to values of the current row, which is reused for the next
+    // row, so keep a copy of them.
+    aggr_result.ForceNewValue();
+  }
+  return Status::OK();
+}
+
+bool PgsqlReadOperation::GroupLimitReached() const {
+  return group_index_.size() >=
+         static_cast<size_t>(std::max(FLAGS_ysql_max_pushdown_groups_per_read, 1));
+}
+
+Result<size_t> PgsqlReadOperation::PopulateGroupAggregates(WriteBuffer *result_buffer) {
+  for (const auto& aggr_results : group_aggr_results_) {
+    for (const QLExprResult& aggr_result : aggr_results) {
+      RETURN_NOT_OK(pggate::WriteColumn(aggr_result.Value(), result_buffer));
+    }
+  }
+  return group_aggr_results_.size();
+}
+
 Status PgsqlReadOperation::GetIntents(const Schema& schema, KeyValueWriteBatchPB* out) {
   auto pair = out->mutable_read_pairs()->Add();
 
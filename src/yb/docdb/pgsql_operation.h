@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_PGSQL_OPERATION_H
 #define YB_DOCDB_PGSQL_OPERATION_H
 
+#include <unordered_map>
+
 #include "yb/common/ql_rowwise_iterator_interface.h"
 
 #include "yb/docdb/doc_expr.h"
@@ -23,6 +25,7 @@
 namespace yb {
 
 class IndexInfo;
+class WriteBuffer;
 
 namespace common {
 
@@ -123,7 +126,7 @@ class PgsqlReadOperation : public DocExprExecutor {
                          const ReadHybridTime& read_time,
                          const Schema& schema,
                          const Schema *index_schema,
-                         faststring *result_buffer,
+                         WriteBuffer *result_buffer,
                          HybridTime *restart_read_ht);
 
   CHECKED_STATUS GetTupleId(QLValue *result) const override;
@@ -135,16 +138,40 @@ class PgsqlReadOperation : public DocExprExecutor {
                               CoarseTimePoint deadline,
                               const ReadHybridTime& read_time,
                               const Schema& schema,
-                              faststring *result_buffer,
+                              WriteBuffer *result_buffer,
                               HybridTime *restart_read_ht);
 
   CHECKED_STATUS PopulateResultSet(const QLTableRow& table_row,
-                                   faststring *result_buffer);
+                                   WriteBuffer *result_buffer);
+
+  // Evaluates the where condition on the row and, if it matches, adds the row to the result set
+  // or to the aggregate. Returns whether the row matched.
+  Result<bool> EvalRow(const QLTableRow& table_row, size_t* fetched_rows,
+                       WriteBuffer *result_buffer);
+
+  // Reads up to batch_size rows from the index iterator and looks up the corresponding base table
+  // rows in ybctid order. The base table rows are returned in index order.
+  CHECKED_STATUS FetchIndexedRows(common::YQLRowwiseIteratorIf* index_iter,
+                                  const Schema& projection,
+                                  const ColumnId& ybbasectid_id,
+                                  size_t batch_size,
+                                  std::vector<QLTableRow>* rows);
 
   CHECKED_STATUS EvalAggregate(const QLTableRow& table_row);
 
   CHECKED_STATUS PopulateAggregate(const QLTableRow& table_row,
-                                   faststring *result_buffer);
+                                   WriteBuffer *result_buffer);
+
+  // Accumulates the row into the partial aggregates of its group when the request has GROUP BY
+  // expressions.
+  CHECKED_STATUS EvalGroupAggregate(const QLTableRow& table_row);
+
+  // Whether the read has partial aggregates of as many groups as it may keep. The read then
+  // stops and returns them, so memory used by a GROUP BY read is bounded.
+  bool GroupLimitReached() const;
+
+  // Writes one row per group to the result buffer and returns the number of rows written.
+  Result<size_t> PopulateGroupAggregates(WriteBuffer *result_buffer);
 
   // Checks whether we have processed enough rows for a page and sets the appropriate paging
   // state in the response object.
@@ -159,6 +186,11 @@ class PgsqlReadOperation : public DocExprExecutor {
   PgsqlResponsePB response_;
   common::YQLRowwiseIteratorIf::UniPtr table_iter_;
   common::YQLRowwiseIteratorIf::UniPtr index_iter_;
+
+  // Partial aggregates of GROUP BY reads, one entry per group in the order the groups were first
+  // seen. group_index_ maps the encoded grouping values to the position of the group.
+  std::vector<std::vector<QLExprResult>> group_aggr_results_;
+  std::unordered_map<std::string, size_t> group_index_;
 };
 
 }  // namespace docdb
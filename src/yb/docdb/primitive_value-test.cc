@@ -13,9 +13,13 @@
 
 #include "yb/docdb/primitive_value.h"
 
+#include <functional>
 #include <limits>
 #include <map>
 
+#include "yb/common/ql_type.h"
+
+#include "yb/util/decimal.h"
 #include "yb/util/random.h"
 #include "yb/util/random_util.h"
 #include "yb/util/test_macros.h"
@@ -308,6 +312,55 @@ TEST(PrimitiveValueTest, TestCorruption) {
   ASSERT_TRUE(decoded.DecodeFromKey(&slice).IsCorruption());
 }
 
+TEST(PrimitiveValueTest, TestDecodeToQLValuePB) {
+  std::vector<std::pair<DataType, QLValuePB>> values;
+  auto add = [&values](DataType type, const std::function<void(QLValuePB*)>& setter) {
+    values.emplace_back(type, QLValuePB());
+    setter(&values.back().second);
+  };
+  add(INT8, [](QLValuePB* v) { v->set_int8_value(-12); });
+  add(INT16, [](QLValuePB* v) { v->set_int16_value(-1234); });
+  add(INT32, [](QLValuePB* v) { v->set_int32_value(-123456); });
+  add(INT64, [](QLValuePB* v) { v->set_int64_value(-1234567890123); });
+  add(UINT32, [](QLValuePB* v) { v->set_uint32_value(123456); });
+  add(UINT64, [](QLValuePB* v) { v->set_uint64_value(1234567890123); });
+  add(FLOAT, [](QLValuePB* v) { v->set_float_value(-1.25); });
+  add(DOUBLE, [](QLValuePB* v) { v->set_double_value(3.5e100); });
+  add(BOOL, [](QLValuePB* v) { v->set_bool_value(true); });
+  add(BOOL, [](QLValuePB* v) { v->set_bool_value(false); });
+  add(TIMESTAMP, [](QLValuePB* v) { v->set_timestamp_value(1234567890123); });
+  add(DATE, [](QLValuePB* v) { v->set_date_value(1u << 31); });
+  add(TIME, [](QLValuePB* v) { v->set_time_value(1234567890); });
+  add(STRING, [](QLValuePB* v) { v->set_string_value(string("a\0b", 3)); });
+  add(STRING, [](QLValuePB* v) { v->set_string_value(""); });
+  add(BINARY, [](QLValuePB* v) { v->set_binary_value("\xff\x01"); });
+  // Decoded through PrimitiveValue.
+  add(DECIMAL, [](QLValuePB* v) {
+    v->set_decimal_value(util::Decimal("-1.5").EncodeToComparable());
+  });
+
+  for (const auto& type_and_value : values) {
+    const auto ql_type = QLType::Create(type_and_value.first);
+    const auto& value = type_and_value.second;
+    const auto encoded = PrimitiveValue::FromQLValuePB(
+        value, ColumnSchema::SortingType::kNotSpecified).ToValue();
+    QLValuePB decoded;
+    ASSERT_OK(PrimitiveValue::DecodeToQLValuePB(encoded, ql_type, &decoded));
+    ASSERT_EQ(value.ShortDebugString(), decoded.ShortDebugString());
+  }
+
+  // Null value overwrites the previous value.
+  QLValuePB decoded;
+  decoded.set_int32_value(1);
+  ASSERT_OK(PrimitiveValue::DecodeToQLValuePB(
+      PrimitiveValue(ValueType::kNullLow).ToValue(), QLType::Create(INT32), &decoded));
+  ASSERT_EQ(decoded.value_case(), QLValuePB::VALUE_NOT_SET);
+
+  // Value of wrong size.
+  ASSERT_TRUE(PrimitiveValue::DecodeToQLValuePB(
+      PrimitiveValue::Int32(1).ToValue() + "x", QLType::Create(INT32), &decoded).IsCorruption());
+}
+
 TEST(PrimitiveValueTest, TestVarintStorage) {
   // Verify varint occupies the appropriate amount of bytes.
   KeyBytes key_bytes;
@@ -24,6 +24,7 @@
 #include "yb/docdb/doc_kv_util.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/intent.h"
+#include "yb/gutil/casts.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -63,6 +64,7 @@ using yb::util::DecodeDoubleFromKey;
     case ValueType::kInvalid: FALLTHROUGH_INTENDED; \
     case ValueType::kJsonb: FALLTHROUGH_INTENDED; \
     case ValueType::kObject: FALLTHROUGH_INTENDED; \
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED; \
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisList: FALLTHROUGH_INTENDED;            \
     case ValueType::kRedisSet: FALLTHROUGH_INTENDED; \
@@ -183,6 +185,8 @@ string PrimitiveValue::ToString() const {
       return inetaddress_val_->ToString();
     case ValueType::kJsonb:
       return FormatBytesAsStr(json_val_);
+    case ValueType::kPackedRow:
+      return Format("PackedRow($0)", FormatBytesAsStr(packed_row_val_));
     case ValueType::kUuidDescending: FALLTHROUGH_INTENDED;
     case ValueType::kUuid:
       return uuid_val_.ToString();
@@ -535,6 +539,10 @@ string PrimitiveValue::ToValue() const {
       return result;
     }
 
+    case ValueType::kPackedRow:
+      result.append(packed_row_val_);
+      return result;
+
     case ValueType::kUuidDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTransactionId: FALLTHROUGH_INTENDED;
     case ValueType::kTableId: FALLTHROUGH_INTENDED;
@@ -1103,6 +1111,11 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
       return Status::OK();
     }
 
+    case ValueType::kPackedRow:
+      new(&packed_row_val_) string(slice.cdata(), slice.size());
+      type_ = value_type;
+      return Status::OK();
+
     case ValueType::kInetaddress: {
       if (slice.size() != kInetAddressV4Size && slice.size() != kInetAddressV6Size) {
         return STATUS_FORMAT(Corruption,
@@ -1289,6 +1302,13 @@ PrimitiveValue PrimitiveValue::Jsonb(const std::string& json) {
   return primitive_value;
 }
 
+PrimitiveValue PrimitiveValue::PackedRow(std::string packed_row) {
+  PrimitiveValue primitive_value;
+  primitive_value.type_ = ValueType::kPackedRow;
+  new(&primitive_value.packed_row_val_) string(std::move(packed_row));
+  return primitive_value;
+}
+
 KeyBytes PrimitiveValue::ToKeyBytes() const {
   KeyBytes kb;
   AppendToKey(&kb);
@@ -1497,6 +1517,8 @@ PrimitiveValue::PrimitiveValue(ValueType value_type)
     frozen_val_ = new FrozenContainer();
   } else if (value_type == ValueType::kJsonb) {
     new(&json_val_) std::string();
+  } else if (value_type == ValueType::kPackedRow) {
+    new(&packed_row_val_) std::string();
   }
 }
 
@@ -1743,5 +1765,130 @@ void PrimitiveValue::ToQLValuePB(const PrimitiveValue& primitive_value,
   LOG(FATAL) << "Unsupported datatype " << ql_type->ToString();
 }
 
+namespace {
+
+CHECKED_STATUS CheckEncodedValueSize(ValueType value_type, const Slice& slice, size_t size) {
+  if (slice.size() != size) {
+    return STATUS_FORMAT(Corruption, "Invalid number of bytes for a $0: $1",
+        value_type, slice.size());
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+Status PrimitiveValue::DecodeToQLValuePB(const Slice& encoded_value,
+                                         const std::shared_ptr<QLType>& ql_type,
+                                         QLValuePB* ql_value) {
+  Slice slice = encoded_value;
+  const auto value_type = ConsumeValueType(&slice);
+  if (value_type == ValueType::kNullLow || value_type == ValueType::kNullHigh) {
+    SetNull(ql_value);
+    return Status::OK();
+  }
+
+  switch (ql_type->main()) {
+    case INT8: FALLTHROUGH_INTENDED;
+    case INT16: FALLTHROUGH_INTENDED;
+    case INT32: {
+      if (value_type != ValueType::kInt32) {
+        break;
+      }
+      RETURN_NOT_OK(CheckEncodedValueSize(value_type, slice, sizeof(int32_t)));
+      const int32_t value = BigEndian::Load32(slice.data());
+      if (ql_type->main() == INT8) {
+        ql_value->set_int8_value(static_cast<int8_t>(value));
+      } else if (ql_type->main() == INT16) {
+        ql_value->set_int16_value(static_cast<int16_t>(value));
+      } else {
+        ql_value->set_int32_value(value);
+      }
+      return Status::OK();
+    }
+    case INT64: FALLTHROUGH_INTENDED;
+    case TIME: {
+      if (value_type != ValueType::kInt64) {
+        break;
+      }
+      RETURN_NOT_OK(CheckEncodedValueSize(value_type, slice, sizeof(int64_t)));
+      const int64_t value = BigEndian::Load64(slice.data());
+      if (ql_type->main() == INT64) {
+        ql_value->set_int64_value(value);
+      } else {
+        ql_value->set_time_value(value);
+      }
+      return Status::OK();
+    }
+    case UINT32: FALLTHROUGH_INTENDED;
+    case DATE: {
+      if (value_type != ValueType::kUInt32) {
+        break;
+      }
+      RETURN_NOT_OK(CheckEncodedValueSize(value_type, slice, sizeof(uint32_t)));
+      const uint32_t value = BigEndian::Load32(slice.data());
+      if (ql_type->main() == UINT32) {
+        ql_value->set_uint32_value(value);
+      } else {
+        ql_value->set_date_value(value);
+      }
+      return Status::OK();
+    }
+    case UINT64:
+      if (value_type != ValueType::kUInt64) {
+        break;
+      }
+      RETURN_NOT_OK(CheckEncodedValueSize(value_type, slice, sizeof(uint64_t)));
+      ql_value->set_uint64_value(BigEndian::Load64(slice.data()));
+      return Status::OK();
+    case FLOAT:
+      if (value_type != ValueType::kFloat) {
+        break;
+      }
+      RETURN_NOT_OK(CheckEncodedValueSize(value_type, slice, sizeof(float)));
+      ql_value->set_float_value(bit_cast<float>(BigEndian::Load32(slice.data())));
+      return Status::OK();
+    case DOUBLE:
+      if (value_type != ValueType::kDouble) {
+        break;
+      }
+      RETURN_NOT_OK(CheckEncodedValueSize(value_type, slice, sizeof(double)));
+      ql_value->set_double_value(bit_cast<double>(BigEndian::Load64(slice.data())));
+      return Status::OK();
+    case BOOL:
+      if (value_type != ValueType::kFalse && value_type != ValueType::kTrue) {
+        break;
+      }
+      ql_value->set_bool_value(value_type == ValueType::kTrue);
+      return Status::OK();
+    case TIMESTAMP:
+      if (value_type != ValueType::kTimestamp) {
+        break;
+      }
+      RETURN_NOT_OK(CheckEncodedValueSize(value_type, slice, sizeof(Timestamp)));
+      ql_value->set_timestamp_value(Timestamp(BigEndian::Load64(slice.data())).ToInt64());
+      return Status::OK();
+    case STRING:
+      if (value_type != ValueType::kString) {
+        break;
+      }
+      ql_value->set_string_value(slice.cdata(), slice.size());
+      return Status::OK();
+    case BINARY:
+      if (value_type != ValueType::kString) {
+        break;
+      }
+      ql_value->set_binary_value(slice.cdata(), slice.size());
+      return Status::OK();
+    default:
+      break;
+  }
+
+  // Other types, and values stored in a different encoding, are decoded through PrimitiveValue.
+  PrimitiveValue value;
+  RETURN_NOT_OK(value.DecodeFromValue(encoded_value));
+  ToQLValuePB(value, ql_type, ql_value);
+  return Status::OK();
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -46,7 +46,8 @@ namespace docdb {
 class SubDocument;
 
 enum class SystemColumnIds : ColumnIdRep {
-  kLivenessColumn = 0  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kLivenessColumn = 0,  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kPackedRow = 1  // Stores values of all non key columns written by an insert, see packed_row.h.
 };
 
 class PrimitiveValue {
@@ -70,6 +71,9 @@ class PrimitiveValue {
     } else if (other.type_ == ValueType::kJsonb) {
       type_ = other.type_;
       new(&json_val_) std::string(other.json_val_);
+    } else if (other.type_ == ValueType::kPackedRow) {
+      type_ = other.type_;
+      new(&packed_row_val_) std::string(other.packed_row_val_);
     } else if (other.type_ == ValueType::kInetaddress
         || other.type_ == ValueType::kInetaddressDescending) {
       type_ = other.type_;
@@ -196,6 +200,12 @@ class PrimitiveValue {
                           const std::shared_ptr<QLType>& ql_type,
                           QLValuePB* ql_val);
 
+  // Same as DecodeFromValue followed by ToQLValuePB, but scalar values are decoded straight into
+  // the QLValuePB, without constructing a PrimitiveValue.
+  static CHECKED_STATUS DecodeToQLValuePB(const rocksdb::Slice& encoded_value,
+                                          const std::shared_ptr<QLType>& ql_type,
+                                          QLValuePB* ql_val);
+
   ValueType value_type() const { return type_; }
 
   void AppendToKey(KeyBytes* key_bytes) const;
@@ -210,6 +220,8 @@ class PrimitiveValue {
       str_val_.~basic_string();
     } else if (type_ == ValueType::kJsonb) {
       json_val_.~basic_string();
+    } else if (type_ == ValueType::kPackedRow) {
+      packed_row_val_.~basic_string();
     } else if (type_ == ValueType::kInetaddress || type_ == ValueType::kInetaddressDescending) {
       delete inetaddress_val_;
     } else if (type_ == ValueType::kDecimal || type_ == ValueType::kDecimalDescending) {
@@ -248,6 +260,7 @@ class PrimitiveValue {
   static PrimitiveValue TableId(Uuid table_id);
   static PrimitiveValue PgTableOid(const PgTableOid pgtable_id);
   static PrimitiveValue Jsonb(const std::string& json);
+  static PrimitiveValue PackedRow(std::string packed_row);
 
   KeyBytes ToKeyBytes() const;
 
@@ -361,6 +374,12 @@ class PrimitiveValue {
     return json_val_;
   }
 
+  // Returns encoded packed row, without the value type, see PackedRow.
+  Slice GetPackedRow() const {
+    DCHECK(type_ == ValueType::kPackedRow);
+    return Slice(packed_row_val_);
+  }
+
   const Uuid& GetUuid() const {
     DCHECK(type_ == ValueType::kUuid || type_ == ValueType::kUuidDescending ||
            type_ == ValueType::kTransactionId || type_ == ValueType::kTableId);
@@ -459,6 +478,7 @@ class PrimitiveValue {
     std::string decimal_val_;
     std::string varint_val_;
     std::string json_val_;
+    std::string packed_row_val_;
   };
 
  private:
@@ -483,6 +503,9 @@ class PrimitiveValue {
     } else if (other->type_ == ValueType::kJsonb) {
       type_ = other->type_;
       new(&json_val_) std::string(std::move(other->json_val_));
+    } else if (other->type_ == ValueType::kPackedRow) {
+      type_ = other->type_;
+      new(&packed_row_val_) std::string(std::move(other->packed_row_val_));
     } else if (other->type_ == ValueType::kDecimal ||
         other->type_ == ValueType::kDecimalDescending) {
       type_ = other->type_;
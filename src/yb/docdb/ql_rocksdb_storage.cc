@@ -41,6 +41,9 @@ Status QLRocksDBStorage::GetIterator(const QLReadRequestPB& request,
 
   auto doc_iter = std::make_unique<DocRowwiseIterator>(
       projection, schema, txn_op_context, doc_db_, deadline, read_time);
+  if (request.has_schema_version()) {
+    doc_iter->set_schema_version(request.schema_version());
+  }
   RETURN_NOT_OK(doc_iter->Init(spec));
   *iter = std::move(doc_iter);
   return Status::OK();
@@ -139,6 +142,9 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
   RETURN_NOT_OK(range_doc_key.DecodeFrom(ybctid.binary_value()));
   doc_iter = std::make_unique<DocRowwiseIterator>(
       projection, schema, txn_op_context, doc_db_, deadline, read_time);
+  if (request.has_schema_version()) {
+    doc_iter->set_schema_version(request.schema_version());
+  }
   RETURN_NOT_OK(doc_iter->Init(DocPgsqlScanSpec(schema, request.stmt_id(), range_doc_key)));
 
   *iter = std::move(doc_iter);
@@ -172,6 +178,9 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
     RETURN_NOT_OK(range_doc_key.DecodeFrom(request.ybctid_column_value().value().binary_value()));
     doc_iter = std::make_unique<DocRowwiseIterator>(
         projection, schema, txn_op_context, doc_db_, deadline, read_time);
+    if (request.has_schema_version()) {
+      doc_iter->set_schema_version(request.schema_version());
+    }
     RETURN_NOT_OK(doc_iter->Init(DocPgsqlScanSpec(schema,
                                                   request.stmt_id(),
                                                   range_doc_key)));
@@ -189,6 +198,9 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
 
     doc_iter = std::make_unique<DocRowwiseIterator>(
         projection, schema, txn_op_context, doc_db_, deadline, req_read_time);
+    if (request.has_schema_version()) {
+      doc_iter->set_schema_version(request.schema_version());
+    }
 
     if (request.range_column_values().size() > 0) {
       // Construct the scan spec basing on the RANGE condition.
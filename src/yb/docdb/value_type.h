@@ -128,6 +128,8 @@ namespace docdb {
     ((kWriteId, 'w')) /* ASCII code 119 */ \
     ((kTransactionId, 'x')) /* ASCII code 120 */ \
     ((kTableId, 'y')) /* ASCII code 121 */ \
+    /* All non key columns of a row stored in a single value, see packed_row.h. */ \
+    ((kPackedRow, 'z')) /* ASCII code 122 */ \
     \
     ((kObject, '{'))  /* ASCII code 123 */ \
     \
@@ -214,7 +216,7 @@ constexpr inline bool IsCollectionType(const ValueType value_type) {
 constexpr inline bool IsPrimitiveValueType(const ValueType value_type) {
   return kMinPrimitiveValueType <= value_type && value_type <= kMaxPrimitiveValueType &&
          !IsCollectionType(value_type) &&
-         value_type != ValueType::kTombstone;
+         value_type != ValueType::kTombstone && value_type != ValueType::kPackedRow;
 }
 
 constexpr inline bool IsSpecialValueType(ValueType value_type) {
@@ -0,0 +1,190 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <future>
+#include <thread>
+
+#include "yb/docdb/wait_queue.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace docdb {
+
+class WaitQueueTest : public YBTest {
+ protected:
+  // Starts waiting and returns future that receives argument of the wait callback.
+  std::future<bool> WaitAsync(const WaitQueue::WaiterPtr& waiter, CoarseTimePoint deadline) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto result = promise->get_future();
+    queue_.WaitAsync(waiter, deadline, [promise](bool woken) {
+      promise->set_value(woken);
+    });
+    return result;
+  }
+
+  WaitQueue queue_;
+};
+
+TEST_F(WaitQueueTest, WakeWhenAllBlockersFinished) {
+  auto waiter_id = TransactionId::GenerateRandom();
+  auto blocker1 = TransactionId::GenerateRandom();
+  auto blocker2 = TransactionId::GenerateRandom();
+
+  auto waiter = queue_.Register(waiter_id, {blocker1, blocker2});
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 2U);
+
+  auto future = WaitAsync(waiter, CoarseMonoClock::now() + 30s);
+
+  queue_.SignalFinished(blocker1);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::timeout);
+  queue_.SignalFinished(blocker2);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  ASSERT_TRUE(future.get());
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 0U);
+}
+
+TEST_F(WaitQueueTest, SignalBeforeWait) {
+  auto blocker = TransactionId::GenerateRandom();
+  auto waiter = queue_.Register(TransactionId::GenerateRandom(), {blocker});
+  queue_.SignalFinished(blocker);
+  auto future = WaitAsync(waiter, CoarseMonoClock::now() + 30s);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  ASSERT_TRUE(future.get());
+}
+
+// Blocker finishes after conflict resolution found it, but before the waiter was registered.
+// So nobody signals it, and the second status check of blockers should tell it to the waiter.
+TEST_F(WaitQueueTest, BlockerFinishedBeforeRegister) {
+  auto blocker1 = TransactionId::GenerateRandom();
+  auto blocker2 = TransactionId::GenerateRandom();
+  auto blocker3 = TransactionId::GenerateRandom();
+  queue_.SignalFinished(blocker1);
+
+  auto waiter = queue_.Register(TransactionId::GenerateRandom(), {blocker1, blocker2, blocker3});
+  // Blocker3 finishes concurrently with the second check, and is still reported as running.
+  queue_.SignalFinished(blocker3);
+  queue_.RetainBlockers(waiter, {blocker2, blocker3});
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 1U);
+
+  auto future = WaitAsync(waiter, CoarseMonoClock::now() + 30s);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::timeout);
+  queue_.SignalFinished(blocker2);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  ASSERT_TRUE(future.get());
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 0U);
+
+  // All blockers finished before registration.
+  waiter = queue_.Register(TransactionId::GenerateRandom(), {blocker1, blocker2});
+  future = WaitAsync(waiter, CoarseMonoClock::now() + 30s);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::timeout);
+  queue_.RetainBlockers(waiter, {});
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  ASSERT_TRUE(future.get());
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 0U);
+}
+
+TEST_F(WaitQueueTest, Timeout) {
+  auto blocker1 = TransactionId::GenerateRandom();
+  auto blocker2 = TransactionId::GenerateRandom();
+  auto waiter = queue_.Register(TransactionId::GenerateRandom(), {blocker1, blocker2});
+  queue_.SignalFinished(blocker1);
+  auto deadline = CoarseMonoClock::now() + 30s;
+  auto future = WaitAsync(waiter, deadline);
+
+  queue_.ExpireWaiters(deadline - 1s);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::timeout);
+  queue_.ExpireWaiters(deadline);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  ASSERT_FALSE(future.get());
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 0U);
+
+  // Signal for unregistered waiter should be ignored.
+  queue_.SignalFinished(blocker2);
+
+  // Waiter with deadline in the past completes right away.
+  waiter = queue_.Register(TransactionId::GenerateRandom(), {blocker1});
+  ASSERT_FALSE(WaitAsync(waiter, CoarseMonoClock::now() - 1s).get());
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 0U);
+}
+
+TEST_F(WaitQueueTest, Unregister) {
+  auto blocker = TransactionId::GenerateRandom();
+  auto waiter1 = queue_.Register(TransactionId::GenerateRandom(), {blocker});
+  auto waiter2 = queue_.Register(TransactionId::GenerateRandom(), {blocker});
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 2U);
+  queue_.Unregister(waiter1);
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 1U);
+  queue_.SignalFinished(blocker);
+  ASSERT_TRUE(WaitAsync(waiter2, CoarseMonoClock::now() + 30s).get());
+}
+
+TEST_F(WaitQueueTest, Shutdown) {
+  auto waiter = queue_.Register(
+      TransactionId::GenerateRandom(), {TransactionId::GenerateRandom()});
+  auto future = WaitAsync(waiter, CoarseMonoClock::now() + 30s);
+  ASSERT_EQ(future.wait_for(0s), std::future_status::timeout);
+  queue_.Shutdown();
+  ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+  ASSERT_FALSE(future.get());
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 0U);
+
+  // New waiters don't wait after shutdown.
+  waiter = queue_.Register(TransactionId::GenerateRandom(), {TransactionId::GenerateRandom()});
+  ASSERT_FALSE(WaitAsync(waiter, CoarseMonoClock::now() + 30s).get());
+}
+
+// Many waiters contend for the same blockers, every one of them should be resumed exactly once,
+// and none of them should hold a thread while waiting.
+TEST_F(WaitQueueTest, ManyWaiters) {
+  constexpr int kBlockers = 4;
+  constexpr int kWaiters = 1000;
+
+  std::vector<TransactionId> blockers;
+  for (int i = 0; i != kBlockers; ++i) {
+    blockers.push_back(TransactionId::GenerateRandom());
+  }
+
+  std::atomic<int> woken{0};
+  std::atomic<int> expired{0};
+  for (int i = 0; i != kWaiters; ++i) {
+    // Every waiter waits for a couple of blockers, some of them expire.
+    auto waiter = queue_.Register(
+        TransactionId::GenerateRandom(),
+        {blockers[i % kBlockers], blockers[(i + 1) % kBlockers]});
+    auto deadline = CoarseMonoClock::now() + (i % 10 == 0 ? 0s : 30s);
+    queue_.WaitAsync(waiter, deadline, [&woken, &expired](bool ok) {
+      ++(ok ? woken : expired);
+    });
+  }
+
+  std::vector<std::thread> threads;
+  for (const auto& blocker : blockers) {
+    threads.emplace_back([this, blocker] {
+      queue_.SignalFinished(blocker);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(expired.load(), kWaiters / 10);
+  ASSERT_EQ(woken.load(), kWaiters - kWaiters / 10);
+  ASSERT_EQ(queue_.TEST_NumWaiters(), 0U);
+}
+
+} // namespace docdb
+} // namespace yb
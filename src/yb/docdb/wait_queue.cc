@@ -0,0 +1,231 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/wait_queue.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "yb/util/tostring.h"
+
+namespace yb {
+namespace docdb {
+
+class WaitQueue::Waiter {
+ public:
+  Waiter(const TransactionId& id, std::vector<TransactionId> blockers)
+      : id_(id), blockers_(std::move(blockers)), left_(blockers_.size()) {}
+
+  const TransactionId& id() const {
+    return id_;
+  }
+
+  const std::vector<TransactionId>& blockers() const {
+    return blockers_;
+  }
+
+ private:
+  friend class WaitQueue;
+
+  const TransactionId id_;
+  const std::vector<TransactionId> blockers_;
+  // Fields below are protected by WaitQueue::mutex_.
+  // Number of blockers that are not finished yet.
+  size_t left_;
+  bool registered_ = true;
+  WaitCallback callback_;
+  CoarseTimePoint deadline_;
+};
+
+WaitQueue::WaitQueue() = default;
+
+WaitQueue::~WaitQueue() {
+  Shutdown();
+}
+
+WaitQueue::WaiterPtr WaitQueue::Register(
+    const TransactionId& waiter_id, const std::vector<TransactionId>& blockers) {
+  auto result = std::make_shared<Waiter>(waiter_id, blockers);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (closing_) {
+    result->registered_ = false;
+    return result;
+  }
+  for (const auto& blocker : blockers) {
+    waiters_[blocker].push_back(result);
+  }
+  VLOG(4) << waiter_id << " waits for " << yb::ToString(blockers);
+  return result;
+}
+
+void WaitQueue::WaitAsync(
+    const WaiterPtr& waiter, CoarseTimePoint deadline, WaitCallback callback) {
+  Callbacks callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DCHECK(!waiter->callback_);
+    waiter->callback_ = std::move(callback);
+    waiter->deadline_ = deadline;
+    if (waiter->left_ == 0 && !closing_) {
+      CompleteUnlocked(waiter, /* woken= */ true, &callbacks);
+    } else if (closing_ || deadline <= CoarseMonoClock::now()) {
+      CompleteUnlocked(waiter, /* woken= */ false, &callbacks);
+    } else {
+      waiting_.push_back(waiter);
+    }
+  }
+  InvokeCallbacks(&callbacks);
+}
+
+void WaitQueue::Unregister(const WaiterPtr& waiter) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  UnregisterUnlocked(waiter);
+}
+
+void WaitQueue::UnregisterUnlocked(const WaiterPtr& waiter) {
+  if (!waiter->registered_) {
+    return;
+  }
+  waiter->registered_ = false;
+  if (waiter->left_ == 0) {
+    // All blockers finished, so waiter was already removed from all queues.
+    return;
+  }
+  for (const auto& blocker : waiter->blockers_) {
+    RemoveFromQueueUnlocked(blocker, waiter);
+  }
+}
+
+bool WaitQueue::RemoveFromQueueUnlocked(const TransactionId& blocker, const WaiterPtr& waiter) {
+  auto it = waiters_.find(blocker);
+  if (it == waiters_.end()) {
+    return false;
+  }
+  auto& queue = it->second;
+  auto queue_it = std::find(queue.begin(), queue.end(), waiter);
+  if (queue_it == queue.end()) {
+    return false;
+  }
+  queue.erase(queue_it);
+  if (queue.empty()) {
+    waiters_.erase(it);
+  }
+  return true;
+}
+
+void WaitQueue::RetainBlockers(const WaiterPtr& waiter, const std::vector<TransactionId>& running) {
+  Callbacks callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!waiter->registered_ || waiter->left_ == 0) {
+      return;
+    }
+    for (const auto& blocker : waiter->blockers_) {
+      if (std::find(running.begin(), running.end(), blocker) != running.end()) {
+        continue;
+      }
+      // Waiter is not in the queue when blocker was already signaled after registration.
+      if (!RemoveFromQueueUnlocked(blocker, waiter)) {
+        continue;
+      }
+      VLOG(4) << waiter->id() << " does not wait for finished " << blocker;
+      if (--waiter->left_ == 0 && waiter->callback_) {
+        waiting_.erase(std::remove(waiting_.begin(), waiting_.end(), waiter), waiting_.end());
+        CompleteUnlocked(waiter, /* woken= */ true, &callbacks);
+        break;
+      }
+    }
+  }
+  InvokeCallbacks(&callbacks);
+}
+
+void WaitQueue::CompleteUnlocked(const WaiterPtr& waiter, bool woken, Callbacks* callbacks) {
+  UnregisterUnlocked(waiter);
+  if (waiter->callback_) {
+    callbacks->emplace_back(std::move(waiter->callback_), woken);
+    waiter->callback_ = nullptr;
+  }
+}
+
+void WaitQueue::InvokeCallbacks(Callbacks* callbacks) {
+  for (auto& entry : *callbacks) {
+    entry.first(entry.second);
+  }
+}
+
+void WaitQueue::SignalFinished(const TransactionId& id) {
+  Callbacks callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = waiters_.find(id);
+    if (it == waiters_.end()) {
+      return;
+    }
+    auto queue = std::move(it->second);
+    waiters_.erase(it);
+    for (const auto& waiter : queue) {
+      if (--waiter->left_ != 0) {
+        continue;
+      }
+      VLOG(4) << "Wake " << waiter->id() << " after " << id;
+      if (waiter->callback_) {
+        waiting_.erase(std::remove(waiting_.begin(), waiting_.end(), waiter), waiting_.end());
+        CompleteUnlocked(waiter, /* woken= */ true, &callbacks);
+      }
+      // Otherwise WaitAsync was not invoked yet, and will complete the waiter right away.
+    }
+  }
+  InvokeCallbacks(&callbacks);
+}
+
+void WaitQueue::ExpireWaiters(CoarseTimePoint now) {
+  Callbacks callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::partition(waiting_.begin(), waiting_.end(), [now](const WaiterPtr& waiter) {
+      return waiter->deadline_ > now;
+    });
+    for (auto i = it; i != waiting_.end(); ++i) {
+      VLOG(4) << "Expired " << (*i)->id();
+      CompleteUnlocked(*i, /* woken= */ false, &callbacks);
+    }
+    waiting_.erase(it, waiting_.end());
+  }
+  InvokeCallbacks(&callbacks);
+}
+
+void WaitQueue::Shutdown() {
+  Callbacks callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+    for (const auto& waiter : waiting_) {
+      CompleteUnlocked(waiter, /* woken= */ false, &callbacks);
+    }
+    waiting_.clear();
+  }
+  InvokeCallbacks(&callbacks);
+}
+
+size_t WaitQueue::TEST_NumWaiters() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t result = 0;
+  for (const auto& entry : waiters_) {
+    result += entry.second.size();
+  }
+  return result;
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,105 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_WAIT_QUEUE_H
+#define YB_DOCDB_WAIT_QUEUE_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/transaction.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace docdb {
+
+// Per tablet queue of transactions that are waiting for conflicting transactions (blockers) to
+// finish, instead of failing with conflict and retrying the whole transaction.
+//
+// Conflict resolution parks a transaction here only when all of its blockers have higher priority.
+// So every edge of the wait-for graph goes from lower to higher priority, and the graph cannot
+// have a cycle, even when its edges belong to different tablets. Transaction with higher priority
+// never waits, it aborts the lower priority blocker as before.
+//
+// Blockers are reported as finished by the transaction participant, when the transaction is removed
+// from the tablet, i.e. after its intents were applied or the transaction was aborted. Waiters of
+// a blocker are woken in the order they started waiting.
+//
+// Waiting does not block any thread, the waiter is resumed via callback.
+class WaitQueue {
+ public:
+  class Waiter;
+  typedef std::shared_ptr<Waiter> WaiterPtr;
+  // Invoked with true when all blockers of the waiter finished, and with false when the waiter
+  // expired or the queue was shut down.
+  typedef std::function<void(bool woken)> WaitCallback;
+
+  WaitQueue();
+  ~WaitQueue();
+
+  // Registers waiter for specified transaction, that is blocked by transactions in `blockers`.
+  // Registration should happen before the final status check of blockers, so the waiter does not
+  // miss a blocker that finishes concurrently.
+  WaiterPtr Register(const TransactionId& waiter_id, const std::vector<TransactionId>& blockers);
+
+  // Invokes callback exactly once, when all blockers of waiter finished, or after deadline passed,
+  // see ExpireWaiters. Then waiter is unregistered.
+  // Callback could be invoked synchronously, or from SignalFinished, ExpireWaiters or Shutdown.
+  // So it should not block, and should not acquire locks held while those are called.
+  void WaitAsync(const WaiterPtr& waiter, CoarseTimePoint deadline, WaitCallback callback);
+
+  // Notifies waiter that only blockers from `running` are still running, i.e. all other blockers
+  // of the waiter finished before it was registered. Nobody would signal such blockers anymore, so
+  // they are considered finished for this waiter.
+  void RetainBlockers(const WaiterPtr& waiter, const std::vector<TransactionId>& running);
+
+  // Unregisters waiter that was not waited, e.g. because its blockers already finished.
+  void Unregister(const WaiterPtr& waiter);
+
+  // Notifies waiters that the specified transaction has finished.
+  void SignalFinished(const TransactionId& id);
+
+  // Invokes callbacks of waiters whose deadline passed before now.
+  void ExpireWaiters(CoarseTimePoint now);
+
+  // Invokes callbacks of all waiters and prevents new waits.
+  void Shutdown();
+
+  size_t TEST_NumWaiters() const;
+
+ private:
+  typedef std::vector<std::pair<WaitCallback, bool>> Callbacks;
+
+  void UnregisterUnlocked(const WaiterPtr& waiter);
+  // Removes waiter from the queue of specified blocker. Returns false if it was not there.
+  bool RemoveFromQueueUnlocked(const TransactionId& blocker, const WaiterPtr& waiter);
+  // Unregisters waiter and adds its callback with specified argument to callbacks.
+  void CompleteUnlocked(const WaiterPtr& waiter, bool woken, Callbacks* callbacks);
+  static void InvokeCallbacks(Callbacks* callbacks);
+
+  mutable std::mutex mutex_;
+  bool closing_ = false;
+  std::unordered_map<TransactionId, std::deque<WaiterPtr>, TransactionIdHash> waiters_;
+  // Waiters that have callback, i.e. WaitAsync was invoked for them.
+  std::vector<WaiterPtr> waiting_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_WAIT_QUEUE_H
@@ -23,6 +23,7 @@
 #include "yb/rocksdb/util/testutil.h"
 
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
@@ -34,6 +35,8 @@ DECLARE_bool(flush_rocksdb_on_shutdown);
 DECLARE_int64(global_memstore_size_percentage);
 DECLARE_int64(global_memstore_size_mb_max);
 DECLARE_int32(memstore_size_mb);
+DECLARE_double(memstore_flush_age_weight);
+DECLARE_double(memstore_flush_size_weight);
 DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
 DECLARE_int32(rocksdb_max_background_flushes);
 
@@ -368,5 +371,68 @@ TEST_F(FlushITest, TestFlushPicksOldestInactiveTabletAfterCompactionWithRestart)
   TestFlushPicksOldestInactiveTabletAfterCompaction(true /* with_restart */);
 }
 
+// Checks that when the global memstore limit is reached, the largest memstores are flushed, and
+// only until the memory that is not being flushed fits into the limit.
+TEST_F(FlushITest, TestFlushPicksLargestMemstoresUntilLimitFits) {
+  FLAGS_memstore_flush_age_weight = 0;
+  FLAGS_memstore_flush_size_weight = 1;
+
+  std::unordered_set<TabletId> known_tablets;
+  auto new_tablets = [this, &known_tablets] {
+    std::unordered_set<TabletId> result;
+    for (auto& peer : cluster_->GetTabletPeers(0)) {
+      if (known_tablets.insert(peer->tablet_id()).second) {
+        result.insert(peer->tablet_id());
+      }
+    }
+    return result;
+  };
+  new_tablets();
+
+  // Large memstores, that should be flushed first.
+  SetupWorkload(GetTableName(1));
+  WriteAtLeast(kServerLimitMB * 1_MB * 3 / 5);
+  const auto large_tablets = new_tablets();
+
+  // Small memstores, flushing them is not required to fit into the limit.
+  SetupWorkload(GetTableName(2));
+  WriteAtLeast(kServerLimitMB * 1_MB / 32);
+  const auto small_tablets = new_tablets();
+  ASSERT_TRUE(tablet_manager_listener_->GetFlushedTablets().empty());
+
+  // Write to another table until the limit is reached.
+  SetupWorkload(GetTableName(3));
+  workload_->Start();
+  ASSERT_OK(LoggedWaitFor(
+      [this] { return !tablet_manager_listener_->GetFlushedTablets().empty(); }, 60s,
+      "Waiting until the memstore limit triggers a flush ...", kWaitDelay));
+  workload_->StopAndJoin();
+  DumpMemoryUsage();
+
+  const auto flushed_tablets = tablet_manager_listener_->GetFlushedTablets();
+  LOG(INFO) << "Flushed tablets: " << yb::ToString(flushed_tablets);
+  ASSERT_EQ(large_tablets.count(flushed_tablets.front()), 1)
+      << "The first flushed tablet does not have the largest memstore";
+  for (const auto& tablet_id : flushed_tablets) {
+    ASSERT_EQ(small_tablets.count(tablet_id), 0)
+        << "Flushed tablet with small memstore, that was not required to fit into the limit: "
+        << tablet_id;
+  }
+}
+
+// Checks that writes are not throttled by the global memstore limit, while flushes triggered by
+// this limit keep up with writes. Memstores that are being flushed stay in the memstore usage until
+// the flush completes, so they should not be counted by throttling.
+TEST_F(FlushITest, NoMemstoreThrottlingWhileFlushesKeepUp) {
+  WriteAtLeast(kServerLimitMB * 1_MB * 10);
+  ASSERT_GT(tablet_manager_listener_->GetFlushedTablets().size(), 1U);
+
+  int64_t rejections = 0;
+  for (auto& peer : cluster_->GetTabletPeers(0)) {
+    rejections += peer->tablet()->metrics()->global_memstore_rejections->value();
+  }
+  ASSERT_EQ(rejections, 0);
+}
+
 } // namespace tserver
 } // namespace yb
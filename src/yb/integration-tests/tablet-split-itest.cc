@@ -23,6 +23,7 @@
 
 #include "yb/rpc/messenger.h"
 
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 
 #include "yb/tserver/mini_tablet_server.h"
@@ -38,6 +39,11 @@ using namespace std::literals;  // NOLINT
 DECLARE_int64(db_write_buffer_size);
 DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
 DECLARE_bool(do_not_start_election_test_only);
+DECLARE_bool(enable_automatic_tablet_splitting);
+DECLARE_uint64(tablet_split_size_threshold_bytes);
+DECLARE_int32(tablet_split_table_cooldown_sec);
+DECLARE_int32(tserver_heartbeat_metrics_interval_ms);
+DECLARE_bool(fail_tablet_split);
 
 namespace yb {
 
@@ -307,4 +313,117 @@ TEST_F(TabletSplitITest, SplitSingleTablet) {
   CheckSourceTabletAfterSplit(source_tablet_id);
 }
 
+class AutomaticTabletSplitITest : public TabletSplitITest {
+ public:
+  void SetUp() override {
+    FLAGS_tserver_heartbeat_metrics_interval_ms = 100;
+    FLAGS_enable_automatic_tablet_splitting = true;
+    // Any tablet with SST files should be split.
+    FLAGS_tablet_split_size_threshold_bytes = 1;
+    // New tablets should not be split again during the test.
+    FLAGS_tablet_split_table_cooldown_sec = 3600;
+    TabletSplitITest::SetUp();
+  }
+};
+
+// Tests automatic splitting of the single tablet:
+// 1. Tablet is split by master, once its leader reports split point after flush.
+// 2. New tablets don't have split point, until data of the source tablet is compacted out of them.
+// 3. New tablets are not split again during table split cooldown.
+// 4. Split state of the source tablet survives master restart, so it is not split twice.
+TEST_F(AutomaticTabletSplitITest, SplitSingleTablet) {
+  constexpr auto kNumRows = 1000;
+
+  CreateTable(client::Transactional::kFalse, 1 /* num_tablets */, client_.get(), &table_);
+  ASSERT_RESULT(WriteRows(kNumRows));
+
+  auto* leader_master = ASSERT_NOTNULL(cluster_->leader_mini_master()->master());
+  const auto source_tablet_id = ASSERT_RESULT(GetSingleTestTabletInfo(*leader_master))->id();
+
+  // Writes are reported to master as write requests handled by the tablet leader.
+  int64_t write_requests = 0;
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+    if (peer->tablet_id() == source_tablet_id) {
+      write_requests += peer->tablet()->metrics()->write_requests->value();
+    }
+  }
+  ASSERT_GT(write_requests, 0);
+
+  // Tablet without SST files does not have split point.
+  SleepFor(1s * kTimeMultiplier);
+  ASSERT_RESULT(GetSingleTestTabletInfo(*leader_master));
+
+  ASSERT_OK(cluster_->FlushTablets());
+  WaitForTabletSplitCompletion();
+  CheckTabletReplicasData(kNumRows);
+
+  const auto is_new_tablet = [&source_tablet_id](
+      const std::shared_ptr<tablet::TabletPeer>& peer) {
+    return peer->tablet_id() != source_tablet_id;
+  };
+  for (const auto& peer : ListTabletPeers(cluster_.get(), is_new_tablet)) {
+    ASSERT_FALSE(peer->tablet()->split_hash_code()) << peer->tablet_id();
+    auto split_hash_code = peer->tablet()->GetMiddleSplitHashCode();
+    ASSERT_TRUE(split_hash_code.status().IsIllegalState()) << split_hash_code.status();
+  }
+
+  ASSERT_OK(cluster_->CompactTablets());
+  for (const auto& peer : ListTabletPeers(cluster_.get(), is_new_tablet)) {
+    ASSERT_OK(WaitFor([&peer] {
+      return peer->tablet()->split_hash_code().is_initialized();
+    }, 10s * kTimeMultiplier, "Wait for split point of " + peer->tablet_id()));
+  }
+
+  // Leaders of the new tablets report split point now, but the table is in split cooldown.
+  SleepFor(1s * kTimeMultiplier);
+  const auto replication_factor = cluster_->num_tablet_servers();
+  ASSERT_EQ(ListTabletPeers(cluster_.get(), ListPeersFilter::kAll).size(),
+            3 * replication_factor);
+
+  ASSERT_OK(cluster_->leader_mini_master()->Restart());
+  ASSERT_OK(cluster_->leader_mini_master()->WaitUntilCatalogManagerIsLeaderAndReadyForTests());
+  auto* catalog_mgr = cluster_->leader_mini_master()->master()->catalog_manager();
+  auto source_tablet_info = catalog_mgr->GetTabletInfo(source_tablet_id);
+  ASSERT_NE(source_tablet_info, nullptr);
+  ASSERT_EQ(source_tablet_info->LockForRead()->data().pb.split_tablet_ids_size(), 2);
+  auto status = catalog_mgr->TEST_SplitTablet(source_tablet_info, 0x8000 /* split_hash_code */);
+  ASSERT_TRUE(status.IsAlreadyPresent()) << status;
+}
+
+// Tests that automatic split, whose SplitTablet RPC was rejected by the source tablet leader, is
+// rolled back, so the tablet could be split again.
+TEST_F(AutomaticTabletSplitITest, RollbackRejectedSplit) {
+  constexpr auto kNumRows = 1000;
+
+  FLAGS_fail_tablet_split = true;
+  CreateTable(client::Transactional::kFalse, 1 /* num_tablets */, client_.get(), &table_);
+  ASSERT_RESULT(WriteRows(kNumRows));
+
+  auto& leader_master = *ASSERT_NOTNULL(cluster_->leader_mini_master()->master());
+  auto source_tablet_info = ASSERT_RESULT(GetSingleTestTabletInfo(leader_master));
+  const auto source_tablet_id = source_tablet_info->id();
+  auto* catalog_mgr = leader_master.catalog_manager();
+
+  ASSERT_OK(cluster_->FlushTablets());
+  std::vector<TabletId> new_tablet_ids;
+  ASSERT_OK(WaitFor([&source_tablet_info, &new_tablet_ids] {
+    const auto& split_tablet_ids = source_tablet_info->LockForRead()->data().pb.split_tablet_ids();
+    new_tablet_ids.assign(split_tablet_ids.begin(), split_tablet_ids.end());
+    return !new_tablet_ids.empty();
+  }, 30s * kTimeMultiplier, "Wait for automatic split"));
+
+  ASSERT_OK(WaitFor([&source_tablet_info] {
+    return source_tablet_info->LockForRead()->data().pb.split_tablet_ids_size() == 0;
+  }, 30s * kTimeMultiplier, "Wait for split rollback"));
+  for (const auto& new_tablet_id : new_tablet_ids) {
+    ASSERT_EQ(catalog_mgr->GetTabletInfo(new_tablet_id), nullptr);
+  }
+
+  FLAGS_fail_tablet_split = false;
+  FLAGS_tablet_split_table_cooldown_sec = 0;
+  WaitForTabletSplitCompletion();
+  CheckTabletReplicasData(kNumRows);
+  CheckSourceTabletAfterSplit(source_tablet_id);
+}
+
 }  // namespace yb
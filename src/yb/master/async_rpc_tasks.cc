@@ -24,6 +24,7 @@
 #include "yb/rpc/messenger.h"
 
 #include "yb/tserver/tserver_admin.proxy.h"
+#include "yb/tserver/tserver_error.h"
 
 #include "yb/util/atomic.h"
 #include "yb/util/flag_tags.h"
@@ -1159,6 +1160,20 @@ void AsyncSplitTablet::HandleResponse(int attempt) {
     LOG_WITH_PREFIX(WARNING) << "TS " << permanent_uuid() << ": split (attempt " << attempt
                              << ") failed for tablet " << tablet_id() << " with error code "
                              << TabletServerErrorPB::Code_Name(code) << ": " << s;
+    switch (code) {
+      case TabletServerErrorPB::TABLET_SPLIT:
+        // Split operation was replicated by one of the previous attempts.
+        TransitionToCompleteState();
+        break;
+      case TabletServerErrorPB::TABLET_SPLIT_REJECTED:
+        // Tablet leader made sure that the tablet is not split, so there is no point in retrying.
+        TransitionToFailedState(
+            MonitoredTaskState::kRunning,
+            s.CloneAndAddErrorCode(tserver::TabletServerError(code)));
+        break;
+      default:
+        break;
+    }
   } else {
     VLOG_WITH_PREFIX(1)
         << "TS " << permanent_uuid() << ": split complete on tablet " << tablet_id();
@@ -1168,6 +1183,12 @@ void AsyncSplitTablet::HandleResponse(int attempt) {
   server::UpdateClock(resp_, master_->clock());
 }
 
+void AsyncSplitTablet::Finished(const Status& status) {
+  if (callback_) {
+    callback_(status);
+  }
+}
+
 bool AsyncSplitTablet::SendRequest(int attempt) {
   req_.set_dest_uuid(permanent_uuid());
   req_.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
@@ -35,6 +35,7 @@
 #include "yb/tserver/tserver_service.pb.h"
 
 #include "yb/util/status.h"
+#include "yb/util/status_callback.h"
 #include "yb/util/memory/memory.h"
 
 
@@ -621,12 +622,20 @@ class AsyncSplitTablet : public AsyncTabletLeaderTask {
 
   std::string type_name() const override { return "Split Tablet"; }
 
+  // Callback is invoked when task reaches terminal state, i.e. it completed, or failed after all
+  // retries, or was aborted.
+  void SetCallback(StdStatusCallback callback) {
+    callback_ = std::move(callback);
+  }
+
  protected:
   void HandleResponse(int attempt) override;
   bool SendRequest(int attempt) override;
+  void Finished(const Status& status) override;
 
   tserver::SplitTabletRequestPB req_;
   tserver::SplitTabletResponsePB resp_;
+  StdStatusCallback callback_;
 };
 
 } // namespace master
@@ -182,6 +182,16 @@ uint32_t TabletInfo::reported_schema_version() const {
   return reported_schema_version_;
 }
 
+void TabletInfo::set_load_stats(const TabletLoadStats& stats) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  load_stats_ = stats;
+}
+
+TabletLoadStats TabletInfo::load_stats() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return load_stats_;
+}
+
 bool TabletInfo::colocated() const {
   auto l = LockForRead();
   return l->data().pb.colocated();
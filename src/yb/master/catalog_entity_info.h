@@ -43,6 +43,7 @@
 #include "yb/util/cow_object.h"
 #include "yb/common/entity_ids.h"
 #include "yb/util/monotime.h"
+#include "yb/util/tostring.h"
 #include "yb/server/monitored_task.h"
 #include "yb/common/schema.h"
 #include "yb/common/index.h"
@@ -163,6 +164,20 @@ class TableInfo;
 
 typedef std::unordered_map<TabletServerId, MonoTime> LeaderStepDownFailureTimes;
 
+// Load of the tablet, as last reported by its leader in tablet server heartbeat.
+struct TabletLoadStats {
+  double read_ops_per_sec = 0;
+  double write_ops_per_sec = 0;
+  uint64_t sst_file_size = 0;
+
+  // Time when stats were received, not initialized if leader did not report stats yet.
+  MonoTime report_time;
+
+  std::string ToString() const {
+    return YB_STRUCT_TO_STRING(read_ops_per_sec, write_ops_per_sec, sst_file_size);
+  }
+};
+
 // The information about a single tablet which exists in the cluster,
 // including its state and locations.
 //
@@ -209,6 +224,10 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   bool set_reported_schema_version(uint32_t version);
   uint32_t reported_schema_version() const;
 
+  // Accessors for the load stats reported by the tablet leader (in-memory only).
+  void set_load_stats(const TabletLoadStats& stats);
+  TabletLoadStats load_stats() const;
+
   bool colocated() const;
 
   // No synchronization needed.
@@ -252,6 +271,8 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
 
+  TabletLoadStats load_stats_;
+
   LeaderStepDownFailureTimes leader_stepdown_failure_times_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletInfo);
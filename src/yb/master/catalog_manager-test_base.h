@@ -24,6 +24,8 @@
 #include "yb/master/catalog_manager_util.h"
 #include "yb/master/cluster_balance_mocked.h"
 
+DECLARE_int32(load_balancer_max_tablet_load_stats_age_ms);
+
 namespace yb {
 namespace master {
 
@@ -171,6 +173,12 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs_multi_az);
     TestBalancingLeaders();
 
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingLeadersByResourceLoad();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingReplicasByResourceLoad();
+
     PrepareTestState(ts_descs_single_az);
     TestMissingPlacementSingleAz();
 
@@ -200,6 +208,16 @@ class TestLoadBalancerBase {
     return cb_->HandleLeaderMoves(out_tablet_id, out_from_ts, out_to_ts);
   }
 
+  Result<bool> HandleResourceMoves(
+      TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
+    return cb_->HandleResourceMoves(out_tablet_id, out_from_ts, out_to_ts);
+  }
+
+  Result<bool> GetReplicaResourceMove(
+      TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
+    return cb_->GetReplicaResourceMove(out_tablet_id, out_from_ts, out_to_ts);
+  }
+
   void TestLeaderBlacklist() {
     LOG(INFO) << "Testing moving overloaded leaders";
     // Move leaders of tablet i to ts i%3.
@@ -730,6 +748,102 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
   }
 
+  void TestBalancingLeadersByResourceLoad() {
+    LOG(INFO) << "Testing moving leaders to even out resource load";
+    LOG(INFO) << "Leader distribution: 2 1 1";
+    ASSERT_OK(AnalyzeTablets());
+
+    // Leader counts are balanced and no stats were reported, so nothing should be moved.
+    string placeholder, tablet_id;
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+    ASSERT_FALSE(ASSERT_RESULT(HandleResourceMoves(&placeholder, &placeholder, &placeholder)));
+
+    // Both leaders on ts0 are hot.
+    for (int i = 0; i < tablets_.size(); ++i) {
+      TabletLoadStats stats;
+      stats.read_ops_per_sec = i == 0 || i == 3 ? 100 : 10;
+      stats.report_time = MonoTime::Now();
+      tablets_[i]->set_load_stats(stats);
+    }
+    LOG(INFO) << "Leader read ops: 200 10 10";
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+
+    // One hot leader should be moved off ts0, to the first of equally loaded servers.
+    TestResourceMove(&tablet_id, ts_descs_[0]->permanent_uuid(), ts_descs_[1]->permanent_uuid());
+    ASSERT_TRUE(tablet_id == tablets_[0]->tablet_id() || tablet_id == tablets_[3]->tablet_id());
+
+    // Now ts1 is the hottest server, so its cold leader should be moved to ts2, while the hot
+    // leader that was just moved should stay.
+    TestResourceMove(&tablet_id, ts_descs_[1]->permanent_uuid(), ts_descs_[2]->permanent_uuid());
+    ASSERT_EQ(tablet_id, tablets_[1]->tablet_id());
+
+    // Hot leaders are on different servers, so no move makes it better.
+    ASSERT_FALSE(ASSERT_RESULT(HandleResourceMoves(&placeholder, &placeholder, &placeholder)));
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+  }
+
+  void TestBalancingReplicasByResourceLoad() {
+    LOG(INFO) << "Testing moving replicas to even out resource load";
+    PlacementInfoPB* cluster_placement = replication_info_.mutable_live_replicas();
+    cluster_placement->set_num_replicas(kNumReplicas);
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    ts_descs_.push_back(SetupTS("4444", "b"));
+
+    // Replica counts are 3 3 2 2 2, which is balanced.
+    const std::vector<std::vector<int>> tablet_servers = {
+        {0, 1, 2}, {0, 1, 3}, {0, 2, 4}, {1, 3, 4}};
+    const std::vector<int> leaders = {2, 3, 4, 4};
+    for (int i = 0; i < tablets_.size(); ++i) {
+      TabletInfo::ReplicaMap replica_map;
+      for (auto j : tablet_servers[i]) {
+        TabletReplica replica;
+        NewReplica(ts_descs_[j].get(), tablet::RUNNING,
+                   leaders[i] == j ? consensus::RaftPeerPB::LEADER
+                                   : consensus::RaftPeerPB::FOLLOWER,
+                   &replica);
+        InsertOrDie(&replica_map, ts_descs_[j]->permanent_uuid(), replica);
+      }
+      tablets_[i]->SetReplicaLocations(replica_map);
+    }
+
+    // Tablets 0 and 1 take 3 times more writes than others, so their replica load is 1.25 and 0.75
+    // for others. Resource load of tablet servers is 3.25 3.25 2 2 1.5.
+    const auto set_stats = [this](MonoTime report_time) {
+      for (int i = 0; i < tablets_.size(); ++i) {
+        TabletLoadStats stats;
+        stats.write_ops_per_sec = i < 2 ? 30 : 10;
+        stats.sst_file_size = 1000;
+        stats.report_time = report_time;
+        tablets_[i]->set_load_stats(stats);
+      }
+    };
+
+    // Stale stats should be ignored, so all tablets are considered equally loaded, and there is no
+    // single replica move that makes load more even.
+    set_stats(MonoTime::Now() - MonoDelta::FromMilliseconds(
+        FLAGS_load_balancer_max_tablet_load_stats_age_ms * 2));
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    string placeholder, tablet_id, from_ts, to_ts;
+    ASSERT_FALSE(ASSERT_RESULT(GetReplicaResourceMove(&placeholder, &placeholder, &placeholder)));
+
+    set_stats(MonoTime::Now());
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+
+    // One of hot replicas should be moved from the most loaded server to the least loaded one,
+    // bringing their loads to 2 and 2.75.
+    ASSERT_TRUE(ASSERT_RESULT(GetReplicaResourceMove(&tablet_id, &from_ts, &to_ts)));
+    ASSERT_TRUE(tablet_id == tablets_[0]->tablet_id() || tablet_id == tablets_[1]->tablet_id());
+    ASSERT_EQ(ts_descs_[1]->permanent_uuid(), from_ts);
+    ASSERT_EQ(ts_descs_[4]->permanent_uuid(), to_ts);
+
+    // Replica moves are not done while previous move is in progress.
+    ASSERT_FALSE(ASSERT_RESULT(GetReplicaResourceMove(&placeholder, &placeholder, &placeholder)));
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -854,6 +968,7 @@ class TestLoadBalancerBase {
     // Reset the tablet map tablets.
     for (const auto tablet : tablets_) {
       tablet_map_[tablet->tablet_id()] = tablet;
+      tablet->set_load_stats(TabletLoadStats());
     }
 
     // Prepare the replicas.
@@ -916,6 +1031,15 @@ class TestLoadBalancerBase {
     }
   }
 
+  void TestResourceMove(string* tablet_id,
+                        const string& expected_from_ts,
+                        const string& expected_to_ts) {
+    string from_ts, to_ts;
+    ASSERT_TRUE(ASSERT_RESULT(HandleResourceMoves(tablet_id, &from_ts, &to_ts)));
+    ASSERT_EQ(expected_from_ts, from_ts);
+    ASSERT_EQ(expected_to_ts, to_ts);
+  }
+
   void AddRunningReplica(TabletInfo* tablet, std::shared_ptr<TSDescriptor> ts_desc,
                          bool is_live = true) {
     TabletInfo::ReplicaMap replicas;
@@ -78,6 +78,7 @@
 #include "yb/consensus/consensus.proxy.h"
 #include "yb/consensus/consensus_peers.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/mathlimits.h"
@@ -132,6 +133,7 @@
 #include "yb/tablet/tablet_metadata.h"
 
 #include "yb/tserver/tserver_admin.proxy.h"
+#include "yb/tserver/tserver_error.h"
 
 #include "yb/util/crypt.h"
 #include "yb/util/debug-util.h"
@@ -142,6 +144,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/random_util.h"
 #include "yb/util/rw_mutex.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
@@ -166,6 +169,7 @@
 #include "yb/util/shared_lock.h"
 
 using namespace std::literals;
+using namespace yb::size_literals;  // NOLINT
 
 DEFINE_int32(master_ts_rpc_timeout_ms, 30 * 1000,  // 30 sec
              "Timeout used for the Master->TS async rpc calls.");
@@ -263,6 +267,40 @@ DEFINE_bool(
     "This cuts down test logs significantly.");
 TAG_FLAG(hide_pg_catalog_table_creation_logs, hidden);
 
+DEFINE_bool(enable_automatic_tablet_splitting, false,
+            "Whether master should split tablets automatically, based on tablet leader stats "
+            "reported by tablet servers.");
+TAG_FLAG(enable_automatic_tablet_splitting, advanced);
+TAG_FLAG(enable_automatic_tablet_splitting, runtime);
+
+DEFINE_uint64(tablet_split_size_threshold_bytes, 10_GB,
+              "Tablet is split automatically when size of its SST files reaches this value. "
+              "0 disables size based splitting.");
+TAG_FLAG(tablet_split_size_threshold_bytes, advanced);
+TAG_FLAG(tablet_split_size_threshold_bytes, runtime);
+
+DEFINE_double(tablet_split_ops_per_sec_threshold, 0,
+              "Tablet is split automatically when number of reads and writes per second at its "
+              "leader reaches this value. 0 disables load based splitting.");
+TAG_FLAG(tablet_split_ops_per_sec_threshold, advanced);
+TAG_FLAG(tablet_split_ops_per_sec_threshold, runtime);
+
+DEFINE_int32(tablet_split_max_outstanding_splits, 1,
+             "Max number of automatic tablet splits, whose new tablets are not running yet.");
+TAG_FLAG(tablet_split_max_outstanding_splits, advanced);
+TAG_FLAG(tablet_split_max_outstanding_splits, runtime);
+
+DEFINE_int32(tablet_split_timeout_sec, 1800,
+             "Automatic tablet split, whose new tablets are not running after this time, is no "
+             "longer counted as outstanding.");
+TAG_FLAG(tablet_split_timeout_sec, advanced);
+TAG_FLAG(tablet_split_timeout_sec, runtime);
+
+DEFINE_int32(tablet_split_table_cooldown_sec, 60,
+             "Min interval between automatic splits of tablets of the same table.");
+TAG_FLAG(tablet_split_table_cooldown_sec, advanced);
+TAG_FLAG(tablet_split_table_cooldown_sec, runtime);
+
 DEFINE_test_flag(int32, simulate_slow_table_create_secs, 0,
     "Simulates a slow table creation by sleeping after the table has been added to memory.");
 
@@ -1578,7 +1616,8 @@ Status CatalogManager::TEST_SplitTablet(
 }
 
 Status CatalogManager::DoSplitTablet(
-    const scoped_refptr<TabletInfo>& source_tablet_info, docdb::DocKeyHash split_hash_code) {
+    const scoped_refptr<TabletInfo>& source_tablet_info, docdb::DocKeyHash split_hash_code,
+    AutomaticSplit automatic_split) {
   const auto split_partition_key = PartitionSchema::EncodeMultiColumnHashValue(split_hash_code);
 
   constexpr auto kNumSplitParts = 2;
@@ -1586,13 +1625,26 @@ Status CatalogManager::DoSplitTablet(
   std::array<PartitionPB, kNumSplitParts> new_tablets_partition = CreateNewTabletsPartition(
       *source_tablet_info, split_partition_key);
 
+  // Write lock does not block readers, so new tablets could be registered while it is held, and it
+  // makes sure that concurrent split requests for the same tablet do not both pass the check.
+  auto source_tablet_lock = source_tablet_info->LockForWrite();
+  auto& source_tablet_pb = source_tablet_lock->mutable_data()->pb;
+  if (source_tablet_pb.split_tablet_ids_size() > 0) {
+    return STATUS_FORMAT(
+        AlreadyPresent, "Tablet $0 is already split", source_tablet_info->tablet_id());
+  }
+
   std::array<TabletId, kNumSplitParts> new_tablet_ids;
   for (int i = 0; i < kNumSplitParts; ++i) {
     auto* new_tablet_info = VERIFY_RESULT(
         RegisterNewTabletForSplit(*source_tablet_info, new_tablets_partition[i]));
     new_tablet_ids[i] = new_tablet_info->id();
+    source_tablet_pb.add_split_tablet_ids(new_tablet_ids[i]);
   }
 
+  RETURN_NOT_OK(sys_catalog_->UpdateItem(source_tablet_info.get(), leader_ready_term()));
+  source_tablet_lock->Commit();
+
   docdb::KeyBytes split_encoded_key;
   docdb::DocKeyEncoderAfterTableIdStep(&split_encoded_key)
       .Hash(split_hash_code, std::vector<docdb::PrimitiveValue>());
@@ -1600,11 +1652,262 @@ Status CatalogManager::DoSplitTablet(
   // TODO(tsplit): what if source tablet will be deleted before or during TS leader is processing
   // split? Add unit-test.
   SendSplitTabletRequest(
-      source_tablet_info, new_tablet_ids, split_encoded_key.data(), split_partition_key);
+      source_tablet_info, new_tablet_ids, split_encoded_key.data(), split_partition_key,
+      automatic_split);
+
+  return Status::OK();
+}
+
+void CatalogManager::ProcessTabletLeaderStats(
+    const google::protobuf::RepeatedPtrField<TabletLeaderStatsPB>& stats) {
+  const auto now = MonoTime::Now();
+  {
+    SharedLock<LockType> l(lock_);
+    for (const auto& tablet_stats : stats) {
+      auto tablet = FindPtrOrNull(*tablet_map_, tablet_stats.tablet_id());
+      if (!tablet) {
+        continue;
+      }
+      TabletLoadStats load_stats;
+      if (tablet_stats.has_read_ops_per_sec() && tablet_stats.has_write_ops_per_sec()) {
+        load_stats.read_ops_per_sec = tablet_stats.read_ops_per_sec();
+        load_stats.write_ops_per_sec = tablet_stats.write_ops_per_sec();
+        load_stats.report_time = now;
+      } else {
+        // Rates are not known for the first heartbeat after the tablet leader moved. Keep the
+        // previous ones with their report time, so the tablet does not look cold right after move.
+        load_stats = tablet->load_stats();
+      }
+      load_stats.sst_file_size = tablet_stats.sst_file_size();
+      tablet->set_load_stats(load_stats);
+    }
+  }
+
+  if (!FLAGS_enable_automatic_tablet_splitting) {
+    return;
+  }
+  // Splits are done by the background tasks thread, so heartbeat processing is not blocked by
+  // writes to the sys catalog.
+  std::lock_guard<std::mutex> lock(automatic_split_mutex_);
+  for (const auto& tablet_stats : stats) {
+    if (!tablet_stats.has_split_hash_code()) {
+      continue;
+    }
+    const bool too_large = FLAGS_tablet_split_size_threshold_bytes > 0 &&
+        tablet_stats.sst_file_size() >= FLAGS_tablet_split_size_threshold_bytes;
+    const bool too_hot = FLAGS_tablet_split_ops_per_sec_threshold > 0 &&
+        tablet_stats.read_ops_per_sec() + tablet_stats.write_ops_per_sec() >=
+            FLAGS_tablet_split_ops_per_sec_threshold;
+    if (too_large || too_hot) {
+      split_candidates_[tablet_stats.tablet_id()] = tablet_stats.split_hash_code();
+    }
+  }
+}
+
+void CatalogManager::ProcessAutomaticTabletSplits() {
+  // Failed splits are kept until automatic splitting is enabled again.
+  if (!FLAGS_enable_automatic_tablet_splitting) {
+    return;
+  }
+
+  std::unordered_map<TabletId, docdb::DocKeyHash> candidates;
+  std::unordered_map<TabletId, FailedSplit> failed_splits;
+  {
+    std::lock_guard<std::mutex> lock(automatic_split_mutex_);
+    candidates.swap(split_candidates_);
+    failed_splits.swap(failed_splits_);
+  }
+
+  const auto now = MonoTime::Now();
+  const auto split_timeout = MonoDelta::FromSeconds(FLAGS_tablet_split_timeout_sec);
+  // Forget splits whose new tablets are running, or were deleted. Splits that did not finish in
+  // time are forgotten as well, so they don't block automatic splitting forever.
+  {
+    SharedLock<LockType> l(lock_);
+    std::lock_guard<std::mutex> lock(automatic_split_mutex_);
+    for (auto it = outstanding_splits_.begin(); it != outstanding_splits_.end();) {
+      bool done = true;
+      for (const auto& new_tablet_id : it->second.new_tablet_ids) {
+        auto new_tablet = FindPtrOrNull(*tablet_map_, new_tablet_id);
+        if (!new_tablet) {
+          continue;
+        }
+        auto new_tablet_lock = new_tablet->LockForRead();
+        if (!new_tablet_lock->data().is_running() && !new_tablet_lock->data().is_deleted()) {
+          done = false;
+          break;
+        }
+      }
+      if (!done && now - it->second.start_time > split_timeout) {
+        LOG(WARNING) << "Split of tablet " << it->first << " timed out";
+        done = true;
+      }
+      it = done ? outstanding_splits_.erase(it) : ++it;
+    }
+  }
+
+  // Split could be applied by the source tablet even if the RPC failed, for instance when only the
+  // response was lost. So it is rolled back only when the source tablet leader confirmed that the
+  // tablet is not split, and is retried otherwise.
+  for (const auto& split : failed_splits) {
+    auto tablet_info = GetTabletInfo(split.first);
+    if (!tablet_info) {
+      continue;
+    }
+    if (!split.second.rejected) {
+      LOG(INFO) << "Retrying failed split of tablet " << split.first;
+      SendSplitTabletRequest(
+          tablet_info, split.second.new_tablet_ids, split.second.split_encoded_key,
+          split.second.split_partition_key, AutomaticSplit::kTrue);
+      continue;
+    }
+    auto status = RollbackTabletSplit(split.first, split.second.new_tablet_ids);
+    if (status.ok()) {
+      LOG(INFO) << "Rolled back rejected split of tablet " << split.first;
+    } else {
+      LOG(WARNING) << "Failed to roll back split of tablet " << split.first << ": " << status;
+    }
+  }
+
+  const auto cooldown = MonoDelta::FromSeconds(FLAGS_tablet_split_table_cooldown_sec);
+  for (const auto& candidate : candidates) {
+    auto tablet_info = GetTabletInfo(candidate.first);
+    if (!tablet_info) {
+      continue;
+    }
+    const auto table_id = tablet_info->table()->id();
+    {
+      std::lock_guard<std::mutex> lock(automatic_split_mutex_);
+      if (outstanding_splits_.size() >=
+              static_cast<size_t>(std::max(FLAGS_tablet_split_max_outstanding_splits, 0))) {
+        VLOG(1) << "Too many outstanding tablet splits, postponing split of " << candidate.first;
+        return;
+      }
+      auto it = last_table_split_time_.find(table_id);
+      if (it != last_table_split_time_.end() && now - it->second < cooldown) {
+        VLOG(1) << "Table " << table_id << " was split recently, postponing split of "
+                << candidate.first;
+        continue;
+      }
+    }
+
+    auto status = SplitTabletAutomatically(candidate.first, candidate.second);
+    if (status.IsAlreadyPresent()) {
+      // Old leader stats of the split tablet could be reported until it is shut down.
+      VLOG(1) << status;
+      continue;
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to split tablet " << candidate.first << ": " << status;
+      continue;
+    }
+
+    std::vector<TabletId> new_tablet_ids;
+    {
+      auto tablet_lock = tablet_info->LockForRead();
+      const auto& split_tablet_ids = tablet_lock->data().pb.split_tablet_ids();
+      new_tablet_ids.assign(split_tablet_ids.begin(), split_tablet_ids.end());
+    }
+    std::lock_guard<std::mutex> lock(automatic_split_mutex_);
+    outstanding_splits_[candidate.first] = OutstandingSplit{std::move(new_tablet_ids), now};
+    last_table_split_time_[table_id] = now;
+  }
+}
+
+Status CatalogManager::RollbackTabletSplit(
+    const TabletId& source_tablet_id, const std::array<TabletId, 2>& new_tablet_ids) {
+  auto source_tablet_info = GetTabletInfo(source_tablet_id);
+  SCHECK(source_tablet_info != nullptr, NotFound, Format("Tablet $0 not found", source_tablet_id));
 
+  // Tablet server could have split the tablet even if we did not get the response. In this case
+  // new tablets are reported, and the split should not be reverted.
+  {
+    SharedLock<LockType> l(lock_);
+    for (const auto& new_tablet_id : new_tablet_ids) {
+      auto new_tablet = FindPtrOrNull(*tablet_map_, new_tablet_id);
+      if (!new_tablet) {
+        continue;
+      }
+      TabletInfo::ReplicaMap locations;
+      new_tablet->GetReplicaLocations(&locations);
+      if (!locations.empty()) {
+        return STATUS_FORMAT(
+            IllegalState, "New tablet $0 of tablet $1 was already reported", new_tablet_id,
+            source_tablet_id);
+      }
+    }
+  }
+
+  {
+    auto source_tablet_lock = source_tablet_info->LockForWrite();
+    auto& source_tablet_pb = source_tablet_lock->mutable_data()->pb;
+    const auto& split_tablet_ids = source_tablet_pb.split_tablet_ids();
+    if (!std::equal(split_tablet_ids.begin(), split_tablet_ids.end(),
+                    new_tablet_ids.begin(), new_tablet_ids.end())) {
+      return STATUS_FORMAT(
+          IllegalState, "Tablet $0 is split into $1 instead of $2", source_tablet_id,
+          split_tablet_ids, new_tablet_ids);
+    }
+    source_tablet_pb.clear_split_tablet_ids();
+    RETURN_NOT_OK(sys_catalog_->UpdateItem(source_tablet_info.get(), leader_ready_term()));
+    source_tablet_lock->Commit();
+  }
+
+  // New tablets were registered only in memory, see RegisterNewTabletForSplit.
+  std::lock_guard<LockType> l(lock_);
+  auto tablet_map_checkout = tablet_map_.CheckOut();
+  for (const auto& new_tablet_id : new_tablet_ids) {
+    tablet_map_checkout->erase(new_tablet_id);
+  }
   return Status::OK();
 }
 
+Status CatalogManager::SplitTabletAutomatically(
+    const TabletId& tablet_id, docdb::DocKeyHash split_hash_code) {
+  auto tablet_info = GetTabletInfo(tablet_id);
+  SCHECK(tablet_info != nullptr, NotFound, Format("Tablet $0 not found", tablet_id));
+
+  const auto& table = tablet_info->table();
+  {
+    auto table_lock = table->LockForRead();
+    const auto& table_pb = table_lock->data().pb;
+    if (table_pb.table_type() == TableType::TRANSACTION_STATUS_TABLE_TYPE ||
+        table_pb.colocated() || !table_pb.partition_schema().has_hash_schema()) {
+      return STATUS_FORMAT(
+          NotSupported, "Automatic split of tablets of $0 is not supported", table->ToString());
+    }
+  }
+
+  PartitionPB partition;
+  {
+    auto tablet_lock = tablet_info->LockForRead();
+    if (tablet_lock->data().pb.split_tablet_ids_size() > 0) {
+      return STATUS_FORMAT(AlreadyPresent, "Tablet $0 is already split", tablet_id);
+    }
+    SCHECK_EQ(tablet_lock->data().pb.state(), SysTabletsEntryPB::RUNNING, IllegalState,
+              "Tablet is not running");
+    partition = tablet_lock->data().pb.partition();
+  }
+
+  // Split point should divide the partition into two non empty parts.
+  if (!partition.partition_key_start().empty() &&
+      split_hash_code <= PartitionSchema::DecodeMultiColumnHashValue(
+          partition.partition_key_start())) {
+    return STATUS_FORMAT(InvalidArgument, "Split hash code $0 is not inside partition $1",
+                         split_hash_code, partition.ShortDebugString());
+  }
+  if (!partition.partition_key_end().empty() &&
+      split_hash_code >= PartitionSchema::DecodeMultiColumnHashValue(
+          partition.partition_key_end())) {
+    return STATUS_FORMAT(InvalidArgument, "Split hash code $0 is not inside partition $1",
+                         split_hash_code, partition.ShortDebugString());
+  }
+
+  LOG(INFO) << "Automatically splitting tablet " << tablet_id << " of " << table->ToString()
+            << " at hash code " << split_hash_code;
+  return DoSplitTablet(tablet_info, split_hash_code, AutomaticSplit::kTrue);
+}
+
 Status CatalogManager::SplitTablet(
     const SplitTabletRequestPB* req, SplitTabletResponsePB* resp, rpc::RpcContext* rpc) {
   RETURN_NOT_OK(CheckOnline());
@@ -1653,6 +1956,10 @@ CHECKED_STATUS ValidateCreateTableSchema(const Schema& schema, CreateTableRespon
                         STATUS(InvalidArgument, "Invalid datatype for primary key column"));
     }
   }
+  Status s = docdb::CheckTableCompressionSupported(schema.table_properties());
+  if (!s.ok()) {
+    return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA, s);
+  }
   return Status::OK();
 }
 
@@ -3499,6 +3806,9 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
   if (req->alter_schema_steps_size() || req->has_alter_properties()) {
     TRACE("Apply alter schema");
     Status s = ApplyAlterSteps(l->data().pb, req, &new_schema, &next_col_id);
+    if (s.ok()) {
+      s = docdb::CheckTableCompressionSupported(new_schema.table_properties());
+    }
     if (!s.ok()) {
       return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA, s);
     }
@@ -3865,6 +4175,11 @@ scoped_refptr<TableInfo> CatalogManager::GetTableInfo(const TableId& table_id) {
   return FindPtrOrNull(*table_ids_map_, table_id);
 }
 
+scoped_refptr<TabletInfo> CatalogManager::GetTabletInfo(const TabletId& tablet_id) {
+  SharedLock<LockType> l(lock_);
+  return FindPtrOrNull(*tablet_map_, tablet_id);
+}
+
 scoped_refptr<TableInfo> CatalogManager::GetTableInfoFromNamespaceNameAndTableName(
     YQLDatabase db_type, const NamespaceName& namespace_name, const TableName& table_name) {
   SharedLock<LockType> l(lock_);
@@ -5647,11 +5962,29 @@ void CatalogManager::SendCopartitionTabletRequest(const scoped_refptr<TabletInfo
 
 void CatalogManager::SendSplitTabletRequest(
     const scoped_refptr<TabletInfo>& tablet, std::array<TabletId, 2> new_tablet_ids,
-    const std::string& split_encoded_key, const std::string& split_partition_key) {
+    const std::string& split_encoded_key, const std::string& split_partition_key,
+    AutomaticSplit automatic_split) {
   VLOG(2) << "Scheduling SplitTablet request to leader tserver for source tablet ID: "
           << tablet->tablet_id() << ", after-split tablet IDs: " << AsString(new_tablet_ids);
   auto call = std::make_shared<AsyncSplitTablet>(
       master_, worker_pool_.get(), tablet, new_tablet_ids, split_encoded_key, split_partition_key);
+  // Source tablet keeps the new tablet ids after the RPC failed for good, so it would never be
+  // split again. Failed automatic split is retried or rolled back by the background tasks thread,
+  // see ProcessAutomaticTabletSplits.
+  if (automatic_split) {
+    call->SetCallback([this, tablet_id = tablet->tablet_id(),
+                       split = FailedSplit{new_tablet_ids, split_encoded_key, split_partition_key,
+                                           false /* rejected */}](const Status& status) mutable {
+      if (status.ok()) {
+        return;
+      }
+      LOG(WARNING) << "Split of tablet " << tablet_id << " failed: " << status;
+      split.rejected = tserver::TabletServerError(status) ==
+                       tserver::TabletServerErrorPB::TABLET_SPLIT_REJECTED;
+      std::lock_guard<std::mutex> lock(automatic_split_mutex_);
+      failed_splits_[tablet_id] = std::move(split);
+    });
+  }
   tablet->table()->AddTask(call);
   WARN_NOT_OK(
       call->Run(),
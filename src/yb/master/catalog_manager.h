@@ -124,6 +124,8 @@ using PlacementId = std::string;
 
 typedef unordered_map<TabletId, TabletServerId> TabletToTabletServerMap;
 
+YB_STRONGLY_TYPED_BOOL(AutomaticSplit);
+
 // Component within the catalog manager which tracks blacklist (decommission) operation
 // related information.
 class BlacklistState {
@@ -409,6 +411,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   scoped_refptr<TableInfo> GetTableInfo(const TableId& table_id);
   scoped_refptr<TableInfo> GetTableInfoUnlocked(const TableId& table_id);
 
+  // Return the tablet info for the tablet with the specified id, if it exists.
+  scoped_refptr<TabletInfo> GetTabletInfo(const TabletId& tablet_id);
+
   // Get Table info given namespace id and table name.
   scoped_refptr<TableInfo> GetTableInfoFromNamespaceNameAndTableName(
       YQLDatabase db_type, const NamespaceName& namespace_name, const TableName& table_name);
@@ -638,6 +643,16 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS SplitTablet(
       const SplitTabletRequestPB* req, SplitTabletResponsePB* resp, rpc::RpcContext* rpc);
 
+  // Remembers load of tablets reported by their leaders, so it could be used by the load balancer,
+  // and picks tablets whose leader stats exceed automatic split thresholds as split candidates,
+  // together with split point reported by the tablet leader.
+  void ProcessTabletLeaderStats(
+      const google::protobuf::RepeatedPtrField<TabletLeaderStatsPB>& stats);
+
+  // Splits candidates picked by ProcessTabletLeaderStats, respecting limit of outstanding splits
+  // and per table cooldown. Called from the background tasks thread.
+  void ProcessAutomaticTabletSplits();
+
   // Test wrapper around protected DoSplitTablet method.
   CHECKED_STATUS TEST_SplitTablet(
       const scoped_refptr<TabletInfo>& source_tablet_info, docdb::DocKeyHash split_hash_code);
@@ -915,9 +930,12 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                     const scoped_refptr<TableInfo>& table);
 
   // Starts the background task to send the SplitTablet RPC to the leader for the specified tablet.
+  // Failure of the RPC for automatic split is recorded, so the split is retried or rolled back by
+  // ProcessAutomaticTabletSplits.
   void SendSplitTabletRequest(
       const scoped_refptr<TabletInfo>& tablet, std::array<TabletId, 2> new_tablet_ids,
-      const std::string& split_encoded_key, const std::string& split_partition_key);
+      const std::string& split_encoded_key, const std::string& split_partition_key,
+      AutomaticSplit automatic_split);
 
   // Send the "truncate table request" to all tablets of the specified table.
   void SendTruncateTableRequest(const scoped_refptr<TableInfo>& table);
@@ -1025,8 +1043,22 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
       const TabletInfo& source_tablet_info, const PartitionPB& partition);
 
   // Splits tablet using specified split_hash_code as a split point.
+  // Ids of the new tablets are persisted in the source tablet entry, so the same tablet is never
+  // split twice, also after master restart or failover.
   CHECKED_STATUS DoSplitTablet(
-      const scoped_refptr<TabletInfo>& source_tablet_info, docdb::DocKeyHash split_hash_code);
+      const scoped_refptr<TabletInfo>& source_tablet_info, docdb::DocKeyHash split_hash_code,
+      AutomaticSplit automatic_split = AutomaticSplit::kFalse);
+
+  // Splits tablet at split_hash_code, unless it is already split or is not eligible for automatic
+  // splitting.
+  CHECKED_STATUS SplitTabletAutomatically(
+      const TabletId& tablet_id, docdb::DocKeyHash split_hash_code);
+
+  // Reverts split of the source tablet, whose leader rejected the SplitTablet RPC after making sure
+  // that the tablet is not split. Clears new tablet ids of the source tablet, so it could be split
+  // again, and forgets the new tablets.
+  CHECKED_STATUS RollbackTabletSplit(
+      const TabletId& source_tablet_id, const std::array<TabletId, 2>& new_tablet_ids);
 
   // Calculate the total number of replicas which are being handled by servers in state.
   int64_t GetNumRelevantReplicas(const BlacklistState& state, bool leaders_only);
@@ -1076,6 +1108,29 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Tablet maps: tablet-id -> TabletInfo
   VersionTracker<TabletInfoMap> tablet_map_;
 
+  // State of automatic tablet splitting, see ProcessAutomaticTabletSplits.
+  std::mutex automatic_split_mutex_;
+  // Split candidates reported since the last ProcessAutomaticTabletSplits: tablet id -> split hash.
+  std::unordered_map<TabletId, docdb::DocKeyHash> split_candidates_;
+  struct OutstandingSplit {
+    std::vector<TabletId> new_tablet_ids;
+    MonoTime start_time;
+  };
+  // Automatic splits whose new tablets are not running yet: source tablet id -> split.
+  std::unordered_map<TabletId, OutstandingSplit> outstanding_splits_;
+  struct FailedSplit {
+    std::array<TabletId, 2> new_tablet_ids;
+    std::string split_encoded_key;
+    std::string split_partition_key;
+    // Source tablet leader confirmed that the tablet is not split, so the split could be rolled
+    // back. Otherwise the SplitTablet RPC is retried, since the split could have been applied.
+    bool rejected;
+  };
+  // Automatic splits whose SplitTablet RPC failed: source tablet id -> split.
+  std::unordered_map<TabletId, FailedSplit> failed_splits_;
+  // Time of the last automatic split of a tablet of the table: table id -> time.
+  std::unordered_map<TableId, MonoTime> last_table_split_time_;
+
   // Namespace maps: namespace-id -> NamespaceInfo and namespace-name -> NamespaceInfo
   NamespaceInfoMap namespace_ids_map_;
   NamespaceNameMapper namespace_names_mapper_;
@@ -142,6 +142,8 @@ void CatalogManagerBgTasks::Run() {
         catalog_manager_->load_balance_policy_->RunLoadBalancer();
       }
 
+      catalog_manager_->ProcessAutomaticTabletSplits();
+
       if (!to_delete.empty() || catalog_manager_->AreTablesDeleting()) {
         catalog_manager_->CleanUpDeletedTables();
       }
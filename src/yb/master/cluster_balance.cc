@@ -14,6 +14,7 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include <boost/algorithm/string/join.hpp>
@@ -77,6 +78,32 @@ DEFINE_test_flag(bool, load_balancer_handle_under_replicated_tablets_only, false
 DEFINE_bool(load_balancer_skip_leader_as_remove_victim, false,
             "Should the LB skip a leader as a possible remove candidate.");
 
+DEFINE_bool(load_balancer_balance_resource_load, true,
+            "Once replica and leader counts are balanced, move replicas and leaders to even out "
+            "resource load of tablet servers, i.e. ops/sec and disk usage reported by tablet "
+            "leaders.");
+TAG_FLAG(load_balancer_balance_resource_load, runtime);
+
+DEFINE_int32(load_balancer_max_concurrent_resource_moves,
+             1,
+             "Maximum number of replica or leader moves done to even out resource load in any one "
+             "run of the load balancer.");
+
+DEFINE_double(load_balancer_resource_imbalance_threshold, 0.2,
+              "Minimal difference between resource loads of two tablet servers, relative to the "
+              "higher one, for the load balancer to move load between them.");
+TAG_FLAG(load_balancer_resource_imbalance_threshold, advanced);
+
+DEFINE_int32(load_balancer_resource_move_cooldown_ms, 5 * 60 * 1000,
+             "Minimal time before the load balancer moves again a tablet, that was moved to even "
+             "out resource load.");
+TAG_FLAG(load_balancer_resource_move_cooldown_ms, advanced);
+
+DEFINE_int32(load_balancer_max_tablet_load_stats_age_ms, 60 * 1000,
+             "Load stats reported by a tablet leader longer ago than this are considered stale and "
+             "are not used to even out resource load, e.g. when the leader stopped reporting them.");
+TAG_FLAG(load_balancer_max_tablet_load_stats_age_ms, advanced);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -89,6 +116,61 @@ using std::set;
 using std::vector;
 using strings::Substitute;
 
+namespace {
+
+// Resource move should decrease difference between loads of tablet servers at least by this value,
+// measured in loads of the average tablet.
+constexpr double kMinResourceMoveGain = 0.01;
+
+// Tablets that could be moved between two tablet servers, with their resource load.
+typedef std::vector<std::pair<TabletId, double>> ResourceMoveCandidates;
+
+// Picks the tablet to move from the tablet server with higher resource load, and optionally the
+// tablet to move back, so the difference between loads of the servers becomes the smallest.
+// Returns false when no move decreases the difference.
+bool PickResourceMove(
+    double imbalance, bool allow_single_move, const ResourceMoveCandidates& from_high,
+    const ResourceMoveCandidates& from_low, TabletId* tablet_id, TabletId* swap_tablet_id) {
+  double best = imbalance - kMinResourceMoveGain;
+  bool found = false;
+  for (const auto& high : from_high) {
+    if (allow_single_move) {
+      double result = std::abs(imbalance - 2 * high.second);
+      if (result < best) {
+        best = result;
+        *tablet_id = high.first;
+        swap_tablet_id->clear();
+        found = true;
+      }
+    }
+    for (const auto& low : from_low) {
+      double result = std::abs(imbalance - 2 * (high.second - low.second));
+      if (result < best) {
+        best = result;
+        *tablet_id = high.first;
+        *swap_tablet_id = low.first;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+// Sorts tablet servers ascending by load returned by get_load.
+template <class GetLoad>
+std::vector<std::pair<double, TabletServerId>> SortByResourceLoad(
+    const std::vector<TabletServerId>& servers, const GetLoad& get_load) {
+  std::vector<std::pair<double, TabletServerId>> result;
+  result.reserve(servers.size());
+  for (const auto& ts_uuid : servers) {
+    result.emplace_back(get_load(ts_uuid), ts_uuid);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
 Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
   const auto& table_id = tablet->table()->id();
   // Set the placement information on a per-table basis, only once.
@@ -182,9 +264,21 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
   // Lock the CatalogManager maps for the duration of the load balancer run.
   SharedLock<CatalogManager::LockType> l(catalog_manager_->lock_);
 
+  // Forget tablets that could be moved to even out resource load again.
+  const auto cooldown = MonoDelta::FromMilliseconds(FLAGS_load_balancer_resource_move_cooldown_ms);
+  const auto now = MonoTime::Now();
+  for (auto it = resource_moved_tablets_.begin(); it != resource_moved_tablets_.end();) {
+    if (now - it->second >= cooldown) {
+      it = resource_moved_tablets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
   int remaining_adds = options->kMaxConcurrentAdds;
   int remaining_removals = options->kMaxConcurrentRemovals;
   int remaining_leader_moves = options->kMaxConcurrentLeaderMoves;
+  int remaining_resource_moves = options->kMaxConcurrentResourceMoves;
 
   // Loop over all tables to get the count of pending tasks.
   int pending_add_replica_tasks = 0;
@@ -234,6 +328,10 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
     TabletServerId out_from_ts;
     TabletServerId out_to_ts;
 
+    // Whether replica and leader counts of this table are balanced, so we could even out resource
+    // load without fighting with the count based balancing.
+    bool counts_balanced = handle_analyze_tablets.ok();
+
     // Handle adding and moving replicas.
     for ( ; remaining_adds > 0; --remaining_adds) {
       auto handle_add = HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts);
@@ -241,11 +339,13 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
         LOG(WARNING) << "Skipping add replicas for " << table.first << ": "
                      << StatusToString(handle_add);
         master_errors++;
+        counts_balanced = false;
         break;
       }
       if (!*handle_add) {
         break;
       }
+      counts_balanced = false;
     }
     if (PREDICT_FALSE(FLAGS_load_balancer_handle_under_replicated_tablets_only)) {
       LOG(INFO) << "Skipping remove replicas and leader moves for " << table.first;
@@ -264,6 +364,7 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
       if (!*handle_remove) {
         break;
       }
+      counts_balanced = false;
     }
 
     // Handle tablet servers with too many leaders.
@@ -273,11 +374,27 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
         LOG(WARNING) << "Skipping leader moves for " << table.first << ": "
                      << StatusToString(handle_leader);
         master_errors++;
+        counts_balanced = false;
         break;
       }
       if (!*handle_leader) {
         break;
       }
+      counts_balanced = false;
+    }
+
+    // Handle tablet servers with too much resource load.
+    for ( ; counts_balanced && remaining_resource_moves > 0; --remaining_resource_moves) {
+      auto handle_resource = HandleResourceMoves(&out_tablet_id, &out_from_ts, &out_to_ts);
+      if (!handle_resource.ok()) {
+        LOG(WARNING) << "Skipping resource moves for " << table.first << ": "
+                     << StatusToString(handle_resource);
+        master_errors++;
+        break;
+      }
+      if (!*handle_resource) {
+        break;
+      }
     }
 
     if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0) {
@@ -404,6 +521,11 @@ Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // low for the given configuration.
   state_->AdjustLeaderBalanceThreshold();
 
+  // Convert load stats reported by tablet leaders to resource loads used to even out actual usage.
+  state_->UpdateTabletResourceLoads(
+      MonoTime::Now() - MonoDelta::FromMilliseconds(
+          FLAGS_load_balancer_max_tablet_load_stats_age_ms));
+
   // Once we've analyzed both the tablet server information as well as the tablets, we can sort the
   // load and are ready to apply the load balancing rules.
   state_->SortLoad();
@@ -837,6 +959,165 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
   FATAL_ERROR("Load balancing algorithm reached invalid state!");
 }
 
+Result<bool> ClusterLoadBalancer::HandleResourceMoves(
+    TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
+  if (!FLAGS_load_balancer_balance_resource_load) {
+    return false;
+  }
+  // Leader moves are cheap and quickly take reads off the hot tablet server, so try them first.
+  if (VERIFY_RESULT(GetLeaderResourceMove(out_tablet_id, out_from_ts, out_to_ts))) {
+    return true;
+  }
+  return GetReplicaResourceMove(out_tablet_id, out_from_ts, out_to_ts);
+}
+
+bool ClusterLoadBalancer::IsResourceMoveCoolingDown(const TabletId& tablet_id) const {
+  auto it = resource_moved_tablets_.find(tablet_id);
+  return it != resource_moved_tablets_.end() &&
+         state_->current_time_ - it->second <
+             MonoDelta::FromMilliseconds(FLAGS_load_balancer_resource_move_cooldown_ms);
+}
+
+Result<bool> ClusterLoadBalancer::GetLeaderResourceMove(
+    TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
+  vector<TabletServerId> servers;
+  for (const auto& ts_uuid : state_->sorted_leader_load_) {
+    if (!state_->leader_blacklisted_servers_.count(ts_uuid)) {
+      servers.push_back(ts_uuid);
+    }
+  }
+  const auto sorted = SortByResourceLoad(servers, [this](const TabletServerId& ts_uuid) {
+    return state_->GetLeaderResourceLoad(ts_uuid);
+  });
+
+  // Leaders of high_ts that could be moved to low_ts.
+  auto movable_leaders = [this](const TabletServerId& high_ts, const TabletServerId& low_ts) {
+    ResourceMoveCandidates result;
+    const auto& peers = state_->per_ts_meta_[low_ts].running_tablets;
+    for (const auto& tablet_id : state_->per_ts_meta_[high_ts].leaders) {
+      if (!peers.count(tablet_id) || IsResourceMoveCoolingDown(tablet_id)) {
+        continue;
+      }
+      const auto& tablet_meta = state_->per_tablet_meta_[tablet_id];
+      if (tablet_meta.leader_stepdown_failures.count(low_ts)) {
+        continue;
+      }
+      result.emplace_back(tablet_id, tablet_meta.leader_load);
+    }
+    return result;
+  };
+
+  for (auto high = sorted.rbegin(); high != sorted.rend(); ++high) {
+    for (auto low = sorted.begin(); low->second != high->second; ++low) {
+      if (!state_->IsResourceImbalanced(high->first, low->first)) {
+        // Servers between low and high are even closer to high.
+        break;
+      }
+      const auto& high_ts = high->second;
+      const auto& low_ts = low->second;
+      // A single move changes difference of leader counts by two, so it is allowed only while the
+      // counts stay balanced.
+      const int count_diff = state_->GetLeaderLoad(high_ts) - state_->GetLeaderLoad(low_ts);
+      const bool allow_single_move =
+          count_diff > 0 &&
+          count_diff - 2 < state_->options_->kMinLeaderLoadVarianceToBalance;
+      TabletId swap_tablet_id;
+      if (!PickResourceMove(high->first - low->first, allow_single_move,
+                            movable_leaders(high_ts, low_ts), movable_leaders(low_ts, high_ts),
+                            out_tablet_id, &swap_tablet_id)) {
+        continue;
+      }
+      LOG(INFO) << "Evening out leader resource load " << high->first << " of TS " << high_ts
+                << " and " << low->first << " of TS " << low_ts;
+      *out_from_ts = high_ts;
+      *out_to_ts = low_ts;
+      RETURN_NOT_OK(MoveLeader(*out_tablet_id, high_ts, low_ts));
+      resource_moved_tablets_[*out_tablet_id] = state_->current_time_;
+      if (!swap_tablet_id.empty()) {
+        RETURN_NOT_OK(MoveLeader(swap_tablet_id, low_ts, high_ts));
+        resource_moved_tablets_[swap_tablet_id] = state_->current_time_;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+Result<bool> ClusterLoadBalancer::GetReplicaResourceMove(
+    TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
+  // Evening out resource load is not urgent, so move replicas only while no other replica moves
+  // are in progress.
+  if (get_total_starting_tablets() > 0 || get_total_over_replication() > 0) {
+    return false;
+  }
+
+  vector<TabletServerId> servers;
+  for (const auto& ts_uuid : state_->sorted_load_) {
+    if (!state_->blacklisted_servers_.count(ts_uuid)) {
+      servers.push_back(ts_uuid);
+    }
+  }
+  const auto sorted = SortByResourceLoad(servers, [this](const TabletServerId& ts_uuid) {
+    return state_->GetResourceLoad(ts_uuid);
+  });
+
+  // Replicas of high_ts that could be moved to low_ts. Leaders are left to leader moves.
+  auto movable_replicas = [this](const TabletServerId& high_ts, const TabletServerId& low_ts)
+      -> Result<ResourceMoveCandidates> {
+    ResourceMoveCandidates result;
+    bool same_placement = state_->per_ts_meta_[high_ts].descriptor->placement_id() ==
+                          state_->per_ts_meta_[low_ts].descriptor->placement_id();
+    for (const auto& tablet_id : state_->per_ts_meta_[high_ts].running_tablets) {
+      const auto& tablet_meta = state_->per_tablet_meta_[tablet_id];
+      if (tablet_meta.leader_uuid == high_ts || IsResourceMoveCoolingDown(tablet_id) ||
+          state_->tablets_over_replicated_.count(tablet_id)) {
+        continue;
+      }
+      const auto& placement_info = GetPlacementByTablet(tablet_id);
+      if (!placement_info.placement_blocks().empty() && !same_placement) {
+        continue;
+      }
+      if (!VERIFY_RESULT(state_->CanAddTabletToTabletServer(tablet_id, low_ts, &placement_info))) {
+        continue;
+      }
+      result.emplace_back(tablet_id, tablet_meta.replica_load);
+    }
+    return result;
+  };
+
+  for (auto high = sorted.rbegin(); high != sorted.rend(); ++high) {
+    for (auto low = sorted.begin(); low->second != high->second; ++low) {
+      if (!state_->IsResourceImbalanced(high->first, low->first)) {
+        break;
+      }
+      const auto& high_ts = high->second;
+      const auto& low_ts = low->second;
+      const int count_diff = state_->GetLoad(high_ts) - state_->GetLoad(low_ts);
+      const bool allow_single_move =
+          count_diff > 0 && count_diff - 2 < state_->options_->kMinLoadVarianceToBalance;
+      TabletId swap_tablet_id;
+      if (!PickResourceMove(high->first - low->first, allow_single_move,
+                            VERIFY_RESULT(movable_replicas(high_ts, low_ts)),
+                            VERIFY_RESULT(movable_replicas(low_ts, high_ts)),
+                            out_tablet_id, &swap_tablet_id)) {
+        continue;
+      }
+      LOG(INFO) << "Evening out resource load " << high->first << " of TS " << high_ts
+                << " and " << low->first << " of TS " << low_ts;
+      *out_from_ts = high_ts;
+      *out_to_ts = low_ts;
+      RETURN_NOT_OK(MoveReplica(*out_tablet_id, high_ts, low_ts));
+      resource_moved_tablets_[*out_tablet_id] = state_->current_time_;
+      if (!swap_tablet_id.empty()) {
+        RETURN_NOT_OK(MoveReplica(swap_tablet_id, low_ts, high_ts));
+        resource_moved_tablets_[swap_tablet_id] = state_->current_time_;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
 Result<bool> ClusterLoadBalancer::HandleRemoveReplicas(
     TabletId* out_tablet_id, TabletServerId* out_from_ts) {
   // Give high priority to removing tablets that are not respecting the placement policy.
@@ -225,6 +225,24 @@ class ClusterLoadBalancer {
   Result<bool> GetLeaderToMove(
       TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Processes leaders and replicas that should be moved from tablet servers with high resource
+  // load, i.e. ops/sec and disk usage reported by tablet leaders, to tablet servers with low
+  // resource load. Moves keep leader and replica counts balanced, so when a single move would break
+  // count balance, a less loaded tablet is moved in the opposite direction.
+  //
+  // Returns true if a move was actually made.
+  Result<bool> HandleResourceMoves(
+      TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts);
+
+  Result<bool> GetLeaderResourceMove(
+      TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts);
+
+  Result<bool> GetReplicaResourceMove(
+      TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts);
+
+  // Whether tablet was moved to even out resource load recently, so it should not be moved again.
+  bool IsResourceMoveCoolingDown(const TabletId& tablet_id) const;
+
   // Issue the change config and modify the in-memory state for moving a replica from one tablet
   // server to another.
   CHECKED_STATUS MoveReplica(
@@ -296,6 +314,10 @@ class ClusterLoadBalancer {
   // Random number generator for picking items at random from sets, using ReservoirSample.
   ThreadSafeRandom random_;
 
+  // Tablets moved to even out resource load, with time of the move. Used to avoid moving the same
+  // tablet back and forth, because of noise in reported stats.
+  std::unordered_map<TabletId, MonoTime> resource_moved_tablets_;
+
   // Controls whether to run the load balancing algorithm or not.
   std::atomic<bool> is_enabled_;
 
@@ -48,6 +48,10 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_int32(load_balancer_max_concurrent_resource_moves);
+
+DECLARE_double(load_balancer_resource_imbalance_threshold);
+
 namespace yb {
 namespace master {
 
@@ -121,6 +125,14 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Load stats reported by the tablet leader.
+  TabletLoadStats load_stats;
+
+  // Resource load added by the leader and by each replica of this tablet to their tablet servers,
+  // relative to the average tablet of the table. Tablets without reported stats count as average.
+  double leader_load = 1.0;
+  double replica_load = 1.0;
+
   std::string ToString() const {
     return Format("{ running: $0 starting: $1 is_under_replicated: $2 "
                       "under_replicated_placements: $3 is_over_replicated: $4 "
@@ -180,6 +192,14 @@ struct Options {
   // Max number of tablet leaders on tablet servers to move in any one run of the load balancer.
   int kMaxConcurrentLeaderMoves = FLAGS_load_balancer_max_concurrent_moves;
 
+  // Max number of replica or leader moves done to even out resource load in any one run of the
+  // load balancer.
+  int kMaxConcurrentResourceMoves = FLAGS_load_balancer_max_concurrent_resource_moves;
+
+  // If difference between resource load of TSs, relative to the higher one, goes past this number,
+  // we should try to balance.
+  double kMinResourceImbalanceToBalance = FLAGS_load_balancer_resource_imbalance_threshold;
+
   // TODO(bogdan): add state for leaders starting remote bootstraps, to limit on that end too.
 };
 
@@ -250,6 +270,73 @@ class ClusterLoadState {
     return per_ts_meta_.at(ts_uuid).leaders.size();
   }
 
+  // Get the resource load of replicas, i.e. writes and disk usage, for a certain TS.
+  double GetResourceLoad(const TabletServerId& ts_uuid) const {
+    const auto& ts_meta = per_ts_meta_.at(ts_uuid);
+    double result = 0;
+    for (const auto* tablets : {&ts_meta.running_tablets, &ts_meta.starting_tablets}) {
+      for (const auto& tablet_id : *tablets) {
+        result += per_tablet_meta_.at(tablet_id).replica_load;
+      }
+    }
+    return result;
+  }
+
+  // Get the resource load of leaders, i.e. reads and writes, for a certain TS.
+  double GetLeaderResourceLoad(const TabletServerId& ts_uuid) const {
+    double result = 0;
+    for (const auto& tablet_id : per_ts_meta_.at(ts_uuid).leaders) {
+      result += per_tablet_meta_.at(tablet_id).leader_load;
+    }
+    return result;
+  }
+
+  // Whether difference between resource loads of two TSs is large enough to balance.
+  bool IsResourceImbalanced(double high_load, double low_load) const {
+    return high_load > 0 &&
+           high_load - low_load >= options_->kMinResourceImbalanceToBalance * high_load;
+  }
+
+  // Converts stats reported by tablet leaders to resource loads relative to the average tablet.
+  // Stats reported before min_report_time are ignored, so load of such tablets stays unknown.
+  void UpdateTabletResourceLoads(MonoTime min_report_time) {
+    double total_ops = 0;
+    double total_write_ops = 0;
+    double total_sst_file_size = 0;
+    int num_reported = 0;
+    auto is_fresh = [min_report_time](const TabletLoadStats& stats) {
+      return stats.report_time.Initialized() && stats.report_time >= min_report_time;
+    };
+    for (const auto& entry : per_tablet_meta_) {
+      const auto& stats = entry.second.load_stats;
+      if (!is_fresh(stats)) {
+        continue;
+      }
+      total_ops += stats.read_ops_per_sec + stats.write_ops_per_sec;
+      total_write_ops += stats.write_ops_per_sec;
+      total_sst_file_size += stats.sst_file_size;
+      ++num_reported;
+    }
+    if (num_reported == 0) {
+      return;
+    }
+    auto relative = [num_reported](double value, double total) {
+      return total > 0 ? value * num_reported / total : 1.0;
+    };
+    for (auto& entry : per_tablet_meta_) {
+      auto& tablet_meta = entry.second;
+      const auto& stats = tablet_meta.load_stats;
+      if (!is_fresh(stats)) {
+        continue;
+      }
+      // Reads are served by the leader only, while writes and disk usage are paid by all replicas.
+      tablet_meta.leader_load =
+          relative(stats.read_ops_per_sec + stats.write_ops_per_sec, total_ops);
+      tablet_meta.replica_load = (relative(stats.write_ops_per_sec, total_write_ops) +
+                                  relative(stats.sst_file_size, total_sst_file_size)) / 2;
+    }
+  }
+
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
   void SetLeaderBlacklist(const BlacklistPB& leader_blacklist) {
     leader_blacklist_ = leader_blacklist;
@@ -264,6 +351,8 @@ class ClusterLoadState {
     // Get the placement for this tablet.
     const auto& placement = placement_by_table_[tablet->table()->id()];
 
+    tablet_meta.load_stats = tablet->load_stats();
+
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
     GetReplicaLocations(tablet, &replica_map);
@@ -42,6 +42,7 @@
 #include "yb/util/init.h"
 #include "yb/util/logging.h"
 #include "yb/util/main_util.h"
+#include "yb/util/wait_state.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/total_mem_watcher.h"
 
@@ -92,6 +93,8 @@ static int MasterMain(int argc, char** argv) {
   LOG_AND_RETURN_FROM_MAIN_NOT_OK(InitYB(MasterOptions::kServerType, argv[0]));
   LOG(INFO) << "NumCPUs determined to be: " << base::NumCPUs();
 
+  WaitStateSampler::Init();
+
   LOG_AND_RETURN_FROM_MAIN_NOT_OK(GetPrivateIpMode());
 
   auto opts_result = MasterOptions::CreateMasterOptions();
@@ -183,6 +183,10 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->UpdateMetrics(req->metrics());
   }
 
+  if (req->tablet_leader_stats_size() > 0) {
+    server_->catalog_manager()->ProcessTabletLeaderStats(req->tablet_leader_stats());
+  }
+
   if (req->has_tablet_report()) {
     s = server_->catalog_manager()->ProcessTabletReport(
       ts_desc.get(), req->tablet_report(), resp->mutable_tablet_report(), &rpc);
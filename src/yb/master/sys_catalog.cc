@@ -544,6 +544,7 @@ Status SysCatalogTable::OpenTablet(const scoped_refptr<tablet::RaftGroupMetadata
           raft_pool(),
           tablet_prepare_pool(),
           nullptr /* retryable_requests */,
+          nullptr /* multi_raft_manager */,
           yb::OpId() /* split_op_id */),
       "Failed to Init() TabletPeer");
 
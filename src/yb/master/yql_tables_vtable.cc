@@ -19,6 +19,28 @@
 namespace yb {
 namespace master {
 
+namespace {
+
+// Returns the Cassandra compressor class of the table compression, or nullptr if there is none.
+const char* CompressorClass(TableCompressionPB compression) {
+  switch (compression) {
+    case TableCompressionPB::TABLE_COMPRESSION_DEFAULT: FALLTHROUGH_INTENDED;
+    case TableCompressionPB::TABLE_COMPRESSION_NONE:
+      return nullptr;
+    case TableCompressionPB::TABLE_COMPRESSION_SNAPPY:
+      return "org.apache.cassandra.io.compress.SnappyCompressor";
+    case TableCompressionPB::TABLE_COMPRESSION_LZ4:
+      return "org.apache.cassandra.io.compress.LZ4Compressor";
+    case TableCompressionPB::TABLE_COMPRESSION_ZSTD:
+      return "org.apache.cassandra.io.compress.ZstdCompressor";
+    case TableCompressionPB::TABLE_COMPRESSION_ZLIB:
+      return "org.apache.cassandra.io.compress.DeflateCompressor";
+  }
+  return nullptr;
+}
+
+} // namespace
+
 YQLTablesVTable::YQLTablesVTable(const Master* const master)
     : YQLVirtualTable(master::kSystemSchemaTablesTableName, master, CreateSchema()) {
 }
@@ -82,6 +104,27 @@ Result<std::shared_ptr<QLRowBlock>> YQLTablesVTable::RetrieveData(
     txn.add_map_value()->set_string_value(schema.table_properties().is_transactional() ?
                                           "true" : "false");
     RETURN_NOT_OK(SetColumnValue(kTransactions, txn.value(), &row));
+
+    // Tables using the default compression of the tablet servers do not report it.
+    const auto& properties = schema.table_properties();
+    if (properties.compression() != TableCompressionPB::TABLE_COMPRESSION_DEFAULT) {
+      QLValue compression;
+      compression.set_map_value();
+      const char* compressor_class = CompressorClass(properties.compression());
+      if (compressor_class) {
+        compression.add_map_key()->set_string_value("class");
+        compression.add_map_value()->set_string_value(compressor_class);
+        if (properties.compression_level()) {
+          compression.add_map_key()->set_string_value("compression_level");
+          compression.add_map_value()->set_string_value(
+              std::to_string(*properties.compression_level()));
+        }
+      } else {
+        compression.add_map_key()->set_string_value("enabled");
+        compression.add_map_value()->set_string_value("false");
+      }
+      RETURN_NOT_OK(SetColumnValue(kCompression, compression.value(), &row));
+    }
   }
 
   return vtable;
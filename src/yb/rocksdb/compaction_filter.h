@@ -141,11 +141,32 @@ class CompactionFilter {
   // compaction filter into the version edit metadata. See DocDBCompactionFilter.
   virtual UserFrontierPtr GetLargestUserFrontier() const { return nullptr; }
 
+  // Called for every output record of the compaction. Returning true means that the record with
+  // the specified user key, that was just kept by Filter, should be held back, so the filter could
+  // update its value using records that follow it. Such a record is written right before the next
+  // output record, or before the output file is finished, with the value updated by
+  // CompleteDelayedOutput. Records that follow it are still passed to Filter in the meantime.
+  virtual bool DelayOutput(const Slice& user_key) { return false; }
+
+  // Called right before the record held back by DelayOutput is written. Could replace its value.
+  virtual void CompleteDelayedOutput(std::string* value) {}
+
   // Returns a name that identifies this compaction filter.
   // The name will be printed to LOG file on start up for diagnosis.
   virtual const char* Name() const = 0;
 };
 
+// CompactionFileFilter allows an application to drop whole SST files, without reading them, e.g.
+// when all records of the file are expired. Decision is made using only the largest user frontier
+// of the file. Files are checked starting from the oldest one, and a file is dropped only when all
+// older files are dropped as well, so records of dropped files could not hide any remaining data.
+class CompactionFileFilter {
+ public:
+  virtual ~CompactionFileFilter() {}
+
+  virtual FilterDecision Filter(const UserFrontier* largest_frontier) = 0;
+};
+
 // Each compaction will create a new CompactionFilter allowing the
 // application to know about different compactions
 class CompactionFilterFactory {
@@ -155,6 +176,23 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // Creates filter used by compaction picker to find files that could be dropped without reading
+  // them. Returns nullptr when no file could be dropped this way.
+  // for_compaction is false when the filter is only used to check whether there are such files,
+  // e.g. by NeedsCompaction, so creating it should not have any side effects. It is true when
+  // files accepted by the filter are going to be dropped.
+  virtual std::unique_ptr<CompactionFileFilter> CreateCompactionFileFilter(bool for_compaction) {
+    return nullptr;
+  }
+
+  // Returns the prefix of user_key that should be used as a boundary between subcompactions instead
+  // of user_key. Each subcompaction has its own filter, so records that a filter has to see
+  // together, e.g. a tombstone and the values it overrides, should have the same such prefix.
+  // Returns an empty slice when the key could not be used as a boundary.
+  virtual Slice SubcompactionBoundary(const Slice& user_key) {
+    return user_key;
+  }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
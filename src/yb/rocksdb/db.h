@@ -803,6 +803,12 @@ class DB {
   // rocksdb instance.
   virtual uint64_t GetCurrentVersionDataSstFilesSize() { return 0; }
 
+  // Returns user key that splits data of the default column family into two parts of
+  // approximately the same size. Computed from the data index of the largest SST file.
+  virtual yb::Result<std::string> GetMiddleKey() {
+    return STATUS(NotSupported, "GetMiddleKey is not supported");
+  }
+
   // Returns number of memtables not flushed in default column family memtable list.
   virtual int GetCfdImmNumNotFlushed() { return 0; }
 
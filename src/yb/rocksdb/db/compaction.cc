@@ -544,7 +544,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level every compaction output is a new sorted run, so it could be split into
+    // non overlapping files.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
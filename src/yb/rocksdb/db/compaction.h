@@ -300,6 +300,10 @@ class Compaction {
   yb::PriorityThreadPoolSuspender* suspender() { return suspender_; }
   void SetSuspender(yb::PriorityThreadPoolSuspender* value) { suspender_ = value; }
 
+  // Priority of the thread pool task that runs this compaction, used for its subcompactions.
+  int priority() const { return priority_; }
+  void SetPriority(int value) { priority_ = value; }
+
  private:
   // mark (or clear) all files that are being compacted
   void MarkFilesBeingCompacted(bool mark_as_compacted);
@@ -379,6 +383,7 @@ class Compaction {
   CompactionReason compaction_reason_;
 
   yb::PriorityThreadPoolSuspender* suspender_ = nullptr;
+  int priority_ = 0;
 };
 
 // Utility function
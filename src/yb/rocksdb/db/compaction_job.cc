@@ -29,14 +29,18 @@
 
 #include <inttypes.h>
 #include <algorithm>
+#include <condition_variable>
 #include <functional>
 #include <vector>
 #include <memory>
 #include <list>
+#include <mutex>
 #include <set>
 #include <thread>
 #include <utility>
 
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/db/builder.h"
 #include "yb/rocksdb/db/db_iter.h"
 #include "yb/rocksdb/db/dbformat.h"
@@ -49,6 +53,7 @@
 #include "yb/rocksdb/db/memtable_list.h"
 #include "yb/rocksdb/db/merge_context.h"
 #include "yb/rocksdb/db/merge_helper.h"
+#include "yb/rocksdb/db/table_cache.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/port/likely.h"
 #include "yb/rocksdb/port/port.h"
@@ -61,6 +66,7 @@
 #include "yb/rocksdb/table/block_based_table_factory.h"
 #include "yb/rocksdb/table/merger.h"
 #include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
@@ -72,9 +78,14 @@
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/stats/iostats_context_imp.h"
 #include "yb/util/string_util.h"
 
+DEFINE_uint64(universal_compaction_min_subcompaction_size_bytes, 1ULL << 30,
+              "Universal compaction does not limit the size of output files, so it is split into "
+              "subcompactions of at least this size.");
+
 namespace rocksdb {
 
 // Maintains state for each sub-compaction
@@ -122,6 +133,19 @@ struct CompactionJob::SubcompactionState {
   CompactionJobStats compaction_job_stats;
   uint64_t approx_size;
 
+  // Suspender of the thread that processes this subcompaction, if it runs in the priority thread
+  // pool.
+  yb::PriorityThreadPoolSuspender* suspender = nullptr;
+
+  // Frontier provided by the compaction filter of this subcompaction.
+  UserFrontierPtr largest_user_frontier;
+
+  // Output record held back at the request of the compaction filter, see
+  // CompactionFilter::DelayOutput.
+  bool has_delayed_output = false;
+  std::string delayed_key;
+  std::string delayed_value;
+
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end,
                      uint64_t size = 0)
       : compaction(c),
@@ -153,6 +177,11 @@ struct CompactionJob::SubcompactionState {
     num_output_records = std::move(o.num_output_records);
     compaction_job_stats = std::move(o.compaction_job_stats);
     approx_size = std::move(o.approx_size);
+    suspender = o.suspender;
+    largest_user_frontier = std::move(o.largest_user_frontier);
+    has_delayed_output = o.has_delayed_output;
+    delayed_key = std::move(o.delayed_key);
+    delayed_value = std::move(o.delayed_value);
     return *this;
   }
 
@@ -372,6 +401,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
   std::vector<Slice> bounds;
+  const bool is_universal = cfd->ioptions()->compaction_style == kCompactionStyleUniversal;
   int start_lvl = c->start_level();
   int out_lvl = c->output_level();
 
@@ -393,6 +423,11 @@ void CompactionJob::GenSubcompactionBoundaries() {
         for (size_t i = 0; i < num_files; i++) {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
+          if (is_universal) {
+            // Universal compaction input files usually cover the whole key range, so also add
+            // keys from their indexes, that split them into parts of similar size.
+            AddSplitKeys(flevel->files[i].fd);
+          }
         }
       } else {
         // For all other levels add the smallest/largest key in the level to
@@ -412,6 +447,10 @@ void CompactionJob::GenSubcompactionBoundaries() {
     }
   }
 
+  for (const auto& key : split_keys_) {
+    bounds.emplace_back(key);
+  }
+
   std::sort(bounds.begin(), bounds.end(),
     [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
       return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
@@ -443,9 +482,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
+  uint64_t max_file_size = cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl);
+  if (is_universal) {
+    max_file_size = std::min<uint64_t>(
+        max_file_size, FLAGS_universal_compaction_min_subcompaction_size_bytes);
+  }
   uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+      sum / min_file_fill_percent / max_file_size));
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -455,6 +498,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
                                     : std::numeric_limits<double>::max();
 
   if (subcompactions > 1) {
+    auto* filter_factory = cfd->ioptions()->compaction_filter_factory;
     // Greedily add ranges to the subcompaction until the sum of the ranges'
     // sizes becomes >= the expected mean size of a subcompaction
     sum = 0;
@@ -466,7 +510,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        auto boundary = ExtractUserKey(ranges[i].range.limit);
+        if (filter_factory) {
+          boundary = filter_factory->SubcompactionBoundary(boundary);
+        }
+        // Boundaries are truncated to prefixes, so neighbouring ones could become equal. In this
+        // case the range is added to the next subcompaction.
+        if (boundary.empty() ||
+            (!boundaries_.empty() && cfd_comparator->Compare(boundary, boundaries_.back()) <= 0)) {
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -479,6 +533,150 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::AddSplitKeys(const FileDescriptor& fd) {
+  auto* cfd = compact_->compaction->column_family_data();
+  auto* table_cache = cfd->table_cache();
+  Cache::Handle* handle = nullptr;
+  auto status = table_cache->FindTable(
+      env_options_, cfd->internal_comparator(), fd, &handle, kDefaultQueryId);
+  if (!status.ok()) {
+    RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+         "Failed to open table %" PRIu64 " to find subcompaction boundaries: %s",
+         fd.GetNumber(), status.ToString().c_str());
+    return;
+  }
+  auto split_keys = table_cache->GetTableReaderFromHandle(handle)->GetSplitKeys(
+      db_options_.max_subcompactions * kSplitKeysPerSubcompaction);
+  table_cache->ReleaseHandle(handle);
+  if (!split_keys.ok()) {
+    RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+         "Failed to get split keys of table %" PRIu64 ": %s",
+         fd.GetNumber(), split_keys.status().ToString().c_str());
+    return;
+  }
+  for (auto& key : *split_keys) {
+    split_keys_.push_back(std::move(key));
+  }
+}
+
+namespace {
+
+// Subcompactions of a single compaction job, that are processed concurrently by the thread that
+// runs the job and by tasks submitted to the priority thread pool. Each subcompaction is claimed by
+// exactly one of them, so the job does not depend on free threads in the pool. Tasks that start
+// after all subcompactions were claimed do nothing, so they could outlive the job.
+class SubcompactionRunner {
+ public:
+  typedef std::function<void(size_t, yb::PriorityThreadPoolSuspender*)> ProcessFunctor;
+
+  SubcompactionRunner(size_t num_subcompactions, ProcessFunctor process)
+      : num_subcompactions_(num_subcompactions), process_(std::move(process)) {}
+
+  // Processes subcompactions that were not claimed yet, until there are no such subcompactions.
+  void ProcessAvailable(yb::PriorityThreadPoolSuspender* suspender) {
+    for (;;) {
+      const size_t index = next_.fetch_add(1, std::memory_order_acq_rel);
+      if (index >= num_subcompactions_) {
+        return;
+      }
+      process_(index, suspender);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (++num_finished_ == num_subcompactions_) {
+        cond_.notify_all();
+      }
+    }
+  }
+
+  void WaitAllFinished() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return num_finished_ == num_subcompactions_; });
+  }
+
+ private:
+  const size_t num_subcompactions_;
+  const ProcessFunctor process_;
+  std::atomic<size_t> next_{0};
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  size_t num_finished_ = 0;
+};
+
+class SubcompactionTask : public yb::PriorityThreadPoolTask {
+ public:
+  explicit SubcompactionTask(std::shared_ptr<SubcompactionRunner> runner)
+      : runner_(std::move(runner)) {}
+
+  void Run(const Status& status, yb::PriorityThreadPoolSuspender* suspender) override {
+    // Subcompactions of an aborted task are processed by the compaction job thread.
+    if (status.ok()) {
+      runner_->ProcessAvailable(suspender);
+    }
+  }
+
+  // The task does not need to be removed from the pool on DB shutdown, since the compaction job
+  // does not wait for it.
+  bool BelongsTo(void* key) override {
+    return false;
+  }
+
+  std::string ToString() const override {
+    return "{ subcompaction }";
+  }
+
+ private:
+  std::shared_ptr<SubcompactionRunner> runner_;
+};
+
+} // namespace
+
+void CompactionJob::RunSubcompactions(FileNumbersHolder* holder) {
+  auto& states = compact_->sub_compact_states;
+  auto* thread_pool = db_options_.priority_thread_pool_for_compactions_and_flushes;
+  if (states.size() > 1 && thread_pool) {
+    auto runner = std::make_shared<SubcompactionRunner>(
+        states.size(), [this, holder, &states](
+            size_t index, yb::PriorityThreadPoolSuspender* suspender) {
+      states[index].suspender = suspender;
+      ProcessKeyValueCompaction(holder, &states[index]);
+    });
+    for (size_t i = 1; i < states.size(); i++) {
+      std::unique_ptr<SubcompactionTask> task(new SubcompactionTask(runner));
+      // Subcompaction tasks use priority of the compaction they belong to, so the compaction job
+      // thread, that waits for them, does not wait for lower priority tasks. They are submitted
+      // later than the compaction task, so they never preempt it.
+      auto status = thread_pool->Submit(compact_->compaction->priority(), &task);
+      if (!status.ok()) {
+        // Remaining subcompactions will be processed by this thread.
+        RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
+             "[%s] [JOB %d] Failed to submit subcompaction task: %s",
+             compact_->compaction->column_family_data()->GetName().c_str(), job_id_,
+             status.ToString().c_str());
+        break;
+      }
+    }
+    runner->ProcessAvailable(compact_->compaction->suspender());
+    runner->WaitAllFinished();
+    return;
+  }
+
+  // Launch a thread for each of subcompactions 1...num_threads-1
+  std::vector<std::thread> threads;
+  threads.reserve(states.size() - 1);
+  for (size_t i = 1; i < states.size(); i++) {
+    threads.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this, holder, &states[i]);
+  }
+
+  // Always schedule the first subcompaction (whether or not there are also
+  // others) in the current thread to be efficient with resources
+  states[0].suspender = compact_->compaction->suspender();
+  ProcessKeyValueCompaction(holder, &states[0]);
+
+  // Wait for all other threads (if there are any) to finish execution
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 Result<FileNumbersHolder> CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -493,23 +691,17 @@ Result<FileNumbersHolder> CompactionJob::Run() {
   assert(num_threads > 0);
   const uint64_t start_micros = env_->NowMicros();
 
-  // Launch a thread for each of subcompactions 1...num_threads-1
-  std::vector<std::thread> thread_pool;
-  thread_pool.reserve(num_threads - 1);
   FileNumbersHolder file_numbers_holder(file_numbers_provider_->CreateHolder());
   file_numbers_holder.Reserve(num_threads);
-  for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this, &file_numbers_holder,
-                             &compact_->sub_compact_states[i]);
-  }
-
-  // Always schedule the first subcompaction (whether or not there are also
-  // others) in the current thread to be efficient with resources
-  ProcessKeyValueCompaction(&file_numbers_holder, &compact_->sub_compact_states[0]);
-
-  // Wait for all other threads (if there are any) to finish execution
-  for (auto& thread : thread_pool) {
-    thread.join();
+  RunSubcompactions(&file_numbers_holder);
+
+  // Each subcompaction has its own compaction filter, all of them should be reflected.
+  for (auto& state : compact_->sub_compact_states) {
+    if (state.largest_user_frontier) {
+      UpdateUserFrontier(
+          &largest_user_frontier_, std::move(state.largest_user_frontier),
+          UpdateUserValueType::kLargest);
+    }
   }
 
   if (output_directory_ && !db_options_.disableDataSync) {
@@ -660,7 +852,7 @@ void CompactionJob::ProcessKeyValueCompaction(
   if (compaction_filter) {
     // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
     // filter.
-    largest_user_frontier_ = compaction_filter->GetLargestUserFrontier();
+    sub_compact->largest_user_frontier = compaction_filter->GetLargestUserFrontier();
   }
 
   MergeHelper merge(
@@ -707,7 +899,10 @@ void CompactionJob::ProcessKeyValueCompaction(
       break;
     } else if (sub_compact->compaction->ShouldStopBefore(key) &&
                sub_compact->builder != nullptr) {
-      status = FinishCompactionOutputFile(input->status(), sub_compact);
+      status = FlushDelayedOutput(compaction_filter, sub_compact);
+      if (status.ok()) {
+        status = FinishCompactionOutputFile(input->status(), sub_compact);
+      }
       if (!status.ok()) {
         break;
       }
@@ -729,18 +924,21 @@ void CompactionJob::ProcessKeyValueCompaction(
     }
     assert(sub_compact->builder != nullptr);
     assert(sub_compact->current_output() != nullptr);
-    sub_compact->builder->Add(key, value);
-    auto boundaries = MakeFileBoundaryValues(db_options_.boundary_extractor.get(),
-                                             key,
-                                             value);
-    if (!boundaries) {
-      status = std::move(boundaries.status());
+    status = FlushDelayedOutput(compaction_filter, sub_compact);
+    if (!status.ok()) {
+      break;
+    }
+    if (compaction_filter && compaction_filter->DelayOutput(c_iter->user_key())) {
+      sub_compact->has_delayed_output = true;
+      sub_compact->delayed_key.assign(key.cdata(), key.size());
+      sub_compact->delayed_value.assign(value.cdata(), value.size());
+      c_iter->Next();
+      continue;
+    }
+    status = AddToOutput(key, value, sub_compact);
+    if (!status.ok()) {
       break;
     }
-    auto& boundary_values = *boundaries;
-    sub_compact->current_output()->meta.UpdateBoundaries(std::move(boundary_values.key),
-                                                         boundary_values);
-    sub_compact->num_output_records++;
 
     // Close output file if it is big enough
     // TODO(aekmekji): determine if file should be closed earlier than this
@@ -775,6 +973,9 @@ void CompactionJob::ProcessKeyValueCompaction(
     status = STATUS(ShutdownInProgress,
         "Database shutdown or Column family drop during compaction");
   }
+  if (status.ok()) {
+    status = FlushDelayedOutput(compaction_filter, sub_compact);
+  }
   if (status.ok() && sub_compact->builder != nullptr) {
     status = FinishCompactionOutputFile(input->status(), sub_compact);
   }
@@ -838,6 +1039,28 @@ void CompactionJob::CloseFile(Status* status, std::unique_ptr<WritableFileWriter
 
 }
 
+Status CompactionJob::AddToOutput(
+    const Slice& key, const Slice& value, SubcompactionState* sub_compact) {
+  sub_compact->builder->Add(key, value);
+  auto boundaries = MakeFileBoundaryValues(db_options_.boundary_extractor.get(), key, value);
+  RETURN_NOT_OK(boundaries);
+  auto& boundary_values = *boundaries;
+  sub_compact->current_output()->meta.UpdateBoundaries(std::move(boundary_values.key),
+                                                       boundary_values);
+  sub_compact->num_output_records++;
+  return Status::OK();
+}
+
+Status CompactionJob::FlushDelayedOutput(
+    CompactionFilter* compaction_filter, SubcompactionState* sub_compact) {
+  if (!sub_compact->has_delayed_output) {
+    return Status::OK();
+  }
+  sub_compact->has_delayed_output = false;
+  compaction_filter->CompleteDelayedOutput(&sub_compact->delayed_value);
+  return AddToOutput(sub_compact->delayed_key, sub_compact->delayed_value, sub_compact);
+}
+
 Status CompactionJob::FinishCompactionOutputFile(
     const Status& input_status, SubcompactionState* sub_compact) {
   AutoThreadOperationStageUpdater stage_updater(
@@ -972,9 +1195,26 @@ Status CompactionJob::InstallCompactionResults(
   // Add compaction outputs
   compaction->AddInputDeletions(compaction->edit());
 
+  // Level 0 output files of the same compaction have overlapping sequence numbers, so they are
+  // marked as a single sorted run, see IsSameSortedRun.
+  uint64_t sorted_run_id = 0;
+  if (compaction->output_level() == 0) {
+    size_t num_outputs = 0;
+    for (const auto& sub_compact : compact_->sub_compact_states) {
+      if (!sub_compact.outputs.empty() && num_outputs == 0) {
+        sorted_run_id = sub_compact.outputs.front().meta.fd.GetNumber();
+      }
+      num_outputs += sub_compact.outputs.size();
+    }
+    if (num_outputs < 2) {
+      sorted_run_id = 0;
+    }
+  }
   for (const auto& sub_compact : compact_->sub_compact_states) {
     for (const auto& out : sub_compact.outputs) {
-      compaction->edit()->AddFile(compaction->output_level(), out.meta);
+      FileMetaData meta = out.meta;
+      meta.sorted_run_id = sorted_run_id;
+      compaction->edit()->AddFile(compaction->output_level(), meta);
     }
   }
   if (largest_user_frontier_) {
@@ -1051,7 +1291,7 @@ Status CompactionJob::OpenCompactionOutputFile(
         (*writable_file)->SetPreallocationBlockSize(preallocation_block_size);
       }
       writer->reset(new WritableFileWriter(
-          std::move(*writable_file), env_options_, sub_compact->compaction->suspender()));
+          std::move(*writable_file), env_options_, sub_compact->suspender));
     };
 
     const bool is_split_sst = cfd->ioptions()->table_factory->IsSplitSstForWriteSupported();
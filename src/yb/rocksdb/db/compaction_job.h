@@ -111,6 +111,12 @@ class CompactionJob {
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
 
+  // Adds keys that split the table into parts of similar size to split_keys_.
+  void AddSplitKeys(const FileDescriptor& fd);
+
+  // Processes all subcompactions, in parallel when there are several of them.
+  void RunSubcompactions(FileNumbersHolder* holder);
+
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
   void AllocateCompactionOutputFileNumbers();
@@ -118,6 +124,10 @@ class CompactionJob {
   // kv-pairs
   void ProcessKeyValueCompaction(FileNumbersHolder* holder, SubcompactionState* sub_compact);
 
+  // Adds the record to the current output file of the subcompaction.
+  Status AddToOutput(const Slice& key, const Slice& value, SubcompactionState* sub_compact);
+  // Adds the record held back at the request of the compaction filter, if any.
+  Status FlushDelayedOutput(CompactionFilter* compaction_filter, SubcompactionState* sub_compact);
   Status FinishCompactionOutputFile(const Status& input_status,
                                     SubcompactionState* sub_compact);
   Status InstallCompactionResults(const MutableCFOptions& mutable_cf_options);
@@ -185,6 +195,11 @@ class CompactionJob {
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
+  // Keys from indexes of input tables, that are used as potential subcompaction boundaries.
+  std::vector<std::string> split_keys_;
+  // Number of split keys requested from each input table per subcompaction, so boundaries could
+  // be chosen with reasonable precision.
+  static constexpr size_t kSplitKeysPerSubcompaction = 4;
 
   UserFrontierPtr largest_user_frontier_;
 };
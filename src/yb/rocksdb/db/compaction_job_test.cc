@@ -28,6 +28,7 @@
 #include "yb/rocksdb/db/compaction_job.h"
 #include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/db/file_numbers.h"
+#include "yb/rocksdb/db/version_builder.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/db/writebuffer.h"
 #include "yb/rocksdb/cache.h"
@@ -40,6 +41,8 @@
 #include "yb/rocksdb/utilities/merge_operators.h"
 #include "yb/util/string_util.h"
 
+DECLARE_uint64(universal_compaction_min_subcompaction_size_bytes);
+
 namespace rocksdb {
 
 namespace {
@@ -256,6 +259,27 @@ class CompactionJobTest : public testing::Test {
       const stl_wrappers::KVMap& expected_results,
       const std::vector<SequenceNumber>& snapshots = {},
       SequenceNumber earliest_write_conflict_snapshot = kMaxSequenceNumber) {
+    size_t num_input_files = 0;
+    ASSERT_NO_FATAL_FAILURE(RunCompactionJob(
+        input_files, /* output_level= */ 1, snapshots, earliest_write_conflict_snapshot,
+        &num_input_files));
+
+    if (expected_results.size() == 0) {
+      ASSERT_GE(compaction_job_stats_.elapsed_micros, 0U);
+      ASSERT_EQ(compaction_job_stats_.num_input_files, num_input_files);
+      ASSERT_EQ(compaction_job_stats_.num_output_files, 0U);
+    } else {
+      ASSERT_GE(compaction_job_stats_.elapsed_micros, 0U);
+      ASSERT_EQ(compaction_job_stats_.num_input_files, num_input_files);
+      ASSERT_EQ(compaction_job_stats_.num_output_files, 1U);
+      mock_table_factory_->AssertLatestFile(expected_results);
+    }
+  }
+
+  void RunCompactionJob(
+      const std::vector<std::vector<FileMetaData*>>& input_files, int output_level,
+      const std::vector<SequenceNumber>& snapshots,
+      SequenceNumber earliest_write_conflict_snapshot, size_t* num_input_files_out) {
     auto cfd = versions_->GetColumnFamilySet()->GetDefault();
 
     size_t num_input_files = 0;
@@ -272,7 +296,7 @@ class CompactionJobTest : public testing::Test {
 
     Compaction compaction(cfd->current()->storage_info(),
                           *cfd->GetLatestMutableCFOptions(),
-                          compaction_input_files, 1, 1024 * 1024, 10, 0,
+                          compaction_input_files, output_level, 1024 * 1024, 10, 0,
                           kNoCompression, {}, true);
     compaction.SetInputVersion(cfd->current());
 
@@ -294,17 +318,7 @@ class CompactionJobTest : public testing::Test {
     mutex_.Lock();
     ASSERT_OK(compaction_job.Install(*cfd->GetLatestMutableCFOptions()));
     mutex_.Unlock();
-
-    if (expected_results.size() == 0) {
-      ASSERT_GE(compaction_job_stats_.elapsed_micros, 0U);
-      ASSERT_EQ(compaction_job_stats_.num_input_files, num_input_files);
-      ASSERT_EQ(compaction_job_stats_.num_output_files, 0U);
-    } else {
-      ASSERT_GE(compaction_job_stats_.elapsed_micros, 0U);
-      ASSERT_EQ(compaction_job_stats_.num_input_files, num_input_files);
-      ASSERT_EQ(compaction_job_stats_.num_output_files, 1U);
-      mock_table_factory_->AssertLatestFile(expected_results);
-    }
+    *num_input_files_out = num_input_files;
   }
 
   Env* env_;
@@ -1032,6 +1046,58 @@ TEST_F(CompactionJobTest, CorruptionAfterDeletion) {
   RunCompaction({files}, expected_results);
 }
 
+// Universal compaction of a single level DB split into subcompactions. Output files should form a
+// single sorted run, even though bottommost compaction zeroes their sequence numbers.
+TEST_F(CompactionJobTest, UniversalSubcompactions) {
+  google::FlagSaver flag_saver;
+  FLAGS_universal_compaction_min_subcompaction_size_bytes = 1;
+  db_options_.max_subcompactions = 4;
+  cf_options_.compaction_style = kCompactionStyleUniversal;
+  cf_options_.num_levels = 1;
+  NewDB();
+
+  auto expected_results = CreateTwoFiles(false);
+  auto files = cfd_->current()->storage_info()->LevelFiles(0);
+  ASSERT_EQ(2U, files.size());
+  size_t num_input_files = 0;
+  ASSERT_NO_FATAL_FAILURE(RunCompactionJob(
+      {files}, /* output_level= */ 0, /* snapshots= */ {}, kMaxSequenceNumber, &num_input_files));
+  ASSERT_EQ(2U, num_input_files);
+  ASSERT_GT(compaction_job_stats_.num_output_files, 1U);
+  mock_table_factory_->AssertLatestFiles(compaction_job_stats_.num_output_files, expected_results);
+
+  auto check_outputs = [this] {
+    const auto& outputs = cfd_->current()->storage_info()->LevelFiles(0);
+    ASSERT_EQ(compaction_job_stats_.num_output_files, outputs.size());
+    uint64_t first_file_number = std::numeric_limits<uint64_t>::max();
+    size_t num_zeroed = 0;
+    for (const auto* file : outputs) {
+      first_file_number = std::min(first_file_number, file->fd.GetNumber());
+      if (file->largest.seqno == 0) {
+        ++num_zeroed;
+      }
+    }
+    ASSERT_GT(num_zeroed, 0U);
+    for (size_t i = 0; i != outputs.size(); ++i) {
+      ASSERT_EQ(first_file_number, outputs[i]->sorted_run_id) << outputs[i]->ToString();
+      if (i > 0) {
+        ASSERT_TRUE(IsSameSortedRun(*outputs[i - 1], *outputs[i]));
+      }
+    }
+  };
+  ASSERT_NO_FATAL_FAILURE(check_outputs());
+
+  // Sorted run id is restored from the manifest.
+  versions_.reset(new VersionSet(
+      dbname_, &db_options_, env_options_, table_cache_.get(), &write_buffer_,
+      &write_controller_));
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.emplace_back(kDefaultColumnFamilyName, cf_options_);
+  ASSERT_OK(versions_->Recover(column_families, false));
+  cfd_ = versions_->GetColumnFamilySet()->GetDefault();
+  ASSERT_NO_FATAL_FAILURE(check_outputs());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
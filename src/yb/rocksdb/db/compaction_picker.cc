@@ -28,6 +28,7 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <limits>
 #include <queue>
 #include <string>
@@ -35,8 +36,10 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/db/version_builder.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/statistics.h"
@@ -1148,7 +1151,70 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  return vstorage->CompactionScore(kLevel0) >= 1 ||
+         !ExpiredFiles(*vstorage, false /* for_compaction */).empty();
+}
+
+std::vector<FileMetaData*> UniversalCompactionPicker::ExpiredFiles(
+    const VersionStorageInfo& vstorage, bool for_compaction) const {
+  std::vector<FileMetaData*> result;
+  if (!ioptions_.compaction_filter_factory) {
+    return result;
+  }
+  // Files at non zero levels are older than files at level 0, so we would have to check them
+  // first. We don't do it, since there is only level 0 in our setup.
+  for (int level = 1; level < vstorage.num_levels(); ++level) {
+    if (!vstorage.LevelFiles(level).empty()) {
+      return result;
+    }
+  }
+  const auto& files = vstorage.LevelFiles(0);
+  if (files.empty()) {
+    return result;
+  }
+  auto file_filter = ioptions_.compaction_filter_factory->CreateCompactionFileFilter(
+      for_compaction);
+  if (!file_filter) {
+    return result;
+  }
+  // Level 0 files are ordered from the newest to the oldest one.
+  for (auto it = files.rbegin(); it != files.rend(); ++it) {
+    FileMetaData* f = *it;
+    if (f->being_compacted ||
+        file_filter->Filter(f->largest.user_frontier.get()) != FilterDecision::kDiscard) {
+      break;
+    }
+    result.push_back(f);
+  }
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+std::unique_ptr<Compaction> UniversalCompactionPicker::PickExpiredFilesCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  auto expired_files = ExpiredFiles(*vstorage, true /* for_compaction */);
+  if (expired_files.empty()) {
+    return nullptr;
+  }
+  for (auto* f : expired_files) {
+    char tmp_fsize[16];
+    AppendHumanBytes(f->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking expired file %" PRIu64
+                              " with size %s for deletion",
+                  cf_name.c_str(), f->fd.GetNumber(), tmp_fsize);
+  }
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = 0;
+  inputs[0].files = std::move(expired_files);
+  auto c = std::make_unique<Compaction>(
+      vstorage, mutable_cf_options, std::move(inputs), 0 /* output_level */,
+      0 /* target_file_size */, 0 /* max_grandparent_overlap_bytes */, 0 /* output_path_id */,
+      kNoCompression, std::vector<FileMetaData*>(), /* is manual */ false,
+      vstorage->CompactionScore(0),
+      /* is deletion compaction */ true, CompactionReason::kFilesExpired);
+  level0_compactions_in_progress_.insert(c.get());
+  return c;
 }
 
 struct UniversalCompactionPicker::SortedRun {
@@ -1175,6 +1241,9 @@ struct UniversalCompactionPicker::SortedRun {
   // `file` Will be null for level > 0. For level = 0, the sorted run is
   // for this file.
   FileMetaData* file;
+  // Other level 0 files of the same sorted run, i.e. output files of a compaction that was split
+  // into subcompactions, see IsSameSortedRun. `size` and `compensated_file_size` include them.
+  std::vector<FileMetaData*> other_files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1209,8 +1278,7 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             file->fd.GetNumber(), sorted_run_count, size, compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1225,15 +1293,27 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
+  FileMetaData* prev_file = nullptr;
   for (FileMetaData* f : vstorage.LevelFiles(0)) {
     if (f->fd.GetTotalFileSize() <= max_file_size) {
-      ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
-          f->being_compacted);
+      auto& sequence = ret.back();
+      if (!sequence.empty() && sequence.back().file != nullptr && prev_file != nullptr &&
+          IsSameSortedRun(*prev_file, *f)) {
+        auto& sorted_run = sequence.back();
+        sorted_run.other_files.push_back(f);
+        sorted_run.size += f->fd.GetTotalFileSize();
+        sorted_run.compensated_file_size += f->compensated_file_size;
+        sorted_run.being_compacted = sorted_run.being_compacted || f->being_compacted;
+      } else {
+        sequence.emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
+            f->being_compacted);
+      }
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
       ret.emplace_back();
     }
+    prev_file = f;
   }
 
   for (int level = 1; level < vstorage.num_levels(); level++) {
@@ -1353,6 +1433,13 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  // Dropping expired files is cheap and frees the most space, so do it first.
+  auto expired_files_compaction = PickExpiredFilesCompaction(
+      cf_name, mutable_cf_options, vstorage, log_buffer);
+  if (expired_files_compaction) {
+    return expired_files_compaction;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
@@ -1694,6 +1781,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalRe
     if (picking_sr.level == 0) {
       FileMetaData* picking_file = picking_sr.file;
       inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.other_files.begin(), picking_sr.other_files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1820,6 +1909,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalSi
     if (picking_sr.level == 0) {
       FileMetaData* f = picking_sr.file;
       inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.other_files.begin(), picking_sr.other_files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
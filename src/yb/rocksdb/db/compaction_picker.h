@@ -264,6 +264,16 @@ class UniversalCompactionPicker : public CompactionPicker {
  private:
   struct SortedRun;
 
+  // Returns the oldest files, that could be dropped without reading them, according to compaction
+  // file filter. See CompactionFilterFactory::CreateCompactionFileFilter for for_compaction.
+  std::vector<FileMetaData*> ExpiredFiles(
+      const VersionStorageInfo& vstorage, bool for_compaction) const;
+
+  // Pick deletion compaction for files returned by ExpiredFiles.
+  std::unique_ptr<Compaction> PickExpiredFilesCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
   std::unique_ptr<Compaction> DoPickCompaction(
       const std::string& cf_name,
       const MutableCFOptions& mutable_cf_options,
@@ -21,9 +21,15 @@
 #include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksdb/db/compaction_picker.h"
 #include <limits>
+#include <map>
 #include <string>
+#include <tuple>
 #include <utility>
 
+#include <boost/optional.hpp>
+
+#include "yb/rocksdb/compaction_filter.h"
+
 #include "yb/rocksdb/util/logging.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
@@ -475,6 +481,158 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+namespace {
+
+// Discards files whose largest frontier value is not greater than expired_value.
+class ExpiredFileFilter : public CompactionFileFilter {
+ public:
+  explicit ExpiredFileFilter(uint64_t expired_value) : expired_value_(expired_value) {}
+
+  FilterDecision Filter(const UserFrontier* largest_frontier) override {
+    if (!largest_frontier ||
+        down_cast<const test::TestUserFrontier&>(*largest_frontier).Value() > expired_value_) {
+      return FilterDecision::kKeep;
+    }
+    return FilterDecision::kDiscard;
+  }
+
+ private:
+  const uint64_t expired_value_;
+};
+
+class ExpiredFileFilterFactory : public CompactionFilterFactory {
+ public:
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    return nullptr;
+  }
+
+  std::unique_ptr<CompactionFileFilter> CreateCompactionFileFilter(bool for_compaction) override {
+    ++(for_compaction ? num_compaction_filters : num_check_filters);
+    if (!expired_value) {
+      return nullptr;
+    }
+    return std::make_unique<ExpiredFileFilter>(*expired_value);
+  }
+
+  const char* Name() const override {
+    return "ExpiredFileFilterFactory";
+  }
+
+  // Files are not expired when not set, like for a table without TTL.
+  boost::optional<uint64_t> expired_value;
+  int num_check_filters = 0;
+  int num_compaction_filters = 0;
+};
+
+} // namespace
+
+TEST_F(CompactionPickerTest, ExpiredFilesUniversal) {
+  const uint64_t kFileSize = 100000;
+
+  ExpiredFileFilterFactory filter_factory;
+  ioptions_.compaction_filter_factory = &filter_factory;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+
+  // Level 0 files from the newest to the oldest one. Files 1 and 2 are expired, file 3 is not, so
+  // file 4 should be kept, even though it is expired, since it could hide records of file 3.
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  const std::vector<std::pair<uint32_t, uint64_t>> file_frontiers = {
+      {4U, 30}, {3U, 100}, {2U, 20}, {1U, 10}};
+  for (const auto& file_frontier : file_frontiers) {
+    const auto file_number = file_frontier.first;
+    const auto seqno = file_number * 100;
+    Add(0, file_number, ToString(file_number * 100).c_str(),
+        ToString(file_number * 100 + 99).c_str(), kFileSize, 0, seqno, seqno + 99);
+    file_map_[file_number].first->largest.user_frontier =
+        test::TestUserFrontier(file_frontier.second).Clone();
+  }
+  mutable_cf_options_.level0_file_num_compaction_trigger = 10;
+  UpdateVersionStorageInfo();
+  ASSERT_LT(vstorage_->CompactionScore(0), 1);
+
+  // Without TTL, no file is expired.
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  filter_factory.expired_value = 50;
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+  // Checking whether compaction is needed should not create a filter for compaction, so it does
+  // not have side effects, like committing history cutoff.
+  ASSERT_EQ(0, filter_factory.num_compaction_filters);
+  ASSERT_EQ(2, filter_factory.num_check_filters);
+
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction);
+  ASSERT_EQ(1, filter_factory.num_compaction_filters);
+  ASSERT_EQ(CompactionReason::kFilesExpired, compaction->compaction_reason());
+  ASSERT_TRUE(compaction->deletion_compaction());
+  ASSERT_EQ(1, compaction->num_input_levels());
+  ASSERT_EQ(2, compaction->num_input_files(0));
+  ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(1U, compaction->input(0, 1)->fd.GetNumber());
+}
+
+// Output files of a compaction that was split into subcompactions form a single sorted run, both
+// when their sequence numbers overlap and when they were all zeroed by bottommost compaction.
+TEST_F(CompactionPickerTest, SubcompactionSortedRunsUniversal) {
+  const uint64_t kFileSize = 100000;
+
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+
+  // Level 0 files from the newest to the oldest one, with sorted run ids.
+  const std::vector<std::tuple<uint32_t, const char*, const char*, SequenceNumber, SequenceNumber,
+                               uint64_t>> files = {
+      std::make_tuple(7U, "100", "900", 300, 399, 0),
+      std::make_tuple(6U, "100", "900", 200, 299, 0),
+      std::make_tuple(5U, "500", "900", 110, 190, 4),
+      std::make_tuple(4U, "100", "499", 100, 199, 4),
+      std::make_tuple(3U, "700", "900", 0, 0, 1),
+      std::make_tuple(2U, "400", "699", 0, 0, 1),
+      std::make_tuple(1U, "100", "399", 0, 0, 1),
+  };
+  auto add_files = [this, &files, kFileSize](size_t skip) {
+    NewVersionStorage(1, kCompactionStyleUniversal);
+    for (size_t i = skip; i != files.size(); ++i) {
+      const auto& file = files[i];
+      Add(0, std::get<0>(file), std::get<1>(file), std::get<2>(file), kFileSize, 0,
+          std::get<3>(file), std::get<4>(file));
+      file_map_[std::get<0>(file)].first->sorted_run_id = std::get<5>(file);
+    }
+    UpdateVersionStorageInfo();
+  };
+
+  // Three sorted runs.
+  add_files(1);
+  ASSERT_LT(vstorage_->CompactionScore(0), 1);
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  // Four sorted runs.
+  add_files(0);
+  ASSERT_GE(vstorage_->CompactionScore(0), 1);
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction);
+
+  // Sorted runs are compacted as a whole.
+  std::map<uint64_t, size_t> run_files;
+  for (size_t i = 0; i != compaction->num_input_files(0); ++i) {
+    auto run_id = compaction->input(0, i)->sorted_run_id;
+    if (run_id != 0) {
+      ++run_files[run_id];
+    }
+  }
+  for (const auto& run_id_and_count : run_files) {
+    ASSERT_EQ(run_id_and_count.first == 1 ? 3U : 2U, run_id_and_count.second)
+        << "Run: " << run_id_and_count.first;
+  }
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
@@ -56,6 +56,7 @@
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/priority_thread_pool.h"
+#include "yb/util/wait_state.h"
 
 #include "yb/rocksdb/db/auto_roll_logger.h"
 #include "yb/rocksdb/db/builder.h"
@@ -255,6 +256,10 @@ class DBImpl::CompactionTask : public ThreadPoolTask {
 
   void DoRun(yb::PriorityThreadPoolSuspender* suspender) override {
     compaction_->SetSuspender(suspender);
+    {
+      InstrumentedMutexLock lock(&db_impl_->mutex_);
+      compaction_->SetPriority(priority_);
+    }
     db_impl_->BackgroundCallCompaction(manual_compaction_, std::move(compaction_holder_), this);
   }
 
@@ -1934,6 +1939,23 @@ uint64_t DBImpl::GetCurrentVersionNumSSTFiles() {
   return default_cf_handle_->cfd()->current()->storage_info()->NumFiles();
 }
 
+yb::Result<std::string> DBImpl::GetMiddleKey() {
+  Version* version;
+  {
+    InstrumentedMutexLock lock(&mutex_);
+    version = default_cf_handle_->cfd()->current();
+    version->Ref();
+  }
+
+  auto result = version->GetMiddleKey();
+
+  {
+    InstrumentedMutexLock lock(&mutex_);
+    version->Unref();
+  }
+  return result;
+}
+
 void DBImpl::SetSSTFileTickers() {
   if (stats_) {
     auto sst_files_size = GetCurrentVersionSstFilesSize();
@@ -3260,6 +3282,7 @@ void DBImpl::BackgroundJobComplete(
 }
 
 void DBImpl::BackgroundCallFlush(ColumnFamilyData* cfd) {
+  yb::ScopedWaitActivity activity("Flush");
   bool made_progress = false;
   JobContext job_context(next_job_id_.fetch_add(1), true);
 
@@ -3293,6 +3316,7 @@ void DBImpl::BackgroundCallFlush(ColumnFamilyData* cfd) {
 
 void DBImpl::BackgroundCallCompaction(ManualCompaction* m, std::unique_ptr<Compaction> compaction,
                                       CompactionTask* compaction_task) {
+  yb::ScopedWaitActivity activity("Compaction");
   bool made_progress = false;
   JobContext job_context(next_job_id_.fetch_add(1), true);
   MaybeDumpStats();
@@ -3496,7 +3520,8 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
     assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+               kCompactionStyleFIFO ||
+           c->compaction_reason() == CompactionReason::kFilesExpired);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -634,6 +634,8 @@ class DBImpl : public DB {
 
   uint64_t GetCurrentVersionNumSSTFiles() override;
 
+  yb::Result<std::string> GetMiddleKey() override;
+
   int GetCfdImmNumNotFlushed() override;
 
   // Updates stats_ object with SST files size metrics.
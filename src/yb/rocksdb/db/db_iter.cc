@@ -247,6 +247,7 @@ inline bool DBIter::ParseKey(ParsedInternalKey* ikey) {
 
 void DBIter::Next() {
   assert(valid_);
+  PERF_COUNTER_ADD(iter_next_count, 1);
 
   if (direction_ == kReverse) {
     FindNextUserKey();
@@ -449,6 +450,7 @@ void DBIter::Prev() {
     ReverseToBackward();
   }
   PrevInternal();
+  PERF_COUNTER_ADD(iter_prev_count, 1);
   if (statistics_ != nullptr) {
     RecordTick(statistics_, NUMBER_DB_PREV);
     if (valid_) {
@@ -750,6 +752,7 @@ void DBIter::Seek(const Slice& target) {
   }
 
   RecordTick(statistics_, NUMBER_DB_SEEK);
+  PERF_COUNTER_ADD(iter_seek_count, 1);
   if (iter_->Valid()) {
     direction_ = kForward;
     ClearSavedValue();
@@ -783,6 +786,7 @@ void DBIter::SeekToFirst() {
   }
 
   RecordTick(statistics_, NUMBER_DB_SEEK);
+  PERF_COUNTER_ADD(iter_seek_count, 1);
   if (iter_->Valid()) {
     FindNextUserEntry(false /* not skipping */);
     if (statistics_ != nullptr) {
@@ -835,6 +839,7 @@ void DBIter::SeekToLast() {
     }
   }
   PrevInternal();
+  PERF_COUNTER_ADD(iter_seek_count, 1);
   if (statistics_ != nullptr) {
     RecordTick(statistics_, NUMBER_DB_SEEK);
     if (valid_) {
@@ -280,6 +280,7 @@ InternalIterator* TableCache::DoNewIterator(
     const ReadOptions& options, TableReaderWithHandle* trwh, const Slice& filter,
     bool for_compaction, Arena* arena, bool skip_filters) {
   RecordTick(ioptions_.statistics, NO_TABLE_CACHE_ITERATORS);
+  PERF_COUNTER_ADD(new_table_iterator_count, 1);
 
   InternalIterator* result =
       trwh->table_reader->NewIterator(options, arena, skip_filters);
@@ -56,6 +56,10 @@ bool NewestFirstBySeqNo(FileMetaData* a, FileMetaData* b) {
   return a->fd.GetNumber() > b->fd.GetNumber();
 }
 
+bool IsSameSortedRun(const FileMetaData& newer, const FileMetaData& older) {
+  return newer.sorted_run_id != 0 && newer.sorted_run_id == older.sorted_run_id;
+}
+
 namespace {
 bool BySmallestKey(FileMetaData* a, FileMetaData* b,
                    const InternalKeyComparator* cmp) {
@@ -147,7 +151,9 @@ class VersionBuilder::Rep {
           assert(f1->largest.seqno > f2->largest.seqno ||
                  // We can have multiple files with seqno = 0 as a result of
                  // using DB::AddFile()
-                 (f1->largest.seqno == 0 && f2->largest.seqno == 0));
+                 (f1->largest.seqno == 0 && f2->largest.seqno == 0) ||
+                 // Outputs of the same compaction split into subcompactions.
+                 IsSameSortedRun(*f1, *f2));
         } else {
           assert(level_nonzero_cmp_(f1, f2));
 
@@ -59,6 +59,12 @@ class VersionBuilder {
 
 extern bool NewestFirstBySeqNo(FileMetaData* a, FileMetaData* b);
 
+// Returns true if level 0 files newer and older, adjacent in NewestFirstBySeqNo order, belong to
+// the same sorted run. It happens when a compaction is split into key range subcompactions, so
+// its output files have overlapping sequence number ranges, or all of them have sequence number 0
+// after bottommost compaction. Such files are marked with the same sorted_run_id.
+extern bool IsSameSortedRun(const FileMetaData& newer, const FileMetaData& older);
+
 }  // namespace rocksdb
 
 #endif // YB_ROCKSDB_DB_VERSION_BUILDER_H
@@ -112,9 +112,9 @@ Slice FileMetaData::UserFilter() const {
 
 std::string FileMetaData::ToString() const {
   return yb::Format("{ number: $0 total_size: $1 base_size: $2 refs: $3 "
-                    "being_compacted: $4 smallest: $5 largest: $6 }",
+                    "being_compacted: $4 smallest: $5 largest: $6 sorted_run_id: $7 }",
                     fd.GetNumber(), fd.GetTotalFileSize(), fd.GetBaseFileSize(), refs,
-                    being_compacted, smallest, largest);
+                    being_compacted, smallest, largest, sorted_run_id);
 }
 
 void VersionEdit::Clear() {
@@ -237,6 +237,9 @@ bool VersionEdit::EncodeTo(VersionEditPB* dst) const {
     if (f.imported) {
       new_file.set_imported(true);
     }
+    if (f.sorted_run_id != 0) {
+      new_file.set_sorted_run_id(f.sorted_run_id);
+    }
   }
 
   // 0 is default and does not need to be explicitly written
@@ -325,6 +328,7 @@ Status VersionEdit::DecodeFrom(BoundaryValuesExtractor* extractor, const Slice&
     meta.marked_for_compaction = source.marked_for_compaction();
     max_level_ = std::max(max_level_, level);
     meta.imported = source.imported();
+    meta.sorted_run_id = source.sorted_run_id();
 
     // Use the relevant fields in the "largest" frontier to update the "flushed" frontier for this
     // version edit. In practice this will only look at OpId and will discard hybrid time and
@@ -97,6 +97,10 @@ struct FileMetaData {
   BoundaryValues smallest;  // The smallest values in this file
   BoundaryValues largest;   // The largest values in this file
   bool imported = false;    // Was this file imported from another DB.
+  // Non zero when this file is one of multiple level 0 output files of the same compaction, e.g.
+  // split into subcompactions. Such files form a single sorted run and have the same id, that is
+  // the number of the first output file of the compaction.
+  uint64_t sorted_run_id = 0;
 
   // Needs to be disposed when refs becomes 0.
   Cache::Handle* table_reader_handle;
@@ -201,6 +205,7 @@ class VersionEdit {
     }
     nf.marked_for_compaction = f.marked_for_compaction;
     nf.imported = f.imported;
+    nf.sorted_run_id = f.sorted_run_id;
     new_files_.emplace_back(level, std::move(nf));
   }
 
@@ -42,6 +42,7 @@
 
 #include "yb/gutil/casts.h"
 #include "yb/util/flags.h"
+#include "yb/util/scope_exit.h"
 
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/file_numbers.h"
@@ -625,6 +626,33 @@ Status Version::GetTableProperties(std::shared_ptr<const TableProperties>* tp,
   return s;
 }
 
+yb::Result<std::string> Version::GetMiddleKey() {
+  // Largest file contains most of the data, so its middle key is a good approximation of the
+  // middle key of the whole DB.
+  const FileMetaData* largest_file = nullptr;
+  for (int level = 0; level < storage_info_.num_levels_; level++) {
+    for (const auto* file : storage_info_.LevelFiles(level)) {
+      if (!largest_file || file->fd.GetTotalFileSize() > largest_file->fd.GetTotalFileSize()) {
+        largest_file = file;
+      }
+    }
+  }
+  if (!largest_file) {
+    return STATUS(Incomplete, "Empty DB");
+  }
+
+  auto table_cache = cfd_->table_cache();
+  Cache::Handle* handle = nullptr;
+  RETURN_NOT_OK(table_cache->FindTable(
+      vset_->env_options_, cfd_->internal_comparator(), largest_file->fd, &handle,
+      kDefaultQueryId));
+  auto se = yb::ScopeExit([table_cache, handle] {
+    table_cache->ReleaseHandle(handle);
+  });
+  auto middle_key = VERIFY_RESULT(table_cache->GetTableReaderFromHandle(handle)->GetMiddleKey());
+  return ExtractUserKey(middle_key).ToBuffer();
+}
+
 Status Version::GetPropertiesOfAllTables(TablePropertiesCollection* props) {
   Status s;
   for (int level = 0; level < storage_info_.num_levels_; level++) {
@@ -1243,11 +1271,15 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      const FileMetaData* prev_file = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          if (!prev_file || !IsSameSortedRun(*prev_file, *f)) {
+            num_sorted_runs++;
+          }
         }
+        prev_file = f;
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
         // For universal compaction, we use level0 score to indicate
@@ -1880,14 +1912,13 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
   int num_l0_count = 0;
-  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max()) {
-    num_l0_count = static_cast<int>(files_[0].size());
-  } else {
-    for (const auto& file : files_[0]) {
-      if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction) {
-        ++num_l0_count;
-      }
+  const FileMetaData* prev_file = nullptr;
+  for (const auto& file : files_[0]) {
+    if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction &&
+        (!prev_file || !IsSameSortedRun(*prev_file, *file))) {
+      ++num_l0_count;
     }
+    prev_file = file;
   }
   if (compaction_style_ == kCompactionStyleUniversal) {
     // For universal compaction, we use level0 score to indicate
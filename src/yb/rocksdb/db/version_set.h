@@ -511,6 +511,9 @@ class Version {
   Status GetAggregatedTableProperties(
       std::shared_ptr<const TableProperties>* tp, int level = -1);
 
+  // Returns middle user key of the largest SST file of this version, see TableReader::GetMiddleKey.
+  yb::Result<std::string> GetMiddleKey();
+
   uint64_t GetEstimatedActiveKeys() {
     return storage_info_.GetEstimatedActiveKeys();
   }
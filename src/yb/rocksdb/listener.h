@@ -74,6 +74,8 @@ enum class CompactionReason {
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] All records of the oldest files are expired
+  kFilesExpired,
 };
 
 #ifndef ROCKSDB_LITE
@@ -106,6 +106,17 @@ struct PerfContext {
   uint64_t bloom_sst_hit_count;
   // total number of SST table bloom misses
   uint64_t bloom_sst_miss_count;
+
+  // The following counters are used by DocDB read statistics. They are incremented on every
+  // iterator operation regardless of perf level, like other counters above.
+  // number of Seek/SeekToFirst/SeekToLast calls on DB iterators
+  uint64_t iter_seek_count;
+  // number of Next calls on DB iterators
+  uint64_t iter_next_count;
+  // number of Prev calls on DB iterators
+  uint64_t iter_prev_count;
+  // number of iterators created over SST files
+  uint64_t new_table_iterator_count;
 };
 
 #if defined(NPERF_CONTEXT) || defined(IOS_CROSS_COMPILE)
@@ -207,6 +207,12 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
   BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
 
+  // Data block compression statistics.
+  NUMBER_BLOCK_COMPRESSED,
+  BLOCK_COMPRESSION_INPUT_BYTES,
+  BLOCK_COMPRESSION_OUTPUT_BYTES,
+  BLOCK_COMPRESSION_NANOS,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -311,7 +317,11 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_MULTI_TOUCH_HIT, "rocksdb_block_cache_multi_touch_hit"},
     {BLOCK_CACHE_MULTI_TOUCH_ADD, "rocksdb_block_cache_multi_touch_add"},
     {BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, "rocksdb_block_cache_multi_touch_bytes_read"},
-    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"}
+    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"},
+    {NUMBER_BLOCK_COMPRESSED, "rocksdb_number_block_compressed"},
+    {BLOCK_COMPRESSION_INPUT_BYTES, "rocksdb_block_compression_input_bytes"},
+    {BLOCK_COMPRESSION_OUTPUT_BYTES, "rocksdb_block_compression_output_bytes"},
+    {BLOCK_COMPRESSION_NANOS, "rocksdb_block_compression_nanos"}
 };
 
 /**
@@ -581,10 +581,24 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
 
   auto type = r->compression_type;
   Slice block_contents;
-  if (raw_block_contents.size() < kCompressionSizeLimit) {
+  if (type == kNoCompression) {
+    block_contents = raw_block_contents;
+  } else if (raw_block_contents.size() < kCompressionSizeLimit) {
+    Statistics* statistics = r->ioptions.statistics;
+    StopWatchNano timer(r->ioptions.env, statistics != nullptr);
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
                       r->table_options.format_version, &r->compressed_output);
+    if (statistics) {
+      RecordTick(statistics, BLOCK_COMPRESSION_NANOS, timer.ElapsedNanos());
+      if (type != kNoCompression) {
+        RecordTick(statistics, NUMBER_BLOCK_COMPRESSED);
+        RecordTick(statistics, BLOCK_COMPRESSION_INPUT_BYTES, raw_block_contents.size());
+        RecordTick(statistics, BLOCK_COMPRESSION_OUTPUT_BYTES, block_contents.size());
+      } else {
+        RecordTick(statistics, NUMBER_BLOCK_NOT_COMPRESSED);
+      }
+    }
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -774,6 +788,7 @@ Status BlockBasedTableBuilder::Finish() {
       PropertyBlockBuilder property_block_builder;
       r->props.filter_policy_name = r->table_options.filter_policy != nullptr ?
           r->table_options.filter_policy->Name() : "";
+      r->props.compression_name = CompressionTypeToString(r->compression_type);
       r->props.data_index_size =
           r->data_index_builder->EstimatedSize() + kBlockTrailerSize;
 
@@ -1613,6 +1613,55 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+
+  const auto data_size = rep_->table_properties ? rep_->table_properties->data_size : 0;
+  if (data_size == 0) {
+    return STATUS(Incomplete, "Table has no data size property");
+  }
+  // Index entries are ordered by data block offset, so the first block that starts in the second
+  // half of data splits the table into two halves.
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    BlockHandle handle;
+    Slice input = index_iter->value();
+    RETURN_NOT_OK(handle.DecodeFrom(&input));
+    if (handle.offset() >= data_size / 2) {
+      return index_iter->key().ToBuffer();
+    }
+  }
+  RETURN_NOT_OK(index_iter->status());
+  return STATUS(Incomplete, "Table has too few data blocks");
+}
+
+yb::Result<std::vector<std::string>> BlockBasedTable::GetSplitKeys(size_t num_parts) {
+  std::vector<std::string> result;
+  const auto data_size = rep_->table_properties ? rep_->table_properties->data_size : 0;
+  if (data_size == 0 || num_parts < 2) {
+    return result;
+  }
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+  result.reserve(num_parts - 1);
+  // Index entries are ordered by data block offset, so the first block that starts at or after
+  // the next part boundary starts the next part.
+  uint64_t next_boundary = data_size / num_parts;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    BlockHandle handle;
+    Slice input = index_iter->value();
+    RETURN_NOT_OK(handle.DecodeFrom(&input));
+    if (handle.offset() < next_boundary || handle.offset() == 0) {
+      continue;
+    }
+    result.push_back(index_iter->key().ToBuffer());
+    if (result.size() == num_parts - 1) {
+      break;
+    }
+    next_boundary = data_size * (result.size() + 1) / num_parts;
+  }
+  RETURN_NOT_OK(index_iter->status());
+  return result;
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
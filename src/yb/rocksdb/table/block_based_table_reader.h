@@ -163,6 +163,14 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Uses the middle entry of the data index. Data blocks have about the same size, so this key
+  // follows the actual key distribution of the table.
+  yb::Result<std::string> GetMiddleKey() override;
+
+  // Same as GetMiddleKey, keys are taken from the data index. So there could be less keys than
+  // requested when the table has few data blocks.
+  yb::Result<std::vector<std::string>> GetSplitKeys(size_t num_parts) override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -41,6 +41,7 @@
 #include "yb/util/format.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/string_util.h"
+#include "yb/util/wait_state.h"
 
 using yb::Format;
 using yb::Result;
@@ -358,6 +359,7 @@ Status ReadBlock(
   Status s;
   {
     PERF_TIMER_GUARD(block_read_time);
+    yb::ScopedWaitState wait_state(yb::WaitStateCode::kBlockRead);
     struct BlockChecksumValidator : public yb::ReadValidator {
       BlockChecksumValidator(
           RandomAccessFileReader* file_, const Footer& footer_, const ReadOptions& options_,
@@ -64,6 +64,33 @@ Status MockTableReader::Get(const ReadOptions&, const Slice& key,
   return Status::OK();
 }
 
+uint64_t MockTableReader::ApproximateOffsetOf(const Slice& key) {
+  uint64_t result = 0;
+  for (auto it = table_.begin(), end = table_.lower_bound(key.ToBuffer()); it != end; ++it) {
+    result += it->first.size() + it->second.size();
+  }
+  return result;
+}
+
+yb::Result<std::vector<std::string>> MockTableReader::GetSplitKeys(size_t num_parts) {
+  std::vector<std::string> result;
+  if (num_parts < 2 || table_.size() < num_parts) {
+    return result;
+  }
+  result.reserve(num_parts - 1);
+  size_t index = 0;
+  for (const auto& entry : table_) {
+    if (index != 0 && index % (table_.size() / num_parts) == 0) {
+      result.push_back(entry.first);
+      if (result.size() == num_parts - 1) {
+        break;
+      }
+    }
+    ++index;
+  }
+  return result;
+}
+
 std::shared_ptr<const TableProperties> MockTableReader::GetTableProperties()
     const {
   return std::shared_ptr<const TableProperties>(new TableProperties());
@@ -158,5 +185,17 @@ void MockTableFactory::AssertLatestFile(
   }
 }
 
+void MockTableFactory::AssertLatestFiles(
+    size_t num_files, const stl_wrappers::KVMap& file_contents) {
+  ASSERT_GE(file_system_.files.size(), num_files);
+  auto contents = MakeMockFile();
+  auto it = file_system_.files.end();
+  for (size_t i = 0; i != num_files; ++i) {
+    --it;
+    contents.insert(it->second.begin(), it->second.end());
+  }
+  ASSERT_TRUE(file_contents == contents);
+}
+
 }  // namespace mock
 }  // namespace rocksdb
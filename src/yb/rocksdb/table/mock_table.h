@@ -66,7 +66,10 @@ class MockTableReader : public TableReader {
   Status Get(const ReadOptions&, const Slice& key, GetContext* get_context,
              bool skip_filters = false) override;
 
-  uint64_t ApproximateOffsetOf(const Slice& key) override { return 0; }
+  // Total size of keys and values of entries that precede key.
+  uint64_t ApproximateOffsetOf(const Slice& key) override;
+
+  yb::Result<std::vector<std::string>> GetSplitKeys(size_t num_parts) override;
 
   virtual size_t ApproximateMemoryUsage() const override { return 0; }
 
@@ -200,6 +203,8 @@ class MockTableFactory : public TableFactory {
   // contents are equal to file_contents
   void AssertSingleFile(const stl_wrappers::KVMap& file_contents);
   void AssertLatestFile(const stl_wrappers::KVMap& file_contents);
+  // Asserts that the latest num_files files together contain exactly file_contents.
+  void AssertLatestFiles(size_t num_files, const stl_wrappers::KVMap& file_contents);
 
  private:
   uint32_t GetAndWriteNextID(WritableFileWriter* file) const;
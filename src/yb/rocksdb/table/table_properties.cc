@@ -95,6 +95,11 @@ std::string TableProperties::ToString(
       filter_policy_name.empty() ? std::string("N/A") : filter_policy_name,
       prop_delim, kv_delim);
 
+  AppendProperty(
+      &result, "compression",
+      compression_name.empty() ? std::string("N/A") : compression_name,
+      prop_delim, kv_delim);
+
   return result;
 }
 
@@ -133,6 +138,8 @@ const std::string TablePropertiesNames::kNumDataIndexBlocks =
     "rocksdb.num.data.index.blocks";
 const std::string TablePropertiesNames::kFilterPolicy =
     "rocksdb.filter.policy";
+const std::string TablePropertiesNames::kCompression =
+    "rocksdb.compression";
 const std::string TablePropertiesNames::kFormatVersion =
     "rocksdb.format.version";
 const std::string TablePropertiesNames::kFixedKeyLen =
@@ -25,7 +25,10 @@
 #define ROCKSDB_TABLE_TABLE_READER_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "yb/util/result.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -72,6 +75,17 @@ class TableReader {
   // be close to the file length.
   virtual uint64_t ApproximateOffsetOf(const Slice& key) = 0;
 
+  // Returns internal key that splits table data into two parts of approximately the same size.
+  virtual yb::Result<std::string> GetMiddleKey() {
+    return STATUS(NotSupported, "GetMiddleKey is not supported for this table type");
+  }
+
+  // Returns up to num_parts - 1 internal keys in increasing order, that split table data into
+  // num_parts parts of approximately the same size.
+  virtual yb::Result<std::vector<std::string>> GetSplitKeys(size_t num_parts) {
+    return STATUS(NotSupported, "GetSplitKeys is not supported for this table type");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -1042,6 +1042,7 @@ TEST_F(BlockBasedTableTest, BasicBlockBasedTableProperties) {
   ASSERT_EQ(raw_value_size, props.raw_value_size);
   ASSERT_EQ(1ul, props.num_data_blocks);
   ASSERT_EQ("", props.filter_policy_name);  // no filter policy is used
+  ASSERT_EQ("NoCompression", props.compression_name);
 
   // Verify data size.
   BlockBuilder block_builder(1);
@@ -79,6 +79,9 @@ struct TableProperties {
   // If no filter policy is used, `filter_policy_name` will be an empty string.
   std::string filter_policy_name;
 
+  // The name of the compression algorithm used to compress data blocks of this table.
+  std::string compression_name;
+
   // user collected properties
   UserCollectedProperties user_collected_properties;
   UserCollectedProperties readable_properties;
@@ -108,6 +111,7 @@ struct TablePropertiesNames {
   static const std::string kFormatVersion;
   static const std::string kFixedKeyLen;
   static const std::string kFilterPolicy;
+  static const std::string kCompression;
 };
 
 extern const std::string kPropertiesBlock;
@@ -23,12 +23,15 @@
 
 #include "yb/rocksdb/cache.h"
 
+#include <atomic>
 #include <forward_list>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <thread>
 #include <gflags/gflags.h>
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/random.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
 
@@ -675,6 +678,243 @@ TEST_F(CacheTest, ApplyToAllCacheEntiresTest) {
   ASSERT_TRUE(inserted == callback_state);
 }
 
+class ClockCacheTest : public CacheTest {
+ public:
+  ClockCacheTest() {
+    cache_ = NewClockCache(kCacheSize, kNumShardBits);
+    cache2_ = NewClockCache(kCacheSize2, kNumShardBits2);
+  }
+};
+
+TEST_F(ClockCacheTest, HitAndMiss) {
+  ASSERT_EQ(-1, Lookup(100));
+
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(-1,  Lookup(200));
+
+  ASSERT_OK(Insert(200, 201));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+
+  ASSERT_OK(Insert(100, 102));
+  ASSERT_EQ(102, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(100);
+  ASSERT_EQ(-1,  Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[1]);
+  ASSERT_EQ(102, deleted_values_[1]);
+}
+
+TEST_F(ClockCacheTest, EntriesArePinned) {
+  ASSERT_OK(Insert(100, 101));
+  Cache::Handle* h1 = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(101, DecodeValue(cache_->Value(h1)));
+  ASSERT_EQ(1U, cache_->GetUsage());
+  ASSERT_EQ(1U, cache_->GetPinnedUsage());
+
+  ASSERT_OK(Insert(100, 102));
+  Cache::Handle* h2 = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(102, DecodeValue(cache_->Value(h2)));
+  ASSERT_EQ(0U, deleted_keys_.size());
+  ASSERT_EQ(2U, cache_->GetUsage());
+  ASSERT_EQ(2U, cache_->GetPinnedUsage());
+
+  cache_->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(101, deleted_values_[0]);
+  ASSERT_EQ(1U, cache_->GetUsage());
+
+  Erase(100);
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(1U, cache_->GetUsage());
+
+  cache_->Release(h2);
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(102, deleted_values_[1]);
+  ASSERT_EQ(0U, cache_->GetUsage());
+  ASSERT_EQ(0U, cache_->GetPinnedUsage());
+}
+
+TEST_F(ClockCacheTest, SecondChance) {
+  const size_t kCapacity = 50;
+  const int kSingleTouchCapacity = kCapacity * FLAGS_cache_single_touch_ratio;
+  cache_ = NewClockCache(kCapacity, 0);
+
+  for (int i = 0; i < kSingleTouchCapacity; ++i) {
+    ASSERT_OK(Insert(i, i));
+  }
+  // Entries from the first half are accessed, so the clock hand skips them once.
+  for (int i = 0; i < kSingleTouchCapacity / 2; ++i) {
+    ASSERT_EQ(i, Lookup(i));
+  }
+  for (int i = kSingleTouchCapacity; i < kSingleTouchCapacity * 3 / 2; ++i) {
+    ASSERT_OK(Insert(i, i));
+  }
+  for (int i = 0; i < kSingleTouchCapacity * 3 / 2; ++i) {
+    const bool evicted = i >= kSingleTouchCapacity / 2 && i < kSingleTouchCapacity;
+    ASSERT_EQ(evicted ? -1 : i, Lookup(i)) << "Key: " << i;
+  }
+}
+
+TEST_F(ClockCacheTest, MultiTouch) {
+  QueryId qid1 = 1000;
+  QueryId qid2 = 1001;
+
+  ASSERT_OK(Insert(100, 101, 1, qid1));
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(100, 101, qid1));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(100, 101, qid2));
+
+  // Multi touch entry should not be evicted by single touch entries.
+  for (int i = 0; i < kCacheSize + 100; i++) {
+    ASSERT_OK(Insert(1000 + i, 2000 + i));
+    ASSERT_EQ(2000 + i, Lookup(1000 + i));
+  }
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(100, 101, qid2));
+}
+
+TEST_F(ClockCacheTest, OverCapacity) {
+  const size_t kCapacity = 50;
+  const size_t kSingleTouchCapacity = kCapacity * FLAGS_cache_single_touch_ratio;
+  std::shared_ptr<Cache> cache = NewClockCache(kCapacity, 0);
+
+  std::vector<Cache::Handle*> handles(kSingleTouchCapacity + 1);
+  for (size_t i = 0; i != handles.size(); ++i) {
+    ASSERT_OK(cache->Insert(
+        EncodeKey(i), kTestQueryId, EncodeValue(i), 1, &CacheTest::Deleter, &handles[i]));
+  }
+
+  // The cache is over capacity since nothing could be evicted.
+  ASSERT_EQ(kSingleTouchCapacity + 1, cache->GetUsage());
+  for (auto* handle : handles) {
+    cache->Release(handle);
+  }
+  ASSERT_EQ(kSingleTouchCapacity, cache->GetUsage());
+  ASSERT_EQ(1U, deleted_keys_.size());
+}
+
+namespace {
+
+std::atomic<size_t> clock_cache_deleted_entries{0};
+
+void CountingDeleter(const Slice& key, void* value) {
+  clock_cache_deleted_entries.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+TEST_F(ClockCacheTest, Concurrent) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeys = 200;
+  constexpr int kOpsPerThread = 20000;
+
+  auto cache = NewClockCache(100, 2);
+  clock_cache_deleted_entries = 0;
+  std::atomic<size_t> inserted_entries{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([&cache, &inserted_entries, t] {
+      Random rnd(t + 1);
+      for (int i = 0; i != kOpsPerThread; ++i) {
+        const int key = rnd.Uniform(kNumKeys);
+        const QueryId query_id = rnd.Uniform(2);
+        switch (rnd.Uniform(3)) {
+          case 0:
+            EXPECT_OK(cache->Insert(
+                EncodeKey(key), query_id, EncodeValue(key), 1, &CountingDeleter));
+            inserted_entries.fetch_add(1, std::memory_order_relaxed);
+            break;
+          case 1: {
+            auto* handle = cache->Lookup(EncodeKey(key), query_id);
+            if (handle != nullptr) {
+              EXPECT_EQ(key, DecodeValue(cache->Value(handle)));
+              cache->Release(handle);
+            }
+            break;
+          }
+          case 2:
+            cache->Erase(EncodeKey(key));
+            break;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+  for (int key = 0; key != kNumKeys; ++key) {
+    cache->Erase(EncodeKey(key));
+  }
+  ASSERT_EQ(0U, cache->GetUsage());
+  ASSERT_EQ(inserted_entries.load(), clock_cache_deleted_entries.load());
+}
+
+TEST_F(ClockCacheTest, DecreaseCapacity) {
+  constexpr int kNumKeys = 1000;
+  constexpr size_t kSmallCapacity = 10;
+
+  auto cache = NewClockCache(kNumKeys, 0);
+  clock_cache_deleted_entries = 0;
+  size_t inserted_entries = 0;
+  auto insert = [&cache, &inserted_entries](int key) {
+    ++inserted_entries;
+    return cache->Insert(EncodeKey(key), kTestQueryId, EncodeValue(key), 1, &CountingDeleter);
+  };
+  for (int key = 0; key != kNumKeys; ++key) {
+    ASSERT_OK(insert(key));
+  }
+
+  // Concurrent lookups should not access deallocated handles, while the cache gets rid of handles
+  // that are not needed after the capacity decrease.
+  std::atomic<bool> stop{false};
+  std::thread reader([&cache, &stop] {
+    Random rnd(1);
+    while (!stop.load(std::memory_order_acquire)) {
+      const int key = rnd.Uniform(kNumKeys);
+      auto* handle = cache->Lookup(EncodeKey(key), kTestQueryId);
+      if (handle != nullptr) {
+        EXPECT_EQ(key, DecodeValue(cache->Value(handle)));
+        cache->Release(handle);
+      }
+    }
+  });
+
+  cache->SetCapacity(kSmallCapacity);
+  for (int key = 0; key != kNumKeys; ++key) {
+    ASSERT_OK(insert(key));
+    if (key % 2 == 0) {
+      cache->Erase(EncodeKey(key));
+    }
+  }
+
+  stop.store(true, std::memory_order_release);
+  reader.join();
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+  ASSERT_LE(cache->GetUsage(), kSmallCapacity);
+
+  // Handles are allocated again when the capacity grows back.
+  cache->SetCapacity(kNumKeys);
+  for (int key = 0; key != kNumKeys; ++key) {
+    ASSERT_OK(insert(key));
+  }
+  ASSERT_GT(cache->GetUsage(), kSmallCapacity);
+  for (int key = 0; key != kNumKeys; ++key) {
+    cache->Erase(EncodeKey(key));
+  }
+  ASSERT_EQ(0U, cache->GetUsage());
+  ASSERT_EQ(inserted_entries, clock_cache_deleted_entries.load());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -0,0 +1,996 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/autovector.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/statistics.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
+#include "yb/util/scope_exit.h"
+
+DECLARE_double(cache_single_touch_ratio);
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation
+//
+// Entries are stored in ClockHandle objects that are never deallocated while the cache exists.
+// A handle of an erased or evicted entry is put to the free list and reused for new entries.
+// Since handle memory always stays valid, Lookup traverses the hash table and acquires a
+// reference without taking the shard mutex. Insert, Erase and eviction still modify the hash
+// table under the mutex.
+//
+// The state of a handle is kept in a single atomic word:
+//   kInCacheBit - the entry is referenced by the hash table.
+//   kUsageBit - the entry was accessed since the clock hand passed it last time.
+//   Remaining bits - number of external references.
+//
+// A reference is acquired only while kInCacheBit is set, so a handle on the free list is never
+// referenced. The entry is freed by the thread that removes the last of the external references
+// and the reference from the hash table.
+//
+// The clock hand walks over all handles of the shard, evicting entries that are not referenced
+// and have no usage bit, and clearing the usage bit of other entries, i.e. giving them a second
+// chance.
+//
+// Single-touch and multi-touch sub-caches have the same semantics as in the LRU cache: an entry
+// accessed by a query different from the one that added it is moved to the multi-touch sub-cache.
+// Each sub-cache is evicted separately to stay within its capacity.
+//
+// Free handles with the lowest index are reused first, so when the number of entries decreases,
+// e.g. after the capacity is decreased, free handles gather at the end of the handle array. They
+// are deallocated when no lock-free lookup is in progress, since only lookups that started before
+// a handle was removed from the hash table could still access it.
+
+constexpr uint32_t kInCacheBit = 1;
+constexpr uint32_t kUsageBit = 2;
+constexpr uint32_t kRefsShift = 2;
+constexpr uint32_t kOneRef = 1 << kRefsShift;
+
+// Number of hash table entries that Lookup visits without the mutex. Concurrent modifications of
+// the hash table could send the lock-free traversal to a different chain, so after this number of
+// steps the lookup is retried under the mutex.
+constexpr size_t kMaxLockFreeLookupSteps = 32;
+
+inline uint32_t CountRefs(uint32_t flags) {
+  return flags >> kRefsShift;
+}
+
+struct ClockHandle {
+  std::atomic<uint32_t> flags{0};
+  std::atomic<uint32_t> hash{0};
+  std::atomic<ClockHandle*> next_hash{nullptr};
+  // Could be changed only under the shard mutex, while the entry is in cache.
+  std::atomic<QueryId> query_id{kDefaultQueryId};
+
+  // Position of the handle in ClockCacheShard::handles_ and whether it is on the free list, both
+  // protected by the shard mutex.
+  size_t index = 0;
+  bool free = false;
+
+  // Fields below are modified only while the handle is not referenced by the hash table and has
+  // no external references.
+  std::string key;
+  void* value = nullptr;
+  void (*deleter)(const Slice&, void* value) = nullptr;
+  size_t charge = 0;
+
+  SubCacheType GetSubCacheType() const {
+    return query_id.load(std::memory_order_relaxed) == kInMultiTouchId ? MULTI_TOUCH
+                                                                       : SINGLE_TOUCH;
+  }
+};
+
+// Array of hash table buckets, each bucket is a linked list of handles.
+struct ClockBuckets {
+  explicit ClockBuckets(size_t size)
+      : mask(size - 1), buckets(new std::atomic<ClockHandle*>[size]) {
+    for (size_t i = 0; i != size; ++i) {
+      buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  size_t size() const {
+    return mask + 1;
+  }
+
+  std::atomic<ClockHandle*>& Bucket(uint32_t hash) {
+    return buckets[hash & mask];
+  }
+
+  const size_t mask;
+  std::unique_ptr<std::atomic<ClockHandle*>[]> buckets;
+};
+
+struct ClockSubCache {
+  std::atomic<size_t> capacity{0};
+  // Memory size of entries residing in the sub-cache, including erased entries that are still
+  // referenced externally.
+  std::atomic<size_t> usage{0};
+};
+
+// Collects entries removed from the cache, so their deleters could be invoked after the mutex is
+// released.
+class ClockEntryDeleter {
+ public:
+  explicit ClockEntryDeleter(yb::CacheMetrics* metrics) : metrics_(metrics) {}
+
+  void Add(ClockHandle* handle, bool counted_in_metrics = true) {
+    entries_.push_back(Entry{
+        std::move(handle->key), handle->value, handle->deleter, handle->charge,
+        handle->GetSubCacheType(), counted_in_metrics});
+  }
+
+  size_t TotalCharge() const {
+    size_t result = 0;
+    for (const auto& entry : entries_) {
+      result += entry.charge;
+    }
+    return result;
+  }
+
+  ~ClockEntryDeleter() {
+    for (const auto& entry : entries_) {
+      (*entry.deleter)(entry.key, entry.value);
+      if (metrics_ != nullptr && entry.counted_in_metrics) {
+        if (entry.subcache_type == MULTI_TOUCH) {
+          metrics_->multi_touch_cache_usage->DecrementBy(entry.charge);
+        } else {
+          metrics_->single_touch_cache_usage->DecrementBy(entry.charge);
+        }
+        metrics_->cache_usage->DecrementBy(entry.charge);
+      }
+    }
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    void* value;
+    void (*deleter)(const Slice&, void* value);
+    size_t charge;
+    SubCacheType subcache_type;
+    bool counted_in_metrics;
+  };
+
+  yb::CacheMetrics* metrics_;
+  autovector<Entry> entries_;
+};
+
+// A single shard of sharded cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard();
+  ~ClockCacheShard();
+
+  void SetCapacity(size_t capacity);
+
+  void SetMetrics(std::shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = std::move(metrics);
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) {
+    MutexLock l(&mutex_);
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  // Like Cache methods, but with an extra "hash" parameter.
+  Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                Cache::Handle** handle, Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                        Statistics* statistics);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+  size_t Evict(size_t required);
+
+  size_t GetUsage() const {
+    return single_touch_sub_cache_.usage.load(std::memory_order_relaxed) +
+           multi_touch_sub_cache_.usage.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const {
+    return pinned_usage_.load(std::memory_order_relaxed);
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe);
+
+ private:
+  ClockSubCache* GetSubCache(SubCacheType subcache_type);
+
+  // Acquires a reference to the handle if it is in cache.
+  bool TryRef(ClockHandle* h);
+
+  // Removes an external reference, returns true if the handle was freed.
+  bool Unref(ClockHandle* h);
+
+  // Frees the handle that was removed from the cache and has no external references.
+  void Free(ClockHandle* h);
+
+  // Same as Free, but deleter is invoked by "deleted" after the mutex is released.
+  // REQUIRES: mutex_ held.
+  void FreeLocked(ClockHandle* h, ClockEntryDeleter* deleted);
+
+  // Moves the entry to the multi-touch sub-cache.
+  void PromoteToMultiTouch(ClockHandle* h);
+
+  // Removes the entry from the hash table and drops the reference of the hash table to it.
+  // REQUIRES: mutex_ held.
+  void RemoveFromCacheLocked(ClockHandle* h, ClockEntryDeleter* deleted);
+
+  // Runs the clock hand until usage of the sub-cache plus charge fits into its capacity, or all
+  // entries of the sub-cache are referenced.
+  // REQUIRES: mutex_ held.
+  void EvictFromClock(size_t charge, ClockEntryDeleter* deleted, SubCacheType subcache_type);
+
+  // Hash table operations, all of them except FindLockFree require mutex_ to be held.
+  ClockHandle* FindLockFree(const Slice& key, uint32_t hash, bool* completed);
+  ClockHandle* FindLocked(const Slice& key, uint32_t hash);
+  ClockHandle* InsertToTableLocked(ClockHandle* h);
+  void RemoveFromTableLocked(ClockHandle* h);
+  void ResizeTableLocked();
+
+  ClockHandle* AllocateHandleLocked();
+  void ReleaseHandleLocked(ClockHandle* h);
+
+  // Deallocates free handles at the end of handles_, if most of the handles are free.
+  void TrimHandlesLocked();
+
+  ClockSubCache single_touch_sub_cache_;
+  ClockSubCache multi_touch_sub_cache_;
+
+  // Memory size of entries that have external references.
+  std::atomic<size_t> pinned_usage_{0};
+
+  std::atomic<ClockBuckets*> table_{nullptr};
+
+  // Number of lookups that traverse the hash table without the mutex.
+  std::atomic<size_t> lock_free_lookups_{0};
+
+  // mutex_ protects the following state.
+  mutable port::Mutex mutex_;
+
+  bool strict_capacity_limit_ = false;
+
+  // All handles of this shard. std::deque never moves its elements, so pointers to handles remain
+  // valid until they are trimmed from its end by TrimHandlesLocked.
+  std::deque<ClockHandle> handles_;
+  // Heap of free handles, the one with the lowest index on top.
+  std::vector<ClockHandle*> free_handles_;
+  size_t clock_hand_ = 0;
+  size_t num_entries_ = 0;
+
+  // All bucket arrays ever used by this shard. Replaced arrays could still be traversed by
+  // concurrent lookups, so they are kept until the shard is destroyed.
+  std::vector<std::unique_ptr<ClockBuckets>> buckets_;
+
+  std::shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+ClockCacheShard::ClockCacheShard() {
+  buckets_.emplace_back(new ClockBuckets(16));
+  table_.store(buckets_.back().get(), std::memory_order_release);
+}
+
+ClockCacheShard::~ClockCacheShard() {
+  for (auto& h : handles_) {
+    // Entries that are still referenced externally are leaked, the same as in the LRU cache.
+    const auto flags = h.flags.load(std::memory_order_acquire);
+    if ((flags & kInCacheBit) && CountRefs(flags) == 0) {
+      (*h.deleter)(h.key, h.value);
+      if (metrics_ != nullptr) {
+        if (h.GetSubCacheType() == MULTI_TOUCH) {
+          metrics_->multi_touch_cache_usage->DecrementBy(h.charge);
+        } else {
+          metrics_->single_touch_cache_usage->DecrementBy(h.charge);
+        }
+        metrics_->cache_usage->DecrementBy(h.charge);
+      }
+    }
+  }
+}
+
+ClockSubCache* ClockCacheShard::GetSubCache(SubCacheType subcache_type) {
+  if (FLAGS_cache_single_touch_ratio == 0) {
+    return &multi_touch_sub_cache_;
+  } else if (FLAGS_cache_single_touch_ratio == 1) {
+    return &single_touch_sub_cache_;
+  }
+  return (subcache_type == SubCacheType::MULTI_TOUCH) ? &multi_touch_sub_cache_ :
+                                                        &single_touch_sub_cache_;
+}
+
+bool ClockCacheShard::TryRef(ClockHandle* h) {
+  auto flags = h->flags.load(std::memory_order_relaxed);
+  for (;;) {
+    if (!(flags & kInCacheBit)) {
+      return false;
+    }
+    if (h->flags.compare_exchange_weak(flags, flags + kOneRef, std::memory_order_acquire)) {
+      if (CountRefs(flags) == 0) {
+        pinned_usage_.fetch_add(h->charge, std::memory_order_relaxed);
+      }
+      return true;
+    }
+  }
+}
+
+bool ClockCacheShard::Unref(ClockHandle* h) {
+  // The entry could be evicted and the handle reused as soon as the reference is removed, so the
+  // charge is read in advance.
+  const auto charge = h->charge;
+  const auto flags = h->flags.fetch_sub(kOneRef, std::memory_order_acq_rel);
+  DCHECK_GE(CountRefs(flags), 1);
+  if (CountRefs(flags) != 1) {
+    return false;
+  }
+  pinned_usage_.fetch_sub(charge, std::memory_order_relaxed);
+  if (flags & kInCacheBit) {
+    return false;
+  }
+  // The entry was erased or replaced while it was referenced.
+  Free(h);
+  return true;
+}
+
+void ClockCacheShard::Free(ClockHandle* h) {
+  GetSubCache(h->GetSubCacheType())->usage.fetch_sub(h->charge, std::memory_order_relaxed);
+  {
+    ClockEntryDeleter deleted(metrics_.get());
+    deleted.Add(h);
+  }
+  MutexLock l(&mutex_);
+  ReleaseHandleLocked(h);
+}
+
+void ClockCacheShard::FreeLocked(ClockHandle* h, ClockEntryDeleter* deleted) {
+  GetSubCache(h->GetSubCacheType())->usage.fetch_sub(h->charge, std::memory_order_relaxed);
+  deleted->Add(h);
+  ReleaseHandleLocked(h);
+}
+
+namespace {
+
+bool HasGreaterIndex(const ClockHandle* lhs, const ClockHandle* rhs) {
+  return lhs->index > rhs->index;
+}
+
+} // namespace
+
+ClockHandle* ClockCacheShard::AllocateHandleLocked() {
+  if (!free_handles_.empty()) {
+    std::pop_heap(free_handles_.begin(), free_handles_.end(), HasGreaterIndex);
+    auto* result = free_handles_.back();
+    free_handles_.pop_back();
+    result->free = false;
+    return result;
+  }
+  handles_.emplace_back();
+  auto* result = &handles_.back();
+  result->index = handles_.size() - 1;
+  return result;
+}
+
+void ClockCacheShard::ReleaseHandleLocked(ClockHandle* h) {
+  h->free = true;
+  free_handles_.push_back(h);
+  std::push_heap(free_handles_.begin(), free_handles_.end(), HasGreaterIndex);
+}
+
+void ClockCacheShard::TrimHandlesLocked() {
+  if (free_handles_.size() * 2 <= handles_.size() || !handles_.back().free) {
+    return;
+  }
+  // Lookups that start after this point use the current hash table, so they could not reach free
+  // handles. Pairs with the sequentially consistent operations in FindLockFree.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (lock_free_lookups_.load(std::memory_order_seq_cst) != 0) {
+    return;
+  }
+  while (!handles_.empty() && handles_.back().free) {
+    handles_.pop_back();
+  }
+  const auto size = handles_.size();
+  free_handles_.erase(
+      std::remove_if(free_handles_.begin(), free_handles_.end(),
+                     [size](const ClockHandle* h) { return h->index >= size; }),
+      free_handles_.end());
+  std::make_heap(free_handles_.begin(), free_handles_.end(), HasGreaterIndex);
+  if (clock_hand_ >= size) {
+    clock_hand_ = 0;
+  }
+}
+
+ClockHandle* ClockCacheShard::FindLockFree(const Slice& key, uint32_t hash, bool* completed) {
+  // Handles are not deallocated while the lookup is in progress, see TrimHandlesLocked.
+  lock_free_lookups_.fetch_add(1, std::memory_order_seq_cst);
+  auto se = yb::ScopeExit([this] {
+    lock_free_lookups_.fetch_sub(1, std::memory_order_release);
+  });
+  auto* table = table_.load(std::memory_order_seq_cst);
+  auto* h = table->Bucket(hash).load(std::memory_order_seq_cst);
+  for (size_t steps = 0; h != nullptr; ++steps) {
+    if (steps == kMaxLockFreeLookupSteps) {
+      *completed = false;
+      return nullptr;
+    }
+    if (h->hash.load(std::memory_order_relaxed) == hash && TryRef(h)) {
+      // Key could not be changed while we hold a reference to the entry.
+      if (key == Slice(h->key)) {
+        *completed = true;
+        return h;
+      }
+      Unref(h);
+    }
+    h = h->next_hash.load(std::memory_order_seq_cst);
+  }
+  *completed = true;
+  return nullptr;
+}
+
+ClockHandle* ClockCacheShard::FindLocked(const Slice& key, uint32_t hash) {
+  auto* h = table_.load(std::memory_order_relaxed)->Bucket(hash).load(std::memory_order_relaxed);
+  while (h != nullptr &&
+         (h->hash.load(std::memory_order_relaxed) != hash || key != Slice(h->key))) {
+    h = h->next_hash.load(std::memory_order_relaxed);
+  }
+  return h;
+}
+
+ClockHandle* ClockCacheShard::InsertToTableLocked(ClockHandle* h) {
+  const uint32_t hash = h->hash.load(std::memory_order_relaxed);
+  std::atomic<ClockHandle*>* link = &table_.load(std::memory_order_relaxed)->Bucket(hash);
+  auto* old = link->load(std::memory_order_relaxed);
+  while (old != nullptr &&
+         (old->hash.load(std::memory_order_relaxed) != hash || old->key != h->key)) {
+    link = &old->next_hash;
+    old = link->load(std::memory_order_relaxed);
+  }
+  h->next_hash.store(
+      old != nullptr ? old->next_hash.load(std::memory_order_relaxed) : nullptr,
+      std::memory_order_relaxed);
+  link->store(h, std::memory_order_release);
+  if (old == nullptr && ++num_entries_ > table_.load(std::memory_order_relaxed)->size()) {
+    // Since each cache entry is fairly large, we aim for a small average linked list length.
+    ResizeTableLocked();
+  }
+  return old;
+}
+
+void ClockCacheShard::RemoveFromTableLocked(ClockHandle* h) {
+  // Concurrent lookups could still traverse the removed handle, so its next_hash is preserved.
+  std::atomic<ClockHandle*>* link =
+      &table_.load(std::memory_order_relaxed)->Bucket(h->hash.load(std::memory_order_relaxed));
+  for (;;) {
+    auto* current = link->load(std::memory_order_relaxed);
+    DCHECK(current != nullptr);
+    if (current == h) {
+      link->store(h->next_hash.load(std::memory_order_relaxed), std::memory_order_release);
+      --num_entries_;
+      return;
+    }
+    link = &current->next_hash;
+  }
+}
+
+void ClockCacheShard::ResizeTableLocked() {
+  auto* old_table = table_.load(std::memory_order_relaxed);
+  buckets_.emplace_back(new ClockBuckets(old_table->size() * 2));
+  auto* new_table = buckets_.back().get();
+  for (size_t i = 0; i != old_table->size(); ++i) {
+    auto* h = old_table->buckets[i].load(std::memory_order_relaxed);
+    while (h != nullptr) {
+      auto* next = h->next_hash.load(std::memory_order_relaxed);
+      auto& bucket = new_table->Bucket(h->hash.load(std::memory_order_relaxed));
+      h->next_hash.store(bucket.load(std::memory_order_relaxed), std::memory_order_release);
+      bucket.store(h, std::memory_order_relaxed);
+      h = next;
+    }
+  }
+  table_.store(new_table, std::memory_order_release);
+}
+
+void ClockCacheShard::RemoveFromCacheLocked(ClockHandle* h, ClockEntryDeleter* deleted) {
+  RemoveFromTableLocked(h);
+  const auto flags = h->flags.fetch_and(~kInCacheBit, std::memory_order_acq_rel);
+  if (CountRefs(flags) == 0) {
+    FreeLocked(h, deleted);
+  }
+}
+
+void ClockCacheShard::EvictFromClock(
+    size_t charge, ClockEntryDeleter* deleted, SubCacheType subcache_type) {
+  ClockSubCache* sub_cache = GetSubCache(subcache_type);
+  // The first pass of the clock hand could only clear usage bits, so entries are evicted during
+  // the second pass.
+  size_t steps_left = handles_.size() * 2;
+  while (sub_cache->usage.load(std::memory_order_relaxed) + charge >
+             sub_cache->capacity.load(std::memory_order_relaxed) &&
+         steps_left-- > 0) {
+    if (clock_hand_ >= handles_.size()) {
+      clock_hand_ = 0;
+    }
+    ClockHandle* h = &handles_[clock_hand_++];
+    auto flags = h->flags.load(std::memory_order_relaxed);
+    if (!(flags & kInCacheBit) || CountRefs(flags) != 0 ||
+        GetSubCache(h->GetSubCacheType()) != sub_cache) {
+      continue;
+    }
+    if (flags & kUsageBit) {
+      h->flags.compare_exchange_strong(flags, flags & ~kUsageBit, std::memory_order_relaxed);
+      continue;
+    }
+    // Fails if a reference was acquired concurrently.
+    if (h->flags.compare_exchange_strong(flags, 0, std::memory_order_acquire)) {
+      RemoveFromTableLocked(h);
+      FreeLocked(h, deleted);
+    }
+  }
+}
+
+void ClockCacheShard::SetCapacity(size_t capacity) {
+  ClockEntryDeleter deleted(metrics_.get());
+  MutexLock l(&mutex_);
+  const auto single_touch_capacity =
+      static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * capacity));
+  single_touch_sub_cache_.capacity.store(single_touch_capacity, std::memory_order_relaxed);
+  multi_touch_sub_cache_.capacity.store(
+      capacity - single_touch_capacity, std::memory_order_relaxed);
+  EvictFromClock(0, &deleted, SINGLE_TOUCH);
+  EvictFromClock(0, &deleted, MULTI_TOUCH);
+  TrimHandlesLocked();
+}
+
+Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                                       Statistics* statistics) {
+  bool completed = false;
+  ClockHandle* e = FindLockFree(key, hash, &completed);
+  if (!completed) {
+    MutexLock l(&mutex_);
+    e = FindLocked(key, hash);
+    if (e != nullptr && !TryRef(e)) {
+      e = nullptr;
+    }
+  }
+
+  if (e != nullptr) {
+    if (!(e->flags.load(std::memory_order_relaxed) & kUsageBit)) {
+      e->flags.fetch_or(kUsageBit, std::memory_order_relaxed);
+    }
+    // Moving the entry to the multi-touch sub-cache happens at most once per entry, so it could
+    // take the mutex.
+    if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
+        e->query_id.load(std::memory_order_relaxed) != query_id) {
+      PromoteToMultiTouch(e);
+    }
+    if (statistics != nullptr) {
+      // overall cache hit
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      // total bytes read from cache
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+      if (e->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      }
+    }
+  } else if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_MISS);
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (e != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCacheShard::PromoteToMultiTouch(ClockHandle* h) {
+  ClockEntryDeleter deleted(metrics_.get());
+  MutexLock l(&mutex_);
+  if (h->GetSubCacheType() == MULTI_TOUCH ||
+      !(h->flags.load(std::memory_order_relaxed) & kInCacheBit)) {
+    return;
+  }
+  // Cannot have any single touch elements in this case.
+  DCHECK_NE(FLAGS_cache_single_touch_ratio, 0);
+  EvictFromClock(h->charge, &deleted, MULTI_TOUCH);
+  if (strict_capacity_limit_ &&
+      multi_touch_sub_cache_.usage.load(std::memory_order_relaxed) + h->charge >
+          multi_touch_sub_cache_.capacity.load(std::memory_order_relaxed)) {
+    return;
+  }
+  h->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+  single_touch_sub_cache_.usage.fetch_sub(h->charge, std::memory_order_relaxed);
+  multi_touch_sub_cache_.usage.fetch_add(h->charge, std::memory_order_relaxed);
+  if (metrics_) {
+    metrics_->multi_touch_cache_usage->IncrementBy(h->charge);
+    metrics_->single_touch_cache_usage->DecrementBy(h->charge);
+  }
+}
+
+void ClockCacheShard::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  ClockHandle* e = reinterpret_cast<ClockHandle*>(handle);
+  const auto subcache_type = e->GetSubCacheType();
+  ClockSubCache* sub_cache = GetSubCache(subcache_type);
+  if (Unref(e)) {
+    return;
+  }
+  // Entries that became evictable could be evicted if the sub-cache is over capacity, that happens
+  // when an insert did not find enough entries to evict.
+  if (sub_cache->usage.load(std::memory_order_relaxed) >
+          sub_cache->capacity.load(std::memory_order_relaxed)) {
+    ClockEntryDeleter deleted(metrics_.get());
+    MutexLock l(&mutex_);
+    EvictFromClock(0, &deleted, subcache_type);
+  }
+}
+
+size_t ClockCacheShard::Evict(size_t required) {
+  ClockEntryDeleter evicted(metrics_.get());
+  {
+    MutexLock l(&mutex_);
+    EvictFromClock(required, &evicted, SINGLE_TOUCH);
+    if (required > evicted.TotalCharge()) {
+      EvictFromClock(required, &evicted, MULTI_TOUCH);
+    }
+    TrimHandlesLocked();
+  }
+  return evicted.TotalCharge();
+}
+
+Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                               void* value, size_t charge,
+                               void (*deleter)(const Slice& key, void* value),
+                               Cache::Handle** handle, Statistics* statistics) {
+  // Don't use the cache if disabled by the caller using the special query id.
+  if (query_id == kNoCacheQueryId) {
+    return Status::OK();
+  }
+  Status s;
+  ClockEntryDeleter last_reference_list(metrics_.get());
+
+  {
+    MutexLock l(&mutex_);
+    ClockHandle* e = AllocateHandleLocked();
+    e->key.assign(key.cdata(), key.size());
+    e->value = value;
+    e->deleter = deleter;
+    e->charge = charge;
+    e->hash.store(hash, std::memory_order_relaxed);
+
+    // Check if there is a single touch cache.
+    SubCacheType subcache_type;
+    if (FLAGS_cache_single_touch_ratio == 0) {
+      e->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+      subcache_type = MULTI_TOUCH;
+    } else if (FLAGS_cache_single_touch_ratio == 1) {
+      // If there is no multi touch cache, default to single cache.
+      e->query_id.store(query_id, std::memory_order_relaxed);
+      subcache_type = SINGLE_TOUCH;
+    } else {
+      // The value goes to the multi touch cache if the same key is already there, or was added by
+      // a different query.
+      ClockHandle* existing = FindLocked(key, hash);
+      if (query_id == kInMultiTouchId ||
+          (existing != nullptr && (existing->GetSubCacheType() == MULTI_TOUCH ||
+                                   existing->query_id.load(std::memory_order_relaxed) !=
+                                       query_id))) {
+        e->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+        subcache_type = MULTI_TOUCH;
+      } else {
+        e->query_id.store(query_id, std::memory_order_relaxed);
+        subcache_type = SINGLE_TOUCH;
+      }
+    }
+
+    EvictFromClock(charge, &last_reference_list, subcache_type);
+    ClockSubCache* sub_cache = GetSubCache(subcache_type);
+    // If the cache no longer has any more space in the given pool.
+    if (strict_capacity_limit_ &&
+        sub_cache->usage.load(std::memory_order_relaxed) + charge >
+            sub_cache->capacity.load(std::memory_order_relaxed)) {
+      if (handle == nullptr) {
+        last_reference_list.Add(e, /* counted_in_metrics= */ false);
+      } else {
+        e->key.clear();
+        *handle = nullptr;
+      }
+      ReleaseHandleLocked(e);
+      s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+    } else {
+      // Insert into the cache. Note that the cache might get larger than its capacity if not
+      // enough space was freed.
+      sub_cache->usage.fetch_add(charge, std::memory_order_relaxed);
+      if (handle != nullptr) {
+        pinned_usage_.fetch_add(charge, std::memory_order_relaxed);
+      }
+      // Publish the entry before it becomes visible to lock-free lookups.
+      e->flags.store(kInCacheBit | (handle != nullptr ? kOneRef : 0), std::memory_order_release);
+      ClockHandle* old = InsertToTableLocked(e);
+      if (old != nullptr) {
+        // The old entry was already replaced in the hash table, so only its in cache bit is
+        // cleared.
+        const auto flags = old->flags.fetch_and(~kInCacheBit, std::memory_order_acq_rel);
+        if (CountRefs(flags) == 0) {
+          FreeLocked(old, &last_reference_list);
+        }
+      }
+      if (handle != nullptr) {
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+    }
+    if (statistics != nullptr) {
+      if (s.ok()) {
+        RecordTick(statistics, BLOCK_CACHE_ADD);
+        RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+        if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+          RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+          RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+        } else {
+          RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+          RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+        }
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+      }
+    }
+    if (metrics_ != nullptr && s.ok()) {
+      if (subcache_type == MULTI_TOUCH) {
+        metrics_->multi_touch_cache_usage->IncrementBy(charge);
+      } else {
+        metrics_->single_touch_cache_usage->IncrementBy(charge);
+      }
+      metrics_->cache_usage->IncrementBy(charge);
+    }
+  }
+
+  return s;
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  ClockEntryDeleter deleted(metrics_.get());
+  MutexLock l(&mutex_);
+  ClockHandle* e = FindLocked(key, hash);
+  if (e != nullptr) {
+    RemoveFromCacheLocked(e, &deleted);
+  }
+  TrimHandlesLocked();
+}
+
+void ClockCacheShard::ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) {
+  if (thread_safe) {
+    mutex_.Lock();
+  }
+  for (auto& h : handles_) {
+    if (h.flags.load(std::memory_order_acquire) & kInCacheBit) {
+      callback(h.value, h.charge);
+    }
+  }
+  if (thread_safe) {
+    mutex_.Unlock();
+  }
+}
+
+static int kNumShardBits = 4;          // default values, can be overridden
+
+class ShardedClockCache : public Cache {
+ private:
+  ClockCacheShard* shards_;
+  std::atomic<uint64_t> last_id_{0};
+  port::Mutex capacity_mutex_;
+  size_t num_shard_bits_;
+  size_t capacity_;
+  bool strict_capacity_limit_;
+  shared_ptr<yb::CacheMetrics> metrics_;
+
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  bool IsValidQueryId(const QueryId query_id) {
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+  }
+
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit)
+      : num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit),
+        metrics_(nullptr) {
+    int num_shards = 1 << num_shard_bits_;
+    shards_ = new ClockCacheShard[num_shards];
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    MutexLock l(&capacity_mutex_);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
+                                       handle, statistics);
+  }
+
+  size_t Evict(size_t bytes_to_evict) override {
+    auto num_shards = 1ULL << num_shard_bits_;
+    size_t total_evicted = 0;
+    // Start at random shard.
+    auto index = Shard(yb::RandomUniformInt<uint32_t>());
+    for (size_t i = 0; bytes_to_evict > total_evicted && i != num_shards; ++i) {
+      total_evicted += shards_[index].Evict(bytes_to_evict - total_evicted);
+      index = (index + 1) & (num_shards - 1);
+    }
+    return total_evicted;
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    ClockHandle* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash.load(std::memory_order_relaxed))].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override { return capacity_; }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    return reinterpret_cast<ClockHandle*>(e)->GetSubCacheType();
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].ApplyToAllCacheEntries(callback, thread_safe);
+    }
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    int num_shards = 1 << num_shard_bits_;
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+};
+
+}  // end anonymous namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity) {
+  return NewClockCache(capacity, kNumShardBits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits) {
+  return NewClockCache(capacity, num_shard_bits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                bool strict_capacity_limit) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(capacity, num_shard_bits, strict_capacity_limit);
+}
+
+}  // namespace rocksdb
@@ -522,8 +522,8 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
   int outlen =
-      LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
-                                 static_cast<int>(length), compressBound);
+      LZ4_compress_default(input, &(*output)[output_header_len],
+                           static_cast<int>(length), compressBound);
   if (outlen == 0) {
     return false;
   }
@@ -601,16 +601,8 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
 
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  int outlen;
-#ifdef LZ4_VERSION_MAJOR  // they only started defining this since r113
-  outlen = LZ4_compressHC2_limitedOutput(input, &(*output)[output_header_len],
-                                         static_cast<int>(length),
-                                         compressBound, opts.level);
-#else
-  outlen =
-      LZ4_compressHC_limitedOutput(input, &(*output)[output_header_len],
-                                   static_cast<int>(length), compressBound);
-#endif
+  int outlen = LZ4_compress_HC(input, &(*output)[output_header_len],
+                               static_cast<int>(length), compressBound, opts.level);
   if (outlen == 0) {
     return false;
   }
@@ -188,6 +188,11 @@ std::string InboundCall::LogPrefix() const {
   return Format("$0: ", this);
 }
 
+const std::string& InboundCall::tenant() const {
+  static const std::string kDefaultTenant;
+  return kDefaultTenant;
+}
+
 bool InboundCall::RespondTimedOutIfPending(const char* message) {
   if (!TryStartProcessing()) {
     return false;
@@ -147,6 +147,10 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // If the client did not specify a deadline, returns MonoTime::Max().
   virtual CoarseTimePoint GetClientDeadline() const = 0;
 
+  // Priority and tenant specified by the client, used for QoS scheduling of the call.
+  virtual RpcPriority priority() const { return RpcPriority::NORMAL_PRIORITY; }
+  virtual const std::string& tenant() const;
+
   // Returns the time spent in the service queue -- from the time the call was received, until
   // it gets handled.
   MonoDelta GetTimeInQueue() const;
@@ -49,7 +49,8 @@ const std::shared_ptr<LocalYBInboundCall>& LocalOutboundCall::CreateLocalInbound
       timeout.Initialized() ? ToCoarse(start_) + timeout : CoarseTimePoint::max();
   auto outbound_call = std::static_pointer_cast<LocalOutboundCall>(shared_from(this));
   inbound_call_ = InboundCall::Create<LocalYBInboundCall>(
-      &rpc_metrics(), remote_method(), outbound_call, deadline);
+      &rpc_metrics(), remote_method(), outbound_call, deadline, controller()->priority(),
+      controller()->tenant());
   return inbound_call_;
 }
 
@@ -64,9 +65,11 @@ LocalYBInboundCall::LocalYBInboundCall(
     RpcMetrics* rpc_metrics,
     const RemoteMethod& remote_method,
     std::weak_ptr<LocalOutboundCall> outbound_call,
-    CoarseTimePoint deadline)
+    CoarseTimePoint deadline,
+    RpcPriority priority,
+    std::string tenant)
     : YBInboundCall(rpc_metrics, remote_method), outbound_call_(outbound_call),
-      deadline_(deadline) {
+      deadline_(deadline), priority_(priority), tenant_(std::move(tenant)) {
 }
 
 const Endpoint& LocalYBInboundCall::remote_address() const {
@@ -57,13 +57,15 @@ class LocalYBInboundCall : public YBInboundCall {
  public:
   LocalYBInboundCall(RpcMetrics* rpc_metrics, const RemoteMethod& remote_method,
                      std::weak_ptr<LocalOutboundCall> outbound_call,
-                     CoarseTimePoint deadline);
+                     CoarseTimePoint deadline, RpcPriority priority, std::string tenant);
 
   bool IsLocalCall() const override { return true; }
 
   const Endpoint& remote_address() const override;
   const Endpoint& local_address() const override;
   CoarseTimePoint GetClientDeadline() const override { return deadline_; }
+  RpcPriority priority() const override { return priority_; }
+  const std::string& tenant() const override { return tenant_; }
 
   CHECKED_STATUS ParseParam(google::protobuf::Message* message) override;
 
@@ -77,6 +79,12 @@ class LocalYBInboundCall : public YBInboundCall {
     return sidecars_.size() - 1;
   }
 
+  // Local sidecars are accessed as contiguous slices, so blocks of the buffer are merged.
+  size_t AddRpcSidecar(WriteBuffer* car) override {
+    sidecars_.push_back(car->TakeContiguous());
+    return sidecars_.size() - 1;
+  }
+
  protected:
   void Respond(const google::protobuf::MessageLite& response, bool is_success) override;
 
@@ -91,6 +99,8 @@ class LocalYBInboundCall : public YBInboundCall {
   std::weak_ptr<LocalOutboundCall> outbound_call_;
 
   const CoarseTimePoint deadline_;
+  const RpcPriority priority_;
+  const std::string tenant_;
 };
 
 } // namespace rpc
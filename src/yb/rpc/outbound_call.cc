@@ -563,6 +563,12 @@ void OutboundCall::InitHeader(RequestHeader* header) {
     if (timeout.Initialized()) {
       header->set_timeout_millis(timeout.ToMilliseconds());
     }
+    if (controller_->priority() != RpcPriority::NORMAL_PRIORITY) {
+      header->set_priority(controller_->priority());
+    }
+    if (!controller_->tenant().empty()) {
+      header->set_tenant(controller_->tenant());
+    }
   }
   header->set_allocated_remote_method(remote_method_pool_->Take());
 }
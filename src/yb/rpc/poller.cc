@@ -28,10 +28,9 @@ Poller::Poller(const std::string& log_prefix, std::function<void()> callback)
 }
 
 void Poller::Start(Scheduler* scheduler, MonoDelta interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
   scheduler_ = scheduler;
   interval_ = interval;
-
-  std::lock_guard<std::mutex> lock(mutex_);
   if (!closing_) {
     Schedule();
   }
@@ -56,6 +56,7 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/status.h"
 #include "yb/util/user.h"
+#include "yb/util/wait_state.h"
 
 DEFINE_int32(num_connections_to_server, 8,
              "Number of underlying connections to each server");
@@ -294,7 +295,10 @@ Status Proxy::SyncRequest(const RemoteMethod* method,
   DoAsyncRequest(
       method, req, DCHECK_NOTNULL(resp), controller, [&latch]() { latch.CountDown(); },
       true /* force_run_callback_on_reactor */);
-  latch.Wait();
+  {
+    ScopedWaitState wait_state(WaitStateCode::kRpcWait);
+    latch.Wait();
+  }
   return controller->status();
 }
 
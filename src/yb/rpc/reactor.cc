@@ -66,6 +66,7 @@
 #include "yb/util/threadpool.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
+#include "yb/util/wait_state.h"
 #include "yb/util/net/socket.h"
 
 using namespace std::literals;
@@ -342,6 +343,7 @@ void Reactor::CheckReadyToStop() {
 // new outbound Transfer ready to send.
 void Reactor::AsyncHandler(ev::async &watcher, int revents) {
   DCHECK(IsCurrentThread());
+  ScopedWaitActivity activity("Reactor");
 
   auto se = ScopeExit([this] {
     async_handler_tasks_.clear();
@@ -21,6 +21,7 @@
 
 #include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
+#include "yb/util/write_buffer.h"
 
 using namespace std::chrono_literals;
 
@@ -146,10 +147,18 @@ void GenericCalculatorService::DoSendStrings(InboundCall* incoming) {
 
   Random r(req.random_seed());
   SendStringsResponsePB resp;
-  for (auto size : req.sizes()) {
+  auto* call = down_cast<YBInboundCall*>(incoming);
+  for (int i = 0; i != req.sizes_size(); ++i) {
+    auto size = req.sizes(i);
     auto sidecar = RefCntBuffer(size);
     RandomString(sidecar.udata(), size, &r);
-    resp.add_sidecars(down_cast<YBInboundCall*>(incoming)->AddRpcSidecar(sidecar.as_slice()));
+    if (req.has_write_buffer_block_size() && i % 2 == 0) {
+      WriteBuffer buffer(req.write_buffer_block_size());
+      buffer.Append(sidecar.as_slice());
+      resp.add_sidecars(call->AddRpcSidecar(&buffer));
+    } else {
+      resp.add_sidecars(call->AddRpcSidecar(sidecar.as_slice()));
+    }
   }
 
   down_cast<YBInboundCall*>(incoming)->RespondSuccess(resp);
@@ -323,7 +332,7 @@ TestServer::TestServer(std::unique_ptr<ServiceIf> service,
     calculator_service->SetMessenger(messenger_.get());
   }
 
-  service_pool_.reset(new ServicePool(kQueueLength,
+  service_pool_.reset(new ServicePool(options.service_queue_length,
                                       &thread_pool_,
                                       &messenger_->scheduler(),
                                       std::move(service),
@@ -379,7 +388,8 @@ CHECKED_STATUS RpcTestBase::DoTestSyncCall(Proxy* proxy, const RemoteMethod* met
 
 void RpcTestBase::DoTestSidecar(Proxy* proxy,
                                 std::vector<size_t> sizes,
-                                Status::Code expected_code) {
+                                Status::Code expected_code,
+                                size_t write_buffer_block_size) {
   const uint32_t kSeed = 12345;
 
   SendStringsRequestPB req;
@@ -387,6 +397,9 @@ void RpcTestBase::DoTestSidecar(Proxy* proxy,
     req.add_sizes(size);
   }
   req.set_random_seed(kSeed);
+  if (write_buffer_block_size != 0) {
+    req.set_write_buffer_block_size(write_buffer_block_size);
+  }
 
   SendStringsResponsePB resp;
   RpcController controller;
@@ -139,6 +139,8 @@ extern const MessengerOptions kDefaultServerMessengerOptions;
 struct TestServerOptions {
   MessengerOptions messenger_options = kDefaultServerMessengerOptions;
   size_t n_worker_threads = 3;
+  // Max number of calls queued in the service pool.
+  size_t service_queue_length = 1000;
   Endpoint endpoint;
 };
 
@@ -194,7 +196,8 @@ class RpcTestBase : public YBTest {
 
   void DoTestSidecar(Proxy* proxy,
                      std::vector<size_t> sizes,
-                     Status::Code expected_code = Status::Code::kOk);
+                     Status::Code expected_code = Status::Code::kOk,
+                     size_t write_buffer_block_size = 0);
 
   void DoTestExpectTimeout(Proxy* proxy, const MonoDelta &timeout);
 
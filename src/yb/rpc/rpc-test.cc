@@ -64,6 +64,9 @@
 
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
+METRIC_DECLARE_histogram(rpc_incoming_queue_time_high_priority);
+METRIC_DECLARE_histogram(rpc_incoming_queue_time_low_priority);
+METRIC_DECLARE_counter(rpcs_timed_out_in_queue);
 
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
@@ -75,6 +78,9 @@ DECLARE_int64(memory_limit_hard_bytes);
 DECLARE_bool(TEST_pause_calculator_echo_request);
 DECLARE_bool(binary_call_parser_reject_on_mem_tracker_hard_limit);
 DECLARE_string(vmodule);
+DECLARE_bool(rpc_enable_qos);
+DECLARE_string(rpc_qos_tenant_weights);
+DECLARE_int64(rpc_qos_min_time_to_deadline_ms);
 
 using namespace std::chrono_literals;
 using std::string;
@@ -432,6 +438,25 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(&p, sizes);
 }
 
+TEST_F(TestRpc, TestRpcSidecarFromWriteBuffer) {
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  // Sidecars with even indexes are added from WriteBuffer, so multi-block sidecars are followed by
+  // slice sidecars, that are copied after the shrunk last block.
+  constexpr size_t kBlockSize = 1024;
+  DoTestSidecar(&p, {10000, 123, 5000, 456}, Status::Code::kOk, kBlockSize);
+  DoTestSidecar(&p, {kBlockSize / 2, 100, 3_MB, 2_MB}, Status::Code::kOk, kBlockSize);
+  DoTestSidecar(&p, {0, 10, 1, kBlockSize * 3}, Status::Code::kOk, kBlockSize);
+
+  ASSERT_OK(WaitFor([] {
+    return MemTracker::GetRootTracker()->FindChild("Call")->consumption() == 0;
+  }, 10s, "Call memory released"));
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   HostPort server_addr;
@@ -734,6 +759,308 @@ TEST_F(TestRpc, QueueTimeout) {
   ASSERT_EQ(counter->value(), kCalls - 1);
 }
 
+// Test that with QoS scheduling queued calls of higher priority are handled first.
+TEST_F(TestRpc, QosPriority) {
+  FLAGS_rpc_enable_qos = true;
+  constexpr auto kCalls = 10;
+
+  // Set up server.
+  TestServerOptions options;
+  options.n_worker_threads = 1;
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr, options);
+
+  // Set up client.
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  const auto* method = CalculatorServiceMethods::SleepMethod();
+
+  struct Call {
+    rpc_test::SleepRequestPB req;
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<Call> calls(2 * kCalls + 1);
+  std::mutex mutex;
+  std::vector<RpcPriority> completed;
+  CountDownLatch latch(calls.size());
+
+  auto send = [&](Call* call, MonoDelta sleep, RpcPriority priority) {
+    call->req.set_sleep_micros(sleep.ToMicroseconds());
+    call->controller.set_timeout(30s);
+    call->controller.set_priority(priority);
+    p.AsyncRequest(method, call->req, &call->resp, &call->controller, [&, call, priority] {
+      ASSERT_OK(call->controller.status());
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.push_back(priority);
+      }
+      latch.CountDown();
+    });
+  };
+
+  // Occupy the only worker thread, so following calls are queued.
+  send(&calls[0], 1s, RpcPriority::NORMAL_PRIORITY);
+  std::this_thread::sleep_for(200ms);
+
+  for (int i = 1; i <= kCalls; ++i) {
+    send(&calls[i], 10ms, RpcPriority::LOW_PRIORITY);
+  }
+  for (int i = kCalls + 1; i <= 2 * kCalls; ++i) {
+    send(&calls[i], 10ms, RpcPriority::HIGH_PRIORITY);
+  }
+
+  latch.Wait();
+
+  ASSERT_EQ(completed.size(), calls.size());
+  ASSERT_EQ(completed[0], RpcPriority::NORMAL_PRIORITY);
+  for (int i = 1; i <= kCalls; ++i) {
+    ASSERT_EQ(completed[i], RpcPriority::HIGH_PRIORITY) << "Call: " << i;
+    ASSERT_EQ(completed[i + kCalls], RpcPriority::LOW_PRIORITY) << "Call: " << i + kCalls;
+  }
+
+  const auto& metric_map = server_messenger()->metric_entity()->UnsafeMetricsMapForTests();
+  for (auto* prototype : {&METRIC_rpc_incoming_queue_time_high_priority,
+                          &METRIC_rpc_incoming_queue_time_low_priority}) {
+    auto histogram = down_cast<Histogram*>(FindOrDie(metric_map, prototype).get());
+    ASSERT_EQ(histogram->TotalCount(), kCalls) << prototype->name();
+  }
+}
+
+// Test that with QoS scheduling backlogged tenants share the service in proportion to their
+// weights.
+TEST_F(TestRpc, QosTenantFairShare) {
+  FLAGS_rpc_enable_qos = true;
+  FLAGS_rpc_qos_tenant_weights = "a:3,b:1";
+  constexpr auto kCallsPerTenant = 6;
+
+  TestServerOptions options;
+  options.n_worker_threads = 1;
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr, options);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  const auto* method = CalculatorServiceMethods::SleepMethod();
+
+  struct Call {
+    rpc_test::SleepRequestPB req;
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<Call> calls(2 * kCallsPerTenant + 1);
+  std::mutex mutex;
+  std::string completed;
+  CountDownLatch latch(calls.size());
+
+  auto send = [&](Call* call, MonoDelta sleep, const std::string& tenant) {
+    call->req.set_sleep_micros(sleep.ToMicroseconds());
+    call->controller.set_timeout(30s);
+    call->controller.set_tenant(tenant);
+    p.AsyncRequest(method, call->req, &call->resp, &call->controller, [&, call, tenant] {
+      ASSERT_OK(call->controller.status());
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed += tenant;
+      }
+      latch.CountDown();
+    });
+  };
+
+  // Occupy the only worker thread, so following calls are queued.
+  send(&calls[0], 1s, "x");
+  std::this_thread::sleep_for(200ms);
+
+  for (int i = 1; i <= kCallsPerTenant; ++i) {
+    send(&calls[i], 10ms, "a");
+  }
+  for (int i = kCallsPerTenant + 1; i <= 2 * kCallsPerTenant; ++i) {
+    send(&calls[i], 10ms, "b");
+  }
+
+  latch.Wait();
+
+  // Tenant a gets 3 calls handled per each call of tenant b, while both of them are backlogged.
+  ASSERT_EQ(completed, "xaaabaaabbbbb");
+}
+
+// Test that with QoS scheduling tenants share the service fairly, even when their calls come from
+// the same host. E.g. calls of different databases sent by the same tablet server.
+TEST_F(TestRpc, QosTenantsOfSameHost) {
+  FLAGS_rpc_enable_qos = true;
+  constexpr auto kCallsPerTenant = 6;
+
+  TestServerOptions options;
+  options.n_worker_threads = 1;
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr, options);
+
+  // Both tenants use the same client messenger, so their calls share the connection.
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  const auto* method = CalculatorServiceMethods::SleepMethod();
+
+  struct Call {
+    rpc_test::SleepRequestPB req;
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<Call> calls(2 * kCallsPerTenant + 1);
+  std::mutex mutex;
+  std::string completed;
+  CountDownLatch latch(calls.size());
+
+  auto send = [&](Call* call, MonoDelta sleep, const std::string& tenant) {
+    call->req.set_sleep_micros(sleep.ToMicroseconds());
+    call->controller.set_timeout(30s);
+    call->controller.set_tenant(tenant);
+    p.AsyncRequest(method, call->req, &call->resp, &call->controller, [&, call, tenant] {
+      ASSERT_OK(call->controller.status());
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed += tenant.back();
+      }
+      latch.CountDown();
+    });
+  };
+
+  // Occupy the only worker thread, so following calls are queued.
+  send(&calls[0], 1s, "db0");
+  std::this_thread::sleep_for(200ms);
+
+  for (int i = 1; i <= kCallsPerTenant; ++i) {
+    send(&calls[i], 10ms, "db1");
+  }
+  for (int i = kCallsPerTenant + 1; i <= 2 * kCallsPerTenant; ++i) {
+    send(&calls[i], 10ms, "db2");
+  }
+
+  latch.Wait();
+
+  // Tenants of equal weight alternate, although the burst of db1 was queued before any call of db2.
+  ASSERT_EQ(completed, "0121212121212");
+}
+
+// Test that with QoS scheduling a call could take the place of a queued call of lower priority,
+// when the service queue is full.
+TEST_F(TestRpc, QosDisplaceLowerPriority) {
+  FLAGS_rpc_enable_qos = true;
+  constexpr size_t kQueueLength = 3;
+
+  TestServerOptions options;
+  options.n_worker_threads = 1;
+  options.service_queue_length = kQueueLength;
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr, options);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  const auto* method = CalculatorServiceMethods::SleepMethod();
+
+  struct Call {
+    rpc_test::SleepRequestPB req;
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<Call> calls(kQueueLength + 2);
+  std::mutex mutex;
+  std::vector<size_t> completed;
+  CountDownLatch latch(calls.size());
+
+  auto send = [&](size_t idx, MonoDelta sleep, RpcPriority priority) {
+    auto* call = &calls[idx];
+    call->req.set_sleep_micros(sleep.ToMicroseconds());
+    call->controller.set_timeout(30s);
+    call->controller.set_priority(priority);
+    p.AsyncRequest(method, call->req, &call->resp, &call->controller, [&, call, idx] {
+      if (call->controller.status().ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.push_back(idx);
+      }
+      latch.CountDown();
+    });
+  };
+
+  // Occupy the only worker thread, then fill the service queue with low priority calls.
+  send(0, 1s, RpcPriority::NORMAL_PRIORITY);
+  std::this_thread::sleep_for(200ms);
+  for (size_t i = 1; i <= kQueueLength; ++i) {
+    send(i, 10ms, RpcPriority::LOW_PRIORITY);
+  }
+  std::this_thread::sleep_for(100ms);
+  send(kQueueLength + 1, 10ms, RpcPriority::HIGH_PRIORITY);
+
+  latch.Wait();
+
+  // The low priority call that would be handled last was rejected in favor of the high priority
+  // one.
+  const auto& rejected = calls[kQueueLength].controller;
+  ASSERT_NOK(rejected.status());
+  ASSERT_NE(rejected.error_response(), nullptr);
+  ASSERT_EQ(rejected.error_response()->code(), ErrorStatusPB::ERROR_SERVER_TOO_BUSY);
+  ASSERT_EQ(completed, (std::vector<size_t>{0, kQueueLength + 1, 1, 2}));
+}
+
+// Test that with QoS scheduling a call that has too little time left before its deadline is failed
+// without being handled.
+TEST_F(TestRpc, QosShedNearDeadline) {
+  FLAGS_rpc_enable_qos = true;
+  FLAGS_rpc_qos_min_time_to_deadline_ms = 500;
+
+  TestServerOptions options;
+  options.n_worker_threads = 1;
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr, options);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  const auto* method = CalculatorServiceMethods::SleepMethod();
+
+  struct Call {
+    rpc_test::SleepRequestPB req;
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<Call> calls(3);
+  CountDownLatch latch(calls.size());
+
+  auto send = [&](Call* call, MonoDelta sleep, MonoDelta timeout) {
+    call->req.set_sleep_micros(sleep.ToMicroseconds());
+    call->controller.set_timeout(timeout);
+    p.AsyncRequest(method, call->req, &call->resp, &call->controller, [&latch] {
+      latch.CountDown();
+    });
+  };
+
+  // Occupy the only worker thread, so following calls are queued.
+  send(&calls[0], 1s, 30s);
+  std::this_thread::sleep_for(200ms);
+
+  // When the worker becomes free, this call has about 200ms left, that is enough to handle it, but
+  // less than rpc_qos_min_time_to_deadline_ms.
+  send(&calls[1], 10ms, 1s);
+  send(&calls[2], 10ms, 30s);
+
+  latch.Wait();
+
+  ASSERT_OK(calls[0].controller.status());
+  const auto& shed = calls[1].controller;
+  ASSERT_NOK(shed.status());
+  ASSERT_NE(shed.error_response(), nullptr);
+  ASSERT_EQ(shed.error_response()->code(), ErrorStatusPB::ERROR_SERVER_TOO_BUSY);
+  ASSERT_OK(calls[2].controller.status());
+
+  const auto& metric_map = server_messenger()->metric_entity()->UnsafeMetricsMapForTests();
+  auto counter = down_cast<Counter*>(
+      FindOrDie(metric_map, &METRIC_rpcs_timed_out_in_queue).get());
+  ASSERT_EQ(counter->value(), 1);
+}
+
 struct DisconnectShare {
   Proxy proxy;
   size_t left;
@@ -173,6 +173,10 @@ size_t RpcContext::AddRpcSidecar(const Slice& car) {
   return call_->AddRpcSidecar(car);
 }
 
+size_t RpcContext::AddRpcSidecar(WriteBuffer* car) {
+  return call_->AddRpcSidecar(car);
+}
+
 void RpcContext::ResetRpcSidecars() {
   call_->ResetRpcSidecars();
 }
@@ -49,6 +49,7 @@ class Message;
 namespace yb {
 
 class Trace;
+class WriteBuffer;
 
 namespace util {
 
@@ -174,6 +175,11 @@ class RpcContext {
   // Returns the index of the sidecar.
   size_t AddRpcSidecar(const Slice& car);
 
+  // Adds blocks of the buffer as an RpcSidecar without copying them, the buffer is reset.
+  //
+  // Returns the index of the sidecar.
+  size_t AddRpcSidecar(WriteBuffer* car);
+
   // Removes all RpcSidecars.
   void ResetRpcSidecars();
 
@@ -70,6 +70,8 @@ void RpcController::Swap(RpcController* other) {
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
   std::swap(call_, other->call_);
   std::swap(invoke_callback_mode_, other->invoke_callback_mode_);
+  std::swap(priority_, other->priority_);
+  std::swap(tenant_, other->tenant_);
 }
 
 void RpcController::Reset() {
@@ -33,11 +33,13 @@
 #define YB_RPC_RPC_CONTROLLER_H
 
 #include <memory>
+#include <string>
 
 #include <glog/logging.h>
 
 #include "yb/gutil/macros.h"
 #include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/rpc_header.pb.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/status.h"
@@ -143,6 +145,14 @@ class RpcController {
 
   InvokeCallbackMode invoke_callback_mode() { return invoke_callback_mode_; }
 
+  // Priority and tenant of the call, used by the server for QoS scheduling.
+  // Should be set prior to making the request.
+  void set_priority(RpcPriority priority) { priority_ = priority; }
+  RpcPriority priority() const { return priority_; }
+
+  void set_tenant(std::string tenant) { tenant_ = std::move(tenant); }
+  const std::string& tenant() const { return tenant_; }
+
   // Return the configured timeout.
   MonoDelta timeout() const;
 
@@ -166,6 +176,8 @@ class RpcController {
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
   InvokeCallbackMode invoke_callback_mode_ = InvokeCallbackMode::kThreadPool;
+  RpcPriority priority_ = RpcPriority::NORMAL_PRIORITY;
+  std::string tenant_;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
@@ -43,6 +43,17 @@ METRIC_DEFINE_counter(server, rpc_outbound_calls_created,
                       yb::MetricUnit::kRequests,
                       "Number of created RPC outbound calls.");
 
+METRIC_DEFINE_counter(server, rpc_consensus_updates_sent_individually,
+                      "Number of UpdateConsensus requests sent in their own RPC.",
+                      yb::MetricUnit::kRequests,
+                      "Number of Raft UpdateConsensus requests sent in their own RPC.");
+
+METRIC_DEFINE_counter(server, rpc_consensus_updates_sent_batched,
+                      "Number of UpdateConsensus requests sent in batches.",
+                      yb::MetricUnit::kRequests,
+                      "Number of Raft UpdateConsensus requests sent inside "
+                      "MultiRaftUpdateConsensus RPCs.");
+
 namespace yb {
 namespace rpc {
 
@@ -54,6 +65,10 @@ RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
     inbound_calls_created = METRIC_rpc_inbound_calls_created.Instantiate(metric_entity);
     outbound_calls_alive = METRIC_rpc_outbound_calls_alive.Instantiate(metric_entity, 0);
     outbound_calls_created = METRIC_rpc_outbound_calls_created.Instantiate(metric_entity);
+    consensus_updates_sent_individually =
+        METRIC_rpc_consensus_updates_sent_individually.Instantiate(metric_entity);
+    consensus_updates_sent_batched =
+        METRIC_rpc_consensus_updates_sent_batched.Instantiate(metric_entity);
   }
 }
 
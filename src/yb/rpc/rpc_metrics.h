@@ -28,6 +28,10 @@ struct RpcMetrics {
   scoped_refptr<Counter> inbound_calls_created;
   scoped_refptr<AtomicGauge<int64_t>> outbound_calls_alive;
   scoped_refptr<Counter> outbound_calls_created;
+  // Raft UpdateConsensus requests sent in their own RPC, and inside MultiRaftUpdateConsensus
+  // batches.
+  scoped_refptr<Counter> consensus_updates_sent_individually;
+  scoped_refptr<Counter> consensus_updates_sent_batched;
 };
 
 } // namespace rpc
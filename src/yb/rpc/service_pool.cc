@@ -33,8 +33,11 @@
 #include "yb/rpc/service_pool.h"
 
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/asio/strand.hpp>
@@ -52,6 +55,8 @@
 #include "yb/rpc/scheduler.h"
 #include "yb/rpc/service_if.h"
 
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/lockfree.h"
@@ -60,6 +65,7 @@
 #include "yb/util/status.h"
 #include "yb/util/thread.h"
 #include "yb/util/trace.h"
+#include "yb/util/wait_state.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
@@ -80,12 +86,53 @@ DEFINE_test_flag(bool, enable_backpressure_mode_for_testing, false,
             "For testing purposes. Enables the rpc's to be considered timed out in the queue even "
             "when we have not had any backpressure in the recent past.");
 
+DEFINE_bool(rpc_enable_qos, false,
+            "Handle queued calls in order of their priority, and in weighted fair order across "
+            "tenants for calls of the same priority, instead of FIFO. When the service queue is "
+            "full, a call could take the place of a queued call of lower priority. "
+            "Applied to service pools created after the flag is changed.");
+TAG_FLAG(rpc_enable_qos, advanced);
+
+DEFINE_string(rpc_qos_tenant_weights, "",
+              "Comma separated list of tenant:weight pairs, specifying share of the service "
+              "received by tenant when QoS scheduling is enabled. Tenants that are not listed "
+              "have weight 1. Calls that do not specify tenant share the default tenant. "
+              "Example: oltp:8,batch:1");
+TAG_FLAG(rpc_qos_tenant_weights, advanced);
+
+DEFINE_int64(rpc_qos_min_time_to_deadline_ms, 0,
+             "When QoS scheduling is enabled, calls that have less than the specified amount of "
+             "time left before their deadline are failed without being handled (in ms)");
+TAG_FLAG(rpc_qos_min_time_to_deadline_ms, advanced);
+TAG_FLAG(rpc_qos_min_time_to_deadline_ms, runtime);
+
 METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
                         yb::MetricUnit::kMicroseconds,
                         "Number of microseconds incoming RPC requests spend in the worker queue",
                         60000000LU, 3);
 
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_low_priority,
+                        "RPC Queue Time Of Low Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming low priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3);
+
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_normal_priority,
+                        "RPC Queue Time Of Normal Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming normal priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3);
+
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_high_priority,
+                        "RPC Queue Time Of High Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming high priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3);
+
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
                       yb::MetricUnit::kRequests,
@@ -113,6 +160,121 @@ namespace {
 
 const CoarseDuration kTimeoutCheckGranularity = 100ms;
 const char* const kTimedOutInQueue = "Call waited in the queue past deadline";
+const char* const kShedBeforeDeadline = "Not enough time left to handle call before deadline";
+
+// Queue of calls ordered for QoS scheduling.
+//
+// Calls of higher priority go first. Calls of the same priority are ordered using weighted fair
+// queuing across tenants: each call gets virtual finish tag equal to
+// max(virtual time, finish tag of the previous call of the same tenant) + 1 / weight of tenant,
+// and calls are served in order of their finish tags. So backlogged tenants share the service in
+// proportion to their weights, and a burst of calls from one tenant does not delay calls of others.
+class QosQueue {
+ public:
+  explicit QosQueue(const std::string& tenant_weights) {
+    std::vector<std::string> entries = strings::Split(tenant_weights, ",", strings::SkipEmpty());
+    for (const auto& entry : entries) {
+      // Split at the last colon, so tenant could contain colons.
+      auto pos = entry.rfind(':');
+      double weight = 0;
+      if (pos == std::string::npos || pos == 0 || !safe_strtod(entry.substr(pos + 1), &weight) ||
+          weight <= 0) {
+        LOG(WARNING) << "Invalid tenant weight: " << entry;
+        continue;
+      }
+      weights_[entry.substr(0, pos)] = weight;
+    }
+  }
+
+  void Push(InboundCallPtr call) {
+    // Calls that are not tagged by client share the default (empty) tenant.
+    const auto& tenant = call->tenant();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& last_finish = last_finish_[tenant];
+    auto start = std::max(virtual_time_, last_finish);
+    last_finish = start + 1.0 / Weight(tenant);
+    auto priority = call->priority();
+    queue_.insert(Entry { priority, start, last_finish, ++serial_, std::move(call) });
+  }
+
+  // Removes the call that should be handled first.
+  InboundCallPtr PopFirst() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) {
+      return nullptr;
+    }
+    return DoPop(queue_.begin());
+  }
+
+  // Removes the call that should be handled last.
+  InboundCallPtr PopLast() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) {
+      return nullptr;
+    }
+    return DoPop(std::prev(queue_.end()));
+  }
+
+  // Removes the call that should be handled last, if its priority is lower than the specified one.
+  InboundCallPtr PopLastWithLowerPriority(RpcPriority priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty() || queue_.rbegin()->priority >= priority) {
+      return nullptr;
+    }
+    return DoPop(std::prev(queue_.end()));
+  }
+
+ private:
+  struct Entry {
+    RpcPriority priority;
+    double start;
+    double finish;
+    uint64_t serial;
+    // Entries of std::set are immutable, but we should be able to move the call out of the entry
+    // that is being removed.
+    mutable InboundCallPtr call;
+  };
+
+  struct EntryComparator {
+    bool operator()(const Entry& lhs, const Entry& rhs) const {
+      if (lhs.priority != rhs.priority) {
+        return lhs.priority > rhs.priority;
+      }
+      if (lhs.finish != rhs.finish) {
+        return lhs.finish < rhs.finish;
+      }
+      return lhs.serial < rhs.serial;
+    }
+  };
+
+  typedef std::set<Entry, EntryComparator> Queue;
+
+  double Weight(const std::string& tenant) const {
+    auto it = weights_.find(tenant);
+    return it != weights_.end() ? it->second : 1.0;
+  }
+
+  InboundCallPtr DoPop(Queue::iterator it) {
+    virtual_time_ = std::max(virtual_time_, it->start);
+    auto result = std::move(it->call);
+    queue_.erase(it);
+    if (queue_.empty()) {
+      // Nobody is backlogged, so start from scratch. It also keeps last_finish_ from accumulating
+      // tenants that are not active anymore.
+      last_finish_.clear();
+      virtual_time_ = 0;
+    }
+    return result;
+  }
+
+  std::unordered_map<std::string, double> weights_;
+
+  std::mutex mutex_;
+  Queue queue_;
+  std::unordered_map<std::string, double> last_finish_;
+  double virtual_time_ = 0;
+  uint64_t serial_ = 0;
+};
 
 } // namespace
 
@@ -135,6 +297,16 @@ class ServicePoolImpl final : public InboundCallHandler {
         check_timeout_strand_(scheduler->io_service()),
         log_prefix_(Format("$0: ", service_->service_name())) {
 
+          if (FLAGS_rpc_enable_qos) {
+            qos_queue_.reset(new QosQueue(FLAGS_rpc_qos_tenant_weights));
+            priority_queue_time_[RpcPriority::LOW_PRIORITY] =
+                METRIC_rpc_incoming_queue_time_low_priority.Instantiate(entity);
+            priority_queue_time_[RpcPriority::NORMAL_PRIORITY] =
+                METRIC_rpc_incoming_queue_time_normal_priority.Instantiate(entity);
+            priority_queue_time_[RpcPriority::HIGH_PRIORITY] =
+                METRIC_rpc_incoming_queue_time_high_priority.Instantiate(entity);
+          }
+
           // Create per service counter for rpcs_in_queue_.
           auto id = Format("rpcs_in_queue_$0", service_->service_name());
           EscapeMetricNameForPrometheus(&id);
@@ -182,6 +354,9 @@ class ServicePoolImpl final : public InboundCallHandler {
     TRACE_TO(call->trace(), "Inserting onto call queue");
 
     auto task = call->BindTask(this);
+    if (!task && qos_queue_ && ShedLowerPriorityCall(call)) {
+      task = call->BindTask(this);
+    }
     if (!task) {
       Overflow(call, "service", queued_calls_.load(std::memory_order_relaxed));
       return;
@@ -193,6 +368,9 @@ class ServicePoolImpl final : public InboundCallHandler {
       ScheduleCheckTimeout(call_deadline);
     }
 
+    if (qos_queue_) {
+      qos_queue_->Push(call);
+    }
     thread_pool_.Enqueue(task);
   }
 
@@ -229,8 +407,11 @@ class ServicePoolImpl final : public InboundCallHandler {
         CoarseMonoClock::Now().time_since_epoch(), std::memory_order_release);
   }
 
-  void Failure(const InboundCallPtr& call, const Status& status) override {
-    if (!call->TryStartProcessing()) {
+  void Failure(const InboundCallPtr& incoming, const Status& status) override {
+    // With QoS scheduling tasks are not bound to particular calls, so we fail the call that would
+    // be handled last.
+    auto call = qos_queue_ ? qos_queue_->PopLast() : incoming;
+    if (!call || !call->TryStartProcessing()) {
       return;
     }
 
@@ -247,7 +428,32 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
   void Handle(InboundCallPtr incoming) override {
+    if (!qos_queue_) {
+      Process(std::move(incoming));
+      return;
+    }
+
+    // Each queued call submits a task to the thread pool, but the task handles the call selected
+    // by QoS queue, that is not necessarily the one it was submitted for.
+    // Calls that could not be completed before their deadline are failed without taking a worker.
+    while (auto call = qos_queue_->PopFirst()) {
+      auto time_left = call->GetClientDeadline() - CoarseMonoClock::Now();
+      if (time_left < GetAtomicFlag(&FLAGS_rpc_qos_min_time_to_deadline_ms) * 1ms) {
+        TRACE_TO(call->trace(), kShedBeforeDeadline);
+        TimedOut(call.get(), kShedBeforeDeadline, rpcs_timed_out_in_queue_.get());
+        continue;
+      }
+      Process(std::move(call));
+      return;
+    }
+  }
+
+  void Process(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
+    if (qos_queue_) {
+      priority_queue_time_[incoming->priority()]->Increment(
+          incoming->GetTimeInQueue().ToMicroseconds());
+    }
     ADOPT_TRACE(incoming->trace());
 
     const char* error_message;
@@ -259,6 +465,7 @@ class ServicePoolImpl final : public InboundCallHandler {
       TRACE_TO(incoming->trace(), "Handling call");
 
       if (incoming->TryStartProcessing()) {
+        ScopedWaitActivity activity(incoming->method_name());
         service_->Handle(std::move(incoming));
       }
       return;
@@ -274,6 +481,19 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
  private:
+  // Frees space in the service queue for the call, by failing the queued call that would be
+  // handled last, if it has lower priority.
+  bool ShedLowerPriorityCall(const InboundCallPtr& call) {
+    auto victim = qos_queue_->PopLastWithLowerPriority(call->priority());
+    if (!victim) {
+      return false;
+    }
+    if (victim->TryStartProcessing()) {
+      Overflow(victim, "service", max_queued_calls_);
+    }
+    return true;
+  }
+
   void TimedOut(InboundCall* call, const char* error_message, Counter* metric) {
     if (call->RespondTimedOutIfPending(error_message)) {
       metric->Increment();
@@ -404,6 +624,7 @@ class ServicePoolImpl final : public InboundCallHandler {
   Scheduler& scheduler_;
   ServiceIfPtr service_;
   scoped_refptr<Histogram> incoming_queue_time_;
+  scoped_refptr<Histogram> priority_queue_time_[RpcPriority_ARRAYSIZE];
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_timed_out_early_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
@@ -448,6 +669,9 @@ class ServicePoolImpl final : public InboundCallHandler {
 
   std::priority_queue<QueuedCheckDeadline> check_timeout_queue_;
 
+  // Orders queued calls when QoS scheduling is enabled, null otherwise.
+  std::unique_ptr<QosQueue> qos_queue_;
+
   std::atomic<bool> closing_ = {false};
   CountDownLatch shutdown_complete_latch_{1};
   std::string log_prefix_;
@@ -478,7 +702,7 @@ void ServicePool::QueueInboundCall(InboundCallPtr call) {
 }
 
 void ServicePool::Handle(InboundCallPtr call) {
-  impl_->Handle(std::move(call));
+  impl_->Process(std::move(call));
 }
 
 const Counter* ServicePool::RpcsTimedOutInQueueMetricForTests() const {
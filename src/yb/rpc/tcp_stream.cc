@@ -21,6 +21,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/memory/memory_usage.h"
 #include "yb/util/string_util.h"
+#include "yb/util/wait_state.h"
 
 using namespace std::literals;
 
@@ -250,6 +251,7 @@ void TcpStream::PopSending() {
 
 void TcpStream::Handler(ev::io& watcher, int revents) {  // NOLINT
   DVLOG_WITH_PREFIX(4) << "Handler(revents=" << revents << ")";
+  ScopedWaitActivity activity("Reactor");
   Status status = Status::OK();
   if (revents & ev::ERROR) {
     status = STATUS(NetworkError, ToString() + ": Handler encountered an error");
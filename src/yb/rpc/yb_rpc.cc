@@ -325,12 +325,32 @@ size_t YBInboundCall::AddRpcSidecar(Slice car) {
   return num_sidecars_++;
 }
 
+size_t YBInboundCall::AddRpcSidecar(WriteBuffer* car) {
+  sidecar_offsets_.Add(total_sidecars_size_);
+  total_sidecars_size_ += car->size();
+
+  // Sidecars are sent back to back, so the unused tail of the last buffer is cut off before the
+  // blocks of car are appended after it. Shrink does not free memory, so consumption is unchanged.
+  if (!sidecar_buffers_.empty()) {
+    sidecar_buffers_.back().Shrink(filled_bytes_in_last_sidecar_buffer_);
+  }
+  const auto capacity = car->capacity();
+  car->TakeBlocks(&sidecar_buffers_);
+  sidecar_buffers_capacity_ += capacity;
+  if (consumption_) {
+    consumption_.Add(capacity);
+  }
+  filled_bytes_in_last_sidecar_buffer_ =
+      sidecar_buffers_.empty() ? 0 : sidecar_buffers_.back().size();
+
+  return num_sidecars_++;
+}
+
 void YBInboundCall::ResetRpcSidecars() {
   if (consumption_) {
-    for (const auto& buffer : sidecar_buffers_) {
-      consumption_.Add(-buffer.size());
-    }
+    consumption_.Add(-static_cast<int64_t>(sidecar_buffers_capacity_));
   }
+  sidecar_buffers_capacity_ = 0;
   num_sidecars_ = 0;
   filled_bytes_in_last_sidecar_buffer_ = 0;
   total_sidecars_size_ = 0;
@@ -349,6 +369,7 @@ void YBInboundCall::ReserveSidecarSpace(size_t space) {
 
 void YBInboundCall::AllocateSidecarBuffer(size_t size) {
   sidecar_buffers_.push_back(RefCntBuffer(size));
+  sidecar_buffers_capacity_ += size;
   if (consumption_) {
     consumption_.Add(size);
   }
@@ -22,6 +22,7 @@
 #include "yb/rpc/rpc_with_call_id.h"
 
 #include "yb/util/ev_util.h"
+#include "yb/util/write_buffer.h"
 
 namespace yb {
 namespace rpc {
@@ -125,6 +126,8 @@ class YBInboundCall : public InboundCall {
   // See RpcContext::AddRpcSidecar()
   virtual size_t AddRpcSidecar(Slice car);
 
+  virtual size_t AddRpcSidecar(WriteBuffer* car);
+
   // See RpcContext::ResetRpcSidecars()
   void ResetRpcSidecars();
 
@@ -166,6 +169,14 @@ class YBInboundCall : public InboundCall {
 
   CoarseTimePoint GetClientDeadline() const override;
 
+  RpcPriority priority() const override {
+    return header_.priority();
+  }
+
+  const std::string& tenant() const override {
+    return header_.tenant();
+  }
+
   const std::string& method_name() const override {
     return remote_method_.method_name();
   }
@@ -190,6 +201,9 @@ class YBInboundCall : public InboundCall {
   size_t num_sidecars_ = 0;
   size_t filled_bytes_in_last_sidecar_buffer_ = 0;
   size_t total_sidecars_size_ = 0;
+  // Allocated size of sidecar_buffers_, that is tracked by consumption_. Could exceed the size of
+  // buffers, since blocks taken from WriteBuffer are shrunk without releasing memory.
+  size_t sidecar_buffers_capacity_ = 0;
   boost::container::small_vector<RefCntBuffer, kMinBufferForSidecarSlices> sidecar_buffers_;
   google::protobuf::RepeatedField<uint32_t> sidecar_offsets_;
 
@@ -60,8 +60,11 @@
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/gutil/walltime.h"
 #include "yb/server/pprof-path-handlers.h"
 #include "yb/server/webserver.h"
 #include "yb/util/flag_tags.h"
@@ -71,8 +74,10 @@
 #include "yb/util/memory/memory.h"
 #include "yb/util/metrics.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/url-coding.h"
 #include "yb/util/version_info.h"
 #include "yb/util/version_info.pb.h"
+#include "yb/util/wait_state.h"
 
 DEFINE_int64(web_log_bytes, 1024 * 1024,
     "The maximum number of bytes to display on the debug webserver's log page");
@@ -208,6 +213,50 @@ static void MemTrackersHandler(const Webserver::WebRequest& req, std::stringstre
   *output << "</table>\n";
 }
 
+// Registered to handle "/wait-states", and prints out sampled wait states of server threads.
+// Arguments:
+//   window_sec - show samples taken during the last window_sec seconds, 60 by default.
+//   group_by - "activity" (default) or "tablet" to show aggregated samples, "none" to list them.
+static void WaitStatesHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  int64_t window_sec = 60;
+  const string* window_arg = FindOrNull(req.parsed_args, "window_sec");
+  if (window_arg) {
+    window_sec = ParseLeadingInt64Value(window_arg->c_str(), window_sec);
+  }
+  const string* group_by_arg = FindOrNull(req.parsed_args, "group_by");
+  const string group_by = group_by_arg ? *group_by_arg : "activity";
+
+  auto samples = WaitStateSampler::GetInstance()->Samples(
+      GetCurrentTimeMicros() - window_sec * 1000000);
+
+  *output << Format("<h1>Wait states sampled during the last $0 seconds</h1>\n", window_sec);
+  *output << "<table class='table table-striped'>\n";
+  if (group_by == "none") {
+    *output << "  <tr><th>Time</th><th>Thread</th><th>State</th><th>Activity</th>"
+               "<th>Tablet</th></tr>\n";
+    for (const auto& sample : samples) {
+      string time;
+      StringAppendStrftime(&time, "%Y-%m-%d %H:%M:%S", sample.time_us / 1000000, true);
+      StringAppendF(&time, ".%03d", static_cast<int>(sample.time_us % 1000000 / 1000));
+      *output << Format("  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+                        time,
+                        EscapeForHtmlToString(sample.thread_name), sample.code,
+                        EscapeForHtmlToString(sample.activity), sample.tablet_id);
+    }
+  } else {
+    const bool by_tablet = group_by == "tablet";
+    *output << Format("  <tr><th>$0</th><th>State</th><th>Samples</th></tr>\n",
+                      by_tablet ? "Tablet" : "Activity");
+    auto aggregates = AggregateWaitStates(
+        samples, by_tablet ? WaitStateGroupBy::kTablet : WaitStateGroupBy::kActivity);
+    for (const auto& aggregate : aggregates) {
+      *output << Format("  <tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+                        EscapeForHtmlToString(aggregate.key), aggregate.code, aggregate.count);
+    }
+  }
+  *output << "</table>\n";
+}
+
 static void WriteMetricsAsJson(const MetricRegistry* const metrics,
                                const Webserver::WebRequest& req, std::stringstream* output) {
   const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
@@ -288,6 +337,7 @@ void AddDefaultPathHandlers(Webserver* webserver) {
                                  MemTrackersHandler, true, false);
   webserver->RegisterPathHandler("/api/v1/version-info", "Build Version Info",
                                  HandleGetVersionInfo, false, false);
+  webserver->RegisterPathHandler("/wait-states", "Wait States", WaitStatesHandler, true, false);
 
   AddPprofPathHandlers(webserver);
 }
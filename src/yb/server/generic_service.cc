@@ -43,6 +43,7 @@
 #include "yb/server/hybrid_clock.h"
 #include "yb/server/server_base.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/wait_state.h"
 
 using std::string;
 using std::unordered_set;
@@ -164,5 +165,36 @@ void GenericServiceImpl::Ping(
   rpc.RespondSuccess();
 }
 
+void GenericServiceImpl::GetWaitStates(const GetWaitStatesRequestPB* req,
+                                       GetWaitStatesResponsePB* resp,
+                                       rpc::RpcContext rpc) {
+  MicrosecondsInt64 since_us = 0;
+  if (req->has_window_ms()) {
+    since_us = GetCurrentTimeMicros() - req->window_ms() * 1000;
+  }
+  auto samples = WaitStateSampler::GetInstance()->Samples(since_us);
+
+  if (req->group_by() == GetWaitStatesRequestPB::NONE) {
+    for (const auto& sample : samples) {
+      auto* sample_pb = resp->add_samples();
+      sample_pb->set_time_us(sample.time_us);
+      sample_pb->set_thread_name(sample.thread_name);
+      sample_pb->set_code(ToString(sample.code));
+      sample_pb->set_activity(sample.activity);
+      sample_pb->set_tablet_id(sample.tablet_id);
+    }
+  } else {
+    auto group_by = req->group_by() == GetWaitStatesRequestPB::TABLET
+        ? WaitStateGroupBy::kTablet : WaitStateGroupBy::kActivity;
+    for (const auto& aggregate : AggregateWaitStates(samples, group_by)) {
+      auto* aggregate_pb = resp->add_aggregates();
+      aggregate_pb->set_key(aggregate.key);
+      aggregate_pb->set_code(ToString(aggregate.code));
+      aggregate_pb->set_count(aggregate.count);
+    }
+  }
+  rpc.RespondSuccess();
+}
+
 } // namespace server
 } // namespace yb
@@ -67,6 +67,10 @@ class GenericServiceImpl : public GenericServiceIf {
 
   void Ping(const PingRequestPB* req, PingResponsePB* resp, rpc::RpcContext rpc) override;
 
+  void GetWaitStates(const GetWaitStatesRequestPB* req,
+                     GetWaitStatesResponsePB* resp,
+                     rpc::RpcContext rpc) override;
+
  private:
   RpcServerBase* server_;
 
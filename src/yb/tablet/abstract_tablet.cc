@@ -11,11 +11,14 @@
 // under the License.
 //
 
+#include <boost/optional.hpp>
+
 #include "yb/common/ql_resultset.h"
 
 #include "yb/common/ql_value.h"
 
 #include "yb/docdb/cql_operation.h"
+#include "yb/docdb/docdb_statistics.h"
 #include "yb/docdb/pgsql_operation.h"
 
 #include "yb/tablet/abstract_tablet.h"
@@ -49,6 +52,10 @@ Status AbstractTablet::HandleQLReadRequest(CoarseTimePoint deadline,
 
   const QLRSRowDesc rsrow_desc(ql_read_request.rsrow_desc());
   QLResultSet resultset(&rsrow_desc, &result->rows_data);
+  boost::optional<docdb::DocDBStatistics> statistics;
+  if (ql_read_request.collect_docdb_stats()) {
+    statistics.emplace();
+  }
   TRACE("Start Execute");
   const Status s = doc_op.Execute(
       QLStorage(), deadline, read_time, schema, projection, &resultset, &result->restart_read_ht);
@@ -67,6 +74,9 @@ Status AbstractTablet::HandleQLReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(CreatePagingStateForRead(
       ql_read_request, resultset.rsrow_count(), &result->response));
 
+  if (statistics) {
+    FillDocDBStats(*statistics, result->response.mutable_docdb_stats());
+  }
   result->response.set_status(QLResponsePB::YQL_STATUS_OK);
   return Status::OK();
 }
@@ -85,6 +95,10 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
                                ? &SchemaRef(pgsql_read_request.index_request().table_id())
                                : nullptr;
 
+  boost::optional<docdb::DocDBStatistics> statistics;
+  if (pgsql_read_request.collect_docdb_stats()) {
+    statistics.emplace();
+  }
   TRACE("Start Execute");
   auto fetched_rows = doc_op.Execute(QLStorage(), deadline, read_time, schema, index_schema,
                                      &result->rows_data, &result->restart_read_ht);
@@ -100,6 +114,10 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(CreatePagingStateForRead(
       pgsql_read_request, *fetched_rows, &result->response));
 
+  if (statistics) {
+    FillDocDBStats(*statistics, result->response.mutable_docdb_stats());
+  }
+
   // TODO(neil) The clients' request should indicate what encoding method should be used. When
   // multi-shard is used to process more complicated queries, proxy-server might prefer a different
   // encoding. For now, we'll call PgsqlSerialize() without checking encoding method.
@@ -112,5 +130,11 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
   return Status::OK();
 }
 
+void AbstractTablet::FillDocDBStats(
+    const docdb::DocDBStatistics& statistics, DocDBStatsPB* stats) const {
+  statistics.CopyToPB(stats);
+  stats->set_tablet_id(tablet_id());
+}
+
 }  // namespace tablet
 }  // namespace yb
@@ -20,8 +20,12 @@
 #include "yb/common/redis_protocol.pb.h"
 #include "yb/common/schema.h"
 
+#include "yb/docdb/docdb_fwd.h"
+
 #include "yb/tablet/tablet_fwd.h"
 
+#include "yb/util/write_buffer.h"
+
 namespace yb {
 namespace tablet {
 
@@ -33,7 +37,9 @@ struct QLReadRequestResult {
 
 struct PgsqlReadRequestResult {
   PgsqlResponsePB response;
-  faststring rows_data;
+  // Rows are written directly to RefCntBuffer blocks, that are sent as an RPC sidecar without
+  // being copied.
+  WriteBuffer rows_data;
   HybridTime restart_read_ht;
 };
 
@@ -131,6 +137,8 @@ class AbstractTablet {
  private:
   virtual HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, CoarseTimePoint deadline) const = 0;
+
+  void FillDocDBStats(const docdb::DocDBStatistics& statistics, DocDBStatsPB* stats) const;
 };
 
 }  // namespace tablet
@@ -46,6 +46,7 @@
 #include "yb/docdb/intent.h"
 #include "yb/docdb/lock_batch.h"
 #include "yb/docdb/shared_lock_manager_fwd.h"
+#include "yb/docdb/wait_queue.h"
 
 #include "yb/gutil/macros.h"
 
@@ -262,6 +263,40 @@ class WriteOperation : public Operation {
     return doc_ops_;
   }
 
+  // Set when the operation should wait for conflicting transactions before being restarted,
+  // see Tablet::StartDocWriteOperation.
+  const docdb::WaitQueue::WaiterPtr& waiter() const {
+    return waiter_;
+  }
+
+  void SetWaiter(docdb::WaitQueue::WaiterPtr waiter) {
+    waiter_ = std::move(waiter);
+  }
+
+  docdb::WaitQueue::WaiterPtr ReleaseWaiter() {
+    return std::move(waiter_);
+  }
+
+  // Time until which the operation could wait for conflicting transactions, set when it starts
+  // waiting for the first time.
+  CoarseTimePoint wait_deadline() const {
+    return wait_deadline_;
+  }
+
+  void SetWaitDeadline(CoarseTimePoint value) {
+    wait_deadline_ = value;
+  }
+
+  // Whether the operation waited for conflicting transactions until wait deadline. Then it should
+  // fail with conflict if they are still running.
+  bool wait_expired() const {
+    return wait_expired_;
+  }
+
+  void SetWaitExpired() {
+    wait_expired_ = true;
+  }
+
   static void StartSynchronization(
       std::unique_ptr<WriteOperation> operation, const Status& status) {
     // We release here, because DoStartSynchronization takes ownership on this.
@@ -319,6 +354,10 @@ class WriteOperation : public Operation {
 
   docdb::DocOperations doc_ops_;
 
+  docdb::WaitQueue::WaiterPtr waiter_;
+  CoarseTimePoint wait_deadline_;
+  bool wait_expired_ = false;
+
   Tablet* tablet() { return state()->tablet(); }
 
   DISALLOW_COPY_AND_ASSIGN(WriteOperation);
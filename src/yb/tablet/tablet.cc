@@ -79,6 +79,7 @@
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/cql_operation.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
@@ -90,6 +91,7 @@
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/redis_operation.h"
+#include "yb/docdb/value.h"
 
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/map-util.h"
@@ -98,6 +100,9 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
+
+#include "yb/rpc/thread_pool.h"
+
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/tablet/tablet_fwd.h"
@@ -190,6 +195,18 @@ TAG_FLAG(backfill_index_timeout_grace_margin_ms, runtime);
 DEFINE_bool(cleanup_intents_sst_files, true,
             "Cleanup intents files that are no more relevant to any running transaction.");
 
+DEFINE_bool(enable_wait_queues, false,
+            "Instead of failing a transaction that conflicts with transactions of higher priority, "
+            "wait until they are committed or aborted.");
+TAG_FLAG(enable_wait_queues, advanced);
+TAG_FLAG(enable_wait_queues, runtime);
+
+DEFINE_int32(wait_queue_max_wait_ms, 1000,
+             "Maximal time that a transaction waits for conflicting transactions to finish, "
+             "before it fails with conflict.");
+TAG_FLAG(wait_queue_max_wait_ms, advanced);
+TAG_FLAG(wait_queue_max_wait_ms, runtime);
+
 DEFINE_test_flag(int32, TEST_slowdown_backfill_by_ms, 0,
                  "If set > 0, slows down the backfill process by this amount.");
 
@@ -206,6 +223,7 @@ DEFINE_test_flag(
     bool, docdb_log_write_batches, false,
     "Dump write batches being written to RocksDB");
 
+DECLARE_bool(docdb_drop_expired_sst_files);
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
 
@@ -589,6 +607,12 @@ Status Tablet::OpenKeyValueTablet() {
 
   rocksdb::Options rocksdb_options;
   InitRocksDBOptions(&rocksdb_options, LogPrefix(docdb::StorageDbType::kRegular));
+  docdb::SetTableCompressionOptions(
+      metadata()->schema().table_properties(), LogPrefix(docdb::StorageDbType::kRegular),
+      &rocksdb_options);
+  if (!metadata()->colocated()) {
+    docdb::SetTableBloomFilterOptions(metadata()->schema(), &rocksdb_options);
+  }
   rocksdb_options.mem_tracker = MemTracker::FindOrCreateTracker(kRegularDB, mem_tracker_);
   rocksdb_options.block_based_table_mem_tracker =
       MemTracker::FindOrCreateTracker(
@@ -605,7 +629,8 @@ Status Tablet::OpenKeyValueTablet() {
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      retention_policy_, &key_bounds_);
+      retention_policy_, &key_bounds_,
+      docdb::MergePackedRowValues(table_type_ == TableType::PGSQL_TABLE_TYPE));
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
     if (mem_table_flush_filter_factory_) {
@@ -683,14 +708,57 @@ Status Tablet::OpenKeyValueTablet() {
 }
 
 void Tablet::RegularDbFilesChanged() {
-  std::lock_guard<std::mutex> lock(num_sst_files_changed_listener_mutex_);
-  if (num_sst_files_changed_listener_) {
-    num_sst_files_changed_listener_();
+  {
+    std::lock_guard<std::mutex> lock(num_sst_files_changed_listener_mutex_);
+    if (num_sst_files_changed_listener_) {
+      num_sst_files_changed_listener_();
+    }
   }
+  UpdateSplitHashCode();
 }
 
 void Tablet::SetCleanupPool(ThreadPool* thread_pool) {
   cleanup_intent_files_token_ = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  update_split_hash_code_token_ = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  UpdateSplitHashCode();
+}
+
+void Tablet::UpdateSplitHashCode() {
+  ScopedRWOperation scoped_read_operation(&pending_op_counter_);
+  if (!scoped_read_operation.ok() || state_ != State::kOpen || !update_split_hash_code_token_) {
+    return;
+  }
+
+  // Reading index of the largest SST file is not free, so it is done at most once per file set
+  // change, outside of the heartbeat and of the flush/compaction threads.
+  if (split_hash_code_update_pending_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  auto status = update_split_hash_code_token_->SubmitFunc(
+      std::bind(&Tablet::DoUpdateSplitHashCode, this));
+  if (!status.ok()) {
+    split_hash_code_update_pending_.store(false, std::memory_order_release);
+    LOG_WITH_PREFIX(WARNING) << "Submit split hash code update failed: " << status;
+  }
+}
+
+void Tablet::DoUpdateSplitHashCode() {
+  split_hash_code_update_pending_.store(false, std::memory_order_release);
+  auto split_hash_code = GetMiddleSplitHashCode();
+  if (split_hash_code.ok()) {
+    split_hash_code_.store(*split_hash_code, std::memory_order_release);
+  } else {
+    VLOG_WITH_PREFIX(4) << "Failed to get split hash code: " << split_hash_code.status();
+    split_hash_code_.store(kNoSplitHashCode, std::memory_order_release);
+  }
+}
+
+boost::optional<docdb::DocKeyHash> Tablet::split_hash_code() const {
+  auto result = split_hash_code_.load(std::memory_order_acquire);
+  if (result == kNoSplitHashCode) {
+    return boost::none;
+  }
+  return static_cast<docdb::DocKeyHash>(result);
 }
 
 void Tablet::CleanupIntentFiles() {
@@ -846,6 +914,7 @@ void Tablet::CompleteShutdown(IsDropTable is_drop_table) {
   }
 
   cleanup_intent_files_token_.reset();
+  update_split_hash_code_token_.reset();
 
   if (transaction_coordinator_) {
     transaction_coordinator_->Shutdown();
@@ -932,6 +1001,7 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
   auto result = std::make_unique<DocRowwiseIterator>(
       std::move(mapped_projection), schema, txn_op_ctx, doc_db(),
       CoarseTimePoint::max() /* deadline */, read_time, &pending_op_counter_);
+  result->set_schema_version(table_info->schema_version);
   RETURN_NOT_OK(result->Init());
   return std::move(result);
 }
@@ -1064,6 +1134,25 @@ void Tablet::WriteToRocksDB(
     case StorageDbType::kIntents: dest_db = intents_db_.get(); break;
   }
 
+  // Remember maximal expiration time of records with value level TTL, so whole SST files could be
+  // dropped by compaction when all their records are expired. YSQL records don't have TTL.
+  docdb::ConsensusFrontiers regular_frontiers;
+  if (storage_db_type == StorageDbType::kRegular && frontiers &&
+      table_type_ != TableType::PGSQL_TABLE_TYPE) {
+    regular_frontiers = down_cast<const docdb::ConsensusFrontiers&>(*frontiers);
+    auto& largest = regular_frontiers.Largest();
+    // Files are dropped only for YCQL tables with default TTL, so the write batch is scanned only
+    // for them. Otherwise value level TTL is unknown, and such file is never dropped as a whole.
+    const bool scan_value_level_ttl =
+        FLAGS_docdb_drop_expired_sst_files && table_type_ == TableType::YQL_TABLE_TYPE &&
+        !docdb::TableTTL(metadata_->schema()).Equals(docdb::Value::kMaxTtl);
+    largest.set_max_value_level_ttl_expiration_time(
+        scan_value_level_ttl
+            ? docdb::MaxValueLevelTtlExpirationTime(*write_batch, largest.hybrid_time())
+            : HybridTime::kMax);
+    frontiers = &regular_frontiers;
+  }
+
   write_batch->SetFrontiers(frontiers);
 
   // We are using Raft replication index for the RocksDB sequence number for
@@ -1130,17 +1219,7 @@ Status Tablet::KeyValueBatchFromRedisWriteBatch(WriteOperation* operation) {
   for (size_t i = 0; i < redis_write_batch->size(); i++) {
     doc_ops.emplace_back(new RedisWriteOperation(redis_write_batch->Mutable(i)));
   }
-  RETURN_NOT_OK(StartDocWriteOperation(operation));
-  if (operation->restart_read_ht().is_valid()) {
-    return Status::OK();
-  }
-  auto* response = operation->response();
-  for (size_t i = 0; i < doc_ops.size(); i++) {
-    auto* redis_write_operation = down_cast<RedisWriteOperation*>(doc_ops[i].get());
-    response->add_redis_response_batch()->Swap(&redis_write_operation->response());
-  }
-
-  return Status::OK();
+  return StartDocWriteOperation(operation);
 }
 
 Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
@@ -1152,6 +1231,7 @@ Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  metrics_->read_requests->Increment();
 
   docdb::RedisReadOperation doc_op(redis_read_request, doc_db(), deadline, read_time);
   RETURN_NOT_OK(doc_op.Execute());
@@ -1170,6 +1250,7 @@ Status Tablet::HandleQLReadRequest(
   ScopedRWOperation scoped_read_operation(&pending_op_counter_, deadline);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  metrics_->read_requests->Increment();
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     DVLOG(1) << "Setting status for read as YQL_STATUS_SCHEMA_VERSION_MISMATCH";
@@ -1283,17 +1364,7 @@ void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> opera
 
   auto status = StartDocWriteOperation(operation.get());
   scoped_read_operation.Reset();
-
-  if (operation->restart_read_ht().is_valid()) {
-    WriteOperation::StartSynchronization(std::move(operation), Status::OK());
-    return;
-  }
-
-  if (status.ok()) {
-    UpdateQLIndexes(std::move(operation));
-  } else {
-    CompleteQLWriteBatch(std::move(operation), status);
-  }
+  DocWriteOperationStarted(std::move(operation), status);
 }
 
 void Tablet::CompleteQLWriteBatch(std::unique_ptr<WriteOperation> operation, const Status& status) {
@@ -1468,6 +1539,7 @@ Status Tablet::HandlePgsqlReadRequest(
   RETURN_NOT_OK(scoped_read_operation);
   // TODO(neil) Work on metrics for PGSQL.
   // ScopedTabletMetricsTracker metrics_tracker(metrics_->pgsql_read_latency);
+  metrics_->read_requests->Increment();
 
   const tablet::TableInfo* table_info =
       VERIFY_RESULT(metadata_->GetTableInfo(pgsql_read_request.table_id()));
@@ -1569,19 +1641,7 @@ Status Tablet::KeyValueBatchFromPgsqlWriteBatch(WriteOperation* operation) {
     return Status::OK();
   }
 
-  RETURN_NOT_OK(StartDocWriteOperation(operation));
-  if (operation->restart_read_ht().is_valid()) {
-    return Status::OK();
-  }
-  for (size_t i = 0; i < doc_ops.size(); i++) {
-    PgsqlWriteOperation* pgsql_write_op = down_cast<PgsqlWriteOperation*>(doc_ops[i].get());
-    // We'll need to return the number of rows inserted, updated, or deleted by each operation.
-    doc_ops[i].release();
-    operation->state()->pgsql_write_ops()
-                      ->emplace_back(unique_ptr<PgsqlWriteOperation>(pgsql_write_op));
-  }
-
-  return Status::OK();
+  return StartDocWriteOperation(operation);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1593,11 +1653,13 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
     return;
   }
 
+  metrics_->write_requests->Increment();
+
   const WriteRequestPB* key_value_write_request = operation->state()->request();
 
   if (!key_value_write_request->redis_write_batch().empty()) {
     auto status = KeyValueBatchFromRedisWriteBatch(operation.get());
-    WriteOperation::StartSynchronization(std::move(operation), status);
+    DocWriteOperationStarted(std::move(operation), status);
     return;
   }
 
@@ -1608,7 +1670,7 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
 
   if (!key_value_write_request->pgsql_write_batch().empty()) {
     auto status = KeyValueBatchFromPgsqlWriteBatch(operation.get());
-    WriteOperation::StartSynchronization(std::move(operation), status);
+    DocWriteOperationStarted(std::move(operation), status);
     return;
   }
 
@@ -1625,7 +1687,7 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
     } else {
       DCHECK(key_value_write_request->has_external_hybrid_time());
     }
-    WriteOperation::StartSynchronization(std::move(operation), status);
+    DocWriteOperationStarted(std::move(operation), status);
     return;
   }
 
@@ -1636,6 +1698,105 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
   operation->state()->CompleteWithStatus(Status::OK());
 }
 
+void Tablet::DocWriteOperationStarted(
+    std::unique_ptr<WriteOperation> operation, const Status& status) {
+  if (status.ok() && operation->waiter()) {
+    WaitForConflictingTransactions(std::move(operation));
+    return;
+  }
+
+  auto& doc_ops = operation->doc_ops();
+  if (!status.ok() || operation->restart_read_ht().is_valid() || doc_ops.empty()) {
+    WriteOperation::StartSynchronization(std::move(operation), status);
+    return;
+  }
+
+  switch (doc_ops.front()->OpType()) {
+    case docdb::DocOperationType::REDIS_WRITE_OPERATION: {
+      auto* response = operation->response();
+      for (size_t i = 0; i < doc_ops.size(); i++) {
+        auto* redis_write_operation = down_cast<RedisWriteOperation*>(doc_ops[i].get());
+        response->add_redis_response_batch()->Swap(&redis_write_operation->response());
+      }
+      break;
+    }
+    case docdb::DocOperationType::QL_WRITE_OPERATION:
+      UpdateQLIndexes(std::move(operation));
+      return;
+    case docdb::DocOperationType::PGSQL_WRITE_OPERATION:
+      for (size_t i = 0; i < doc_ops.size(); i++) {
+        PgsqlWriteOperation* pgsql_write_op = down_cast<PgsqlWriteOperation*>(doc_ops[i].get());
+        // We'll need to return the number of rows inserted, updated, or deleted by each operation.
+        doc_ops[i].release();
+        operation->state()->pgsql_write_ops()
+                          ->emplace_back(unique_ptr<PgsqlWriteOperation>(pgsql_write_op));
+      }
+      break;
+    case docdb::DocOperationType::PGSQL_READ_OPERATION:
+      LOG_WITH_PREFIX(DFATAL) << "Unexpected read operation in write: " << operation->ToString();
+      break;
+  }
+
+  WriteOperation::StartSynchronization(std::move(operation), Status::OK());
+}
+
+// Resumes write operation that waited for conflicting transactions to finish.
+class Tablet::ResumeWriteOperationTask : public rpc::ThreadPoolTask {
+ public:
+  ResumeWriteOperationTask(Tablet* tablet, std::unique_ptr<WriteOperation> operation)
+      : tablet_(tablet), operation_(std::move(operation)) {}
+
+  // Invoked when the wait completes, while the tablet is alive. The tablet does not complete
+  // shutdown until the resumed operation is done, since the task holds a read/write operation.
+  void Prepare(bool woken) {
+    scoped_operation_.emplace(&tablet_->pending_op_counter_);
+    if (!woken) {
+      // Last attempt, fails with conflict if blockers are still running.
+      operation_->SetWaitExpired();
+    }
+  }
+
+  void Run() override {
+    if (!scoped_operation_->ok()) {
+      operation_->state()->CompleteWithStatus(MoveStatus(*scoped_operation_));
+      return;
+    }
+    auto status = tablet_->StartDocWriteOperation(operation_.get());
+    tablet_->DocWriteOperationStarted(std::move(operation_), status);
+  }
+
+  void Done(const Status& status) override {
+    if (!status.ok() && operation_) {
+      operation_->state()->CompleteWithStatus(status);
+    }
+    delete this;
+  }
+
+ private:
+  Tablet* const tablet_;
+  std::unique_ptr<WriteOperation> operation_;
+  boost::optional<ScopedRWOperation> scoped_operation_;
+};
+
+void Tablet::WaitForConflictingTransactions(std::unique_ptr<WriteOperation> operation) {
+  auto waiter = operation->ReleaseWaiter();
+  if (operation->wait_deadline() == CoarseTimePoint()) {
+    operation->SetWaitDeadline(std::min(
+        operation->deadline(), CoarseMonoClock::now() + FLAGS_wait_queue_max_wait_ms * 1ms));
+  }
+  auto wait_deadline = operation->wait_deadline();
+
+  // std::function should be copyable, so the operation is owned by the task until it is resumed.
+  auto* task = new ResumeWriteOperationTask(this, std::move(operation));
+  transaction_participant_->wait_queue()->WaitAsync(
+      waiter, wait_deadline, [this, task](bool woken) {
+    task->Prepare(woken);
+    // Callback could be invoked while the transaction participant holds its mutex, so the
+    // operation is resumed in the thread pool.
+    transaction_participant_->context()->Enqueue(task);
+  });
+}
+
 Status Tablet::Flush(FlushMode mode, FlushFlags flags, int64_t ignore_if_flushed_after_tick) {
   TRACE_EVENT0("tablet", "Tablet::Flush");
 
@@ -2333,6 +2494,25 @@ Result<HybridTime> Tablet::OldestMutableMemtableWriteHybridTime() const {
   return result;
 }
 
+Result<MemTableMemoryUsage> Tablet::GetMemTableMemoryUsage() const {
+  ScopedRWOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  MemTableMemoryUsage result;
+  for (auto* db : { regular_db_.get(), intents_db_.get() }) {
+    if (db) {
+      uint64_t active = 0, all = 0;
+      if (!db->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &active) ||
+          !db->GetIntProperty(rocksdb::DB::Properties::kCurSizeAllMemTables, &all)) {
+        return STATUS_FORMAT(IllegalState, "Failed to get memtable usage of $0", db->GetName());
+      }
+      result.active += active;
+      result.immutable += all > active ? all - active : 0;
+    }
+  }
+  return result;
+}
+
 Status Tablet::DebugDump(vector<string> *lines) {
   switch (table_type_) {
     case TableType::PGSQL_TABLE_TYPE: FALLTHROUGH_INTENDED;
@@ -2402,6 +2582,7 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
         clock_->Update(result);
       }
     } else {
+      const int num_read_pairs = write_batch->read_pairs_size();
       if (isolation_level == IsolationLevel::SERIALIZABLE_ISOLATION &&
           prepare_result.need_read_snapshot) {
         boost::container::small_vector<RefCntPrefix, 16> paths;
@@ -2421,10 +2602,23 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
         }
       }
 
+      docdb::WaitQueue* wait_queue =
+          FLAGS_enable_wait_queues && transaction_participant_ && !operation->wait_expired()
+              ? transaction_participant_->wait_queue() : nullptr;
+      docdb::WaitQueue::WaiterPtr waiter;
       RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
           operation->doc_ops(), *write_batch, clock_->Now(),
           read_time ? read_time.read : HybridTime::kMax, doc_db(), partial_range_key_intents,
-          transaction_participant_.get(), metrics_->transaction_conflicts.get()));
+          transaction_participant_.get(), metrics_->transaction_conflicts.get(),
+          wait_queue, wait_queue ? &waiter : nullptr));
+      if (waiter) {
+        // Blockers could write the same keys, so our in memory locks are released on return, and
+        // the operation is restarted after blockers finish, see WaitForConflictingTransactions.
+        write_batch->mutable_read_pairs()->DeleteSubrange(
+            num_read_pairs, write_batch->read_pairs_size() - num_read_pairs);
+        operation->SetWaiter(std::move(waiter));
+        return Status::OK();
+      }
 
       if (!read_time) {
         auto safe_time = SafeTime(RequireLease::kTrue);
@@ -2614,6 +2808,40 @@ uint64_t Tablet::GetCurrentVersionNumSSTFiles() const {
   });
 }
 
+Result<docdb::DocKeyHash> Tablet::GetMiddleSplitHashCode() const {
+  ScopedRWOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+  if (!regular_db_) {
+    return STATUS(IllegalState, "Regular RocksDB is not opened");
+  }
+
+  // Data of the split parent is dropped from tablet SST files by compaction only, before that
+  // middle key reflects parent data, and tablet size includes data that does not belong to it.
+  if (!key_bounds_.lower.empty() || !key_bounds_.upper.empty()) {
+    std::vector<rocksdb::LiveFileMetaData> files;
+    regular_db_->GetLiveFilesMetaData(&files);
+    for (const auto& file : files) {
+      if (!key_bounds_.IsWithinBounds(file.smallest.key) ||
+          !key_bounds_.IsWithinBounds(file.largest.key)) {
+        return STATUS_FORMAT(
+            IllegalState, "SST file $0 has data outside of tablet key bounds, not compacted yet",
+            file.name);
+      }
+    }
+  }
+
+  const auto middle_key = VERIFY_RESULT(regular_db_->GetMiddleKey());
+  docdb::DocKeyDecoder decoder(middle_key);
+  RETURN_NOT_OK(decoder.DecodeCotableId());
+  RETURN_NOT_OK(decoder.DecodePgtableId());
+  docdb::DocKeyHash hash_code;
+  if (!VERIFY_RESULT(decoder.DecodeHashCode(&hash_code))) {
+    return STATUS_FORMAT(
+        NotSupported, "Middle key does not have hash code: $0", Slice(middle_key).ToDebugString());
+  }
+  return hash_code;
+}
+
 std::pair<int, int> Tablet::GetNumMemtables() const {
   int intents_num_memtables = 0;
   int regular_num_memtables = 0;
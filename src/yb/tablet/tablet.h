@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <atomic>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -161,6 +162,14 @@ struct DocDbOpIds {
   std::string ToString() const;
 };
 
+struct MemTableMemoryUsage {
+  // Memory allocated by the mutable memtables.
+  size_t active = 0;
+
+  // Memory allocated by the immutable memtables, that are waiting for flush or being flushed.
+  size_t immutable = 0;
+};
+
 typedef std::function<Status(const TableInfo&)> AddTableListener;
 
 class TabletScopedIf : public RefCountedThreadSafe<TabletScopedIf> {
@@ -438,6 +447,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // is empty.
   Result<HybridTime> OldestMutableMemtableWriteHybridTime() const;
 
+  // Returns memory allocated by memtables of regular and intents RocksDB.
+  Result<MemTableMemoryUsage> GetMemTableMemoryUsage() const;
+
   // For non-kudu table type fills key-value batch in transaction state request and updates
   // request in state. Due to acquiring locks it can block the thread.
   void AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation> operation);
@@ -496,6 +508,16 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   uint64_t GetCurrentVersionSstFilesUncompressedSize() const;
   uint64_t GetCurrentVersionNumSSTFiles() const;
 
+  // Returns hash code of the key that splits data of this tablet into two parts of approximately
+  // the same size. Used as a split point for automatic tablet splitting.
+  // Fails with IllegalState while SST files still contain data outside of key bounds of this
+  // tablet, i.e. before this tablet was compacted after its own split.
+  Result<docdb::DocKeyHash> GetMiddleSplitHashCode() const;
+
+  // Returns split hash code last calculated in background by GetMiddleSplitHashCode, it is
+  // recalculated each time set of regular DB SST files is changed.
+  boost::optional<docdb::DocKeyHash> split_hash_code() const;
+
   void ListenNumSSTFilesChanged(std::function<void()> listener);
 
   // Returns the number of memtables in intents and regular db-s.
@@ -595,6 +617,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS StartDocWriteOperation(WriteOperation* operation);
 
+  // Continues processing of the operation after StartDocWriteOperation returned status.
+  void DocWriteOperationStarted(std::unique_ptr<WriteOperation> operation, const Status& status);
+
+  class ResumeWriteOperationTask;
+
+  // Resumes the operation from the thread pool, after its conflicting transactions finished or its
+  // wait deadline passed. The thread does not block while the operation waits.
+  void WaitForConflictingTransactions(std::unique_ptr<WriteOperation> operation);
+
   CHECKED_STATUS OpenKeyValueTablet();
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
@@ -770,6 +801,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void RegularDbFilesChanged();
 
+  // Schedules recalculation of split_hash_code_ in the cleanup pool.
+  void UpdateSplitHashCode();
+  void DoUpdateSplitHashCode();
+
   HybridTime ApplierSafeTime(HybridTime min_allowed, CoarseTimePoint deadline) override;
 
   void MinRunningHybridTimeSatisfied() override {
@@ -791,6 +826,13 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<ThreadPoolToken> cleanup_intent_files_token_;
 
+  std::unique_ptr<ThreadPoolToken> update_split_hash_code_token_;
+  // Whether recalculation of split hash code was submitted but is not started yet.
+  std::atomic<bool> split_hash_code_update_pending_{false};
+  // Last calculated split hash code, or kNoSplitHashCode if it is not available.
+  static constexpr int32_t kNoSplitHashCode = -1;
+  std::atomic<int32_t> split_hash_code_{kNoSplitHashCode};
+
   std::unique_ptr<TabletSnapshots> snapshots_;
 
   SnapshotCoordinator* snapshot_coordinator_ = nullptr;
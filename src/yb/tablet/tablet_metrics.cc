@@ -46,6 +46,14 @@ METRIC_DEFINE_counter(tablet, rows_deleted, "Rows Deleted",
     yb::MetricUnit::kRows,
     "Number of row delete operations performed on this tablet since service start");
 
+METRIC_DEFINE_counter(tablet, read_requests, "Read Requests",
+    yb::MetricUnit::kRequests,
+    "Number of read requests handled by this tablet since service start");
+
+METRIC_DEFINE_counter(tablet, write_requests, "Write Requests",
+    yb::MetricUnit::kRequests,
+    "Number of write requests handled by this tablet since service start");
+
 METRIC_DEFINE_counter(tablet, insertions_failed_dup_key, "Duplicate Key Inserts",
                       yb::MetricUnit::kRows,
                       "Number of inserts which failed because the key already existed");
@@ -119,6 +127,12 @@ METRIC_DEFINE_counter(tablet, majority_sst_files_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to number of majority SST files.");
 
+METRIC_DEFINE_counter(tablet, global_memstore_rejections,
+  "Global Memstore Limit Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of RPC requests rejected because flushes don't keep up with the global memstore "
+  "limit.");
+
 METRIC_DEFINE_counter(tablet, transaction_conflicts,
   "Distributed Transaction Conflicts",
   yb::MetricUnit::kRequests,
@@ -149,10 +163,13 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(not_leader_rejections),
     MINIT(leader_memory_pressure_rejections),
     MINIT(majority_sst_files_rejections),
+    MINIT(global_memstore_rejections),
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
     MINIT(restart_read_requests),
-    MINIT(rows_inserted) {
+    MINIT(rows_inserted),
+    MINIT(read_requests),
+    MINIT(write_requests) {
 }
 #undef MINIT
 
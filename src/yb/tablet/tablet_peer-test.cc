@@ -172,6 +172,7 @@ class TabletPeerTest : public YBTabletTest,
                                            raft_pool_.get(),
                                            tablet_prepare_pool_.get(),
                                            nullptr /* retryable_requests */,
+                                           nullptr /* multi_raft_manager */,
                                            yb::OpId() /* split_op_id */));
   }
 
@@ -187,6 +187,7 @@ Status TabletPeer::InitTabletPeer(
     ThreadPool* raft_pool,
     ThreadPool* tablet_prepare_pool,
     consensus::RetryableRequests* retryable_requests,
+    consensus::MultiRaftManager* multi_raft_manager,
     const yb::OpId& split_op_id) {
   DCHECK(tablet) << "A TabletPeer must be provided with a Tablet";
   DCHECK(log) << "A TabletPeer must be provided with a Log";
@@ -267,6 +268,7 @@ Status TabletPeer::InitTabletPeer(
         tablet_->table_type(),
         raft_pool,
         retryable_requests,
+        multi_raft_manager,
         split_op_id);
     has_consensus_.store(true, std::memory_order_release);
 
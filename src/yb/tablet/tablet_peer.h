@@ -121,6 +121,7 @@ class TabletPeer : public consensus::ConsensusContext,
       ThreadPool* raft_pool,
       ThreadPool* tablet_prepare_pool,
       consensus::RetryableRequests* retryable_requests,
+      consensus::MultiRaftManager* multi_raft_manager,
       const yb::OpId& split_op_id);
 
   // Starts the TabletPeer, making it available for Write()s. If this
@@ -71,6 +71,25 @@ HistoryRetentionDirective TabletRetentionPolicy::GetRetentionDirective() {
     }
   }
 
+  return MakeRetentionDirective(history_cutoff);
+}
+
+HistoryRetentionDirective TabletRetentionPolicy::ProposedRetentionDirective() {
+  HybridTime history_cutoff;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (FLAGS_enable_history_cutoff_propagation) {
+      history_cutoff = SanitizeHistoryCutoff(committed_history_cutoff_);
+    } else {
+      history_cutoff = EffectiveHistoryCutoff();
+    }
+  }
+
+  return MakeRetentionDirective(history_cutoff);
+}
+
+HistoryRetentionDirective TabletRetentionPolicy::MakeRetentionDirective(
+    HybridTime history_cutoff) {
   std::shared_ptr<ColumnIds> deleted_before_history_cutoff = std::make_shared<ColumnIds>();
   for (const auto& deleted_col : metadata_.deleted_cols()) {
     if (deleted_col.ht < history_cutoff) {
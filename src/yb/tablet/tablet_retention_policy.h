@@ -30,6 +30,8 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
 
   docdb::HistoryRetentionDirective GetRetentionDirective() override;
 
+  docdb::HistoryRetentionDirective ProposedRetentionDirective() override;
+
   // Tries to update history cutoff to proposed value, not allowing it to decrease.
   // Returns new committed history cutoff value.
   HybridTime UpdateCommittedHistoryCutoff(HybridTime new_value);
@@ -48,6 +50,7 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
 
  private:
   bool ShouldRetainDeleteMarkersInMajorCompaction() const;
+  docdb::HistoryRetentionDirective MakeRetentionDirective(HybridTime history_cutoff);
   HybridTime EffectiveHistoryCutoff() REQUIRES(mutex_);
 
   // Check proposed history cutoff against other restrictions (for instance min reading timestamp),
@@ -37,7 +37,10 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb.h"
+#include "yb/docdb/wait_queue.h"
 
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/poller.h"
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/rpc_context.h"
 #include "yb/rpc/thread_pool.h"
@@ -88,6 +91,11 @@ DEFINE_uint64(max_transactions_in_status_request, 128,
               "Request status for at most specified number of transactions at once. "
                   "0 disables load time transaction status resolution.");
 
+DEFINE_int32(wait_queue_poll_interval_ms, 100,
+             "How often transactions that wait for conflicting transactions are checked for "
+             "expiration of their wait deadline.");
+TAG_FLAG(wait_queue_poll_interval_ms, advanced);
+
 METRIC_DEFINE_simple_counter(
     tablet, transaction_load_attempts,
     "Total number of tries to load transaction metadata from the intents RocksDB",
@@ -118,7 +126,8 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
         log_prefix_(context->LogPrefix()),
         status_resolver_(context, &rpcs_, FLAGS_max_transactions_in_status_request,
                          std::bind(&Impl::TransactionsStatus, this, _1)),
-        last_loaded_(TransactionId::Nil()) {
+        last_loaded_(TransactionId::Nil()),
+        wait_queue_poller_(log_prefix_, std::bind(&Impl::ExpireWaiters, this)) {
     LOG_WITH_PREFIX(INFO) << "Create";
     metric_transactions_running_ = METRIC_transactions_running.Instantiate(entity, 0);
     metric_transaction_load_attempts_ = METRIC_transaction_load_attempts.Instantiate(entity);
@@ -141,6 +150,9 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     }
 
     LOG_WITH_PREFIX(INFO) << "Shutdown";
+    wait_queue_poller_.Shutdown();
+    // Resumes waiting write operations, so they could fail before the tablet is shut down.
+    wait_queue_.Shutdown();
     return true;
   }
 
@@ -565,6 +577,21 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     }
   }
 
+  docdb::WaitQueue* wait_queue() {
+    // The poller is started lazily, since wait queues are used only when enabled, and the client
+    // is not available yet when participants are started, e.g. for the sys catalog on master
+    // cold start.
+    std::call_once(wait_queue_poller_started_, [this] {
+      wait_queue_poller_.Start(
+          &client()->messenger()->scheduler(), FLAGS_wait_queue_poll_interval_ms * 1ms);
+    });
+    return &wait_queue_;
+  }
+
+  void ExpireWaiters() {
+    wait_queue_.ExpireWaiters(CoarseMonoClock::now());
+  }
+
   TransactionParticipantContext* participant_context() const {
     return &participant_context_;
   }
@@ -1099,6 +1126,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     LOG_IF_WITH_PREFIX(DFATAL, !recently_removed_transactions_.insert(transaction.id()).second)
         << "Transaction removed twice: " << transaction.id();
     VLOG_WITH_PREFIX(4) << "Remove transaction: " << transaction.id();
+    wait_queue_.SignalFinished(transaction.id());
     transactions_.erase(it);
     TransactionsModifiedUnlocked(min_running_notifier);
   }
@@ -1288,6 +1316,12 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   std::atomic<CoarseTimePoint> next_check_min_running_{CoarseTimePoint()};
   HybridTime waiting_for_min_running_ht_ = HybridTime::kMax;
   std::atomic<bool> shutdown_done_{false};
+
+  // Transactions waiting for conflicting transactions of this tablet to be removed.
+  docdb::WaitQueue wait_queue_;
+  // Expires waiters of wait_queue_, whose wait deadline passed.
+  rpc::Poller wait_queue_poller_;
+  std::once_flag wait_queue_poller_started_;
 };
 
 TransactionParticipant::TransactionParticipant(
@@ -1391,6 +1425,10 @@ TransactionParticipantContext* TransactionParticipant::context() const {
   return impl_->participant_context();
 }
 
+docdb::WaitQueue* TransactionParticipant::wait_queue() const {
+  return impl_->wait_queue();
+}
+
 HybridTime TransactionParticipant::MinRunningHybridTime() const {
   return impl_->MinRunningHybridTime();
 }
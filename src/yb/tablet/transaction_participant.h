@@ -56,6 +56,12 @@ class OneWayBitmap;
 class RWOperationCounter;
 class TransactionMetadataPB;
 
+namespace docdb {
+
+class WaitQueue;
+
+}
+
 namespace tserver {
 
 class GetTransactionStatusAtParticipantResponsePB;
@@ -210,6 +216,9 @@ class TransactionParticipant : public TransactionStatusManager {
 
   TransactionParticipantContext* context() const;
 
+  // Queue of transactions waiting for transactions of this tablet to commit or abort.
+  docdb::WaitQueue* wait_queue() const;
+
   HybridTime MinRunningHybridTime() const;
 
   // When minimal start hybrid time of running transaction will be at least `ht` applier
@@ -0,0 +1,414 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/pg_shared_exchange_server.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/common/consistent_read_point.h"
+#include "yb/common/transaction_error.h"
+#include "yb/common/wire_protocol.h"
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/macros.h"
+
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/tablet/tablet_metadata.h"
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/tserver/ts_tablet_manager.h"
+#include "yb/tserver/tserver_service.proxy.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/thread.h"
+#include "yb/util/threadpool.h"
+
+using namespace std::literals;
+
+DEFINE_int32(pg_shared_exchange_max_threads, 64,
+             "Maximum number of threads used to parse and dispatch YSQL requests received "
+             "through shared memory.");
+TAG_FLAG(pg_shared_exchange_max_threads, advanced);
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+// Interval used to recheck whether the server is shutting down while there are no requests.
+constexpr auto kIdleWaitInterval = 1s;
+
+// Time given to a backend to consume a part of a response that does not fit the exchange buffer.
+constexpr auto kResponsePartTimeout = 5s;
+
+// Minimal interval between reloads of the local peers of a table, when none of them contains the
+// requested key. Ops of tablets led by other tservers are expected to miss all the time.
+constexpr auto kTablePeersRefreshInterval = 1s;
+
+// Responds with a failure. Details that do not fit the exchange buffer are dropped.
+void RespondFailure(const Status& status, PgSharedExchange* exchange) {
+  PgSharedExchangeResponsePB response;
+  auto* status_pb = response.mutable_status();
+  StatusToPB(status, status_pb);
+  if (response.ByteSizeLong() > exchange->buffer_size()) {
+    status_pb->clear_message();
+    status_pb->clear_source_file();
+    status_pb->clear_errors();
+  }
+  const size_t response_size = response.ByteSizeLong();
+  if (response_size > exchange->buffer_size()) {
+    // Empty response does not match the sent operations, so the backend reports an error anyway.
+    LOG(DFATAL) << "Shared exchange buffer of " << exchange->buffer_size()
+                << " bytes is too small for failure response: " << status;
+    exchange->Respond(0);
+    return;
+  }
+  response.SerializeWithCachedSizesToArray(pointer_cast<uint8_t*>(exchange->buffer()));
+  exchange->Respond(response_size);
+}
+
+// Whether the error means that the tablet is not served by this tserver at the moment. Ops of such
+// tablet are sent by the backend through RPC, so the client looks up and retries the right replica.
+bool IsTabletNotServedError(TabletServerErrorPB::Code code) {
+  switch (code) {
+    case TabletServerErrorPB::TABLET_NOT_FOUND: FALLTHROUGH_INTENDED;
+    case TabletServerErrorPB::TABLET_NOT_RUNNING: FALLTHROUGH_INTENDED;
+    case TabletServerErrorPB::NOT_THE_LEADER: FALLTHROUGH_INTENDED;
+    case TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE: FALLTHROUGH_INTENDED;
+    case TabletServerErrorPB::TABLET_SPLIT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+struct PgSharedExchangeServer::Call {
+  explicit Call(const server::ClockPtr& clock) : read_point(clock) {}
+
+  PgSharedExchange* exchange = nullptr;
+  PgSharedExchangeRequestPB request;
+  PgSharedExchangeResponsePB response;
+  ConsistentReadPoint read_point;
+  bool had_read_time = false;
+  CoarseTimePoint deadline;
+  std::atomic<size_t> running_reads{0};
+
+  std::mutex mutex;
+  // First failure of tablet reads.
+  Status status;
+};
+
+// Read of the ops of a single tablet, the same as client::internal::ReadRpc would send.
+struct PgSharedExchangeServer::TabletRead {
+  std::shared_ptr<Call> call;
+  // Indexes of the ops in the request of the call, in the order of pgsql_batch.
+  std::vector<int> op_indexes;
+  ReadRequestPB req;
+  ReadResponsePB resp;
+  rpc::RpcController controller;
+};
+
+PgSharedExchangeServer::PgSharedExchangeServer(
+    PgSharedExchangeArea* area, TSTabletManager* tablet_manager,
+    std::shared_ptr<TabletServerServiceProxy> proxy, server::ClockPtr clock)
+    : area_(area), tablet_manager_(tablet_manager), proxy_(std::move(proxy)),
+      clock_(std::move(clock)) {
+}
+
+PgSharedExchangeServer::~PgSharedExchangeServer() {
+  Shutdown();
+}
+
+Status PgSharedExchangeServer::Start() {
+  RETURN_NOT_OK(ThreadPoolBuilder("pg_shm")
+                    .set_max_threads(FLAGS_pg_shared_exchange_max_threads)
+                    .Build(&thread_pool_));
+  return Thread::Create("pg_shm", "pg_shm_exchange", &PgSharedExchangeServer::Run, this,
+                        &thread_);
+}
+
+void PgSharedExchangeServer::Shutdown() {
+  if (closing_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  if (thread_) {
+    WARN_NOT_OK(ThreadJoiner(thread_.get()).Join(), "Failed to join shared exchange thread");
+    thread_ = nullptr;
+  }
+  if (thread_pool_) {
+    thread_pool_->Shutdown();
+  }
+}
+
+void PgSharedExchangeServer::Run() {
+  uint32_t last_seen = 0;
+  while (!closing_.load(std::memory_order_acquire)) {
+    area_->WaitRequest(&last_seen, kIdleWaitInterval);
+    for (size_t i = 0; i != area_->num_exchanges(); ++i) {
+      auto& exchange = area_->exchange(i);
+      if (!exchange.StartProcessing()) {
+        continue;
+      }
+      auto status = thread_pool_->SubmitFunc(
+          std::bind(&PgSharedExchangeServer::Process, this, &exchange));
+      if (!status.ok()) {
+        RespondFailure(status, &exchange);
+      }
+    }
+  }
+}
+
+void PgSharedExchangeServer::Process(PgSharedExchange* exchange) {
+  auto call = std::make_shared<Call>(clock_);
+  call->exchange = exchange;
+  auto request = exchange->request();
+  Status status;
+  if (!call->request.ParseFromArray(request.data(), request.size())) {
+    status = STATUS(Corruption, "Failed to parse shared exchange request");
+  } else {
+    status = StartCall(call);
+  }
+  if (!status.ok()) {
+    FinishCall(call, status);
+  }
+}
+
+Status PgSharedExchangeServer::StartCall(const std::shared_ptr<Call>& call) {
+  auto& request = call->request;
+  auto& response = call->response;
+  call->deadline = CoarseMonoClock::now() + std::chrono::milliseconds(request.timeout_ms());
+
+  const auto& read_point = request.read_point();
+  auto read_time = ReadHybridTime::FromReadTimePB(read_point);
+  call->had_read_time = static_cast<bool>(read_time);
+  if (call->had_read_time) {
+    ConsistentReadPoint::HybridTimeMap local_limits;
+    for (const auto& entry : read_point.local_limits()) {
+      local_limits.emplace(entry.first, HybridTime(entry.second));
+    }
+    call->read_point.SetReadTime(read_time, std::move(local_limits));
+  }
+
+  // Ops are grouped per tablet, the same way as client::internal::Batcher does.
+  std::unordered_map<TabletId, std::shared_ptr<TabletRead>> reads;
+  auto& ops = *request.mutable_ops();
+  for (int i = 0; i != ops.size(); ++i) {
+    response.add_responses();
+    response.add_rows_data();
+    auto& op = ops[i];
+    auto peer = LeaderPeer(op.table_id(), op.partition_key());
+    if (!peer) {
+      response.add_rpc_ops(i);
+      continue;
+    }
+    auto& read = reads[peer->tablet_id()];
+    if (!read) {
+      read = std::make_shared<TabletRead>();
+      read->call = call;
+      read->req.set_tablet_id(peer->tablet_id());
+    }
+    read->op_indexes.push_back(i);
+    read->req.add_pgsql_batch()->Swap(op.mutable_request());
+  }
+
+  if (reads.empty()) {
+    FinishCall(call, Status::OK());
+    return Status::OK();
+  }
+
+  // Reads of different tablets, including tablets read by the backend through RPC, have to use the
+  // same read time. Otherwise it is picked by the tablet.
+  if (!call->had_read_time && (reads.size() > 1 || !response.rpc_ops().empty())) {
+    call->read_point.SetCurrentReadTime();
+  }
+
+  call->running_reads.store(reads.size(), std::memory_order_release);
+  for (auto& entry : reads) {
+    auto read = std::move(entry.second);
+    auto& req = read->req;
+    req.set_propagated_hybrid_time(call->read_point.Now().ToUint64());
+    call->read_point.GetReadTime(entry.first).AddToPB(&req);
+    if (read_point.has_metadata()) {
+      *req.mutable_transaction() = read_point.metadata();
+    }
+    read->controller.set_deadline(call->deadline);
+    auto* read_ptr = read.get();
+    proxy_->ReadAsync(req, &read_ptr->resp, &read_ptr->controller, [this, read] {
+      TabletReadDone(read.get());
+    });
+  }
+  return Status::OK();
+}
+
+void PgSharedExchangeServer::TabletReadDone(TabletRead* read) {
+  auto& call = *read->call;
+  auto& resp = read->resp;
+  const auto& tablet_id = read->req.tablet_id();
+
+  auto status = read->controller.status();
+  // The tablet moved or is temporarily unavailable, leave the ops to the client, that knows how to
+  // find the right replica and when to retry.
+  bool not_served = status.IsServiceUnavailable();
+  if (status.ok() && resp.has_error()) {
+    status = StatusFromPB(resp.error().status());
+    not_served = IsTabletNotServedError(resp.error().code());
+  }
+  if (status.ok()) {
+    auto restart_read_time = ReadHybridTime::FromRestartReadTimePB(resp);
+    if (restart_read_time) {
+      call.read_point.RestartRequired(tablet_id, restart_read_time);
+      status = STATUS(TryAgain, Format("Restart read required at: $0", restart_read_time), Slice(),
+                      TransactionError(TransactionErrorCode::kReadRestartRequired));
+    }
+  }
+
+  if (not_served) {
+    VLOG(2) << "Tablet " << tablet_id << " is not served locally: " << status;
+    std::lock_guard<std::mutex> lock(call.mutex);
+    for (auto idx : read->op_indexes) {
+      call.response.add_rpc_ops(idx);
+    }
+    status = Status::OK();
+  } else if (status.ok()) {
+    if (resp.has_used_read_time()) {
+      // Read time is picked by the tablet only when this is the only tablet of the call.
+      call.read_point.SetReadTime(
+          ReadHybridTime::FromPB(resp.used_read_time()), ConsistentReadPoint::HybridTimeMap());
+    }
+    if (static_cast<size_t>(resp.pgsql_batch().size()) != read->op_indexes.size()) {
+      status = STATUS_FORMAT(
+          IllegalState, "Read response count mismatch: $0 requests sent, $1 responses received",
+          read->op_indexes.size(), resp.pgsql_batch().size());
+    }
+    for (size_t i = 0; status.ok() && i != read->op_indexes.size(); ++i) {
+      const auto idx = read->op_indexes[i];
+      auto* op_resp = call.response.mutable_responses(idx);
+      op_resp->Swap(resp.mutable_pgsql_batch(i));
+      if (op_resp->has_rows_data_sidecar()) {
+        auto rows_data = read->controller.GetSidecar(op_resp->rows_data_sidecar());
+        if (!rows_data.ok()) {
+          status = rows_data.status();
+          break;
+        }
+        call.response.mutable_rows_data(idx)->assign(rows_data->cdata(), rows_data->size());
+      }
+    }
+  }
+
+  if (!status.ok()) {
+    std::lock_guard<std::mutex> lock(call.mutex);
+    if (call.status.ok()) {
+      call.status = status;
+    }
+  }
+  if (call.running_reads.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Status call_status;
+    {
+      std::lock_guard<std::mutex> lock(call.mutex);
+      call_status = call.status;
+    }
+    FinishCall(read->call, call_status);
+  }
+}
+
+void PgSharedExchangeServer::FinishCall(const std::shared_ptr<Call>& call, const Status& status) {
+  auto& response = call->response;
+  if (!status.ok()) {
+    StatusToPB(status, response.mutable_status());
+  } else {
+    auto& rpc_ops = *response.mutable_rpc_ops();
+    std::sort(rpc_ops.begin(), rpc_ops.end());
+  }
+  call->read_point.FinishChildTransactionResult(
+      HadReadTime(call->had_read_time), response.mutable_read_point_result());
+  response.set_propagated_hybrid_time(clock_->Now().ToUint64());
+
+  auto* exchange = call->exchange;
+  const size_t response_size = response.ByteSize();
+  if (response_size <= exchange->buffer_size()) {
+    response.SerializeWithCachedSizesToArray(pointer_cast<uint8_t*>(exchange->buffer()));
+    exchange->Respond(response_size);
+    return;
+  }
+
+  // The response does not fit the buffer, stream it to the backend part by part.
+  // Streaming waits for the backend to consume every part, while this could be invoked as read
+  // callback on a thread shared with other calls. So it is done by our own thread pool.
+  auto serialized = std::make_shared<std::string>();
+  response.SerializeToString(serialized.get());
+  auto submit_status = thread_pool_->SubmitFunc([exchange, serialized] {
+    WARN_NOT_OK(exchange->RespondInParts(*serialized, kResponsePartTimeout),
+                "Failed to send shared exchange response");
+  });
+  if (!submit_status.ok()) {
+    RespondFailure(submit_status, exchange);
+  }
+}
+
+tablet::TabletPeerPtr PgSharedExchangeServer::LeaderPeer(
+    const TableId& table_id, const std::string& partition_key) {
+  auto find_peer = [&partition_key](const TablePeers& table_peers) -> tablet::TabletPeerPtr {
+    for (const auto& weak_peer : table_peers.peers) {
+      auto peer = weak_peer.lock();
+      if (!peer) {
+        continue;
+      }
+      const auto& metadata = peer->tablet_metadata();
+      // A split tablet still contains the key, while its ops are served by the new tablets.
+      if (metadata->tablet_data_state() == tablet::TABLET_DATA_READY &&
+          metadata->partition().ContainsKey(partition_key)) {
+        return peer;
+      }
+    }
+    return nullptr;
+  };
+
+  tablet::TabletPeerPtr peer;
+  bool refresh = true;
+  {
+    std::lock_guard<std::mutex> lock(table_peers_mutex_);
+    auto it = table_peers_.find(table_id);
+    if (it != table_peers_.end()) {
+      peer = find_peer(it->second);
+      refresh = !peer &&
+                CoarseMonoClock::now() >= it->second.refresh_time + kTablePeersRefreshInterval;
+    }
+  }
+  if (refresh) {
+    TablePeers table_peers;
+    table_peers.refresh_time = CoarseMonoClock::now();
+    for (const auto& candidate : tablet_manager_->GetTabletPeers()) {
+      // Colocated tables share the tablet, so the tablet metadata is checked for the table.
+      if (candidate->tablet_metadata()->GetTableInfo(table_id).ok()) {
+        table_peers.peers.push_back(candidate);
+      }
+    }
+    peer = find_peer(table_peers);
+    std::lock_guard<std::mutex> lock(table_peers_mutex_);
+    table_peers_[table_id] = std::move(table_peers);
+  }
+
+  if (!peer || peer->LeaderStatus() != consensus::LeaderStatus::LEADER_AND_READY) {
+    return nullptr;
+  }
+  return peer;
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_PG_SHARED_EXCHANGE_SERVER_H
+#define YB_TSERVER_PG_SHARED_EXCHANGE_SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/server/clock.h"
+
+#include "yb/tablet/tablet_fwd.h"
+
+#include "yb/tserver/tserver_shared_mem.h"
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Thread;
+class ThreadPool;
+
+namespace tserver {
+
+class TabletServerServiceProxy;
+class TSTabletManager;
+
+// Serves YSQL reads that local postgres backends send through PgSharedExchange, see
+// PgSharedExchangeArea. Ops are dispatched to the tablet peers led by this tserver through the
+// local TabletServerService proxy, so they take the regular TabletServiceImpl::Read path without
+// any socket or client side batching on the way. Ops of other tablets are returned to the backend,
+// that sends them through RPC.
+class PgSharedExchangeServer {
+ public:
+  PgSharedExchangeServer(
+      PgSharedExchangeArea* area, TSTabletManager* tablet_manager,
+      std::shared_ptr<TabletServerServiceProxy> proxy, server::ClockPtr clock);
+
+  ~PgSharedExchangeServer();
+
+  CHECKED_STATUS Start();
+
+  void Shutdown();
+
+ private:
+  struct Call;
+  struct TabletRead;
+
+  struct TablePeers {
+    std::vector<std::weak_ptr<tablet::TabletPeer>> peers;
+    CoarseTimePoint refresh_time;
+  };
+
+  void Run();
+
+  void Process(PgSharedExchange* exchange);
+
+  CHECKED_STATUS StartCall(const std::shared_ptr<Call>& call);
+
+  void TabletReadDone(TabletRead* read);
+
+  void FinishCall(const std::shared_ptr<Call>& call, const Status& status);
+
+  // Returns the peer of the tablet of 'table_id' that contains 'partition_key', when it is led by
+  // this tserver, nullptr otherwise.
+  tablet::TabletPeerPtr LeaderPeer(const TableId& table_id, const std::string& partition_key);
+
+  PgSharedExchangeArea* const area_;
+  TSTabletManager* const tablet_manager_;
+  const std::shared_ptr<TabletServerServiceProxy> proxy_;
+  const server::ClockPtr clock_;
+
+  std::atomic<bool> closing_{false};
+  scoped_refptr<Thread> thread_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+
+  // Local tablet peers of tables read by backends.
+  std::mutex table_peers_mutex_;
+  std::unordered_map<TableId, TablePeers> table_peers_;
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_PG_SHARED_EXCHANGE_SERVER_H
@@ -13,6 +13,8 @@
 
 #include "yb/tserver/remote_bootstrap_file_downloader.h"
 
+#include <deque>
+
 #include "yb/common/wire_protocol.h"
 
 #include "yb/fs/fs_manager.h"
@@ -21,10 +23,13 @@
 
 #include "yb/tserver/remote_bootstrap.proxy.h"
 
+#include "yb/util/countdown_latch.h"
 #include "yb/util/crc.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/scope_exit.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/thread.h"
 #include "yb/util/net/rate_limiter.h"
 
 using namespace yb::size_literals;
@@ -45,6 +50,17 @@ DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 256_MB,
              "the total limit will be 2 * remote_bootstrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_downloads, 4,
+             "Maximum number of files downloaded in parallel by a single remote bootstrap client. "
+             "WAL segments are always downloaded sequentially.");
+TAG_FLAG(remote_bootstrap_max_concurrent_downloads, advanced);
+
+DEFINE_int32(remote_bootstrap_max_chunks_in_flight_per_file, 4,
+             "Maximum number of chunks of a single file requested in parallel by a remote "
+             "bootstrap client. Chunks are still written in order, so up to this number of "
+             "chunks could be held in memory for each file being downloaded.");
+TAG_FLAG(remote_bootstrap_max_chunks_in_flight_per_file, advanced);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
@@ -73,9 +89,22 @@ CHECKED_STATUS ExtractRemoteError(
           " from remote service");
 }
 
-} // namespace
+// Request for a single chunk of a file, that is being downloaded.
+struct ChunkFetch {
+  ChunkFetch(uint64_t offset_, int32_t length_) : offset(offset_), length(length_) {}
 
-extern std::atomic<int32_t> remote_bootstrap_clients_started_;
+  const uint64_t offset;
+  const int32_t length;
+  FetchDataRequestPB req;
+  FetchDataResponsePB resp;
+  rpc::RpcController controller;
+  CountDownLatch latch{1};
+};
+
+// Number of files that are being downloaded by all remote bootstrap clients.
+std::atomic<int32_t> active_downloads{0};
+
+} // namespace
 
 RemoteBootstrapFileDownloader::RemoteBootstrapFileDownloader(
     const std::string* log_prefix, FsManager* fs_manager)
@@ -97,23 +126,55 @@ Env& RemoteBootstrapFileDownloader::env() const {
 Status RemoteBootstrapFileDownloader::DownloadFile(
     const tablet::FilePB& file_pb, const std::string& dir, DataIdPB *data_id) {
   auto file_path = JoinPathSegments(dir, file_pb.name());
+  // Env::CreateDirs tolerates concurrent creation of the same directories, so it is done without
+  // holding mutex_, that would serialize all download streams behind the file system.
   RETURN_NOT_OK(env().CreateDirs(DirName(file_path)));
 
-  if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+  bool inode_registered = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (file_pb.inode() != 0) {
+      auto it = inode2file_.find(file_pb.inode());
+      if (it == inode2file_.end()) {
+        inode2file_.emplace(file_pb.inode(), InodeFile{file_path, false});
+        inode_registered = true;
+        break;
+      }
+      if (!it->second.ready) {
+        // File with the same inode is being downloaded by another stream, wait for it.
+        inode_cond_.wait(lock);
+        continue;
+      }
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = env().LinkFile(it->second, file_path);
+                          << " => " << it->second.path;
+      auto link_status = env().LinkFile(it->second.path, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second.path
                              << ": " << link_status;
+      break;
     }
   }
 
+  auto status = DoDownloadFile(file_pb, file_path, data_id);
+
+  if (inode_registered) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (status.ok()) {
+      inode2file_[file_pb.inode()].ready = true;
+    } else {
+      inode2file_.erase(file_pb.inode());
+    }
+    inode_cond_.notify_all();
+  }
+
+  return status;
+}
+
+Status RemoteBootstrapFileDownloader::DoDownloadFile(
+    const tablet::FilePB& file_pb, const std::string& file_path, DataIdPB *data_id) {
   WritableFileOptions opts;
   opts.sync_on_close = true;
   std::unique_ptr<WritableFile> file;
@@ -125,11 +186,54 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
                                DataIdPB::IdType_Name(data_id->type()), file_path));
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
-  if (file_pb.inode() != 0) {
-    inode2file_.emplace(file_pb.inode(), file_path);
+  return Status::OK();
+}
+
+Status RemoteBootstrapFileDownloader::ParallelDownload(
+    size_t count, const std::function<Status(size_t)>& download) {
+  std::atomic<size_t> next_index{0};
+  std::mutex status_mutex;
+  Status result;
+  auto failed = [&status_mutex, &result] {
+    std::lock_guard<std::mutex> lock(status_mutex);
+    return !result.ok();
+  };
+  auto worker = [&] {
+    while (!failed()) {
+      auto index = next_index.fetch_add(1, std::memory_order_acq_rel);
+      if (index >= count) {
+        break;
+      }
+      auto status = download(index);
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(status_mutex);
+        if (result.ok()) {
+          result = status;
+        }
+      }
+    }
+  };
+
+  const auto num_streams = std::min<size_t>(
+      std::max(FLAGS_remote_bootstrap_max_concurrent_downloads, 1), count);
+  std::vector<scoped_refptr<Thread>> threads;
+  // The current thread is used as one of the streams.
+  for (size_t i = 1; i < num_streams; ++i) {
+    scoped_refptr<Thread> thread;
+    auto status = Thread::Create(
+        "remote_bootstrap", Format("rb-download-$0", i), worker, &thread);
+    if (!status.ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Failed to start download stream: " << status;
+      break;
+    }
+    threads.push_back(std::move(thread));
+  }
+  worker();
+  for (auto& thread : threads) {
+    WARN_NOT_OK(ThreadJoiner(thread.get()).Join(), "Failed to join download stream");
   }
 
-  return Status::OK();
+  return result;
 }
 
 template<class Appendable>
@@ -145,17 +249,21 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
 
   std::unique_ptr<RateLimiter> rate_limiter;
 
+  // The rate limit is shared by all downloads of all remote bootstrap clients in this process.
+  active_downloads.fetch_add(1, std::memory_order_acq_rel);
+  auto se = ScopeExit([] {
+    active_downloads.fetch_sub(1, std::memory_order_acq_rel);
+  });
+
   if (FLAGS_remote_bootstrap_rate_limit_bytes_per_sec > 0) {
     static auto rate_updater = []() {
-      auto remote_bootstrap_clients_started =
-          remote_bootstrap_clients_started_.load(std::memory_order_acquire);
-      if (remote_bootstrap_clients_started < 1) {
-        YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of remote bootstrap sessions: "
-                                   << remote_bootstrap_clients_started;
+      auto downloads = active_downloads.load(std::memory_order_acquire);
+      if (downloads < 1) {
+        YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of remote bootstrap downloads: "
+                                   << downloads;
         return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec);
       }
-      return static_cast<uint64_t>(
-          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / remote_bootstrap_clients_started);
+      return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / downloads);
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -164,47 +272,89 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
     rate_limiter = std::make_unique<RateLimiter>();
   }
 
-  rpc::RpcController controller;
-  controller.set_timeout(session_idle_timeout_);
-  FetchDataRequestPB req;
-
-  bool done = false;
-  while (!done) {
-    controller.Reset();
-    req.set_session_id(session_id_);
-    req.mutable_data_id()->CopyFrom(data_id);
-    req.set_offset(offset);
-    if (rate_limiter->active()) {
-      auto max_size = rate_limiter->GetMaxSizeForNextTransmission();
-      if (max_size > std::numeric_limits<decltype(max_length)>::max()) {
-        max_size = std::numeric_limits<decltype(max_length)>::max();
-      }
-      max_length = std::min(max_length, decltype(max_length)(max_size));
+  if (rate_limiter->active()) {
+    auto max_size = rate_limiter->GetMaxSizeForNextTransmission();
+    if (max_size > std::numeric_limits<decltype(max_length)>::max()) {
+      max_size = std::numeric_limits<decltype(max_length)>::max();
     }
-    req.set_max_length(max_length);
-
-    FetchDataResponsePB resp;
-    auto status = rate_limiter->SendOrReceiveData([this, &req, &resp, &controller]() {
-      return proxy_->FetchData(req, &resp, &controller);
-    }, [&resp]() { return resp.ByteSize(); });
-    RETURN_NOT_OK_UNWIND_PREPEND(status, controller, "Unable to fetch data from remote");
-    DCHECK_LE(resp.chunk().data().size(), max_length);
+    max_length = std::min(max_length, decltype(max_length)(max_size));
+  }
+  rate_limiter->Init();
+
+  // Chunks are requested by offset, so several consecutive chunks of the file are fetched in
+  // parallel, while they are still appended in order. The first request tells the file length,
+  // so only it is sent alone.
+  const size_t max_in_flight = std::max(FLAGS_remote_bootstrap_max_chunks_in_flight_per_file, 1);
+  std::deque<std::unique_ptr<ChunkFetch>> in_flight;
+  auto wait_in_flight = ScopeExit([&in_flight] {
+    // Responses are written into the fetches, so they should outlive outstanding calls.
+    for (const auto& fetch : in_flight) {
+      fetch->latch.Wait();
+    }
+  });
+
+  auto start_fetch = [this, &data_id, &in_flight](
+      uint64_t fetch_offset, int32_t length, bool front) {
+    auto fetch = std::make_unique<ChunkFetch>(fetch_offset, length);
+    fetch->controller.set_timeout(session_idle_timeout_);
+    fetch->req.set_session_id(session_id_);
+    *fetch->req.mutable_data_id() = data_id;
+    fetch->req.set_offset(fetch_offset);
+    fetch->req.set_max_length(length);
+    auto* raw_fetch = fetch.get();
+    if (front) {
+      in_flight.push_front(std::move(fetch));
+    } else {
+      in_flight.push_back(std::move(fetch));
+    }
+    proxy_->FetchDataAsync(
+        raw_fetch->req, &raw_fetch->resp, &raw_fetch->controller, [raw_fetch] {
+      raw_fetch->latch.CountDown();
+    });
+  };
+
+  // Offset right after the last requested chunk.
+  uint64_t next_fetch_offset = max_length;
+  // Unknown until the first response is received.
+  uint64_t total_data_length = std::numeric_limits<uint64_t>::max();
+  start_fetch(0, max_length, /* front= */ false);
+
+  while (!in_flight.empty()) {
+    auto& fetch = *in_flight.front();
+    fetch.latch.Wait();
+    RETURN_NOT_OK_UNWIND_PREPEND(
+        fetch.controller.status(), fetch.controller, "Unable to fetch data from remote");
+    const auto& chunk = fetch.resp.chunk();
+    DCHECK_LE(chunk.data().size(), fetch.length);
 
     // Sanity-check for corruption.
-    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk()),
+    RETURN_NOT_OK_PREPEND(VerifyData(offset, chunk),
                           Format("Error validating data item $0", data_id));
 
     // Write the data.
-    RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
+    RETURN_NOT_OK(appendable->Append(chunk.data()));
     VLOG_WITH_PREFIX(3)
-        << "resp size: " << resp.ByteSize() << ", chunk size: " << resp.chunk().data().size();
-
-    if (offset + resp.chunk().data().size() == resp.chunk().total_data_length()) {
-      done = true;
+        << "resp size: " << fetch.resp.ByteSize() << ", chunk size: " << chunk.data().size();
+    rate_limiter->UpdateDataSizeAndMaybeSleep(fetch.resp.ByteSize());
+
+    total_data_length = chunk.total_data_length();
+    const uint64_t fetch_end = fetch.offset + fetch.length;
+    const size_t chunk_size = chunk.data().size();
+    offset += chunk_size;
+    in_flight.pop_front();
+
+    if (offset < total_data_length && offset < fetch_end) {
+      // The sender could return less than requested, e.g. because of its own rate limit.
+      // The rest of the requested range goes before the chunks that are already in flight.
+      start_fetch(offset, static_cast<int32_t>(fetch_end - offset), /* front= */ true);
     }
-    offset += resp.chunk().data().size();
+    while (in_flight.size() < max_in_flight && next_fetch_offset < total_data_length) {
+      start_fetch(next_fetch_offset, max_length, /* front= */ false);
+      next_fetch_offset += max_length;
+    }
+
     if (FLAGS_bytes_remote_bootstrap_durable_write_mb != 0) {
-      periodic_sync_unsynced_bytes += resp.chunk().data().size();
+      periodic_sync_unsynced_bytes += chunk_size;
       if (periodic_sync_unsynced_bytes > FLAGS_bytes_remote_bootstrap_durable_write_mb * 1_MB) {
         RETURN_NOT_OK(appendable->Sync());
         periodic_sync_unsynced_bytes = 0;
@@ -212,6 +362,12 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
     }
   }
 
+  if (offset != total_data_length) {
+    return STATUS_FORMAT(
+        Corruption, "Downloaded $0 bytes of $1 for data item $2", offset, total_data_length,
+        data_id);
+  }
+
   VLOG_WITH_PREFIX(2) << "Transmission rate: " << rate_limiter->GetRate();
 
   return Status::OK();
@@ -14,7 +14,10 @@
 #ifndef YB_TSERVER_REMOTE_BOOTSTRAP_FILE_DOWNLOADER_H
 #define YB_TSERVER_REMOTE_BOOTSTRAP_FILE_DOWNLOADER_H
 
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -45,9 +48,16 @@ class RemoteBootstrapFileDownloader {
       std::shared_ptr<RemoteBootstrapServiceProxy> proxy, std::string session_id,
       MonoDelta session_idle_timeout);
 
+  // Download a single remote file into the specified directory. Files that have the same inode on
+  // the remote side are downloaded once and then hard linked. Could be invoked concurrently.
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
 
+  // Invokes download for each index in [0, count), running up to
+  // remote_bootstrap_max_concurrent_downloads of them in parallel.
+  // Returns the first failure, remaining downloads are not started after it.
+  CHECKED_STATUS ParallelDownload(size_t count, const std::function<Status(size_t)>& download);
+
   // Download a single remote file. The block and WAL implementations delegate
   // to this method when downloading files.
   //
@@ -67,6 +77,9 @@ class RemoteBootstrapFileDownloader {
   }
 
  private:
+  CHECKED_STATUS DoDownloadFile(
+      const tablet::FilePB& file_pb, const std::string& file_path, DataIdPB* data_id);
+
   CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
 
   const std::string& LogPrefix() const {
@@ -81,7 +94,18 @@ class RemoteBootstrapFileDownloader {
   std::shared_ptr<RemoteBootstrapServiceProxy> proxy_;
   std::string session_id_;
   MonoDelta session_idle_timeout_ = MonoDelta::kZero;
-  std::unordered_map<uint64_t, std::string> inode2file_;
+
+  struct InodeFile {
+    std::string path;
+
+    // Whether the file is completely downloaded, i.e. could be linked.
+    bool ready = false;
+  };
+
+  // Protects inode2file_.
+  std::mutex mutex_;
+  std::condition_variable inode_cond_;
+  std::unordered_map<uint64_t, InodeFile> inode2file_;
 };
 
 CHECKED_STATUS UnwindRemoteError(const Status& status, const rpc::RpcController& controller);
@@ -20,6 +20,8 @@
 
 using std::shared_ptr;
 
+DECLARE_int32(remote_bootstrap_max_concurrent_downloads);
+
 namespace yb {
 namespace tserver {
 
@@ -31,6 +33,8 @@ using tablet::TabletStatusListener;
 class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
  public:
   RemoteBootstrapRocksDBClientTest() : RemoteBootstrapClientTest(YQL_TABLE_TYPE) {}
+
+  void TestDownloadRocksDBFiles();
 };
 
 // Basic begin / end remote bootstrap session.
@@ -40,8 +44,7 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestBeginEndSession) {
   ASSERT_OK(client_->Finish());
 }
 
-// Basic RocksDB files download unit test.
-TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+void RemoteBootstrapRocksDBClientTest::TestDownloadRocksDBFiles() {
   TabletStatusListener listener(meta_);
   ASSERT_OK(client_->FetchAll(&listener));
   auto tablet_peer_checkpoint_dir =
@@ -81,5 +84,15 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   }
 }
 
+// Basic RocksDB files download unit test.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+  TestDownloadRocksDBFiles();
+}
+
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesSequentially) {
+  FLAGS_remote_bootstrap_max_concurrent_downloads = 1;
+  TestDownloadRocksDBFiles();
+}
+
 } // namespace tserver
 } // namespace yb
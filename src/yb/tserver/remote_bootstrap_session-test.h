@@ -170,6 +170,7 @@ class RemoteBootstrapTest : public YBTabletTest {
         raft_pool_.get(),
         tablet_prepare_pool_.get(),
         nullptr /* retryable_requests */,
+        nullptr /* multi_raft_manager */,
         yb::OpId() /* split_op_id */));
     consensus::ConsensusBootstrapInfo boot_info;
     ASSERT_OK(tablet_peer_->Start(boot_info));
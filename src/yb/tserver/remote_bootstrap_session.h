@@ -128,11 +128,15 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   // Change the peer's role to VOTER.
   CHECKED_STATUS ChangeRole();
 
-  void InitRateLimiter();
+  void InitRateLimiter() REQUIRES(rate_limiter_mutex_);
 
   void EnsureRateLimiterIsInitialized();
 
-  RateLimiter& rate_limiter() { return rate_limiter_; }
+  // Rate limiter is shared by all concurrent FetchData requests of the session, so it is accessed
+  // only through the following methods.
+  uint64_t GetMaxSizeForNextTransmission();
+
+  void UpdateDataSizeAndMaybeSleep(uint64_t data_size);
 
   static const std::string kCheckpointsDir;
 
@@ -217,7 +221,8 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   MonoTime start_time_;
 
   // Used to limit the transmission rate.
-  RateLimiter rate_limiter_;
+  std::mutex rate_limiter_mutex_;
+  RateLimiter rate_limiter_ GUARDED_BY(rate_limiter_mutex_);
 
   // Pointer to the counter for of the number of sessions in RemoteBootstrapService. Used to
   // calculate the rate for the rate limiter.
@@ -81,20 +81,24 @@ Status RemoteBootstrapSnapshotsComponent::Download() {
                         Format("Failed to create & sync top snapshots directory $0",
                                top_snapshots_dir));
 
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::SNAPSHOT_FILE);
+  // Create all snapshot directories before starting parallel downloads.
   for (auto const& file_pb : kv_store.snapshot_files()) {
     const string snapshot_dir = JoinPathSegments(top_snapshots_dir, file_pb.snapshot_id());
 
     RETURN_NOT_OK_PREPEND(fs_manager().CreateDirIfMissingAndSync(snapshot_dir),
                           Format("Failed to create & sync snapshot directory $0", snapshot_dir));
-
-    const std::string file_path = JoinPathSegments(snapshot_dir, file_pb.file().name());
-    data_id.set_snapshot_id(file_pb.snapshot_id());
-    RETURN_NOT_OK(downloader_.DownloadFile(file_pb.file(), snapshot_dir, &data_id));
   }
 
-  return Status::OK();
+  const auto& files = kv_store.snapshot_files();
+  return downloader_.ParallelDownload(
+      files.size(), [this, &files, &top_snapshots_dir](size_t idx) {
+    const auto& file_pb = files.Get(idx);
+    DataIdPB data_id;
+    data_id.set_type(DataIdPB::SNAPSHOT_FILE);
+    data_id.set_snapshot_id(file_pb.snapshot_id());
+    return downloader_.DownloadFile(
+        file_pb.file(), JoinPathSegments(top_snapshots_dir, file_pb.snapshot_id()), &data_id);
+  });
 }
 
 Status RemoteBootstrapSnapshotsSource::Init() {
@@ -28,6 +28,7 @@
 #include "yb/tserver/tserver_error.h"
 
 #include "yb/util/logging.h"
+#include "yb/util/wait_state.h"
 
 namespace yb {
 namespace tserver {
@@ -127,6 +128,7 @@ Result<std::shared_ptr<tablet::TabletPeer>> LookupTabletPeerOrRespond(
     const string& tablet_id,
     RespClass* resp,
     rpc::RpcContext* context) {
+  SetWaitStateTablet(tablet_id);
   std::shared_ptr<tablet::TabletPeer> result;
   Status status = tablet_manager->GetTabletPeer(tablet_id, &result);
   if (PREDICT_FALSE(!status.ok())) {
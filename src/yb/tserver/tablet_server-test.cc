@@ -31,6 +31,9 @@
 //
 
 #include "yb/consensus/log-test-base.h"
+#include "yb/consensus/consensus.proxy.h"
+#include "yb/consensus/consensus_peers.h"
+#include "yb/consensus/multi_raft_batcher.h"
 
 #include "yb/common/ql_value.h"
 
@@ -54,6 +57,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver_admin.proxy.h"
 
+#include "yb/util/async_util.h"
 #include "yb/util/crc.h"
 #include "yb/util/curl_util.h"
 #include "yb/util/url-coding.h"
@@ -84,11 +88,16 @@ DECLARE_int32(metrics_retirement_age_ms);
 DECLARE_string(block_manager);
 DECLARE_string(rpc_bind_addresses);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_uint64(multi_raft_batch_size);
+DECLARE_uint64(multi_raft_heartbeat_window_ms);
 
 // Declare these metrics prototypes for simpler unit testing of their behavior.
 METRIC_DECLARE_counter(rows_inserted);
 METRIC_DECLARE_counter(rows_updated);
 METRIC_DECLARE_counter(rows_deleted);
+METRIC_DECLARE_histogram(handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus);
+METRIC_DECLARE_counter(rpc_consensus_updates_sent_individually);
+METRIC_DECLARE_counter(rpc_consensus_updates_sent_batched);
 
 namespace yb {
 namespace tserver {
@@ -895,5 +904,125 @@ TEST_F(TabletServerTest, TestChecksumScan) {
   ASSERT_EQ(first_crc, resp.checksum());
 }
 
+namespace {
+
+// Heartbeat from a leader of an older term. The replica rejects it without changing its state,
+// but still responds to it.
+consensus::ConsensusRequestPB StaleHeartbeat(
+    const std::string& dest_uuid, const std::string& tablet_id) {
+  consensus::ConsensusRequestPB req;
+  req.set_dest_uuid(dest_uuid);
+  req.set_tablet_id(tablet_id);
+  req.set_caller_uuid("stale-leader");
+  req.set_caller_term(0);
+  return req;
+}
+
+uint64_t MultiRaftUpdateConsensusCalls(MiniTabletServer* server) {
+  return METRIC_handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus.Instantiate(
+      server->server()->metric_entity())->TotalCount();
+}
+
+int64_t CounterValue(MiniTabletServer* server, CounterPrototype* prototype) {
+  return prototype->Instantiate(server->server()->metric_entity())->value();
+}
+
+} // namespace
+
+TEST_F(TabletServerTest, TestMultiRaftUpdateConsensusPartialFailure) {
+  const auto& uuid = mini_server_->server()->fs_manager()->uuid();
+
+  consensus::MultiRaftConsensusRequestPB req;
+  *req.add_consensus_request() = StaleHeartbeat(uuid, kTabletId);
+  *req.add_consensus_request() = StaleHeartbeat(uuid, "no-such-tablet");
+  *req.add_consensus_request() = StaleHeartbeat("wrong-uuid", kTabletId);
+  *req.add_consensus_request() = StaleHeartbeat(uuid, kTabletId);
+
+  consensus::MultiRaftConsensusResponsePB resp;
+  RpcController controller;
+  ASSERT_OK(consensus_proxy_->MultiRaftUpdateConsensus(req, &resp, &controller));
+  ASSERT_EQ(req.consensus_request_size(), resp.consensus_response_size());
+
+  // Failure of one tablet does not affect the responses of the others.
+  for (int i : {0, 3}) {
+    const auto& tablet_resp = resp.consensus_response(i);
+    SCOPED_TRACE(tablet_resp.ShortDebugString());
+    ASSERT_FALSE(tablet_resp.has_error());
+    ASSERT_EQ(uuid, tablet_resp.responder_uuid());
+    ASSERT_EQ(consensus::ConsensusErrorPB::INVALID_TERM,
+              tablet_resp.status().error().code());
+  }
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.consensus_response(1).error().code());
+  ASSERT_EQ(TabletServerErrorPB::WRONG_SERVER_UUID, resp.consensus_response(2).error().code());
+}
+
+TEST_F(TabletServerTest, TestMultiRaftHeartbeatBatcher) {
+  constexpr int kNumHeartbeats = 8;
+  FLAGS_multi_raft_batch_size = kNumHeartbeats;
+  // Large enough for the batch to be sent because of its size only.
+  FLAGS_multi_raft_heartbeat_window_ms = 60000;
+
+  const auto& uuid = mini_server_->server()->fs_manager()->uuid();
+  const auto hostport = HostPort::FromBoundEndpoint(mini_server_->bound_rpc_addr());
+  // Send heartbeats from the server itself, the same way its Raft leaders do, so they are counted
+  // in the server metrics.
+  auto* messenger = mini_server_->server()->messenger();
+  auto& proxy_cache = mini_server_->server()->proxy_cache();
+  consensus::MultiRaftManager manager(messenger, &proxy_cache);
+  auto batcher = manager.AddOrGetBatcher(hostport);
+  ASSERT_EQ(batcher, manager.AddOrGetBatcher(hostport));
+
+  const auto calls_before = MultiRaftUpdateConsensusCalls(mini_server_.get());
+  const auto individual_before = CounterValue(
+      mini_server_.get(), &METRIC_rpc_consensus_updates_sent_individually);
+  const auto batched_before = CounterValue(
+      mini_server_.get(), &METRIC_rpc_consensus_updates_sent_batched);
+
+  consensus::ConsensusResponsePB responses[kNumHeartbeats];
+  Status statuses[kNumHeartbeats];
+  CountDownLatch latch(kNumHeartbeats);
+  for (int i = 0; i != kNumHeartbeats; ++i) {
+    // The last heartbeat is for a tablet the server does not have.
+    auto req = StaleHeartbeat(uuid, i + 1 == kNumHeartbeats ? "no-such-tablet" : kTabletId);
+    batcher->AddRequestToBatch(req, &responses[i], [&statuses, &latch, i](const Status& s) {
+      statuses[i] = s;
+      latch.CountDown();
+    });
+  }
+  ASSERT_TRUE(latch.WaitFor(MonoDelta::FromSeconds(30)));
+
+  for (int i = 0; i != kNumHeartbeats; ++i) {
+    SCOPED_TRACE(responses[i].ShortDebugString());
+    ASSERT_OK(statuses[i]);
+    if (i + 1 == kNumHeartbeats) {
+      ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, responses[i].error().code());
+    } else {
+      ASSERT_FALSE(responses[i].has_error());
+      ASSERT_EQ(uuid, responses[i].responder_uuid());
+    }
+  }
+  ASSERT_EQ(calls_before + 1, MultiRaftUpdateConsensusCalls(mini_server_.get()));
+  ASSERT_EQ(batched_before + kNumHeartbeats,
+            CounterValue(mini_server_.get(), &METRIC_rpc_consensus_updates_sent_batched));
+  ASSERT_EQ(individual_before,
+            CounterValue(mini_server_.get(), &METRIC_rpc_consensus_updates_sent_individually));
+
+  // Heartbeat of a peer without batcher is sent in its own RPC.
+  consensus::RpcPeerProxy peer_proxy(
+      hostport, std::make_unique<consensus::ConsensusServiceProxy>(&proxy_cache, hostport),
+      nullptr /* multi_raft_batcher */, &messenger->rpc_metrics());
+  const auto heartbeat = StaleHeartbeat(uuid, kTabletId);
+  consensus::ConsensusResponsePB response;
+  RpcController controller;
+  Synchronizer sync;
+  peer_proxy.UpdateHeartbeatAsync(&heartbeat, &response, &controller, sync.AsStdStatusCallback());
+  ASSERT_OK(sync.Wait());
+  ASSERT_EQ(individual_before + 1,
+            CounterValue(mini_server_.get(), &METRIC_rpc_consensus_updates_sent_individually));
+  ASSERT_EQ(batched_before + kNumHeartbeats,
+            CounterValue(mini_server_.get(), &METRIC_rpc_consensus_updates_sent_batched));
+  ASSERT_EQ(calls_before + 1, MultiRaftUpdateConsensusCalls(mini_server_.get()));
+}
+
 } // namespace tserver
 } // namespace yb
@@ -51,6 +51,7 @@
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tserver/heartbeater_factory.h"
 #include "yb/tserver/metrics_snapshotter.h"
+#include "yb/tserver/pg_shared_exchange_server.h"
 #include "yb/tserver/tablet_service.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver-path-handlers.h"
@@ -120,6 +121,17 @@ DEFINE_int32(cql_proxy_webserver_port, 0, "Webserver port for CQL proxy");
 
 DEFINE_string(pgsql_proxy_bind_address, "", "Address to bind the PostgreSQL proxy to");
 DECLARE_int32(pgsql_proxy_webserver_port);
+DECLARE_bool(ysql_use_shared_exchange);
+
+DEFINE_int32(ysql_shared_exchange_slots, 256,
+             "Number of postgres backends that could send reads to the tablet server through "
+             "shared memory at the same time, others use RPC.");
+TAG_FLAG(ysql_shared_exchange_slots, advanced);
+
+DEFINE_int32(ysql_shared_exchange_buffer_size, 64 * 1024,
+             "Size of the shared memory buffer of each backend, used for reads sent through shared "
+             "memory. Larger responses are passed in several parts.");
+TAG_FLAG(ysql_shared_exchange_buffer_size, advanced);
 
 DEFINE_int64(inbound_rpc_memory_limit, 0, "Inbound RPC memory limit");
 
@@ -145,6 +157,12 @@ TabletServer::TabletServer(const TabletServerOptions& opts)
   SetConnectionContextFactory(rpc::CreateConnectionContextFactory<rpc::YBInboundConnectionContext>(
       FLAGS_inbound_rpc_memory_limit, mem_tracker()));
 
+  if (FLAGS_ysql_use_shared_exchange) {
+    pg_shared_exchange_segment_ = std::make_unique<PgSharedExchangeSegment>(CHECK_RESULT(
+        PgSharedExchangeSegment::Create(FLAGS_ysql_shared_exchange_slots,
+                                        FLAGS_ysql_shared_exchange_buffer_size)));
+  }
+
   LOG(INFO) << "yb::tserver::TabletServer created at " << this;
   LOG(INFO) << "yb::tserver::TSTabletManager created at " << tablet_manager_.get();
 }
@@ -326,6 +344,17 @@ Status TabletServer::Start() {
     proxy_ = std::make_shared<TabletServerServiceProxy>(proxy_cache_.get(), HostPort());
   }
 
+  if (pg_shared_exchange_segment_) {
+    // Reads from shared memory are always dispatched locally, regardless of
+    // enable_direct_local_tablet_server_call.
+    auto local_proxy = proxy_ ? proxy_ : std::make_shared<TabletServerServiceProxy>(
+        proxy_cache_.get(), HostPort());
+    pg_shared_exchange_server_ = std::make_unique<PgSharedExchangeServer>(
+        pg_shared_exchange_segment_->get(), tablet_manager_.get(), std::move(local_proxy),
+        clock());
+    RETURN_NOT_OK(pg_shared_exchange_server_->Start());
+  }
+
   RETURN_NOT_OK(heartbeater_->Start());
 
   if (FLAGS_tserver_enable_metrics_snapshotter) {
@@ -351,6 +380,10 @@ void TabletServer::Shutdown() {
       WARN_NOT_OK(metrics_snapshotter_->Stop(), "Failed to stop TS Metrics Snapshotter thread");
     }
 
+    if (pg_shared_exchange_server_) {
+      pg_shared_exchange_server_->Shutdown();
+    }
+
     {
       std::lock_guard<simple_spinlock> l(lock_);
       tablet_server_service_ = nullptr;
@@ -458,6 +491,10 @@ int TabletServer::GetSharedMemoryFd() {
   return shared_object_.GetFd();
 }
 
+int TabletServer::GetSharedExchangeFd() {
+  return pg_shared_exchange_segment_ ? pg_shared_exchange_segment_->GetFd() : -1;
+}
+
 void TabletServer::SetYSQLCatalogVersion(uint64_t new_version) {
   std::lock_guard<simple_spinlock> l(lock_);
   if (new_version > ysql_catalog_version_) {
@@ -68,6 +68,7 @@ constexpr const char* const kTcMallocMaxThreadCacheBytes = "tcmalloc.max_total_t
 
 class Heartbeater;
 class MetricsSnapshotter;
+class PgSharedExchangeServer;
 class TabletServerPathHandlers;
 class TSTabletManager;
 
@@ -188,6 +189,10 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   // Returns the file descriptor of this tablet server's shared memory segment.
   int GetSharedMemoryFd();
 
+  // File descriptor of the shared memory segment with exchanges of local postgres backends, -1 if
+  // the shared exchange is disabled.
+  int GetSharedExchangeFd();
+
   // Currently only used by cdc.
   virtual int32_t cluster_config_version() const {
     return std::numeric_limits<int32_t>::max();
@@ -263,6 +268,12 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   // Shared memory owned by the tablet server.
   TServerSharedObject shared_object_;
 
+  // Exchanges of local postgres backends, mapped read-write by them, unlike shared_object_.
+  std::unique_ptr<PgSharedExchangeSegment> pg_shared_exchange_segment_;
+
+  // Serves reads sent by local postgres backends through pg_shared_exchange_segment_.
+  std::unique_ptr<PgSharedExchangeServer> pg_shared_exchange_server_;
+
   std::atomic<client::TransactionPool*> transaction_pool_{nullptr};
   std::mutex transaction_pool_mutex_;
   std::unique_ptr<client::TransactionManager> transaction_manager_holder_;
@@ -59,6 +59,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/main_util.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/wait_state.h"
 
 using namespace std::placeholders;
 
@@ -159,6 +160,8 @@ int TabletServerMain(int argc, char** argv) {
 
   LOG(INFO) << "NumCPUs determined to be: " << base::NumCPUs();
 
+  WaitStateSampler::Init();
+
   if (FLAGS_remote_boostrap_rate_limit_bytes_per_sec > 0) {
     LOG(WARNING) << "Flag remote_boostrap_rate_limit_bytes_per_sec has been deprecated. "
                  << "Use remote_bootstrap_rate_limit_bytes_per_sec flag instead";
@@ -209,6 +212,7 @@ int TabletServerMain(int argc, char** argv) {
         server->GetSharedMemoryFd());
     LOG_AND_RETURN_FROM_MAIN_NOT_OK(pg_process_conf_result);
     auto& pg_process_conf = *pg_process_conf_result;
+    pg_process_conf.tserver_shm_exchange_fd = server->GetSharedExchangeFd();
     pg_process_conf.master_addresses = tablet_server_options->master_addresses_flag;
     pg_process_conf.certs_dir = FLAGS_certs_dir.empty()
         ? server::DefaultCertsDir(*server->fs_manager())
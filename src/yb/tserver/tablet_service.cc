@@ -57,6 +57,7 @@
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/escaping.h"
 #include "yb/master/sys_catalog_constants.h"
+#include "yb/rocksdb/memory_monitor.h"
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/tablet/tablet_bootstrap_if.h"
@@ -66,6 +67,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -92,6 +94,7 @@
 #include "yb/util/status_callback.h"
 #include "yb/util/trace.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/tserver/service_util.h"
 
@@ -137,6 +140,8 @@ DEFINE_int32(num_concurrent_backfills_allowed, 8,
 
 DEFINE_test_flag(bool, tserver_noop_read_write, false, "Respond NOOP to read/write.");
 
+DEFINE_test_flag(bool, fail_tablet_split, false, "Respond with error to SplitTablet requests.");
+
 DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from followers, "
              "specify the maximum time a follower can be behind by using the last message received "
              "from the leader. If set to zero, a read can be served by a follower regardless of "
@@ -144,6 +149,11 @@ DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from fo
 TAG_FLAG(max_stale_read_bound_time_ms, evolving);
 TAG_FLAG(max_stale_read_bound_time_ms, runtime);
 
+DEFINE_int32(multi_raft_update_consensus_threads, 8,
+             "Maximum number of threads that apply the requests of a MultiRaftUpdateConsensus "
+             "batch to their tablets in parallel.");
+TAG_FLAG(multi_raft_update_consensus_threads, advanced);
+
 DEFINE_uint64(sst_files_soft_limit, 24,
               "When majority SST files number is greater that this limit, we will start rejecting "
               "part of write requests. The higher the number of SST files, the higher probability "
@@ -155,6 +165,15 @@ DEFINE_uint64(sst_files_hard_limit, 48,
               "requests.");
 TAG_FLAG(sst_files_hard_limit, runtime);
 
+DEFINE_int32(global_memstore_throttling_range_percentage, 20,
+             "When the global memstore usage, not counting memstores that are being flushed, "
+             "exceeds its limit, i.e. flushes are not keeping up with writes, we start rejecting "
+             "part of write requests. The probability of rejection grows with the usage and "
+             "reaches 100% when the usage exceeds the limit by this percentage. 0 disables "
+             "throttling.");
+TAG_FLAG(global_memstore_throttling_range_percentage, advanced);
+TAG_FLAG(global_memstore_throttling_range_percentage, runtime);
+
 DEFINE_uint64(min_rejection_delay_ms, 100, ".");
 TAG_FLAG(min_rejection_delay_ms, runtime);
 
@@ -305,6 +324,15 @@ void AdjustYsqlOperationTransactionality(
   }
 }
 
+bool HasPendingSplitOperation(const TabletPeer& tablet_peer) {
+  for (const auto& driver : tablet_peer.operation_tracker()->GetPendingOperations()) {
+    if (driver->operation_type() == tablet::OperationType::kSplit) {
+      return true;
+    }
+  }
+  return false;
+}
+
 } // namespace
 
 template<class Resp>
@@ -348,6 +376,31 @@ bool TabletServiceImpl::CheckWriteThrottlingOrRespond(
     }
   }
 
+  auto* tablet_manager = server_->tablet_manager();
+  auto* memory_monitor = tablet_manager->memory_monitor();
+  const auto memstore_throttling_range = FLAGS_global_memstore_throttling_range_percentage;
+  if (memory_monitor && memstore_throttling_range > 0 && memory_monitor->limit() > 0) {
+    const auto memstore_limit = memory_monitor->limit();
+    // Usage stays above the limit until the flushes triggered by it complete, so memstores that
+    // are being flushed are not counted.
+    const auto memstore_usage = memory_monitor->memory_usage();
+    const auto memstore_flushing = std::min(
+        memstore_usage, tablet_manager->memstore_flushing_memory());
+    const auto memstore_mutable_usage = memstore_usage - memstore_flushing;
+    if (memstore_mutable_usage >= memstore_limit) {
+      const double memstore_full_delta = memstore_limit * 0.01 * memstore_throttling_range;
+      const double memstore_used_delta = memstore_mutable_usage - memstore_limit;
+      if (memstore_used_delta >= memstore_full_delta * (1 - score)) {
+        tablet->metrics()->global_memstore_rejections->Increment();
+        auto message = Format(
+            "Global memstore limit exceeded $0 (being flushed $1) against $2, score: $3",
+            memstore_mutable_usage, memstore_flushing, memstore_limit, score);
+        return RejectWrite(tablet_peer, message, score + memstore_used_delta / memstore_full_delta,
+                           resp, context);
+      }
+    }
+  }
+
   if (FLAGS_TEST_write_rejection_percentage != 0 &&
       score >= 1.0 - FLAGS_TEST_write_rejection_percentage * 0.01) {
     auto status = Format("TEST: Write request rejected, desired percentage: $0, score: $1",
@@ -1200,6 +1253,32 @@ void TabletServiceAdminImpl::SplitTablet(
     return;
   }
 
+  // Leader is ready, so it has committed an operation of its own term, and SPLIT_OP replicated by
+  // a previous leader is committed as well. Such operation is either applied already, or still
+  // pending. Master relies on these checks to tell whether a split could be rolled back.
+  const auto& tablet_peer = *leader_tablet_peer.peer;
+  if (tablet_peer.tablet_metadata()->tablet_data_state() == tablet::TABLET_DATA_SPLIT) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(AlreadyPresent, "Tablet $0 is already split", req->tablet_id()),
+        TabletServerErrorPB::TABLET_SPLIT, &context);
+    return;
+  }
+  if (HasPendingSplitOperation(tablet_peer)) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(TryAgain, "Split of tablet $0 is in progress", req->tablet_id()),
+        TabletServerErrorPB::ALREADY_IN_PROGRESS, &context);
+    return;
+  }
+
+  if (PREDICT_FALSE(FLAGS_fail_tablet_split)) {
+    SetupErrorAndRespond(
+        resp->mutable_error(), STATUS(IllegalState, "Tablet split failed by test flag"),
+        TabletServerErrorPB::TABLET_SPLIT_REJECTED, &context);
+    return;
+  }
+
   auto state = std::make_unique<tablet::SplitOperationState>(
       leader_tablet_peer.peer->tablet(), leader_tablet_peer.peer->raft_consensus(),
       server_->tablet_manager(), req);
@@ -1963,7 +2042,8 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
         read_context->read_time.local_limit = read_context->safe_ht_to_read;
         return read_context->read_time;
       }
-      result.response.set_rows_data_sidecar(read_context->context->AddRpcSidecar(result.rows_data));
+      result.response.set_rows_data_sidecar(
+          read_context->context->AddRpcSidecar(&result.rows_data));
       read_context->resp->add_pgsql_batch()->Swap(&result.response);
     }
     return ReadHybridTime();
@@ -1980,9 +2060,49 @@ ConsensusServiceImpl::ConsensusServiceImpl(const scoped_refptr<MetricEntity>& me
                                            TabletPeerLookupIf* tablet_manager)
     : ConsensusServiceIf(metric_entity),
       tablet_manager_(tablet_manager) {
+  CHECK_OK(ThreadPoolBuilder("multi-raft-update")
+               .set_max_threads(std::max(FLAGS_multi_raft_update_consensus_threads, 1))
+               .Build(&multi_raft_update_pool_));
 }
 
 ConsensusServiceImpl::~ConsensusServiceImpl() {
+  multi_raft_update_pool_->Shutdown();
+}
+
+Status ConsensusServiceImpl::DoUpdateConsensus(
+    ConsensusRequestPB* req, ConsensusResponsePB* resp, CoarseTimePoint deadline) {
+  SetWaitStateTablet(req->tablet_id());
+  TabletPeerPtr tablet_peer;
+  Status s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    if (s.IsServiceUnavailable()) {
+      return s;
+    }
+    return s.CloneAndAddErrorCode(TabletServerError(TabletServerErrorPB::TABLET_NOT_FOUND));
+  }
+
+  tablet::RaftGroupStatePB state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    return STATUS(IllegalState, "Tablet not RUNNING", tablet::RaftGroupStateError(state))
+        .CloneAndAddErrorCode(TabletServerError(TabletServerErrorPB::TABLET_NOT_RUNNING));
+  }
+
+  // Submit the update directly to the TabletPeer's Consensus instance.
+  auto consensus = tablet_peer->shared_consensus();
+  if (!consensus) {
+    return STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running",
+                  TabletServerError(TabletServerErrorPB::TABLET_NOT_RUNNING));
+  }
+
+  RETURN_NOT_OK(consensus->Update(req, resp, deadline));
+
+  auto tablet = tablet_peer->shared_tablet();
+  if (tablet) {
+    resp->set_num_sst_files(tablet->GetCurrentVersionNumSSTFiles());
+  }
+
+  resp->set_propagated_hybrid_time(tablet_peer->clock().Now().ToUint64());
+  return Status::OK();
 }
 
 void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
@@ -1992,17 +2112,11 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   if (!CheckUuidMatchOrRespond(tablet_manager_, "UpdateConsensus", req, resp, &context)) {
     return;
   }
-  auto tablet_peer = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
-      tablet_manager_, req->tablet_id(), resp, &context));
-
-  // Submit the update directly to the TabletPeer's Consensus instance.
-  shared_ptr<Consensus> consensus;
-  if (!GetConsensusOrRespond(tablet_peer, resp, &context, &consensus)) return;
 
   // Unfortunately, we have to use const_cast here, because the protobuf-generated interface only
   // gives us a const request, but we need to be able to move messages out of the request for
   // efficiency.
-  Status s = consensus->Update(
+  Status s = DoUpdateConsensus(
       const_cast<ConsensusRequestPB*>(req), resp, context.GetClientDeadline());
   if (PREDICT_FALSE(!s.ok())) {
     // Clear the response first, since a partially-filled response could
@@ -2010,19 +2124,76 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
     // in embedded optional messages.
     resp->Clear();
 
-    SetupErrorAndRespond(resp->mutable_error(), s,
-                         TabletServerErrorPB::UNKNOWN_ERROR,
-                         &context);
+    SetupErrorAndRespond(resp->mutable_error(), s, &context);
     return;
   }
 
-  auto tablet = tablet_peer->shared_tablet();
-  if (tablet) {
-    resp->set_num_sst_files(tablet->GetCurrentVersionNumSSTFiles());
+  context.RespondSuccess();
+}
+
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
+  const auto num_requests = req->consensus_request_size();
+  for (int i = 0; i != num_requests; ++i) {
+    resp->add_consensus_response();
+  }
+  if (num_requests == 0) {
+    context.RespondSuccess();
+    return;
   }
 
-  resp->set_propagated_hybrid_time(tablet_peer->clock().Now().ToUint64());
-  context.RespondSuccess();
+  // Requests of different tablets are independent, so they are applied in parallel, and the RPC
+  // is responded to when the last of them is done.
+  struct BatchState {
+    BatchState(rpc::RpcContext context_, int pending_)
+        : context(std::move(context_)), pending(pending_) {}
+
+    rpc::RpcContext context;
+    std::atomic<int> pending;
+  };
+  auto batch_state = std::make_shared<BatchState>(std::move(context), num_requests);
+  const auto deadline = batch_state->context.GetClientDeadline();
+
+  // As in UpdateConsensus, we need to be able to move messages out of the request.
+  auto* mutable_req = const_cast<consensus::MultiRaftConsensusRequestPB*>(req);
+  for (int i = 0; i != num_requests; ++i) {
+    auto* consensus_req = mutable_req->mutable_consensus_request(i);
+    auto* consensus_resp = resp->mutable_consensus_response(i);
+    auto task = [this, consensus_req, consensus_resp, deadline, batch_state] {
+      UpdateConsensusInBatch(consensus_req, consensus_resp, deadline);
+      if (--batch_state->pending == 0) {
+        batch_state->context.RespondSuccess();
+      }
+    };
+    // The last request is applied on this thread, there is nothing else for it to do meanwhile.
+    if (i + 1 == num_requests || !multi_raft_update_pool_->SubmitFunc(task).ok()) {
+      task();
+    }
+  }
+}
+
+void ConsensusServiceImpl::UpdateConsensusInBatch(
+    ConsensusRequestPB* req, ConsensusResponsePB* resp, CoarseTimePoint deadline) {
+  const string& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  Status s;
+  if (PREDICT_FALSE(!req->dest_uuid().empty() && req->dest_uuid() != local_uuid)) {
+    s = STATUS_FORMAT(InvalidArgument,
+                      "MultiRaftUpdateConsensus: Wrong destination UUID requested. "
+                      "Local UUID: $0. Requested UUID: $1", local_uuid, req->dest_uuid())
+        .CloneAndAddErrorCode(TabletServerError(TabletServerErrorPB::WRONG_SERVER_UUID));
+  } else {
+    s = DoUpdateConsensus(req, resp, deadline);
+  }
+  if (PREDICT_FALSE(!s.ok())) {
+    resp->Clear();
+    auto ts_error = TabletServerError::FromStatus(s);
+    StatusToPB(s, resp->mutable_error()->mutable_status());
+    resp->mutable_error()->set_code(
+        ts_error ? ts_error->value() : TabletServerErrorPB::UNKNOWN_ERROR);
+  }
 }
 
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
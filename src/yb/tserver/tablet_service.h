@@ -51,6 +51,7 @@ namespace yb {
 class Schema;
 class Status;
 class HybridTime;
+class ThreadPool;
 
 namespace tserver {
 
@@ -258,6 +259,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB *req,
+                                        consensus::MultiRaftConsensusResponsePB *resp,
+                                        rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -295,7 +300,23 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                     rpc::RpcContext context) override;
 
  private:
+  // Applies a single UpdateConsensus request to its tablet. Shared by UpdateConsensus and
+  // MultiRaftUpdateConsensus. The returned error status carries the TabletServerErrorPB code to
+  // report to the caller.
+  CHECKED_STATUS DoUpdateConsensus(consensus::ConsensusRequestPB* req,
+                                   consensus::ConsensusResponsePB* resp,
+                                   CoarseTimePoint deadline);
+
+  // Handles a single request of a MultiRaftUpdateConsensus batch. Failures are reported in 'resp'
+  // the same way UpdateConsensus reports them, but without responding to the RPC.
+  void UpdateConsensusInBatch(consensus::ConsensusRequestPB* req,
+                              consensus::ConsensusResponsePB* resp,
+                              CoarseTimePoint deadline);
+
   TabletPeerLookupIf* tablet_manager_;
+
+  // Applies the requests of MultiRaftUpdateConsensus batches in parallel.
+  std::unique_ptr<ThreadPool> multi_raft_update_pool_;
 };
 
 }  // namespace tserver
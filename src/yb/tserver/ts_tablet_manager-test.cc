@@ -50,6 +50,7 @@
 #include "yb/tserver/tablet_server.h"
 #include "yb/util/test_util.h"
 #include "yb/util/format.h"
+#include "yb/util/size_literals.h"
 
 #define ASSERT_REPORT_HAS_UPDATED_TABLET(report, tablet_id) \
   ASSERT_NO_FATALS(AssertReportHasUpdatedTablet(report, tablet_id))
@@ -58,6 +59,9 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_double(memstore_flush_age_weight);
+DECLARE_double(memstore_flush_size_weight);
+DECLARE_double(memstore_flush_wal_weight);
 
 namespace yb {
 namespace tserver {
@@ -298,6 +302,40 @@ TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   }
 }
 
+TEST(MemstoreFlushSelectionTest, PickMemstoreToFlush) {
+  FlagSaver flag_saver;
+
+  const auto now = HybridTime::FromMicros(10000000);
+  auto make_candidate = [now](MicrosTime age, size_t memstore_size, uint64_t wal_size) {
+    MemstoreFlushCandidate candidate;
+    candidate.oldest_write = HybridTime::FromMicros(now.GetPhysicalValueMicros() - age);
+    candidate.memstore_size = memstore_size;
+    candidate.wal_size = wal_size;
+    return candidate;
+  };
+
+  std::vector<MemstoreFlushCandidate> candidates = {
+    make_candidate(/* age= */ 5000000, /* memstore_size= */ 1_KB, /* wal_size= */ 1_MB),
+    make_candidate(/* age= */ 1000000, /* memstore_size= */ 64_MB, /* wal_size= */ 4_MB),
+    make_candidate(/* age= */ 2000000, /* memstore_size= */ 2_MB, /* wal_size= */ 512_MB),
+  };
+
+  // By default the tablet with the oldest write is flushed.
+  ASSERT_EQ(0, PickMemstoreToFlush(candidates, now));
+
+  FLAGS_memstore_flush_size_weight = 2.0;
+  ASSERT_EQ(1, PickMemstoreToFlush(candidates, now));
+
+  FLAGS_memstore_flush_size_weight = 0.0;
+  FLAGS_memstore_flush_wal_weight = 2.0;
+  ASSERT_EQ(2, PickMemstoreToFlush(candidates, now));
+
+  // On equal scores the tablet with the oldest write is preferred.
+  FLAGS_memstore_flush_age_weight = 0.0;
+  FLAGS_memstore_flush_wal_weight = 0.0;
+  ASSERT_EQ(0, PickMemstoreToFlush(candidates, now));
+}
+
 static void AssertMonotonicReportSeqno(int64_t* report_seqno,
                                        const TabletReportPB &report) {
   ASSERT_LT(*report_seqno, report.sequence_number());
@@ -50,6 +50,7 @@
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/consensus/retryable_requests.h"
@@ -124,6 +125,11 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_string(db_block_cache_type, "lru",
+              "Eviction policy of the block cache: lru or clock. The clock cache does not take a "
+              "mutex on cache hits, so it scales better with many concurrent readers.");
+TAG_FLAG(db_block_cache_type, advanced);
+
 DEFINE_bool(enable_log_cache_gc, true,
             "Set to true to enable log cache garbage collector.");
 
@@ -183,6 +189,26 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_double(memstore_flush_age_weight, 1.0,
+              "Weight of the oldest memstore write age, when selecting the tablet to flush after "
+              "the global memstore limit is reached.");
+TAG_FLAG(memstore_flush_age_weight, advanced);
+TAG_FLAG(memstore_flush_age_weight, runtime);
+
+DEFINE_double(memstore_flush_size_weight, 0.0,
+              "Weight of the memstore size, when selecting the tablet to flush after the global "
+              "memstore limit is reached. Prefers flushing large memstores over producing tiny "
+              "SST files.");
+TAG_FLAG(memstore_flush_size_weight, advanced);
+TAG_FLAG(memstore_flush_size_weight, runtime);
+
+DEFINE_double(memstore_flush_wal_weight, 0.0,
+              "Weight of the WAL size, when selecting the tablet to flush after the global "
+              "memstore limit is reached. Prefers flushing tablets with large WAL, that is "
+              "usually retained by their memstores.");
+TAG_FLAG(memstore_flush_wal_weight, advanced);
+TAG_FLAG(memstore_flush_wal_weight, runtime);
+
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
              "This defaults to -1 for system auto-generated default, which would use "
@@ -292,57 +318,142 @@ using tablet::TabletPeerPtr;
 using tablet::TabletStatusListener;
 using tablet::TabletStatusPB;
 
+size_t PickMemstoreToFlush(const std::vector<MemstoreFlushCandidate>& candidates, HybridTime now) {
+  const auto now_micros = now.GetPhysicalValueMicros();
+  auto age = [now_micros](const MemstoreFlushCandidate& candidate) {
+    const auto micros = candidate.oldest_write.GetPhysicalValueMicros();
+    return now_micros > micros ? now_micros - micros : 0;
+  };
+
+  MicrosTime max_age = 0;
+  size_t max_memstore_size = 0;
+  uint64_t max_wal_size = 0;
+  for (const auto& candidate : candidates) {
+    max_age = std::max(max_age, age(candidate));
+    max_memstore_size = std::max(max_memstore_size, candidate.memstore_size);
+    max_wal_size = std::max(max_wal_size, candidate.wal_size);
+  }
+
+  auto normalize = [](double value, double max) {
+    return max > 0 ? value / max : 0.0;
+  };
+  const auto age_weight = FLAGS_memstore_flush_age_weight;
+  const auto size_weight = FLAGS_memstore_flush_size_weight;
+  const auto wal_weight = FLAGS_memstore_flush_wal_weight;
+
+  size_t result = 0;
+  double best_score = -1.0;
+  for (size_t i = 0; i != candidates.size(); ++i) {
+    const auto& candidate = candidates[i];
+    const auto score =
+        age_weight * normalize(age(candidate), max_age) +
+        size_weight * normalize(candidate.memstore_size, max_memstore_size) +
+        wal_weight * normalize(candidate.wal_size, max_wal_size);
+    // On equal score prefer the tablet with the oldest write.
+    if (score > best_score ||
+        (score == best_score && candidate.oldest_write < candidates[result].oldest_write)) {
+      best_score = score;
+      result = i;
+    }
+  }
+  return result;
+}
+
 // Only called from the background task to ensure it's synchronized
 void TSTabletManager::MaybeFlushTablet() {
-  int iteration = 0;
-  while (memory_monitor()->Exceeded() ||
-         (iteration++ == 0 && FLAGS_pretend_memory_exceeded_enforce_flush)) {
-    YB_LOG_EVERY_N_SECS(INFO, 5) << Format("Memstore global limit of $0 bytes reached, looking for "
-                                           "tablet to flush", memory_monitor()->limit());
-    auto flush_tick = rocksdb::FlushTick();
-    TabletPeerPtr tablet_to_flush = TabletToFlush();
+  if (!memory_monitor()->Exceeded() && !FLAGS_pretend_memory_exceeded_enforce_flush) {
+    memstore_flushing_memory_.store(0, std::memory_order_release);
+    return;
+  }
+
+  YB_LOG_EVERY_N_SECS(INFO, 5) << Format("Memstore global limit of $0 bytes reached, looking for "
+                                         "tablet to flush", memory_monitor()->limit());
+
+  // Memory is released only when a flush completes, so memory of the memstores that are being
+  // flushed is not counted, otherwise we would flush every tablet while the first flushes are
+  // still in progress.
+  size_t flushing_memory = 0;
+  auto candidates = MemstoreFlushCandidates(&flushing_memory);
+  const auto now = server_->clock()->Now();
+  auto flush_tick = rocksdb::FlushTick();
+
+  for (int iteration = 0; !candidates.empty(); ++iteration) {
+    const auto memory_usage = memory_monitor()->memory_usage();
+    const auto limit = memory_monitor()->limit();
+    // When memory exceeding is pretended, one tablet is flushed regardless of memory usage.
+    if ((limit == 0 || memory_usage < limit + flushing_memory) &&
+        (iteration != 0 || !FLAGS_pretend_memory_exceeded_enforce_flush)) {
+      break;
+    }
+
+    const auto idx = PickMemstoreToFlush(candidates, now);
+    auto candidate = std::move(candidates[idx]);
+    candidates.erase(candidates.begin() + idx);
+    flushing_memory += candidate.memstore_size;
+
     // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
     // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
     // will not happen often, but should be fixed.
-    if (tablet_to_flush) {
-      LOG(INFO)
-          << TabletLogPrefix(tablet_to_flush->tablet_id())
-          << "Flushing tablet with oldest memstore write at "
-          << tablet_to_flush->tablet()->OldestMutableMemtableWriteHybridTime();
-      WARN_NOT_OK(
-          tablet_to_flush->tablet()->Flush(
-              tablet::FlushMode::kAsync, tablet::FlushFlags::kAll, flush_tick),
-          Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
-      for (auto listener : TEST_listeners) {
-        listener->StartedFlush(tablet_to_flush->tablet_id());
-      }
+    const auto& tablet_to_flush = candidate.tablet_peer;
+    auto tablet = tablet_to_flush->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    LOG(INFO)
+        << TabletLogPrefix(tablet_to_flush->tablet_id())
+        << "Flushing tablet with oldest memstore write at " << candidate.oldest_write
+        << ", memstore size: " << candidate.memstore_size << ", WAL size: " << candidate.wal_size
+        << ", global memstore usage: " << memory_usage << ", being flushed: "
+        << flushing_memory - candidate.memstore_size;
+    WARN_NOT_OK(
+        tablet->Flush(tablet::FlushMode::kAsync, tablet::FlushFlags::kAll, flush_tick),
+        Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
+    for (auto listener : TEST_listeners) {
+      listener->StartedFlush(tablet_to_flush->tablet_id());
     }
   }
+
+  memstore_flushing_memory_.store(flushing_memory, std::memory_order_release);
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all tablet memstores are
-// empty or about to flush.
-TabletPeerPtr TSTabletManager::TabletToFlush() {
+std::vector<MemstoreFlushCandidate> TSTabletManager::MemstoreFlushCandidates(
+    size_t* flushing_memory) {
+  std::vector<MemstoreFlushCandidate> result;
   SharedLock<RWMutex> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
-  TabletPeerPtr tablet_to_flush;
   for (const TabletMap::value_type& entry : tablet_map_) {
     const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
-      const auto ht = tablet->OldestMutableMemtableWriteHybridTime();
-      if (ht.ok()) {
-        if (*ht < oldest_write_in_memstores) {
-          oldest_write_in_memstores = *ht;
-          tablet_to_flush = entry.second;
-        }
-      } else {
-        YB_LOG_EVERY_N_SECS(WARNING, 5) << Format(
-            "Failed to get oldest mutable memtable write ht for tablet $0: $1",
-            tablet->tablet_id(), ht.status());
-      }
+    if (!tablet) {
+      continue;
+    }
+    const auto usage = tablet->GetMemTableMemoryUsage();
+    if (!usage.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 5) << Format(
+          "Failed to get memtable memory usage for tablet $0: $1",
+          tablet->tablet_id(), usage.status());
+      continue;
     }
+    *flushing_memory += usage->immutable;
+
+    const auto ht = tablet->OldestMutableMemtableWriteHybridTime();
+    if (!ht.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 5) << Format(
+          "Failed to get oldest mutable memtable write ht for tablet $0: $1",
+          tablet->tablet_id(), ht.status());
+      continue;
+    }
+    if (*ht == HybridTime::kMax) {
+      // Mutable memstore is empty.
+      continue;
+    }
+
+    MemstoreFlushCandidate candidate;
+    candidate.tablet_peer = entry.second;
+    candidate.oldest_write = *ht;
+    candidate.memstore_size = usage->active;
+    candidate.wal_size = entry.second->log_available() ? entry.second->log()->OnDiskSize() : 0;
+    result.push_back(std::move(candidate));
   }
-  return tablet_to_flush;
+  return result;
 }
 
 namespace {
@@ -448,8 +559,15 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
       block_cache_size_bytes, "BlockBasedTable", server_->mem_tracker());
 
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+    if (FLAGS_db_block_cache_type == "clock") {
+      tablet_options_.block_cache = rocksdb::NewClockCache(block_cache_size_bytes,
+                                                           FLAGS_db_block_cache_num_shard_bits);
+    } else {
+      LOG_IF(DFATAL, FLAGS_db_block_cache_type != "lru")
+          << "Unknown block cache type: " << FLAGS_db_block_cache_type << ", using lru";
+      tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
+                                                         FLAGS_db_block_cache_num_shard_bits);
+    }
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
     block_based_table_gc_ = std::make_shared<LRUCacheGC>(tablet_options_.block_cache);
     block_based_table_mem_tracker_->AddGarbageCollector(block_based_table_gc_);
@@ -500,6 +618,9 @@ Status TSTabletManager::Init() {
       &server_->options(), server_->metric_entity(), server_->mem_tracker(),
       server_->messenger());
 
+  multi_raft_manager_ = std::make_unique<consensus::MultiRaftManager>(
+      server_->messenger(), &server_->proxy_cache());
+
   tablet_options_.env = server_->GetEnv();
   tablet_options_.rocksdb_env = server_->GetRocksDBEnv();
   tablet_options_.listeners = server_->options().listeners;
@@ -1372,6 +1493,7 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
         raft_pool(),
         tablet_prepare_pool(),
         &retryable_requests,
+        multi_raft_manager_.get(),
         yb::OpId::FromPB(bootstrap_info.split_op_id));
 
     if (!s.ok()) {
@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_TS_TABLET_MANAGER_H
 #define YB_TSERVER_TS_TABLET_MANAGER_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -48,6 +49,8 @@
 #include "yb/client/async_initializer.h"
 #include "yb/client/client_fwd.h"
 
+#include "yb/common/hybrid_time.h"
+
 #include "yb/consensus/consensus_fwd.h"
 #include "yb/consensus/metadata.pb.h"
 
@@ -95,6 +98,27 @@ class TsTabletManagerListener {
 
 using rocksdb::MemoryMonitor;
 
+// Memstore state of a tablet, used to select tablets to flush when the global memstore limit is
+// exceeded.
+struct MemstoreFlushCandidate {
+  std::shared_ptr<tablet::TabletPeer> tablet_peer;
+
+  // Hybrid time of the oldest write in the mutable memtables.
+  HybridTime oldest_write;
+
+  // Memory allocated by the mutable memtables, i.e. freed by the flush.
+  size_t memstore_size = 0;
+
+  // On disk size of the tablet WAL. Only a part of it could be retained by the memtables, but it is
+  // used as a cheap estimate of WAL that could be garbage collected after the flush.
+  uint64_t wal_size = 0;
+};
+
+// Returns index of the candidate to flush. Each candidate is scored by the age of its oldest write,
+// its memstore size and its WAL size, normalized by the maximum value across all candidates and
+// weighted by the memstore_flush_*_weight flags.
+size_t PickMemstoreToFlush(const std::vector<MemstoreFlushCandidate>& candidates, HybridTime now);
+
 // Map of tablet id -> transition reason string.
 typedef std::unordered_map<std::string, std::string> TransitionInProgressMap;
 
@@ -301,6 +325,13 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
+  // Memory of memstores that were being flushed, when the memstore limit was last checked by
+  // MaybeFlushTablet. Such memory is released when the flush completes, so it does not mean that
+  // flushes are not keeping up with writes.
+  size_t memstore_flushing_memory() const {
+    return memstore_flushing_memory_.load(std::memory_order_acquire);
+  }
+
   client::YBClient& client();
 
   tablet::TabletOptions* TEST_tablet_options() { return &tablet_options_; }
@@ -424,8 +455,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   CHECKED_STATUS StartSubtabletsSplit(
       const tablet::RaftGroupMetadata& source_tablet_meta, SplitTabletsCreationMetaData* tcmetas);
 
-  // Return the tablet with oldest write still in its memstore
-  std::shared_ptr<tablet::TabletPeer> TabletToFlush();
+  // Returns tablets that have writes in their mutable memstores. Memory of the memstores that are
+  // already being flushed is added to flushing_memory.
+  std::vector<MemstoreFlushCandidate> MemstoreFlushCandidates(size_t* flushing_memory);
 
   TSTabletManagerStatePB state() const {
     SharedLock<RWMutex> lock(lock_);
@@ -509,11 +541,17 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // See memstore_flushing_memory.
+  std::atomic<size_t> memstore_flushing_memory_{0};
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
   boost::optional<yb::client::AsyncClientInitialiser> async_client_init_;
 
+  // Coalesces heartbeats sent by the leaders on this server to the same tablet server.
+  std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
+
   TabletPeers shutting_down_peers_;
 
   std::shared_ptr<GarbageCollector> block_based_table_gc_;
@@ -15,11 +15,13 @@
 
 #include "yb/master/master.pb.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
 
 DEFINE_int32(tserver_heartbeat_metrics_interval_ms, 5000,
              "Interval (in milliseconds) at which tserver sends its metrics in a heartbeat to "
@@ -86,12 +88,55 @@ void TServerMetricsHeartbeatDataProvider::DoAddData(master::TSHeartbeatRequestPB
 
   metrics->set_uptime_seconds(uptime_seconds);
 
+  AddTabletLeaderStats(req, div);
+
   VLOG_WITH_PREFIX(4) << "Read Ops per second: " << rops_per_sec;
   VLOG_WITH_PREFIX(4) << "Write Ops per second: " << wops_per_sec;
   VLOG_WITH_PREFIX(4) << "Total SST File Sizes: "<< total_file_sizes;
   VLOG_WITH_PREFIX(4) << "Uptime seconds: "<< uptime_seconds;
 }
 
+void TServerMetricsHeartbeatDataProvider::AddTabletLeaderStats(
+    master::TSHeartbeatRequestPB* req, double elapsed_seconds) {
+  std::unordered_map<TabletId, TabletState> new_tablets;
+  for (const auto& tablet_peer : server().tablet_manager()->GetTabletPeers()) {
+    if (!tablet_peer ||
+        tablet_peer->LeaderStatus() != consensus::LeaderStatus::LEADER_AND_READY) {
+      continue;
+    }
+    auto tablet = tablet_peer->shared_tablet();
+    if (!tablet || !tablet->metrics() ||
+        tablet->metadata()->tablet_data_state() != tablet::TABLET_DATA_READY) {
+      continue;
+    }
+
+    auto it = tablets_.find(tablet->tablet_id());
+    const bool is_new = it == tablets_.end();
+    auto& state = new_tablets[tablet->tablet_id()];
+    if (!is_new) {
+      state = it->second;
+    }
+    auto prev_state = state;
+    state.reads = tablet->metrics()->read_requests->value();
+    state.writes = tablet->metrics()->write_requests->value();
+
+    auto* stats = req->add_tablet_leader_stats();
+    stats->set_tablet_id(tablet->tablet_id());
+    stats->set_sst_file_size(tablet->GetCurrentVersionSstFilesSize());
+    // Rates are not known for the first heartbeat after this server became leader.
+    if (!is_new && elapsed_seconds > 0) {
+      stats->set_read_ops_per_sec((state.reads - prev_state.reads) / elapsed_seconds);
+      stats->set_write_ops_per_sec((state.writes - prev_state.writes) / elapsed_seconds);
+    }
+    // Split point is calculated by the tablet in background, when its SST files are changed.
+    auto split_hash_code = tablet->split_hash_code();
+    if (split_hash_code) {
+      stats->set_split_hash_code(*split_hash_code);
+    }
+  }
+  tablets_ = std::move(new_tablets);
+}
+
 uint64_t TServerMetricsHeartbeatDataProvider::CalculateUptime() {
   MonoDelta delta = MonoTime::Now().GetDeltaSince(start_time_);
   uint64_t uptime_seconds = static_cast<uint64_t>(delta.ToSeconds());
@@ -15,6 +15,9 @@
 #define YB_TSERVER_TSERVER_METRICS_HEARTBEAT_DATA_PROVIDER_H
 
 #include <memory>
+#include <unordered_map>
+
+#include "yb/common/entity_ids.h"
 
 #include "yb/tserver/heartbeater.h"
 
@@ -30,11 +33,21 @@ class TServerMetricsHeartbeatDataProvider : public PeriodicalHeartbeatDataProvid
 
   uint64_t CalculateUptime();
 
+  void AddTabletLeaderStats(master::TSHeartbeatRequestPB* req, double elapsed_seconds);
+
   MonoTime start_time_;
 
   // Stores the total read and writes ops for computing iops.
   uint64_t prev_reads_ = 0;
   uint64_t prev_writes_ = 0;
+
+  struct TabletState {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+  };
+
+  // State of tablets led by this server, as of the previous heartbeat.
+  std::unordered_map<TabletId, TabletState> tablets_;
 };
 
 } // namespace tserver
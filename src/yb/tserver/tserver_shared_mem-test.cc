@@ -0,0 +1,179 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/tserver/tserver_shared_mem.h"
+
+#include "yb/util/random_util.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace tserver {
+
+class TServerSharedMemTest : public YBTest {
+ protected:
+  static constexpr size_t kNumExchanges = 4;
+  static constexpr size_t kBufferSize = 128;
+
+  void SetUp() override {
+    YBTest::SetUp();
+    server_segment_ = std::make_unique<PgSharedExchangeSegment>(ASSERT_RESULT(
+        PgSharedExchangeSegment::Create(kNumExchanges, kBufferSize)));
+    // Backends map the segment on their own, so use a separate mapping for the client side.
+    client_segment_ = std::make_unique<PgSharedExchangeSegment>(ASSERT_RESULT(
+        PgSharedExchangeSegment::Open(server_segment_->GetFd())));
+  }
+
+  // Serves a single request sent through any exchange, responding with 'response'. Returns the
+  // request.
+  std::string ServeRequest(const std::string& response, bool in_parts) {
+    auto* area = server_segment_->get();
+    uint32_t last_seen = 0;
+    for (;;) {
+      for (size_t i = 0; i != area->num_exchanges(); ++i) {
+        auto& exchange = area->exchange(i);
+        if (!exchange.StartProcessing()) {
+          continue;
+        }
+        auto request = exchange.request().ToBuffer();
+        if (in_parts) {
+          CHECK_OK(exchange.RespondInParts(response, 5s));
+        } else {
+          memcpy(exchange.buffer(), response.data(), response.size());
+          exchange.Respond(response.size());
+        }
+        return request;
+      }
+      area->WaitRequest(&last_seen, 100ms);
+    }
+  }
+
+  void TestRoundTrip(size_t response_size) {
+    auto* exchange = client_segment_->get()->Acquire();
+    ASSERT_NE(exchange, nullptr);
+
+    std::string request = RandomHumanReadableString(kBufferSize / 2);
+    std::string response = RandomHumanReadableString(response_size);
+    std::string received_request;
+    std::thread server([this, &response, &received_request] {
+      received_request = ServeRequest(response, response.size() > kBufferSize);
+    });
+
+    memcpy(exchange->buffer(), request.data(), request.size());
+    std::string parts;
+    exchange->SendRequest(client_segment_->get(), request.size());
+    auto result = exchange->WaitResponse(CoarseMonoClock::now() + 10s, &parts);
+    server.join();
+
+    ASSERT_OK(result);
+    ASSERT_EQ(request, received_request);
+    ASSERT_EQ(response, result->ToBuffer());
+    ASSERT_TRUE(exchange->idle());
+    exchange->Release(getpid());
+  }
+
+  std::unique_ptr<PgSharedExchangeSegment> server_segment_;
+  std::unique_ptr<PgSharedExchangeSegment> client_segment_;
+};
+
+TEST_F(TServerSharedMemTest, ControlDataReadOnly) {
+  auto owner = ASSERT_RESULT(TServerSharedObject::Create());
+  owner->SetYSQLCatalogVersion(42);
+
+  // Backends map the control data read-only.
+  auto reader = ASSERT_RESULT(TServerSharedObject::OpenReadOnly(owner.GetFd()));
+  ASSERT_EQ(42, reader->ysql_catalog_version());
+  owner->SetYSQLCatalogVersion(43);
+  ASSERT_EQ(43, reader->ysql_catalog_version());
+}
+
+TEST_F(TServerSharedMemTest, SegmentSizedFromParameters) {
+  auto* area = client_segment_->get();
+  ASSERT_EQ(kNumExchanges, area->num_exchanges());
+  ASSERT_EQ(kBufferSize, area->buffer_size());
+  for (size_t i = 0; i != kNumExchanges; ++i) {
+    ASSERT_EQ(kBufferSize, area->exchange(i).buffer_size());
+  }
+
+  // Each backend gets its own exchange, until all of them are taken.
+  std::vector<PgSharedExchange*> acquired;
+  for (size_t i = 0; i != kNumExchanges; ++i) {
+    auto* exchange = area->Acquire();
+    ASSERT_NE(exchange, nullptr);
+    ASSERT_EQ(std::find(acquired.begin(), acquired.end(), exchange), acquired.end());
+    acquired.push_back(exchange);
+  }
+  ASSERT_EQ(area->Acquire(), nullptr);
+
+  acquired.back()->Release(getpid());
+  ASSERT_EQ(area->Acquire(), acquired.back());
+}
+
+TEST_F(TServerSharedMemTest, Response) {
+  TestRoundTrip(kBufferSize / 4);
+  TestRoundTrip(kBufferSize);
+}
+
+TEST_F(TServerSharedMemTest, ResponseInParts) {
+  TestRoundTrip(kBufferSize + 1);
+  TestRoundTrip(kBufferSize * 10 + kBufferSize / 3);
+}
+
+TEST_F(TServerSharedMemTest, AbandonedResponsePart) {
+  auto* exchange = client_segment_->get()->Acquire();
+  ASSERT_NE(exchange, nullptr);
+
+  std::string request = "request";
+  memcpy(exchange->buffer(), request.data(), request.size());
+
+  // The backend gives up on the request, while the tserver is still processing it.
+  Status client_status;
+  std::thread client([this, exchange, &request, &client_status] {
+    std::string parts;
+    exchange->SendRequest(client_segment_->get(), request.size());
+    client_status = ResultToStatus(
+        exchange->WaitResponse(CoarseMonoClock::now() + 100ms, &parts));
+  });
+
+  auto* area = server_segment_->get();
+  PgSharedExchange* server_exchange = nullptr;
+  ASSERT_OK(WaitFor([area, &server_exchange] {
+    for (size_t i = 0; i != area->num_exchanges(); ++i) {
+      if (area->exchange(i).StartProcessing()) {
+        server_exchange = &area->exchange(i);
+        return true;
+      }
+    }
+    return false;
+  }, 10s, "Request picked"));
+
+  client.join();
+  ASSERT_TRUE(client_status.IsTimedOut()) << client_status;
+
+  // Nobody consumes the first part, so the tserver should not wait for it forever, and the exchange
+  // should become reusable.
+  auto status = server_exchange->RespondInParts(std::string(kBufferSize * 3, 'x'), 100ms);
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+  ASSERT_TRUE(server_exchange->idle());
+
+  exchange->Release(getpid());
+  ASSERT_EQ(client_segment_->get()->Acquire(), exchange);
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,271 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/tserver_shared_mem.h"
+
+#include <signal.h>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <climits>
+#include <thread>
+
+#include "yb/util/alignment.h"
+#include "yb/util/errno.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+// Time the backend keeps waiting for a response after the deadline, once the tserver picked the
+// request. The tserver applies the same deadline to the request, so it should respond shortly.
+constexpr auto kProcessingGracePeriod = 5s;
+
+// Futexes in shared memory are used by different processes, so FUTEX_PRIVATE_FLAG must not be
+// used here.
+void FutexWait(std::atomic<uint32_t>* address, uint32_t expected, MonoDelta timeout) {
+#if defined(__linux__)
+  struct timespec ts;
+  timeout.ToTimeSpec(&ts);
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+  if (address->load(std::memory_order_acquire) == expected) {
+    std::this_thread::sleep_for(
+        std::min<std::chrono::steady_clock::duration>(timeout.ToSteadyDuration(), 1ms));
+  }
+#endif
+}
+
+void FutexWake(std::atomic<uint32_t>* address) {
+#if defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+          0);
+#endif
+}
+
+bool ProcessExists(pid_t pid) {
+  return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+} // namespace
+
+bool PgSharedExchange::TryAcquire(pid_t pid) {
+  auto owner = owner_.load(std::memory_order_acquire);
+  if (owner != 0 && ProcessExists(owner)) {
+    return false;
+  }
+  if (!owner_.compare_exchange_strong(owner, pid, std::memory_order_acq_rel)) {
+    return false;
+  }
+  // The tserver could still be processing a request of the previous owner, or sending it the
+  // response, the buffer cannot be reused until it is done.
+  uint32_t state = state_.load(std::memory_order_acquire);
+  if (state == kProcessing || state == kResponsePart ||
+      !state_.compare_exchange_strong(state, kIdle, std::memory_order_acq_rel)) {
+    owner_.store(0, std::memory_order_release);
+    return false;
+  }
+  return true;
+}
+
+void PgSharedExchange::Release(pid_t pid) {
+  owner_.compare_exchange_strong(pid, 0, std::memory_order_acq_rel);
+}
+
+void PgSharedExchange::SendRequest(PgSharedExchangeArea* area, size_t request_size) {
+  DCHECK_LE(request_size, buffer_size_);
+  DCHECK(idle());
+
+  size_ = request_size;
+  state_.store(kRequestSent, std::memory_order_release);
+  area->NotifyRequest();
+}
+
+Result<Slice> PgSharedExchange::WaitResponse(CoarseTimePoint deadline, std::string* parts) {
+  parts->clear();
+  for (;;) {
+    uint32_t state = state_.load(std::memory_order_acquire);
+    if (state == kResponseReady) {
+      state_.store(kIdle, std::memory_order_release);
+      if (parts->empty()) {
+        return Slice(buffer(), size_);
+      }
+      parts->append(buffer(), size_);
+      return Slice(*parts);
+    }
+    if (state == kResponsePart) {
+      parts->append(buffer(), size_);
+      state_.store(kProcessing, std::memory_order_release);
+      FutexWake(&state_);
+      continue;
+    }
+    if (state == kIdle) {
+      return STATUS(Aborted, "Tablet server stopped sending response");
+    }
+    auto now = CoarseMonoClock::now();
+    if (state == kRequestSent && now >= deadline) {
+      if (state_.compare_exchange_strong(state, kIdle, std::memory_order_acq_rel)) {
+        return STATUS(TimedOut, "Timed out waiting for tserver to pick request");
+      }
+      continue;
+    }
+    auto wait_deadline = deadline;
+    if (state == kProcessing) {
+      wait_deadline += kProcessingGracePeriod;
+      if (now >= wait_deadline) {
+        return STATUS(TimedOut, "Timed out waiting for tserver to process request");
+      }
+    }
+    FutexWait(&state_, state, MonoDelta(wait_deadline - now));
+  }
+}
+
+bool PgSharedExchange::StartProcessing() {
+  uint32_t expected = kRequestSent;
+  return state_.compare_exchange_strong(expected, kProcessing, std::memory_order_acq_rel);
+}
+
+void PgSharedExchange::Respond(size_t response_size) {
+  DCHECK_LE(response_size, buffer_size_);
+  size_ = response_size;
+  state_.store(kResponseReady, std::memory_order_release);
+  FutexWake(&state_);
+}
+
+Status PgSharedExchange::RespondInParts(Slice response, MonoDelta part_timeout) {
+  while (response.size() > buffer_size_) {
+    memcpy(buffer(), response.data(), buffer_size_);
+    response.remove_prefix(buffer_size_);
+    size_ = buffer_size_;
+    state_.store(kResponsePart, std::memory_order_release);
+    FutexWake(&state_);
+
+    // Only the owner could consume the part, TryAcquire does not take over an exchange in this
+    // state.
+    auto deadline = CoarseMonoClock::now() + part_timeout;
+    for (;;) {
+      uint32_t state = state_.load(std::memory_order_acquire);
+      if (state == kProcessing) {
+        break;
+      }
+      auto now = CoarseMonoClock::now();
+      if (now >= deadline) {
+        if (state_.compare_exchange_strong(state, kIdle, std::memory_order_acq_rel)) {
+          FutexWake(&state_);
+          return STATUS(TimedOut, "Timed out waiting for backend to consume response part");
+        }
+        continue;
+      }
+      FutexWait(&state_, state, MonoDelta(deadline - now));
+    }
+  }
+  memcpy(buffer(), response.data(), response.size());
+  Respond(response.size());
+  return Status::OK();
+}
+
+namespace {
+
+constexpr size_t kExchangeAlignment = 64;
+
+size_t FirstExchangeOffset() {
+  return align_up(sizeof(PgSharedExchangeArea), kExchangeAlignment);
+}
+
+} // namespace
+
+PgSharedExchangeArea::PgSharedExchangeArea(size_t num_exchanges, size_t buffer_size)
+    : num_exchanges_(num_exchanges), buffer_size_(buffer_size) {
+  LOG_IF(FATAL, !requests_.is_lock_free()) << "Shared memory atomics must be lock-free";
+  for (size_t i = 0; i != num_exchanges_; ++i) {
+    new (&exchange(i)) PgSharedExchange(buffer_size_);
+  }
+}
+
+size_t PgSharedExchangeArea::ExchangeStride(size_t buffer_size) {
+  return align_up(sizeof(PgSharedExchange) + buffer_size, kExchangeAlignment);
+}
+
+size_t PgSharedExchangeArea::SegmentSize(size_t num_exchanges, size_t buffer_size) {
+  return FirstExchangeOffset() + num_exchanges * ExchangeStride(buffer_size);
+}
+
+PgSharedExchange& PgSharedExchangeArea::exchange(size_t idx) {
+  DCHECK_LT(idx, num_exchanges_);
+  return *reinterpret_cast<PgSharedExchange*>(
+      reinterpret_cast<char*>(this) + FirstExchangeOffset() + idx * ExchangeStride(buffer_size_));
+}
+
+PgSharedExchange* PgSharedExchangeArea::Acquire() {
+  auto pid = getpid();
+  for (size_t i = 0; i != num_exchanges_; ++i) {
+    auto& result = exchange(i);
+    if (result.TryAcquire(pid)) {
+      return &result;
+    }
+  }
+  return nullptr;
+}
+
+void PgSharedExchangeArea::NotifyRequest() {
+  requests_.fetch_add(1, std::memory_order_acq_rel);
+  FutexWake(&requests_);
+}
+
+void PgSharedExchangeArea::WaitRequest(uint32_t* last_seen, MonoDelta timeout) {
+  auto current = requests_.load(std::memory_order_acquire);
+  if (current == *last_seen) {
+    FutexWait(&requests_, current, timeout);
+    current = requests_.load(std::memory_order_acquire);
+  }
+  *last_seen = current;
+}
+
+Result<PgSharedExchangeSegment> PgSharedExchangeSegment::Create(
+    size_t num_exchanges, size_t buffer_size) {
+  auto segment = VERIFY_RESULT(SharedMemorySegment::Create(
+      PgSharedExchangeArea::SegmentSize(num_exchanges, buffer_size)));
+  new (segment.GetAddress()) PgSharedExchangeArea(num_exchanges, buffer_size);
+  return PgSharedExchangeSegment(std::move(segment));
+}
+
+Result<PgSharedExchangeSegment> PgSharedExchangeSegment::Open(int fd) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return STATUS_FORMAT(IOError, "Failed to stat shared exchange segment: $0",
+                         ErrnoToString(errno));
+  }
+  const auto segment_size = static_cast<size_t>(st.st_size);
+  if (segment_size < sizeof(PgSharedExchangeArea)) {
+    return STATUS_FORMAT(Corruption, "Shared exchange segment is too small: $0", segment_size);
+  }
+  PgSharedExchangeSegment result(VERIFY_RESULT(SharedMemorySegment::Open(
+      fd, SharedMemorySegment::AccessMode::kReadWrite, segment_size)));
+  auto expected_size = PgSharedExchangeArea::SegmentSize(
+      result->num_exchanges(), result->buffer_size());
+  if (segment_size < expected_size) {
+    return STATUS_FORMAT(Corruption, "Shared exchange segment size $0, while $1 expected",
+                         segment_size, expected_size);
+  }
+  return result;
+}
+
+} // namespace tserver
+} // namespace yb
@@ -14,15 +14,174 @@
 #ifndef YB_TSERVER_TSERVER_SHARED_MEM_H
 #define YB_TSERVER_TSERVER_SHARED_MEM_H
 
+#include <unistd.h>
+
 #include <atomic>
+#include <string>
 
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
 #include "yb/util/shared_mem.h"
+#include "yb/util/slice.h"
 
 #include "yb/tserver/tserver_util_fwd.h"
 
 namespace yb {
 namespace tserver {
 
+class PgSharedExchangeArea;
+
+// Area used by a single postgres backend to send requests to the local tserver through shared
+// memory, instead of a loopback RPC. The backend writes a request into the buffer and waits for
+// the tserver to overwrite it with the response. A response larger than the buffer is passed in
+// several parts, each of them is consumed by the backend before the tserver writes the next one.
+//
+// Exchanges are placed in PgSharedExchangeArea, the buffer of an exchange immediately follows it.
+class PgSharedExchange {
+ public:
+  enum State : uint32_t {
+    kIdle,           // Owned by a backend, no request in flight.
+    kRequestSent,    // Request was written by the backend, waiting for the tserver.
+    kProcessing,     // Request was picked by the tserver, or the last response part was consumed.
+    kResponsePart,   // Part of the response was written by the tserver, more parts follow.
+    kResponseReady,  // Response was written by the tserver, waiting for the backend.
+  };
+
+  explicit PgSharedExchange(size_t buffer_size) : buffer_size_(buffer_size) {}
+
+  // Tries to make the process with the specified pid the owner of this exchange. An exchange left
+  // behind by a process that does not exist anymore is taken over.
+  bool TryAcquire(pid_t pid);
+
+  void Release(pid_t pid);
+
+  pid_t owner() const {
+    return owner_.load(std::memory_order_acquire);
+  }
+
+  char* buffer() {
+    return reinterpret_cast<char*>(this + 1);
+  }
+
+  const char* buffer() const {
+    return reinterpret_cast<const char*>(this + 1);
+  }
+
+  size_t buffer_size() const {
+    return buffer_size_;
+  }
+
+  // Backend side. Sends the first 'request_size' bytes of the buffer, without waiting for the
+  // response, see WaitResponse.
+  void SendRequest(PgSharedExchangeArea* area, size_t request_size);
+
+  // Backend side. Waits for the response to the sent request. Returns the response, which lives in
+  // the buffer until the next request is sent, or, when the response came in several parts, in
+  // 'parts'.
+  // Returns TimedOut if the tserver did not pick the request until 'deadline', the request is
+  // cancelled in this case. If the tserver picked the request but did not respond long after
+  // 'deadline', TimedOut is returned as well and the exchange stays busy, see idle().
+  Result<Slice> WaitResponse(CoarseTimePoint deadline, std::string* parts);
+
+  bool idle() const {
+    return state_.load(std::memory_order_acquire) == kIdle;
+  }
+
+  // Server side. Marks a pending request as picked up, returns false if there is no such request.
+  bool StartProcessing();
+
+  Slice request() const {
+    return Slice(buffer(), size_);
+  }
+
+  // Server side. Publishes the first 'response_size' bytes of the buffer as the response.
+  void Respond(size_t response_size);
+
+  // Server side. Publishes a response that could be larger than the buffer. Fails if the backend
+  // does not consume a part within 'part_timeout', the exchange is returned to the backend as idle
+  // in this case, so it gets an error instead of the rest of the response.
+  CHECKED_STATUS RespondInParts(Slice response, MonoDelta part_timeout);
+
+ private:
+  std::atomic<pid_t> owner_{0};
+  // Holds State, 32 bit wide so it could be used as a futex.
+  std::atomic<uint32_t> state_{kIdle};
+  size_t size_ = 0;
+  const size_t buffer_size_;
+};
+
+// Shared memory segment with the PgSharedExchange slots of local postgres backends. It is separate
+// from TServerSharedData, so backends could map the tserver control data read-only while they
+// write to their exchanges. The segment is sized from the number of slots and the buffer size it
+// is created with. The tserver only writes the slot headers, so the kernel does not allocate
+// memory for a buffer until a backend writes a request to it.
+class PgSharedExchangeArea {
+ public:
+  PgSharedExchangeArea(size_t num_exchanges, size_t buffer_size);
+
+  // Size of the segment that holds an area with the specified parameters.
+  static size_t SegmentSize(size_t num_exchanges, size_t buffer_size);
+
+  size_t num_exchanges() const {
+    return num_exchanges_;
+  }
+
+  size_t buffer_size() const {
+    return buffer_size_;
+  }
+
+  PgSharedExchange& exchange(size_t idx);
+
+  // Acquires a free PgSharedExchange for the calling process, returns nullptr if all of them are
+  // in use.
+  PgSharedExchange* Acquire();
+
+  // Wakes up the tserver to process requests sent through exchanges.
+  void NotifyRequest();
+
+  // Waits until a request is sent through some exchange or 'timeout' elapses. 'last_seen' is the
+  // request counter observed by the previous call, it is updated with the current value.
+  void WaitRequest(uint32_t* last_seen, MonoDelta timeout);
+
+ private:
+  static size_t ExchangeStride(size_t buffer_size);
+
+  const size_t num_exchanges_;
+  const size_t buffer_size_;
+
+  // Incremented every time a request is sent through one of exchanges, used as a futex the tserver
+  // waits on.
+  std::atomic<uint32_t> requests_{0};
+};
+
+// Owner of the mapping of a PgSharedExchangeArea segment.
+class PgSharedExchangeSegment {
+ public:
+  // Creates a new segment, used by the tserver.
+  static Result<PgSharedExchangeSegment> Create(size_t num_exchanges, size_t buffer_size);
+
+  // Maps the segment created by the tserver, used by postgres backends.
+  static Result<PgSharedExchangeSegment> Open(int fd);
+
+  PgSharedExchangeArea* get() const {
+    return static_cast<PgSharedExchangeArea*>(segment_.GetAddress());
+  }
+
+  PgSharedExchangeArea* operator->() const {
+    return get();
+  }
+
+  int GetFd() const {
+    return segment_.GetFd();
+  }
+
+ private:
+  explicit PgSharedExchangeSegment(SharedMemorySegment segment)
+      : segment_(std::move(segment)) {}
+
+  SharedMemorySegment segment_;
+};
+
 class TServerSharedData {
  public:
   TServerSharedData() {
@@ -19,6 +19,8 @@
 namespace yb {
 namespace tserver {
 
+class PgSharedExchangeArea;
+class PgSharedExchangeSegment;
 class TServerSharedData;
 typedef SharedMemoryObject<TServerSharedData> TServerSharedObject;
 
@@ -29,7 +29,11 @@ Env::~Env() {
 CHECKED_STATUS Env::CreateDirs(const std::string& dirname) {
   if (!FileExists(dirname)) {
     RETURN_NOT_OK(CreateDirs(DirName(dirname)));
-    RETURN_NOT_OK(CreateDir(dirname));
+    auto status = CreateDir(dirname);
+    // Directory could be concurrently created by another thread, checked by IsDirectory below.
+    if (!status.ok() && !status.IsAlreadyPresent()) {
+      return status;
+    }
   }
   return VERIFY_RESULT(IsDirectory(dirname)) ?
       Status::OK() : STATUS_FORMAT(IOError, "Not a directory: $0", dirname);
@@ -13,7 +13,9 @@
 
 #include <chrono>
 #include <cmath>
+#include <mutex>
 #include <random>
+#include <thread>
 
 #include "yb/util/net/rate_limiter.h"
 #include "yb/util/random_util.h"
@@ -78,6 +80,46 @@ TEST(RateLimiter, TestUpdateDataSize) {
   ASSERT_LE(diff, max_allowed_rate_diff);
 }
 
+TEST(RateLimiter, TestConcurrentUpdateDataSize) {
+  // Several threads share one rate limiter and sleep outside of the lock that protects it, like
+  // concurrent fetches of a remote bootstrap session do.
+  constexpr int kThreads = 4;
+  constexpr int kCallsPerThread = 5;
+  constexpr uint64_t kTargetRate = 4 * kRate;
+  RateLimiter rate_limiter([]() { return kTargetRate; });
+  std::mutex mutex;
+  rate_limiter.Init();
+  auto start = MonoTime::Now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&rate_limiter, &mutex]() {
+      for (int j = 0; j < kCallsPerThread; ++j) {
+        MonoDelta sleep_time;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          sleep_time = rate_limiter.UpdateDataSizeAndGetSleepTime(kRate);
+        }
+        if (sleep_time.Initialized()) {
+          SleepFor(sleep_time);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto elapsed = MonoTime::Now().GetDeltaSince(start);
+
+  // kThreads * kCallsPerThread * kRate bytes at kTargetRate bytes/sec should take ~5s.
+  uint64_t expected_time_ms =
+      kThreads * kCallsPerThread * kRate * MonoTime::kMillisecondsPerSecond / kTargetRate;
+  LOG(INFO) << "Elapsed time: " << elapsed << ", expected: " << expected_time_ms << "ms";
+  ASSERT_GE(static_cast<uint64_t>(elapsed.ToMilliseconds()), expected_time_ms * 95 / 100);
+  auto aggregate_rate = MonoTime::kMillisecondsPerSecond * kThreads * kCallsPerThread * kRate /
+                        elapsed.ToMilliseconds();
+  ASSERT_LE(aggregate_rate, kTargetRate * 105 / 100);
+}
+
 TEST(RateLimiter, TestSendRequest) {
   MonoDelta local_sleep_time(3s);
   RateLimiter rate_limiter([]() { return kRate; });
@@ -58,39 +58,72 @@ uint64_t RateLimiter::GetRate() {
 }
 
 void RateLimiter::UpdateDataSizeAndMaybeSleep(uint64_t data_size) {
+  auto sleep_time = UpdateDataSizeAndGetSleepTime(data_size);
+  if (sleep_time.Initialized()) {
+    SleepFor(sleep_time);
+  }
+}
+
+MonoDelta RateLimiter::UpdateDataSizeAndGetSleepTime(uint64_t data_size) {
   auto now = MonoTime::Now();
-  auto elapsed = now.GetDeltaSince(end_time_);
-  end_time_ = now;
   total_bytes_ += data_size;
   UpdateRate();
-  UpdateTimeSlotSizeAndMaybeSleep(data_size, elapsed);
+  if (!active()) {
+    end_time_ = now;
+    return MonoDelta();
+  }
+
+  // end_time_ is the time when all the data reported so far is transmitted at target_rate_. It is
+  // in the future while earlier callers are still sleeping, so this transmission gets the slot
+  // right after theirs and concurrent callers do not exceed target_rate_ in aggregate. Time not
+  // used while idle is not carried over.
+  auto transmission_time = MonoDelta::FromMicroseconds(
+      MonoTime::kMicrosecondsPerSecond * data_size / target_rate_);
+  end_time_ = std::max(end_time_ + transmission_time, now);
+  auto sleep_time = end_time_.GetDeltaSince(now);
+  VLOG(1) << " target_rate_=" << target_rate_
+          << " received size=" << data_size
+          << " and sleeping for=" << sleep_time;
+  return UpdateTimeSlotForSleep(sleep_time);
 }
 
 void RateLimiter::UpdateTimeSlotSizeAndMaybeSleep(uint64_t data_size, MonoDelta elapsed) {
+  auto sleep_time = UpdateTimeSlotSize(data_size, elapsed);
+  if (sleep_time.Initialized()) {
+    SleepFor(sleep_time);
+    end_time_ = MonoTime::Now();
+  }
+}
+
+MonoDelta RateLimiter::UpdateTimeSlotSize(uint64_t data_size, MonoDelta elapsed) {
   if (!active()) {
-    return;
+    return MonoDelta();
   }
 
   // If the rate is greater than target_rate_, sleep until both rates are equal.
-  if (MonoTime::kMillisecondsPerSecond * data_size > target_rate_ * elapsed.ToMilliseconds()) {
-    auto sleep_time =
-        MonoTime::kMillisecondsPerSecond * data_size / target_rate_ - elapsed.ToMilliseconds();
-    VLOG(1) << " target_rate_=" << target_rate_
-            << " elapsed=" << elapsed.ToMilliseconds()
-            << " received size=" << data_size
-            << " and sleeping for=" << sleep_time;
-    SleepFor(MonoDelta::FromMilliseconds(sleep_time));
+  auto elapsed_ms = std::max<int64_t>(elapsed.ToMilliseconds(), 0);
+  auto sleep_time = static_cast<int64_t>(
+      MonoTime::kMillisecondsPerSecond * data_size / target_rate_) - elapsed_ms;
+  VLOG(1) << " target_rate_=" << target_rate_
+          << " elapsed=" << elapsed_ms
+          << " received size=" << data_size
+          << " and sleeping for=" << sleep_time;
+  return UpdateTimeSlotForSleep(MonoDelta::FromMilliseconds(sleep_time));
+}
+
+MonoDelta RateLimiter::UpdateTimeSlotForSleep(MonoDelta sleep_time) {
+  if (sleep_time <= MonoDelta::kZero) {
+    time_slot_ms_ = std::min(max_time_slot_, time_slot_ms_ * 2);
+    return MonoDelta();
+  }
 #if defined(OS_MACOSX)
-    total_time_slept_ += MonoDelta::FromMilliseconds(sleep_time);
+  total_time_slept_ += sleep_time;
 #endif
-    end_time_ = MonoTime::Now();
-    // If we slept for more than 80% of time_slot_ms_, reduce the size of this time slot.
-    if (sleep_time > time_slot_ms_ * 80 / 100) {
-      time_slot_ms_ = std::max(min_time_slot_, time_slot_ms_ / 2);
-    }
-  } else {
-    time_slot_ms_ = std::min(max_time_slot_, time_slot_ms_ * 2);
+  // If we slept for more than 80% of time_slot_ms_, reduce the size of this time slot.
+  if (static_cast<uint64_t>(sleep_time.ToMilliseconds()) > time_slot_ms_ * 80 / 100) {
+    time_slot_ms_ = std::max(min_time_slot_, time_slot_ms_ / 2);
   }
+  return sleep_time;
 }
 
 void RateLimiter::UpdateRate() {
@@ -58,6 +58,10 @@ class RateLimiter {
   // than the rate provided by target_rate_updater_.
   void UpdateDataSizeAndMaybeSleep(uint64_t data_size);
 
+  // Same as UpdateDataSizeAndMaybeSleep, but returns the time the caller should sleep instead of
+  // sleeping, so the caller could do it without holding the lock that protects this object.
+  MonoDelta UpdateDataSizeAndGetSleepTime(uint64_t data_size);
+
   void Init();
 
   // We can only have an active rate limiter if the user has provided a function to update the rate.
@@ -82,6 +86,9 @@ class RateLimiter {
  private:
   void UpdateRate();
   void UpdateTimeSlotSizeAndMaybeSleep(uint64_t data_size, MonoDelta elapsed);
+  MonoDelta UpdateTimeSlotSize(uint64_t data_size, MonoDelta elapsed);
+  // Adjusts time_slot_ms_ for the given sleep time. Returns sleep_time if it is positive.
+  MonoDelta UpdateTimeSlotForSleep(MonoDelta sleep_time);
   uint64_t GetSizeForNextTimeSlot();
 
   bool init_ = false;
@@ -89,7 +96,8 @@ class RateLimiter {
   // Time when this rate was initialized. Used to calculate the long-term rate.
   MonoTime start_time_;
 
-  // Last time stats were updated.
+  // Last time stats were updated. For UpdateDataSizeAndGetSleepTime, the time when the data
+  // reported so far is transmitted at the target rate, which could be in the future.
   MonoTime end_time_;
 
   // Reset every time the rate changes
@@ -0,0 +1,117 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/test_util.h"
+#include "yb/util/thread.h"
+#include "yb/util/wait_state.h"
+
+DECLARE_int32(wait_state_history_size);
+DECLARE_int32(wait_state_sample_interval_ms);
+
+namespace yb {
+
+class WaitStateTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    // Take samples explicitly to get deterministic results.
+    FLAGS_wait_state_sample_interval_ms = 0;
+    WaitStateSampler::Init();
+  }
+};
+
+TEST_F(WaitStateTest, Sampling) {
+  auto* sampler = WaitStateSampler::GetInstance();
+  const auto start = GetCurrentTimeMicros();
+
+  CountDownLatch ready(1);
+  CountDownLatch finish(1);
+  scoped_refptr<Thread> thread;
+  ASSERT_OK(Thread::Create("test", "waiter", [&ready, &finish] {
+    ScopedWaitActivity activity("TestActivity");
+    SetWaitStateTablet("test-tablet");
+    ScopedWaitState wait_state(WaitStateCode::kLockWait);
+    ready.CountDown();
+    finish.Wait();
+  }, &thread));
+
+  {
+    // Idle threads and threads that finished their activity are not sampled.
+    ScopedWaitActivity activity("Finished");
+  }
+
+  ready.Wait();
+  sampler->SampleNow();
+  finish.CountDown();
+  thread->Join();
+  sampler->SampleNow();
+
+  auto samples = sampler->Samples(start);
+  ASSERT_EQ(1, samples.size());
+  ASSERT_EQ("waiter", samples[0].thread_name);
+  ASSERT_EQ(WaitStateCode::kLockWait, samples[0].code);
+  ASSERT_EQ("TestActivity", samples[0].activity);
+  ASSERT_EQ("test-tablet", samples[0].tablet_id);
+
+  {
+    ScopedWaitActivity activity("Outer", "tablet-1");
+    sampler->SampleNow();
+    {
+      ScopedWaitActivity nested_activity("Inner", "tablet-2");
+      ScopedWaitState wait_state(WaitStateCode::kBlockRead);
+      sampler->SampleNow();
+    }
+    sampler->SampleNow();
+  }
+
+  samples = sampler->Samples(start);
+  ASSERT_EQ(4, samples.size());
+
+  auto by_activity = AggregateWaitStates(samples, WaitStateGroupBy::kActivity);
+  ASSERT_EQ(3, by_activity.size());
+  ASSERT_EQ("Outer", by_activity[0].key);
+  ASSERT_EQ(WaitStateCode::kOnCpu, by_activity[0].code);
+  ASSERT_EQ(2, by_activity[0].count);
+
+  auto by_tablet = AggregateWaitStates(samples, WaitStateGroupBy::kTablet);
+  ASSERT_EQ(3, by_tablet.size());
+  ASSERT_EQ("tablet-1", by_tablet[0].key);
+  ASSERT_EQ(2, by_tablet[0].count);
+}
+
+TEST_F(WaitStateTest, HistoryWrapAround) {
+  auto* sampler = WaitStateSampler::GetInstance();
+  FLAGS_wait_state_history_size = 3;
+  const auto start = GetCurrentTimeMicros();
+
+  ScopedWaitActivity activity("WrapAround");
+  for (int i = 0; i != 5; ++i) {
+    sampler->SampleNow();
+  }
+
+  // Only the newest samples are retained, oldest first.
+  auto samples = sampler->Samples(start);
+  ASSERT_EQ(3, samples.size());
+  for (size_t i = 0; i != samples.size(); ++i) {
+    ASSERT_EQ("WrapAround", samples[i].activity);
+    if (i > 0) {
+      ASSERT_LE(samples[i - 1].time_us, samples[i].time_us);
+    }
+  }
+  ASSERT_EQ(0, sampler->Samples(samples.back().time_us + 1).size());
+}
+
+} // namespace yb
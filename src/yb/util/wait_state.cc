@@ -0,0 +1,241 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/wait_state.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/map-util.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(wait_state_sample_interval_ms, 100,
+             "Interval between samples of thread wait states. 0 disables sampling.");
+TAG_FLAG(wait_state_sample_interval_ms, runtime);
+TAG_FLAG(wait_state_sample_interval_ms, advanced);
+
+DEFINE_int32(wait_state_history_size, 50000,
+             "Max number of thread wait state samples retained in memory.");
+TAG_FLAG(wait_state_history_size, runtime);
+TAG_FLAG(wait_state_history_size, advanced);
+
+namespace yb {
+
+namespace {
+
+template <size_t N>
+void CopyToBuffer(const std::string& source, char (&dest)[N]) {
+  const size_t len = std::min(source.size(), N - 1);
+  memcpy(dest, source.data(), len);
+  dest[len] = 0;
+}
+
+std::string CurrentThreadName() {
+  auto* thread = Thread::current_thread();
+  if (thread) {
+    return thread->name();
+  }
+  char buffer[16];
+  if (pthread_getname_np(pthread_self(), buffer, sizeof(buffer)) == 0) {
+    return buffer;
+  }
+  return std::to_string(Thread::CurrentThreadId());
+}
+
+} // namespace
+
+DEFINE_STATIC_THREAD_LOCAL(WaitStateSampler::TLS, WaitStateSampler, tls_);
+
+std::atomic<bool> WaitStateSampler::enabled_{false};
+
+WaitStateSampler::WaitStateSampler() : finish_(1) {
+}
+
+WaitStateSampler::~WaitStateSampler() {
+  finish_.CountDown();
+  if (thread_) {
+    CHECK_OK(ThreadJoiner(thread_.get()).Join());
+  }
+}
+
+void WaitStateSampler::Init() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    GetInstance()->Start();
+  });
+}
+
+void WaitStateSampler::Start() {
+  CHECK_OK(Thread::Create(
+      "wait-state", "wait-state-sampler", std::bind(&WaitStateSampler::RunThread, this),
+      &thread_));
+  enabled_.store(true, std::memory_order_release);
+}
+
+void WaitStateSampler::Register(TLS* tls) {
+  auto tid = Thread::CurrentThreadIdForStack();
+  MutexLock l(tls_lock_);
+  InsertOrDie(&tls_by_tid_, tid, tls);
+}
+
+void WaitStateSampler::Unregister(TLS* tls) {
+  auto tid = Thread::CurrentThreadIdForStack();
+  MutexLock l(tls_lock_);
+  CHECK(tls_by_tid_.erase(tid));
+}
+
+void WaitStateSampler::RunThread() {
+  for (;;) {
+    auto interval_ms = FLAGS_wait_state_sample_interval_ms;
+    // When sampling is disabled, check periodically whether it was enabled again.
+    if (finish_.WaitFor(MonoDelta::FromMilliseconds(interval_ms > 0 ? interval_ms : 1000))) {
+      break;
+    }
+    if (interval_ms > 0) {
+      SampleNow();
+    }
+  }
+}
+
+void WaitStateSampler::SampleNow() {
+  std::vector<WaitStateSample> samples;
+  const auto now = GetCurrentTimeMicros();
+  {
+    MutexLock l(tls_lock_);
+    for (const auto& entry : tls_by_tid_) {
+      TLS::Data data;
+      entry.second->data_.SnapshotCopy(&data);
+      const auto code = static_cast<WaitStateCode>(data.code_);
+      if (code == WaitStateCode::kIdle) {
+        continue;
+      }
+      samples.push_back(WaitStateSample {
+          now, entry.second->thread_name_, code, data.activity_, data.tablet_id_ });
+    }
+  }
+
+  MutexLock l(samples_lock_);
+  const size_t capacity = std::max(FLAGS_wait_state_history_size, 1);
+  if (samples_.capacity().capacity() != capacity) {
+    samples_.set_capacity(capacity);
+  }
+  for (auto& sample : samples) {
+    samples_.push_back(std::move(sample));
+  }
+}
+
+std::vector<WaitStateSample> WaitStateSampler::Samples(MicrosecondsInt64 since_us) const {
+  MutexLock l(samples_lock_);
+  // Walk back from the newest sample, so the wall clock going back does not hide recent samples.
+  auto it = samples_.end();
+  while (it != samples_.begin() && std::prev(it)->time_us >= since_us) {
+    --it;
+  }
+  return std::vector<WaitStateSample>(it, samples_.end());
+}
+
+WaitStateSampler::TLS* WaitStateSampler::CreateTLS() {
+  INIT_STATIC_THREAD_LOCAL(WaitStateSampler::TLS, tls_);
+  return tls_;
+}
+
+WaitStateSampler::TLS::TLS() : thread_name_(CurrentThreadName()) {
+  memset(&data_, 0, sizeof(data_));
+  static_assert(static_cast<int>(WaitStateCode::kIdle) == 0, "Zeroed state should be idle");
+  WaitStateSampler::GetInstance()->Register(this);
+}
+
+WaitStateSampler::TLS::~TLS() {
+  WaitStateSampler::GetInstance()->Unregister(this);
+}
+
+// See KernelStackWatchdog::TLS::Data::SnapshotCopy.
+void WaitStateSampler::TLS::Data::SnapshotCopy(Data* copy) const {
+  for (;;) {
+    Atomic32 v_0 = base::subtle::Acquire_Load(&seq_lock_);
+    if (v_0 & 1) {
+      base::subtle::PauseCPU();
+      continue;
+    }
+    ANNOTATE_IGNORE_READS_BEGIN();
+    memcpy(copy, this, sizeof(*copy));
+    ANNOTATE_IGNORE_READS_END();
+    Atomic32 v_1 = base::subtle::Release_Load(&seq_lock_);
+    if (v_1 == v_0) {
+      break;
+    }
+  }
+}
+
+ScopedWaitActivity::ScopedWaitActivity(
+    const std::string& activity, const std::string& tablet_id) {
+  if (!WaitStateSampler::IsEnabled()) {
+    return;
+  }
+  tls_ = WaitStateSampler::GetTLS();
+  previous_ = tls_->data_;
+  tls_->BeginUpdate();
+  tls_->data_.code_ = static_cast<int32_t>(WaitStateCode::kOnCpu);
+  CopyToBuffer(activity, tls_->data_.activity_);
+  CopyToBuffer(tablet_id, tls_->data_.tablet_id_);
+  tls_->EndUpdate();
+}
+
+ScopedWaitActivity::~ScopedWaitActivity() {
+  if (!tls_) {
+    return;
+  }
+  tls_->BeginUpdate();
+  tls_->data_.code_ = previous_.code_;
+  memcpy(tls_->data_.activity_, previous_.activity_, sizeof(previous_.activity_));
+  memcpy(tls_->data_.tablet_id_, previous_.tablet_id_, sizeof(previous_.tablet_id_));
+  tls_->EndUpdate();
+}
+
+void SetWaitStateTablet(const std::string& tablet_id) {
+  if (!WaitStateSampler::IsEnabled()) {
+    return;
+  }
+  auto* tls = WaitStateSampler::GetTLS();
+  tls->BeginUpdate();
+  CopyToBuffer(tablet_id, tls->data_.tablet_id_);
+  tls->EndUpdate();
+}
+
+std::vector<WaitStateAggregate> AggregateWaitStates(
+    const std::vector<WaitStateSample>& samples, WaitStateGroupBy group_by) {
+  std::map<std::pair<std::string, WaitStateCode>, size_t> counts;
+  for (const auto& sample : samples) {
+    const auto& key = group_by == WaitStateGroupBy::kTablet ? sample.tablet_id : sample.activity;
+    ++counts[std::make_pair(key, sample.code)];
+  }
+
+  std::vector<WaitStateAggregate> result;
+  result.reserve(counts.size());
+  for (const auto& entry : counts) {
+    result.push_back(WaitStateAggregate { entry.first.first, entry.first.second, entry.second });
+  }
+  std::stable_sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.count > rhs.count;
+  });
+  return result;
+}
+
+} // namespace yb
@@ -0,0 +1,239 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_WAIT_STATE_H
+#define YB_UTIL_WAIT_STATE_H
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/circular_buffer.hpp>
+
+#include "yb/gutil/atomicops.h"
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/gutil/singleton.h"
+#include "yb/gutil/walltime.h"
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/enums.h"
+#include "yb/util/mutex.h"
+#include "yb/util/thread.h"
+#include "yb/util/threadlocal.h"
+
+namespace yb {
+
+// What a thread is currently doing, as seen by the wait state sampler.
+YB_DEFINE_ENUM(WaitStateCode,
+               // Thread does not perform any activity, it is not sampled.
+               (kIdle)
+               // Thread performs activity and does not wait for anything known.
+               (kOnCpu)
+               // Waiting for a lock on document keys in the shared lock manager.
+               (kLockWait)
+               // Waiting for WAL to be synced to disk.
+               (kWalSync)
+               // Waiting for a block to be read from an SST file.
+               (kBlockRead)
+               // Waiting for a response to an outbound RPC.
+               (kRpcWait)
+               // Resolving conflicts of a transaction or write.
+               (kConflictResolution));
+
+// Wait state of a thread captured by the sampler.
+struct WaitStateSample {
+  // Wall clock time of the sample.
+  MicrosecondsInt64 time_us;
+  std::string thread_name;
+  WaitStateCode code;
+  // Activity performed by the thread, i.e. RPC method or background job, see ScopedWaitActivity.
+  std::string activity;
+  // Tablet the activity is performed for, if known.
+  std::string tablet_id;
+};
+
+YB_DEFINE_ENUM(WaitStateGroupBy, (kActivity)(kTablet));
+
+// Number of samples of a wait state per activity or tablet.
+struct WaitStateAggregate {
+  std::string key;
+  WaitStateCode code;
+  size_t count;
+};
+
+// Aggregates samples by activity or tablet, most frequent entries go first.
+std::vector<WaitStateAggregate> AggregateWaitStates(
+    const std::vector<WaitStateSample>& samples, WaitStateGroupBy group_by);
+
+// Active session history of the process.
+//
+// Each thread publishes its wait state in a thread local structure, and a background thread
+// periodically samples wait states of all threads that perform some activity into a bounded ring,
+// so latency spikes could be explained after the fact.
+//
+// Publishing is wait free, it uses the same sequence lock approach as KernelStackWatchdog.
+// Sampling is only enabled in processes that call Init, until then wait state hooks do nothing.
+class WaitStateSampler {
+ public:
+  static WaitStateSampler* GetInstance() {
+    return Singleton<WaitStateSampler>::get();
+  }
+
+  // Enables wait state sampling in this process. Called on startup of tserver and master.
+  static void Init();
+
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_acquire);
+  }
+
+  // Returns retained samples taken at or after since_us wall clock time, oldest first.
+  std::vector<WaitStateSample> Samples(MicrosecondsInt64 since_us = 0) const;
+
+  // Samples wait states of all threads immediately.
+  void SampleNow();
+
+ private:
+  friend class Singleton<WaitStateSampler>;
+  friend class ScopedWaitActivity;
+  friend class ScopedWaitState;
+  friend void SetWaitStateTablet(const std::string& tablet_id);
+
+  // The thread-local wait state. It is constructed on first use and registers itself with the
+  // sampler, and unregisters when the thread exits.
+  struct TLS {
+    TLS();
+    ~TLS();
+
+    static constexpr size_t kMaxActivityLength = 64;
+    static constexpr size_t kMaxTabletIdLength = 40;
+
+    // POD data, that could be copied by the sampler while being modified, see SnapshotCopy.
+    struct Data {
+      int32_t code_;
+      char activity_[kMaxActivityLength];
+      char tablet_id_[kMaxTabletIdLength];
+
+      // Odd while the owning thread modifies the data.
+      Atomic32 seq_lock_;
+
+      // Take a consistent snapshot of this data into dst.
+      void SnapshotCopy(Data* dst) const;
+    };
+
+    void BeginUpdate() {
+      base::subtle::Acquire_Store(&data_.seq_lock_, data_.seq_lock_ + 1);
+    }
+
+    void EndUpdate() {
+      base::subtle::Release_Store(&data_.seq_lock_, data_.seq_lock_ + 1);
+    }
+
+    const std::string thread_name_;
+    Data data_;
+  };
+
+  WaitStateSampler();
+  ~WaitStateSampler();
+
+  // Get or create the TLS for the current thread.
+  static TLS* GetTLS() {
+    TLS* tls = tls_;
+    if (PREDICT_FALSE(tls == nullptr)) {
+      tls = CreateTLS();
+    }
+    return tls;
+  }
+
+  static TLS* CreateTLS();
+
+  void Register(TLS* tls);
+  void Unregister(TLS* tls);
+
+  void Start();
+  void RunThread();
+
+  DECLARE_STATIC_THREAD_LOCAL(TLS, tls_);
+
+  static std::atomic<bool> enabled_;
+
+  typedef std::unordered_map<ThreadIdForStack, TLS*> TLSMap;
+
+  // Lock protecting tls_by_tid_.
+  mutable Mutex tls_lock_;
+  TLSMap tls_by_tid_;
+
+  // Lock protecting samples_. Memory for samples is allocated as they are added.
+  mutable Mutex samples_lock_;
+  boost::circular_buffer_space_optimized<WaitStateSample> samples_;
+
+  scoped_refptr<Thread> thread_;
+  CountDownLatch finish_;
+
+  DISALLOW_COPY_AND_ASSIGN(WaitStateSampler);
+};
+
+// Marks the current thread as performing the given activity, i.e. handling an RPC or running a
+// background job, for the lifetime of this object. The thread is sampled as on CPU, unless it
+// waits inside a ScopedWaitState. The previous activity of the thread is restored on destruction.
+class ScopedWaitActivity {
+ public:
+  explicit ScopedWaitActivity(const std::string& activity, const std::string& tablet_id = "");
+  ~ScopedWaitActivity();
+
+ private:
+  // Null when sampling is not enabled.
+  WaitStateSampler::TLS* tls_ = nullptr;
+  WaitStateSampler::TLS::Data previous_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedWaitActivity);
+};
+
+// Marks the current thread as waiting in the given state for the lifetime of this object.
+class ScopedWaitState {
+ public:
+  explicit ScopedWaitState(WaitStateCode code) {
+    if (!WaitStateSampler::IsEnabled()) {
+      return;
+    }
+    tls_ = WaitStateSampler::GetTLS();
+    previous_code_ = tls_->data_.code_;
+    tls_->BeginUpdate();
+    tls_->data_.code_ = static_cast<int32_t>(code);
+    tls_->EndUpdate();
+  }
+
+  ~ScopedWaitState() {
+    if (!tls_) {
+      return;
+    }
+    tls_->BeginUpdate();
+    tls_->data_.code_ = previous_code_;
+    tls_->EndUpdate();
+  }
+
+ private:
+  // Null when sampling is not enabled.
+  WaitStateSampler::TLS* tls_ = nullptr;
+  int32_t previous_code_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedWaitState);
+};
+
+// Sets tablet of the activity performed by the current thread, once it becomes known.
+void SetWaitStateTablet(const std::string& tablet_id);
+
+} // namespace yb
+
+#endif // YB_UTIL_WAIT_STATE_H
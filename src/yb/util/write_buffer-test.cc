@@ -0,0 +1,79 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/util/random_util.h"
+#include "yb/util/test_util.h"
+#include "yb/util/write_buffer.h"
+
+namespace yb {
+
+class WriteBufferTest : public YBTest {
+};
+
+TEST_F(WriteBufferTest, AppendAndWrite) {
+  std::mt19937_64 rng(SeedRandom());
+  for (int iteration = 0; iteration != 100; ++iteration) {
+    WriteBuffer buffer(RandomUniformInt<size_t>(1, 64, &rng));
+    std::string expected;
+    for (int i = RandomUniformInt(0, 100, &rng); i-- > 0;) {
+      auto str = RandomHumanReadableString(RandomUniformInt(0, 100, &rng), &rng);
+      buffer.Append(str);
+      expected += str;
+      ASSERT_EQ(expected.size(), buffer.size());
+      ASSERT_GE(buffer.capacity(), buffer.size());
+    }
+    ASSERT_EQ(expected, buffer.ToString());
+
+    if (!expected.empty()) {
+      // Overwrite a range that could span multiple blocks.
+      auto pos = RandomUniformInt<size_t>(0, expected.size() - 1, &rng);
+      auto len = RandomUniformInt<size_t>(0, expected.size() - pos, &rng);
+      auto str = RandomHumanReadableString(len, &rng);
+      buffer.Write(pos, str.c_str(), len);
+      expected.replace(pos, len, str);
+      ASSERT_EQ(expected, buffer.ToString());
+    }
+
+    boost::container::small_vector<RefCntBuffer, 4> blocks;
+    auto num_blocks = buffer.num_blocks();
+    buffer.TakeBlocks(&blocks);
+    ASSERT_EQ(num_blocks, blocks.size());
+    ASSERT_TRUE(buffer.empty());
+    std::string taken;
+    for (const auto& block : blocks) {
+      ASSERT_GT(block.size(), 0);
+      taken.append(block.data(), block.size());
+    }
+    ASSERT_EQ(expected, taken);
+    ASSERT_EQ(0, buffer.capacity());
+  }
+}
+
+TEST_F(WriteBufferTest, TakeContiguous) {
+  WriteBuffer buffer(16);
+  ASSERT_EQ(0, buffer.TakeContiguous().size());
+
+  buffer.Append(Slice("0123456789"));
+  ASSERT_EQ(1, buffer.num_blocks());
+  ASSERT_EQ("0123456789", buffer.TakeContiguous().AsSlice().ToBuffer());
+  ASSERT_TRUE(buffer.empty());
+
+  buffer.Append(Slice("0123456789"));
+  buffer.Append(Slice("abcdefghij"));
+  ASSERT_EQ(2, buffer.num_blocks());
+  ASSERT_EQ("0123456789abcdefghij", buffer.TakeContiguous().AsSlice().ToBuffer());
+}
+
+} // namespace yb
@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/write_buffer.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+void WriteBuffer::Append(const char* data, size_t len) {
+  size_ += len;
+  if (!blocks_.empty()) {
+    auto& last_block = blocks_.back();
+    auto fit = std::min(last_block.size() - filled_bytes_in_last_block_, len);
+    memcpy(last_block.data() + filled_bytes_in_last_block_, data, fit);
+    filled_bytes_in_last_block_ += fit;
+    data += fit;
+    len -= fit;
+  }
+
+  if (len != 0) {
+    AllocateBlock(std::max(len, blocks_.empty() ? block_size_ : size_));
+    memcpy(blocks_.back().data(), data, len);
+    filled_bytes_in_last_block_ = len;
+  }
+}
+
+void WriteBuffer::Write(size_t pos, const char* data, size_t len) {
+  DCHECK_LE(pos + len, size_);
+  for (auto it = blocks_.begin(); len != 0; ++it) {
+    DCHECK(it != blocks_.end());
+    const size_t block_size = it + 1 == blocks_.end() ? filled_bytes_in_last_block_ : it->size();
+    if (pos >= block_size) {
+      pos -= block_size;
+      continue;
+    }
+    const size_t fit = std::min(block_size - pos, len);
+    memcpy(it->data() + pos, data, fit);
+    data += fit;
+    len -= fit;
+    pos = 0;
+  }
+}
+
+void WriteBuffer::TakeBlocks(boost::container::small_vector_base<RefCntBuffer>* output) {
+  if (!blocks_.empty()) {
+    blocks_.back().Shrink(filled_bytes_in_last_block_);
+    for (auto& block : blocks_) {
+      output->push_back(std::move(block));
+    }
+  }
+  Reset();
+}
+
+RefCntBuffer WriteBuffer::TakeContiguous() {
+  RefCntBuffer result;
+  if (blocks_.size() == 1) {
+    result = std::move(blocks_.back());
+    result.Shrink(filled_bytes_in_last_block_);
+  } else if (!blocks_.empty()) {
+    result = RefCntBuffer(size_);
+    auto* out = result.data();
+    for (auto it = blocks_.begin(); it != blocks_.end(); ++it) {
+      const size_t len = it + 1 == blocks_.end() ? filled_bytes_in_last_block_ : it->size();
+      memcpy(out, it->data(), len);
+      out += len;
+    }
+  }
+  Reset();
+  return result;
+}
+
+void WriteBuffer::AssignTo(std::string* out) const {
+  out->clear();
+  out->reserve(size_);
+  for (auto it = blocks_.begin(); it != blocks_.end(); ++it) {
+    const size_t len = it + 1 == blocks_.end() ? filled_bytes_in_last_block_ : it->size();
+    out->append(it->data(), len);
+  }
+}
+
+void WriteBuffer::Reset() {
+  blocks_.clear();
+  filled_bytes_in_last_block_ = 0;
+  size_ = 0;
+  capacity_ = 0;
+}
+
+void WriteBuffer::AllocateBlock(size_t size) {
+  blocks_.emplace_back(size);
+  capacity_ += size;
+}
+
+} // namespace yb
@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_WRITE_BUFFER_H
+#define YB_UTIL_WRITE_BUFFER_H
+
+#include <string>
+
+#include <boost/container/small_vector.hpp>
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Buffer that accumulates appended data in a chain of RefCntBuffer blocks.
+//
+// Unlike faststring, it never moves already written data when it grows, and its blocks could be
+// handed over to the RPC layer as is, e.g. as a response sidecar, so the data is not copied once
+// more before being sent to the socket.
+class WriteBuffer {
+ public:
+  static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+  // block_size is the size of the first allocated block. Subsequent blocks are at least as large as
+  // the data written so far, so the number of blocks grows logarithmically with the data size.
+  explicit WriteBuffer(size_t block_size = kDefaultBlockSize) : block_size_(block_size) {}
+
+  WriteBuffer(WriteBuffer&& rhs) = default;
+  WriteBuffer& operator=(WriteBuffer&& rhs) = default;
+
+  void Append(const char* data, size_t len);
+
+  void Append(const Slice& slice) {
+    Append(slice.cdata(), slice.size());
+  }
+
+  // Overwrites len bytes at position pos, that should have been already appended.
+  void Write(size_t pos, const char* data, size_t len);
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t num_blocks() const {
+    return blocks_.size();
+  }
+
+  // Total size of allocated blocks, that is not less than size(). The memory is still held by the
+  // blocks taken by TakeBlocks, even after the last of them is shrunk.
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  // Moves blocks with written data to the end of output and resets this buffer.
+  // The last block is shrunk to the size of data written to it.
+  void TakeBlocks(boost::container::small_vector_base<RefCntBuffer>* output);
+
+  // Returns written data as a single block and resets this buffer. Data is copied only when it
+  // spans multiple blocks.
+  RefCntBuffer TakeContiguous();
+
+  // Copies written data to the string.
+  void AssignTo(std::string* out) const;
+
+  std::string ToString() const {
+    std::string result;
+    AssignTo(&result);
+    return result;
+  }
+
+  void Reset();
+
+ private:
+  void AllocateBlock(size_t size);
+
+  size_t block_size_;
+  boost::container::small_vector<RefCntBuffer, 4> blocks_;
+  size_t filled_bytes_in_last_block_ = 0;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(WriteBuffer);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_WRITE_BUFFER_H
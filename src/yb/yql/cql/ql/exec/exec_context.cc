@@ -18,6 +18,7 @@
 #include "yb/client/callbacks.h"
 #include "yb/client/table.h"
 #include "yb/client/yb_op.h"
+#include "yb/common/ql_protocol_util.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/util/trace.h"
 
@@ -189,6 +190,13 @@ Status TnodeContext::AppendRowsResult(RowsResult::SharedPtr&& rows_result) {
   return rows_result_->Append(std::move(*rows_result));
 }
 
+void TnodeContext::AddDocDBStats(const DocDBStatsPB& stats) {
+  if (!docdb_stats_) {
+    docdb_stats_.emplace();
+  }
+  yb::AddDocDBStats(stats, &*docdb_stats_);
+}
+
 void TnodeContext::InitializePartition(QLReadRequestPB *req, uint64_t start_partition) {
   current_partition_index_ = start_partition;
   // Hash values before the first 'IN' condition will be already set.
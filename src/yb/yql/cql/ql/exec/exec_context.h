@@ -83,6 +83,14 @@ class TnodeContext {
     return row_count_;
   }
 
+  // Accumulates DocDB statistics of a read performed by this statement.
+  void AddDocDBStats(const DocDBStatsPB& stats);
+
+  // Accumulated DocDB statistics, set only when the reads were requested to collect them.
+  const boost::optional<DocDBStatsPB>& docdb_stats() const {
+    return docdb_stats_;
+  }
+
   // Used for multi-partition selects (i.e. with 'IN' conditions on hash columns).
   // Called from Executor::FetchMoreRowsIfNeeded to check if request is finished.
   uint64_t UnreadPartitionsRemaining() const {
@@ -154,6 +162,9 @@ class TnodeContext {
   // Accumulated number of rows fetched by the statement.
   size_t row_count_ = 0;
 
+  // Accumulated DocDB statistics of the reads performed by the statement.
+  boost::optional<DocDBStatsPB> docdb_stats_;
+
   // For multi-partition selects (e.g. selects with 'IN' condition on hash cols) we hold the options
   // for each hash column (starting from first 'IN') as we iteratively query each partition.
   // e.g. for a query "h1 = 1 and h2 in (2,3) and h3 in (4,5) and h4 = 6".
@@ -33,11 +33,18 @@
 
 #include "yb/rpc/thread_pool.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
 
+DEFINE_bool(cql_collect_docdb_stats, false,
+            "Collect DocDB statistics of CQL reads and add them to the trace of the statement, "
+            "so they are logged for slow queries.");
+TAG_FLAG(cql_collect_docdb_stats, runtime);
+TAG_FLAG(cql_collect_docdb_stats, advanced);
+
 namespace yb {
 namespace ql {
 
@@ -827,6 +834,9 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
   // Where clause - Hash, range, and regular columns.
 
   req->set_is_aggregate(tnode->is_aggregate());
+  if (FLAGS_cql_collect_docdb_stats) {
+    req->set_collect_docdb_stats(true);
+  }
 
   Result<uint64_t> max_rows_estimate = WhereClauseToPB(req, tnode->key_where_ops(),
                                                        tnode->where_ops(),
@@ -1807,6 +1817,15 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
       continue;
     }
 
+    // Accumulate the DocDB statistics of the read. They are cleared from the response, so they are
+    // not counted again when the op is processed once more.
+    if (op->response().has_docdb_stats()) {
+      const auto& stats = op->response().docdb_stats();
+      TRACE("DocDB stats: $0", stats.ShortDebugString());
+      tnode_context->AddDocDBStats(stats);
+      op->mutable_response()->clear_docdb_stats();
+    }
+
     // If the statement is in a transaction, check the status of the current operation. If it
     // failed to apply (either because of an execution error or unsatisfied IF condition), quit the
     // execution and abort the transaction. Also, if this is a batch returning status, mark all
@@ -1885,6 +1904,10 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
     op_itr = ops.erase(op_itr);
   }
 
+  if (ops.empty() && tnode_context->docdb_stats()) {
+    TRACE("Total DocDB stats: $0", tnode_context->docdb_stats()->ShortDebugString());
+  }
+
   // If there is a child context, process it.
   TnodeContext* child_context = tnode_context->child_context();
   if (child_context != nullptr) {
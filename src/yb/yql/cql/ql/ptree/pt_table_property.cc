@@ -481,10 +481,12 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
   }
   switch (iterator->second) {
     case PropertyMapType::kCaching: FALLTHROUGH_INTENDED;
-    case PropertyMapType::kCompaction: FALLTHROUGH_INTENDED;
-    case PropertyMapType::kCompression:
+    case PropertyMapType::kCompaction:
       LOG(WARNING) << "Ignoring table property " << table_property_name;
       break;
+    case PropertyMapType::kCompression:
+      RETURN_NOT_OK(SetCompressionProperty(table_property));
+      break;
     case PropertyMapType::kTransactions:
       for (const auto& subproperty : map_elements_->node_list()) {
         string subproperty_name;
@@ -512,6 +514,52 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
   return Status::OK();
 }
 
+Status PTTablePropertyMap::SetCompressionProperty(yb::TableProperties *table_property) const {
+  bool enabled = true;
+  for (const auto& subproperty : map_elements_->node_list()) {
+    string subproperty_name;
+    ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
+    auto iter = Compression::kSubpropertyDataTypes.find(subproperty_name);
+    DCHECK(iter != Compression::kSubpropertyDataTypes.end());
+    int64_t int_val;
+    bool bool_val;
+    string str_val;
+    switch (iter->second) {
+      case Compression::Subproperty::kClass: FALLTHROUGH_INTENDED;
+      case Compression::Subproperty::kSstableCompression: {
+        RETURN_NOT_OK(GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name, &str_val));
+        // An empty 'sstable_compression' disables compression.
+        if (str_val.empty()) {
+          enabled = false;
+          break;
+        }
+        TableCompressionPB compression;
+        if (Compression::ClassToTableCompression(str_val, &compression)) {
+          table_property->SetCompression(compression);
+        } else {
+          LOG(WARNING) << "Ignoring unknown compression class " << str_val;
+        }
+        break;
+      }
+      case Compression::Subproperty::kCompressionLevel:
+        RETURN_NOT_OK(GetIntValueFromExpr(subproperty->rhs(), subproperty_name, &int_val));
+        table_property->SetCompressionLevel(static_cast<int32_t>(int_val));
+        break;
+      case Compression::Subproperty::kEnabled:
+        RETURN_NOT_OK(GetBoolValueFromExpr(subproperty->rhs(), subproperty_name, &bool_val));
+        enabled = enabled && bool_val;
+        break;
+      case Compression::Subproperty::kChunkLengthKb: FALLTHROUGH_INTENDED;
+      case Compression::Subproperty::kCrcCheckChance:
+        break;
+    }
+  }
+  if (!enabled) {
+    table_property->SetCompression(TableCompressionPB::TABLE_COMPRESSION_NONE);
+  }
+  return Status::OK();
+}
+
 Status PTTablePropertyMap::AnalyzeCompaction() {
   vector<string> invalid_subproperties;
   vector<PTTableProperty::SharedPtr> subproperties;
@@ -769,6 +817,14 @@ Status PTTablePropertyMap::AnalyzeCompression() {
         break;
       case Compression::Subproperty::kClass:
         break;
+      case Compression::Subproperty::kCompressionLevel:
+        RETURN_NOT_OK(GetIntValueFromExpr(subproperty->rhs(), subproperty_name, &int_val));
+        if (int_val < std::numeric_limits<int32_t>::min() ||
+            int_val > std::numeric_limits<int32_t>::max()) {
+          return STATUS(InvalidArgument, Substitute("Value of $0 is out of range ($1)",
+                                                    subproperty_name, int_val));
+        }
+        break;
       case Compression::Subproperty::kCrcCheckChance:
         RETURN_NOT_OK(GetDoubleValueFromExpr(subproperty->rhs(), subproperty_name, &double_val));
         if (double_val < 0.0 || double_val > 1.0) {
@@ -822,11 +878,30 @@ const std::map<std::string, Compression::Subproperty> Compression::kSubpropertyD
     {"chunk_length_kb",     Compression::Subproperty::kChunkLengthKb},
     {"chunk_length_in_kb",  Compression::Subproperty::kChunkLengthKb},
     {"class",               Compression::Subproperty::kClass},
+    {"compression_level",   Compression::Subproperty::kCompressionLevel},
     {"crc_check_chance",    Compression::Subproperty::kCrcCheckChance},
     {"enabled",             Compression::Subproperty::kEnabled},
     {"sstable_compression", Compression::Subproperty::kSstableCompression}
 };
 
+bool Compression::ClassToTableCompression(const std::string& class_name,
+                                          TableCompressionPB* compression) {
+  static const std::map<std::string, TableCompressionPB> kClasses = {
+      {"deflatecompressor", TableCompressionPB::TABLE_COMPRESSION_ZLIB},
+      {"lz4compressor",     TableCompressionPB::TABLE_COMPRESSION_LZ4},
+      {"snappycompressor",  TableCompressionPB::TABLE_COMPRESSION_SNAPPY},
+      {"zstdcompressor",    TableCompressionPB::TABLE_COMPRESSION_ZSTD}
+  };
+  const auto dot = class_name.rfind('.');
+  const auto iter = kClasses.find(
+      dot == std::string::npos ? class_name : class_name.substr(dot + 1));
+  if (iter == kClasses.end()) {
+    return false;
+  }
+  *compression = iter->second;
+  return true;
+}
+
 const std::map<std::string, Compaction::Subproperty> Compaction::kSubpropertyDataTypes = {
     {"base_time_seconds", Compaction::Subproperty::kBaseTimeSeconds},
     {"bucket_high", Compaction::Subproperty::kBucketHigh},
@@ -218,6 +218,8 @@ class PTTablePropertyMap : public PTTableProperty {
   Status AnalyzeCompression();
   Status AnalyzeTransactions(SemContext *sem_context);
 
+  Status SetCompressionProperty(yb::TableProperties *table_property) const;
+
   static const std::map<std::string, PTTablePropertyMap::PropertyMapType> kPropertyDataTypes;
   TreeListNode<PTTableProperty>::SharedPtr map_elements_;
 };
@@ -226,12 +228,18 @@ struct Compression {
   enum class Subproperty : int {
     kChunkLengthKb,
     kClass,
+    kCompressionLevel,
     kCrcCheckChance,
     kEnabled,
     kSstableCompression
   };
 
   static const std::map<std::string, Subproperty> kSubpropertyDataTypes;
+
+  // Maps the lower case name of a Cassandra compressor class, with or without the package name,
+  // to the table compression. Returns false if the class is unknown.
+  static bool ClassToTableCompression(const std::string& class_name,
+                                      TableCompressionPB* compression);
 };
 
 struct Compaction {
@@ -260,6 +260,79 @@ TEST_F(TestQLCreateTable, TestQLCreateTableWithTTL) {
   EXPECT_EQ(1000, properties_pb.default_time_to_live());
 }
 
+TEST_F(TestQLCreateTable, TestQLCreateTableWithCompression) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get an available processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  master::CatalogManager *catalog_manager = cluster_->mini_master()->master()->catalog_manager();
+  auto get_properties = [catalog_manager](const std::string& table_name) {
+    master::GetTableSchemaRequestPB request_pb;
+    master::GetTableSchemaResponsePB response_pb;
+    request_pb.mutable_table()->mutable_namespace_()->set_name(kDefaultKeyspaceName);
+    request_pb.mutable_table()->set_table_name(table_name);
+    CHECK_OK(catalog_manager->GetTableSchema(&request_pb, &response_pb));
+    return response_pb.schema().table_properties();
+  };
+  auto get_system_compression = [processor](const std::string& table_name) {
+    CHECK_OK(processor->Run(Format(
+        "SELECT compression FROM system_schema.tables WHERE keyspace_name = '$0' AND "
+        "table_name = '$1'", kDefaultKeyspaceName, table_name)));
+    auto row_block = processor->row_block();
+    CHECK_EQ(1, row_block->row_count());
+    const auto& value = row_block->row(0).column(0);
+    std::map<std::string, std::string> result;
+    if (!value.IsNull()) {
+      const auto& map_value = value.map_value();
+      for (int i = 0; i != map_value.keys_size(); ++i) {
+        result[map_value.keys(i).string_value()] = map_value.values(i).string_value();
+      }
+    }
+    return result;
+  };
+
+  EXEC_VALID_STMT("CREATE TABLE compressed (c1 int PRIMARY KEY, c2 int) WITH compression = "
+                  "{'class': 'LZ4Compressor', 'compression_level': 3};");
+  auto properties_pb = get_properties("compressed");
+  EXPECT_EQ(TableCompressionPB::TABLE_COMPRESSION_LZ4, properties_pb.compression());
+  EXPECT_EQ(3, properties_pb.compression_level());
+  auto system_compression = get_system_compression("compressed");
+  EXPECT_EQ("org.apache.cassandra.io.compress.LZ4Compressor", system_compression["class"]);
+  EXPECT_EQ("3", system_compression["compression_level"]);
+
+  // The class reported by system_schema.tables could be used to create a table.
+  EXEC_VALID_STMT(Format(
+      "CREATE TABLE compressed_copy (c1 int PRIMARY KEY, c2 int) WITH compression = "
+      "{'class': '$0'};", system_compression["class"]));
+  EXPECT_EQ(TableCompressionPB::TABLE_COMPRESSION_LZ4,
+            get_properties("compressed_copy").compression());
+
+  EXEC_VALID_STMT("ALTER TABLE compressed WITH compression = {'class': 'SnappyCompressor'};");
+  EXPECT_EQ(TableCompressionPB::TABLE_COMPRESSION_SNAPPY,
+            get_properties("compressed").compression());
+
+  EXEC_VALID_STMT("ALTER TABLE compressed WITH compression = {'sstable_compression': ''};");
+  EXPECT_EQ(TableCompressionPB::TABLE_COMPRESSION_NONE,
+            get_properties("compressed").compression());
+  system_compression = get_system_compression("compressed");
+  EXPECT_EQ("false", system_compression["enabled"]);
+  EXPECT_EQ(0, system_compression.count("class"));
+
+  // Tables without the property use the default compression of tablet servers.
+  EXEC_VALID_STMT("CREATE TABLE uncompressed (c1 int PRIMARY KEY, c2 int);");
+  EXPECT_FALSE(get_properties("uncompressed").has_compression());
+  EXPECT_TRUE(get_system_compression("uncompressed").empty());
+
+  // ZSTD is not available in this build, so it is rejected instead of silently replaced.
+  EXEC_INVALID_STMT("CREATE TABLE zstd (c1 int PRIMARY KEY, c2 int) WITH compression = "
+                    "{'class': 'ZstdCompressor'};");
+  EXEC_INVALID_STMT("ALTER TABLE compressed WITH compression = {'class': 'ZstdCompressor'};");
+  EXPECT_EQ(TableCompressionPB::TABLE_COMPRESSION_NONE,
+            get_properties("compressed").compression());
+}
+
 TEST_F(TestQLCreateTable, TestQLCreateTableWithClusteringOrderBy) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -24,11 +24,34 @@
 #include "yb/client/table_creator.h"
 #include "yb/client/transaction_pool.h"
 
+#include "yb/util/flag_tags.h"
+
 #include "yb/yql/cql/ql/ptree/pt_grant_revoke.h"
 #include "yb/yql/cql/ql/util/ql_env.h"
 
 DEFINE_bool(use_cassandra_authentication, false, "If to require authentication on startup.");
 
+DEFINE_int32(cql_rpc_priority, yb::rpc::RpcPriority::NORMAL_PRIORITY,
+             "Priority of RPCs sent by CQL to tablet servers, used for QoS scheduling when "
+             "rpc_enable_qos is set: 1 - low, 2 - normal, 3 - high. The RPCs are attributed to "
+             "the keyspace of the table they access as tenant.");
+TAG_FLAG(cql_rpc_priority, advanced);
+
+namespace {
+
+bool ValidateCqlRpcPriority(const char* flagname, int32_t value) {
+  if (!yb::rpc::RpcPriority_IsValid(value)) {
+    LOG(ERROR) << "Invalid value for " << flagname << ": " << value;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+__attribute__((unused))
+DEFINE_validator(cql_rpc_priority, &ValidateCqlRpcPriority);
+
 namespace yb {
 namespace ql {
 
@@ -102,7 +125,11 @@ Result<YBTransactionPtr> QLEnv::NewTransaction(const YBTransactionPtr& transacti
 }
 
 YBSessionPtr QLEnv::NewSession() {
-  return std::make_shared<YBSession>(client_, clock_);
+  auto result = std::make_shared<YBSession>(client_, clock_);
+  // CQL session could access tables of different keyspaces, so it does not specify tenant, and
+  // each RPC is attributed to the keyspace of its table.
+  result->SetRpcQos(static_cast<rpc::RpcPriority>(FLAGS_cql_rpc_priority), std::string());
+  return result;
 }
 
 //------------------------------------------------------------------------------------------------
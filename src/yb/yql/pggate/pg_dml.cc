@@ -16,10 +16,12 @@
 #include "yb/client/table.h"
 #include "yb/client/yb_op.h"
 #include "yb/common/pg_system_attr.h"
+#include "yb/common/ql_value.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/util/debug-util.h"
 #include "yb/yql/pggate/pg_dml.h"
 #include "yb/yql/pggate/pg_select_index.h"
+#include "yb/yql/pggate/pggate_flags.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
 namespace yb {
@@ -313,7 +315,33 @@ Status PgDml::Fetch(int32_t natts,
   return Status::OK();
 }
 
+void PgDml::GetDocDBStats(PgDocDBStats* stats) const {
+  if (doc_op_) {
+    doc_op_->GetDocDBStats(stats);
+  }
+  if (secondary_index_query_) {
+    secondary_index_query_->GetDocDBStats(stats);
+  }
+}
+
+void PgDml::GetDocDBTabletStats(std::vector<PgDocDBStats>* stats) const {
+  if (doc_op_) {
+    doc_op_->GetDocDBTabletStats(stats);
+  }
+  if (secondary_index_query_) {
+    secondary_index_query_->GetDocDBTabletStats(stats);
+  }
+}
+
 Result<bool> PgDml::FetchDataFromServer() {
+  if (has_group_by()) {
+    if (group_aggregates_merged_) {
+      return false;
+    }
+    RETURN_NOT_OK(MergeGroupAggregates());
+    return true;
+  }
+
   // Get the rowsets from doc-operator.
   RETURN_NOT_OK(doc_op_->GetResult(&rowsets_));
 
@@ -338,6 +366,124 @@ Result<bool> PgDml::FetchDataFromServer() {
   return true;
 }
 
+namespace {
+
+// Adds the partial sum or count in "partial" to "merged".
+CHECKED_STATUS MergePartialSum(const QLValuePB& partial, QLValuePB* merged) {
+  switch (merged->value_case()) {
+    case InternalType::kInt8Value:
+      merged->set_int8_value(merged->int8_value() + partial.int8_value());
+      break;
+    case InternalType::kInt16Value:
+      merged->set_int16_value(merged->int16_value() + partial.int16_value());
+      break;
+    case InternalType::kInt32Value:
+      merged->set_int32_value(merged->int32_value() + partial.int32_value());
+      break;
+    case InternalType::kInt64Value:
+      merged->set_int64_value(merged->int64_value() + partial.int64_value());
+      break;
+    case InternalType::kFloatValue:
+      merged->set_float_value(merged->float_value() + partial.float_value());
+      break;
+    case InternalType::kDoubleValue:
+      merged->set_double_value(merged->double_value() + partial.double_value());
+      break;
+    default:
+      return STATUS_FORMAT(NotSupported, "Cannot merge partial SUM of type $0",
+                           merged->value_case());
+  }
+  return Status::OK();
+}
+
+// Merges the partial aggregate of a target into the aggregate of the same group.
+CHECKED_STATUS MergePartialAggregate(const PgExpr& target, const QLValuePB& partial,
+                                     QLValuePB* merged) {
+  if (!target.is_aggregate() || QLValue::IsNull(partial)) {
+    return Status::OK();
+  }
+  if (QLValue::IsNull(*merged)) {
+    *merged = partial;
+    return Status::OK();
+  }
+  switch (target.opcode()) {
+    case PgExpr::Opcode::PG_EXPR_COUNT: FALLTHROUGH_INTENDED;
+    case PgExpr::Opcode::PG_EXPR_SUM:
+      return MergePartialSum(partial, merged);
+    case PgExpr::Opcode::PG_EXPR_MIN:
+      if (Compare(partial, *merged) < 0) {
+        *merged = partial;
+      }
+      return Status::OK();
+    case PgExpr::Opcode::PG_EXPR_MAX:
+      if (Compare(partial, *merged) > 0) {
+        *merged = partial;
+      }
+      return Status::OK();
+    default:
+      return STATUS_FORMAT(NotSupported, "Cannot merge partial aggregate $0",
+                           static_cast<int>(target.opcode()));
+  }
+}
+
+} // namespace
+
+Status PgDml::MergeGroupAggregates() {
+  // Partial aggregates of a group can come from any tablet or page, so they are merged until all
+  // the responses are received or there are too many groups. In the latter case, the merged groups
+  // are returned and the rest of the responses are merged by the next call.
+  const size_t max_groups = std::max(FLAGS_ysql_max_merged_groups, 1);
+  std::list<PgDocResult> partial_rowsets;
+  std::vector<QLValuePB> row(targets_.size());
+  std::string group_key;
+  while (!doc_op_->end_of_data() && groups_.size() < max_groups) {
+    partial_rowsets.clear();
+    RETURN_NOT_OK(doc_op_->GetResult(&partial_rowsets));
+    for (auto& rowset : partial_rowsets) {
+      Slice cursor;
+      int64_t row_count = 0;
+      PgDocData::LoadCache(rowset.data(), &row_count, &cursor);
+      for (int64_t i = 0; i < row_count; i++) {
+        // Groups are identified by the encoded values of the non-aggregate targets, which are the
+        // grouping columns.
+        group_key.clear();
+        for (size_t col = 0; col < targets_.size(); col++) {
+          RETURN_NOT_OK(ReadColumn(targets_[col]->internal_type(), &cursor, &row[col]));
+          if (!targets_[col]->is_aggregate()) {
+            const uint32_t value_size = row[col].ByteSize();
+            group_key.append(reinterpret_cast<const char*>(&value_size), sizeof(value_size));
+            row[col].AppendToString(&group_key);
+          }
+        }
+
+        auto it = group_index_.find(group_key);
+        if (it == group_index_.end()) {
+          group_index_.emplace(group_key, groups_.size());
+          groups_.push_back(row);
+          continue;
+        }
+        auto& group = groups_[it->second];
+        for (size_t col = 0; col < targets_.size(); col++) {
+          RETURN_NOT_OK(MergePartialAggregate(*targets_[col], row[col], &group[col]));
+        }
+      }
+    }
+  }
+  group_aggregates_merged_ = doc_op_->end_of_data();
+
+  faststring buffer;
+  PgWire::WriteInt64(groups_.size(), &buffer);
+  for (const auto& group : groups_) {
+    for (const auto& value : group) {
+      RETURN_NOT_OK(WriteColumn(value, &buffer));
+    }
+  }
+  rowsets_.emplace_back(buffer.ToString());
+  groups_.clear();
+  group_index_.clear();
+  return Status::OK();
+}
+
 Result<bool> PgDml::GetNextRow(PgTuple *pg_tuple) {
   for (auto rowset_iter = rowsets_.begin(); rowset_iter != rowsets_.end();) {
     // Check if the rowset has any data.
@@ -449,7 +595,8 @@ bool PgDml::has_aggregate_targets() {
       num_aggregate_targets++;
   }
 
-  CHECK(num_aggregate_targets == 0 || num_aggregate_targets == targets_.size())
+  CHECK(num_aggregate_targets == 0 || num_aggregate_targets == targets_.size() ||
+        has_group_by())
     << "Some, but not all, targets are aggregate expressions.";
 
   return num_aggregate_targets > 0;
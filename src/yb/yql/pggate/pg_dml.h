@@ -80,6 +80,18 @@ class PgDml : public PgStatement {
 
   bool has_aggregate_targets();
 
+  // Whether the aggregate targets are grouped by GROUP BY expressions pushed down to DocDB.
+  virtual bool has_group_by() const {
+    return false;
+  }
+
+  // Add DocDB statistics of the reads performed by this statement to stats.
+  void GetDocDBStats(PgDocDBStats* stats) const;
+
+  // Append DocDB statistics of the reads performed by this statement on each tablet to stats.
+  // Tablet ids of the statistics point to memory owned by this statement.
+  void GetDocDBTabletStats(std::vector<PgDocDBStats>* stats) const;
+
   bool has_doc_op() {
     return doc_op_ != nullptr;
   }
@@ -108,6 +120,11 @@ class PgDml : public PgStatement {
   // Update bind values.
   CHECKED_STATUS UpdateBindPBs();
 
+  // Reads the partial GROUP BY aggregates from the tablets and merges the rows of the same group.
+  // The merged rows, one per group, are added to rowsets_. At most ysql_max_merged_groups groups
+  // are merged at a time, so a group could be returned by more than one call.
+  CHECKED_STATUS MergeGroupAggregates();
+
   // Update set values.
   CHECKED_STATUS UpdateAssignPBs();
 
@@ -193,6 +210,14 @@ class PgDml : public PgStatement {
   std::list<PgDocResult> rowsets_;
   int64_t current_row_order_ = 0;
 
+  // Whether the partial GROUP BY aggregates of the current execution have been merged already.
+  bool group_aggregates_merged_ = false;
+
+  // Groups merged by MergeGroupAggregates(), group_index_ maps the encoded grouping values to the
+  // position of the group.
+  std::unordered_map<std::string, size_t> group_index_;
+  std::vector<std::vector<QLValuePB>> groups_;
+
   //------------------------------------------------------------------------------------------------
   // Hashed and range values/components used to compute the tuple id.
   //
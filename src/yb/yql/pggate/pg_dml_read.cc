@@ -77,6 +77,15 @@ PgsqlExpressionPB *PgDmlRead::AllocTargetPB() {
   return read_req_->add_targets();
 }
 
+Status PgDmlRead::AppendGroupBy(PgExpr *group_by) {
+  SCHECK(!secondary_index_query_, NotSupported, "GROUP BY pushdown is not supported with index");
+
+  PgsqlExpressionPB *expr_pb = read_req_->add_group_by_exprs();
+  RETURN_NOT_OK(group_by->PrepareForRead(this, expr_pb));
+  expr_binds_[expr_pb] = group_by;
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 // RESULT SET SUPPORT.
 // For now, selected expressions are just a list of column names (ref).
@@ -155,6 +164,9 @@ Status PgDmlRead::Exec(const PgExecParameters *exec_params) {
   if (doc_op_) {
     doc_op_->Initialize(exec_params);
   }
+  group_aggregates_merged_ = false;
+  group_index_.clear();
+  groups_.clear();
 
   // Set column references in protobuf and whether query is aggregate.
   SetColumnRefs();
@@ -75,6 +75,14 @@ class PgDmlRead : public PgDml {
   // Bind a column with an IN condition.
   CHECKED_STATUS BindColumnCondIn(int attnum, int n_attr_values, PgExpr **attr_values);
 
+  // Append a GROUP BY expression. Aggregate targets are then computed per group in DocDB, and
+  // non-aggregate targets must be grouping expressions.
+  CHECKED_STATUS AppendGroupBy(PgExpr *group_by);
+
+  bool has_group_by() const override {
+    return read_req_ && read_req_->group_by_exprs_size() > 0;
+  }
+
   // Execute.
   virtual CHECKED_STATUS Exec(const PgExecParameters *exec_params);
 
@@ -166,6 +166,44 @@ Result<int32_t> PgDocOp::GetRowsAffectedCount() const {
   return GetRowsAffectedCountImpl();
 }
 
+void PgDocOp::GetDocDBStats(PgDocDBStats* stats) const {
+  for (const auto& p : tablet_docdb_stats_) {
+    const auto& source = p.second;
+    stats->num_tablet_reads += source.num_tablet_reads;
+    stats->num_seeks += source.num_seeks;
+    stats->num_nexts += source.num_nexts;
+    stats->num_skipped_entries += source.num_skipped_entries;
+    stats->num_intents_scanned += source.num_intents_scanned;
+    stats->block_cache_hits += source.block_cache_hits;
+    stats->block_cache_misses += source.block_cache_misses;
+    stats->bloom_checks += source.bloom_checks;
+    stats->bloom_useful += source.bloom_useful;
+    stats->sst_files_touched += source.sst_files_touched;
+  }
+}
+
+void PgDocOp::GetDocDBTabletStats(std::vector<PgDocDBStats>* stats) const {
+  for (const auto& p : tablet_docdb_stats_) {
+    stats->push_back(p.second);
+  }
+}
+
+void PgDocOp::AddDocDBStats(const DocDBStatsPB& source) {
+  auto it = tablet_docdb_stats_.emplace(source.tablet_id(), PgDocDBStats()).first;
+  auto& stats = it->second;
+  stats.tablet_id = it->first.c_str();
+  ++stats.num_tablet_reads;
+  stats.num_seeks += source.num_seeks();
+  stats.num_nexts += source.num_nexts();
+  stats.num_skipped_entries += source.num_skipped_entries();
+  stats.num_intents_scanned += source.num_intents_scanned();
+  stats.block_cache_hits += source.block_cache_hits();
+  stats.block_cache_misses += source.block_cache_misses();
+  stats.bloom_checks += source.bloom_checks();
+  stats.bloom_useful += source.bloom_useful();
+  stats.sst_files_touched += source.sst_files_touched();
+}
+
 Status PgDocOp::SendRequest(bool force_non_bufferable) {
   DCHECK(exec_status_.ok());
   DCHECK(!response_.InProgress());
@@ -205,6 +243,9 @@ void PgDocReadOp::Initialize(const PgExecParameters *exec_params) {
   template_op_->mutable_request()->set_return_paging_state(true);
   SetRequestPrefetchLimit();
   SetRowMark();
+  if (exec_params_.collect_docdb_stats) {
+    template_op_->mutable_request()->set_collect_docdb_stats(true);
+  }
 }
 
 Status PgDocReadOp::CreateBatchOps(int partition_count) {
@@ -450,6 +491,9 @@ Result<std::list<PgDocResult>> PgDocReadOp::ProcessResponseImpl() {
   std::list<PgDocResult> result;
   for (const auto& read_op : read_ops_) {
     RETURN_NOT_OK(pg_session_->HandleResponse(*read_op, PgObjectId()));
+    if (read_op->response().has_docdb_stats()) {
+      AddDocDBStats(read_op->response().docdb_stats());
+    }
   }
 
   if (batch_row_orders_.size() == 0) {
@@ -16,6 +16,7 @@
 #define YB_YQL_PGGATE_PG_DOC_OP_H_
 
 #include <deque>
+#include <map>
 
 #include "yb/util/locks.h"
 #include "yb/client/yb_op.h"
@@ -65,6 +66,11 @@ class PgDocResult {
     return row_count_;
   }
 
+  // Raw data of this batch as sent by DocDB.
+  const string& data() const {
+    return data_;
+  }
+
  private:
   // Data selected from DocDB.
   string data_;
@@ -116,6 +122,17 @@ class PgDocOp : public std::enable_shared_from_this<PgDocOp> {
 
   Result<int32_t> GetRowsAffectedCount() const;
 
+  // Add DocDB statistics received by this op to stats.
+  void GetDocDBStats(PgDocDBStats* stats) const;
+
+  // Append DocDB statistics received by this op from each tablet to stats.
+  void GetDocDBTabletStats(std::vector<PgDocDBStats>* stats) const;
+
+  // Whether all requested data has been received.
+  bool end_of_data() const {
+    return end_of_data_;
+  }
+
   // Instruct this doc_op to abandon execution and querying data by setting end_of_data_ to 'true'.
   // - This op will not send request to tablet server.
   // - This op will return empty result-set when being requested for data.
@@ -124,6 +141,9 @@ class PgDocOp : public std::enable_shared_from_this<PgDocOp> {
   }
 
  protected:
+  // Add DocDB statistics received from a tablet.
+  void AddDocDBStats(const DocDBStatsPB& stats);
+
   // Session control.
   PgSession::ScopedRefPtr pg_session_;
 
@@ -147,6 +167,10 @@ class PgDocOp : public std::enable_shared_from_this<PgDocOp> {
   // Next request will be sent in case upper level will ask for additional data.
   bool suppress_next_result_prefetching_ = false;
 
+  // DocDB statistics accumulated from responses of each tablet, when requested by exec_params_.
+  // Tablet id of the statistics points to the key.
+  std::map<std::string, PgDocDBStats> tablet_docdb_stats_;
+
  private:
   CHECKED_STATUS SendRequest(bool force_non_bufferable);
 
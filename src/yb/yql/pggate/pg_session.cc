@@ -13,6 +13,7 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <future>
 #include <memory>
 #include <boost/optional.hpp>
 
@@ -221,6 +222,35 @@ void InitKeyColumnPrimitiveValues(
   }
 }
 
+// Owns a request started by PgSharedExchangeClient::Start. When the flush result is dropped without
+// being checked, the response is still waited for, so the exchange is free for the next request.
+class SharedExchangeWaiter {
+ public:
+  explicit SharedExchangeWaiter(PgSharedExchangeClient* client) : client_(client) {}
+
+  SharedExchangeWaiter(SharedExchangeWaiter&& rhs) : client_(rhs.client_) {
+    rhs.client_ = nullptr;
+  }
+
+  SharedExchangeWaiter(const SharedExchangeWaiter&) = delete;
+  void operator=(const SharedExchangeWaiter&) = delete;
+
+  ~SharedExchangeWaiter() {
+    if (client_) {
+      WARN_NOT_OK(ResultToStatus(client_->Wait()), "Shared exchange request failed");
+    }
+  }
+
+  Result<PgSharedExchangeClient::ReadOps> Wait() {
+    auto* client = client_;
+    client_ = nullptr;
+    return client->Wait();
+  }
+
+ private:
+  PgSharedExchangeClient* client_;
+};
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -311,18 +341,74 @@ Status PgSession::RunHelper::Apply(std::shared_ptr<client::YBPgsqlOp> op,
     // (transactional or non-transactional)
     DCHECK_EQ(yb_session_.get(), session);
   }
+  if (op->type() == YBOperation::Type::PGSQL_READ &&
+      UseSharedExchange(down_cast<client::YBPgsqlReadOp&>(*op), read_only, *yb_session_)) {
+    shared_exchange_ops_.push_back(std::static_pointer_cast<client::YBPgsqlReadOp>(op));
+    return Status::OK();
+  }
+  ++applied_ops_;
   return yb_session_->Apply(std::move(op));
 }
 
+bool PgSession::RunHelper::UseSharedExchange(
+    const client::YBPgsqlReadOp& op, bool read_only, const client::YBSession& session) const {
+  if (!pg_session_.shared_exchange_client_ || !read_only ||
+      op.yb_consistency_level() != YBConsistencyLevel::STRONG) {
+    return false;
+  }
+  // Serializable reads write intents, that have to be tracked by YBTransaction. Snapshot reads only
+  // need the transaction metadata and read point, that the tablet server gets from the request.
+  const auto& transaction = session.transaction();
+  return !transaction || transaction->isolation() == IsolationLevel::SNAPSHOT_ISOLATION;
+}
+
 Result<PgSessionAsyncRunResult> PgSession::RunHelper::Flush() {
-  if (yb_session_) {
-    auto future_status = MakeFuture<Status>([this](auto callback) {
+  if (!yb_session_) {
+    // All operations were buffered, no need to flush.
+    return PgSessionAsyncRunResult();
+  }
+
+  auto* exchange_client = pg_session_.shared_exchange_client_.get();
+  bool exchange_started = false;
+  if (!shared_exchange_ops_.empty()) {
+    // Reads sent through RPC in the same flush should use the same read time.
+    exchange_started = exchange_client->Start(
+        yb_session_.get(), shared_exchange_ops_, client::ForceConsistentRead(applied_ops_ != 0));
+    if (!exchange_started) {
+      for (auto& op : shared_exchange_ops_) {
+        RETURN_NOT_OK(yb_session_->Apply(std::move(op)));
+      }
+      applied_ops_ += shared_exchange_ops_.size();
+    }
+    shared_exchange_ops_.clear();
+  }
+
+  std::future<Status> future_status;
+  if (applied_ops_) {
+    future_status = MakeFuture<Status>([this](auto callback) {
       yb_session_->FlushAsync([callback](const Status& status) { callback(status); });
     });
-    return PgSessionAsyncRunResult(std::move(future_status), std::move(yb_session_));
   }
-  // All operations were buffered, no need to flush.
-  return PgSessionAsyncRunResult();
+  if (exchange_started) {
+    // Ops of tablets not led by the local tablet server are sent through RPC once the response
+    // tells which ones they are.
+    future_status = std::async(
+        std::launch::deferred,
+        [waiter = SharedExchangeWaiter(exchange_client), session = yb_session_,
+         rpc_status = std::move(future_status)]() mutable -> Status {
+      auto rpc_ops = waiter.Wait();
+      auto status = rpc_status.valid() ? rpc_status.get() : Status::OK();
+      RETURN_NOT_OK(rpc_ops);
+      if (!status.ok() || rpc_ops->empty()) {
+        return status;
+      }
+      for (auto& op : *rpc_ops) {
+        RETURN_NOT_OK(session->Apply(std::move(op)));
+      }
+      return session->FlushFuture().get();
+    });
+  }
+  return PgSessionAsyncRunResult(std::move(future_status), std::move(yb_session_));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -398,6 +484,7 @@ PgSession::PgSession(
     scoped_refptr<PgTxnManager> pg_txn_manager,
     scoped_refptr<server::HybridClock> clock,
     const tserver::TServerSharedObject* tserver_shared_object,
+    tserver::PgSharedExchangeArea* pg_shared_exchange_area,
     const YBCPgCallbacks& pg_callbacks)
     : client_(client),
       session_(client_->NewSession()),
@@ -405,6 +492,10 @@ PgSession::PgSession(
       clock_(std::move(clock)),
       tserver_shared_object_(tserver_shared_object),
       pg_callbacks_(pg_callbacks) {
+  if (pg_shared_exchange_area) {
+    shared_exchange_client_ = std::make_unique<PgSharedExchangeClient>(
+        pg_shared_exchange_area, clock_);
+  }
 
   session_->SetTimeout(MonoDelta::FromMilliseconds(FLAGS_pg_yb_session_timeout_ms));
   session_->SetForceConsistentRead(client::ForceConsistentRead::kTrue);
@@ -417,6 +508,7 @@ PgSession::~PgSession() {
 
 Status PgSession::ConnectDatabase(const string& database_name) {
   connected_database_ = database_name;
+  session_->SetRpcQos(static_cast<rpc::RpcPriority>(FLAGS_ysql_rpc_priority), database_name);
   return Status::OK();
 }
 
@@ -800,6 +892,8 @@ Result<YBSession*> PgSession::GetSession(bool transactional,
                                          bool needs_pessimistic_locking) {
   if (transactional) {
     YBSession* txn_session = VERIFY_RESULT(pg_txn_manager_->GetTransactionalSession());
+    txn_session->SetRpcQos(static_cast<rpc::RpcPriority>(FLAGS_ysql_rpc_priority),
+                           connected_database_);
     RETURN_NOT_OK(pg_txn_manager_->BeginWriteTransactionIfNecessary(read_only_op,
                                                                     needs_pessimistic_locking));
     VLOG(2) << __PRETTY_FUNCTION__
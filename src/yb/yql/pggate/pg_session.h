@@ -30,6 +30,7 @@
 #include "yb/util/result.h"
 
 #include "yb/yql/pggate/pg_env.h"
+#include "yb/yql/pggate/pg_shared_exchange_client.h"
 #include "yb/yql/pggate/pg_tabledesc.h"
 
 namespace yb {
@@ -105,6 +106,7 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
             scoped_refptr<PgTxnManager> pg_txn_manager,
             scoped_refptr<server::HybridClock> clock,
             const tserver::TServerSharedObject* tserver_shared_object,
+            tserver::PgSharedExchangeArea* pg_shared_exchange_area,
             const YBCPgCallbacks& pg_callbacks);
   virtual ~PgSession();
 
@@ -292,10 +294,17 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
     Result<PgSessionAsyncRunResult> Flush();
 
    private:
+    // Whether op could be sent to the local tablet server through shared memory.
+    bool UseSharedExchange(const client::YBPgsqlReadOp& op, bool read_only,
+                           const client::YBSession& session) const;
+
     PgSession& pg_session_;
     bool transactional_;
     PgsqlOpBuffer& buffered_ops_;
     client::YBSessionPtr yb_session_;
+    // Operations applied to yb_session_.
+    size_t applied_ops_ = 0;
+    std::vector<std::shared_ptr<client::YBPgsqlReadOp>> shared_exchange_ops_;
   };
 
   // Run multiple operations.
@@ -359,6 +368,9 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   std::unordered_set<RowIdentifier, boost::hash<RowIdentifier>> buffered_keys_;
 
   const tserver::TServerSharedObject* const tserver_shared_object_;
+
+  // Not null if reads could be sent to the local tablet server through shared memory.
+  std::unique_ptr<PgSharedExchangeClient> shared_exchange_client_;
   const YBCPgCallbacks& pg_callbacks_;
 };
 
@@ -0,0 +1,189 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/pggate/pg_shared_exchange_client.h"
+
+#include <unistd.h>
+
+#include <glog/logging.h>
+
+#include "yb/client/session.h"
+#include "yb/client/table.h"
+#include "yb/client/transaction.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/common/consistent_read_point.h"
+#include "yb/common/wire_protocol.h"
+
+#include "yb/gutil/casts.h"
+
+#include "yb/tserver/tserver_shared_mem.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace pggate {
+
+PgSharedExchangeClient::PgSharedExchangeClient(
+    tserver::PgSharedExchangeArea* area, scoped_refptr<server::HybridClock> clock)
+    : area_(area),
+      clock_(std::move(clock)),
+      exchange_(area_->Acquire()) {
+  LOG_IF(WARNING, !exchange_) << "No free shared exchange, all reads will be sent through RPC";
+}
+
+PgSharedExchangeClient::~PgSharedExchangeClient() {
+  if (exchange_) {
+    exchange_->Release(getpid());
+  }
+}
+
+bool PgSharedExchangeClient::Start(
+    client::YBSession* session, ReadOps ops, client::ForceConsistentRead force_consistent_read) {
+  if (!exchange_ || in_flight_) {
+    return false;
+  }
+
+  request_.Clear();
+  for (const auto& op : ops) {
+    auto* op_pb = request_.add_ops();
+    // Also narrows hash code bounds of the request, the same as the batcher does.
+    if (!op->GetPartitionKey(op_pb->mutable_partition_key()).ok()) {
+      // The batcher reports the failure.
+      return false;
+    }
+    op_pb->set_table_id(op->table()->id());
+    // Copy the request, so it is still available when the op should be sent through RPC.
+    *op_pb->mutable_request() = op->request();
+  }
+  const auto timeout = session->timeout();
+  deadline_ = CoarseMonoClock::now() + timeout.ToSteadyDuration();
+  request_.set_timeout_ms(timeout.ToMilliseconds());
+
+  sent_ = false;
+  transaction_ = session->transaction();
+  if (transaction_) {
+    // Transaction metadata is not known until the status tablet is picked, the request is sent by
+    // Wait in this case.
+    transaction_data_ = transaction_->PrepareChildFuture(force_consistent_read, deadline_);
+    if (transaction_data_.wait_for(0s) == std::future_status::ready) {
+      auto data = transaction_data_.get();
+      if (!data.ok()) {
+        transaction_ = nullptr;
+        return false;
+      }
+      request_.mutable_read_point()->Swap(&*data);
+      if (!Send()) {
+        transaction_ = nullptr;
+        return false;
+      }
+    }
+  } else {
+    read_point_ = session->read_point();
+    if (read_point_) {
+      if (force_consistent_read && !read_point_->GetReadTime()) {
+        read_point_->SetCurrentReadTime();
+      }
+      read_point_->PrepareChildTransactionData(request_.mutable_read_point());
+    }
+    if (!Send()) {
+      return false;
+    }
+  }
+
+  ops_ = std::move(ops);
+  in_flight_ = true;
+  return true;
+}
+
+bool PgSharedExchangeClient::Send() {
+  const size_t request_size = request_.ByteSizeLong();
+  if (request_size > exchange_->buffer_size()) {
+    return false;
+  }
+  request_.SerializeWithCachedSizesToArray(pointer_cast<uint8_t*>(exchange_->buffer()));
+  exchange_->SendRequest(area_, request_size);
+  sent_ = true;
+  return true;
+}
+
+Result<PgSharedExchangeClient::ReadOps> PgSharedExchangeClient::Wait() {
+  DCHECK(in_flight_);
+  auto result = DoWait();
+  in_flight_ = false;
+  ops_.clear();
+  read_point_ = nullptr;
+  transaction_ = nullptr;
+  return result;
+}
+
+Result<PgSharedExchangeClient::ReadOps> PgSharedExchangeClient::DoWait() {
+  if (!sent_) {
+    auto data = VERIFY_RESULT(transaction_data_.get());
+    request_.mutable_read_point()->Swap(&data);
+    if (!Send()) {
+      return ops_;
+    }
+  }
+
+  auto response_data = exchange_->WaitResponse(deadline_, &response_parts_);
+  if (!response_data.ok()) {
+    if (!exchange_->idle()) {
+      // The tablet server still owns the buffer, stop using shared memory in this backend.
+      LOG(WARNING) << "Shared exchange request failed: " << response_data.status();
+      exchange_->Release(getpid());
+      exchange_ = nullptr;
+    }
+    return response_data.status();
+  }
+
+  tserver::PgSharedExchangeResponsePB resp;
+  if (!resp.ParseFromArray(response_data->data(), response_data->size())) {
+    return STATUS(Corruption, "Failed to parse shared exchange response");
+  }
+  if (resp.has_propagated_hybrid_time()) {
+    clock_->Update(HybridTime(resp.propagated_hybrid_time()));
+  }
+  // Read restart is reported as failure, so the result is applied first.
+  if (resp.has_read_point_result()) {
+    if (transaction_) {
+      RETURN_NOT_OK(transaction_->ApplyChildResult(resp.read_point_result()));
+    } else if (read_point_) {
+      read_point_->ApplyChildTransactionResult(resp.read_point_result());
+    }
+  }
+  if (resp.has_status()) {
+    RETURN_NOT_OK(StatusFromPB(resp.status()));
+  }
+  if (resp.responses().size() != ops_.size() || resp.rows_data().size() != ops_.size()) {
+    return STATUS_FORMAT(
+        IllegalState, "Got $0 responses for $1 operations through shared exchange",
+        resp.responses().size(), ops_.size());
+  }
+
+  ReadOps rpc_ops;
+  auto rpc_it = resp.rpc_ops().begin();
+  for (size_t i = 0; i != ops_.size(); ++i) {
+    if (rpc_it != resp.rpc_ops().end() && *rpc_it == i) {
+      rpc_ops.push_back(ops_[i]);
+      ++rpc_it;
+      continue;
+    }
+    ops_[i]->mutable_response()->Swap(resp.mutable_responses(i));
+    ops_[i]->mutable_rows_data()->swap(*resp.mutable_rows_data(i));
+  }
+  return rpc_ops;
+}
+
+}  // namespace pggate
+}  // namespace yb
@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_YQL_PGGATE_PG_SHARED_EXCHANGE_CLIENT_H_
+#define YB_YQL_PGGATE_PG_SHARED_EXCHANGE_CLIENT_H_
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/common/common.pb.h"
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/server/hybrid_clock.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+
+namespace yb {
+
+class ConsistentReadPoint;
+
+namespace tserver {
+
+class PgSharedExchange;
+class PgSharedExchangeArea;
+
+} // namespace tserver
+
+namespace pggate {
+
+// Sends read operations of this backend to the local tablet server through the shared memory
+// segment, bypassing the RPC stack. The tablet server executes operations of the tablets it leads
+// and returns the rest, that are sent through RPC. Operations that have to be tracked by
+// YBTransaction, i.e. serializable reads, are not eligible, see PgSession::RunHelper.
+class PgSharedExchangeClient {
+ public:
+  typedef std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ReadOps;
+
+  PgSharedExchangeClient(
+      tserver::PgSharedExchangeArea* area, scoped_refptr<server::HybridClock> clock);
+
+  ~PgSharedExchangeClient();
+
+  // Starts execution of 'ops' in the context of 'session', Wait should be called to get the
+  // results. Returns false if 'ops' should be executed through 'session' as usual instead, e.g.
+  // because the previous request is still in flight or the request does not fit the shared buffer.
+  // 'force_consistent_read' should be set when the session executes other reads concurrently, so
+  // all of them use the same read time.
+  bool Start(client::YBSession* session, ReadOps ops,
+             client::ForceConsistentRead force_consistent_read);
+
+  // Waits for the request sent by Start. Fills responses of the executed ops and returns the ops
+  // that the caller should execute through RPC, because the tablet server does not lead their
+  // tablets.
+  Result<ReadOps> Wait();
+
+ private:
+  // Serializes request_ into the exchange buffer and sends it. Returns false if it does not fit.
+  bool Send();
+
+  Result<ReadOps> DoWait();
+
+  tserver::PgSharedExchangeArea* const area_;
+  const scoped_refptr<server::HybridClock> clock_;
+  tserver::PgSharedExchange* exchange_;
+  // Holds responses that did not fit the exchange buffer and came in several parts.
+  std::string response_parts_;
+
+  // State of the request in flight.
+  bool in_flight_ = false;
+  bool sent_ = false;
+  ReadOps ops_;
+  tserver::PgSharedExchangeRequestPB request_;
+  CoarseTimePoint deadline_;
+  ConsistentReadPoint* read_point_ = nullptr;
+  client::YBTransactionPtr transaction_;
+  // Transaction data that is still being prepared, when the transaction was not ready at Start.
+  std::future<Result<ChildTransactionDataPB>> transaction_data_;
+};
+
+}  // namespace pggate
+}  // namespace yb
+
+#endif // YB_YQL_PGGATE_PG_SHARED_EXCHANGE_CLIENT_H_
@@ -86,6 +86,15 @@ std::unique_ptr<tserver::TServerSharedObject> InitTServerSharedObject() {
       tserver::TServerSharedObject::OpenReadOnly(FLAGS_pggate_tserver_shm_fd)));
 }
 
+std::unique_ptr<tserver::PgSharedExchangeSegment> InitPgSharedExchangeSegment() {
+  if (YBCIsInitDbModeEnvVarSet() || FLAGS_pggate_ignore_tserver_shm ||
+      !FLAGS_ysql_use_shared_exchange || FLAGS_pggate_tserver_shm_exchange_fd == -1) {
+    return nullptr;
+  }
+  return std::make_unique<tserver::PgSharedExchangeSegment>(CHECK_RESULT(
+      tserver::PgSharedExchangeSegment::Open(FLAGS_pggate_tserver_shm_exchange_fd)));
+}
+
 } // namespace
 
 using std::make_shared;
@@ -137,6 +146,7 @@ PgApiImpl::PgApiImpl(const YBCPgTypeEntity *YBCDataTypeArray, int count, YBCPgCa
                          messenger_holder_.messenger.get()),
       clock_(new server::HybridClock()),
       tserver_shared_object_(InitTServerSharedObject()),
+      pg_shared_exchange_segment_(InitPgSharedExchangeSegment()),
       pg_txn_manager_(new PgTxnManager(&async_client_init_, clock_, tserver_shared_object_.get())),
       pg_callbacks_(callbacks) {
   CHECK_OK(clock_->Init());
@@ -185,6 +195,9 @@ Status PgApiImpl::InitSession(const PgEnv *pg_env,
                                                pg_txn_manager_,
                                                clock_,
                                                tserver_shared_object_.get(),
+                                               pg_shared_exchange_segment_
+                                                   ? pg_shared_exchange_segment_->get()
+                                                   : nullptr,
                                                pg_callbacks_);
   if (!database_name.empty()) {
     RETURN_NOT_OK(session->ConnectDatabase(database_name));
@@ -632,6 +645,14 @@ Status PgApiImpl::DmlAppendTarget(PgStatement *handle, PgExpr *target) {
   return down_cast<PgDml*>(handle)->AppendTarget(target);
 }
 
+Status PgApiImpl::DmlAppendGroupBy(PgStatement *handle, PgExpr *expr) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgDmlRead*>(handle)->AppendGroupBy(expr);
+}
+
 Status PgApiImpl::DmlBindColumn(PgStatement *handle, int attr_num, PgExpr *attr_value) {
   return down_cast<PgDml*>(handle)->BindColumn(attr_num, attr_value);
 }
@@ -663,6 +684,21 @@ Status PgApiImpl::DmlFetch(PgStatement *handle, int32_t natts, uint64_t *values,
   return down_cast<PgDml*>(handle)->Fetch(natts, values, isnulls, syscols, has_data);
 }
 
+Status PgApiImpl::DmlGetDocDBStats(PgStatement *handle, PgDocDBStats *stats) {
+  *stats = PgDocDBStats();
+  down_cast<PgDml*>(handle)->GetDocDBStats(stats);
+  return Status::OK();
+}
+
+Status PgApiImpl::DmlGetDocDBTabletStats(PgStatement *handle, const PgDocDBStats **stats,
+                                         int *num_stats) {
+  docdb_tablet_stats_.clear();
+  down_cast<PgDml*>(handle)->GetDocDBTabletStats(&docdb_tablet_stats_);
+  *stats = docdb_tablet_stats_.data();
+  *num_stats = static_cast<int>(docdb_tablet_stats_.size());
+  return Status::OK();
+}
+
 Status PgApiImpl::DmlBuildYBTupleId(PgStatement *handle, const PgAttrValueDescriptor *attrs,
                                     int32_t nattrs, uint64_t *ybctid) {
   const string id = VERIFY_RESULT(down_cast<PgDml*>(handle)->BuildYBTupleId(attrs, nattrs));
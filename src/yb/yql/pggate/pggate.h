@@ -256,6 +256,9 @@ class PgApiImpl {
   // All DML statements
   CHECKED_STATUS DmlAppendTarget(PgStatement *handle, PgExpr *expr);
 
+  // Append a GROUP BY expression to a SELECT statement with aggregate targets.
+  CHECKED_STATUS DmlAppendGroupBy(PgStatement *handle, PgExpr *expr);
+
   // Binding Columns: Bind column with a value (expression) in a statement.
   // + This API is used to identify the rows you want to operate on. If binding columns are not
   //   there, that means you want to operate on all rows (full scan). You can view this as a
@@ -299,6 +302,14 @@ class PgApiImpl {
                                        bool is_null, const YBCPgTypeEntity *type_entity);
 
 
+  // Returns DocDB statistics of the reads performed by the statement.
+  CHECKED_STATUS DmlGetDocDBStats(PgStatement *handle, PgDocDBStats *stats);
+
+  // Returns DocDB statistics of the reads performed by the statement on each tablet. The result is
+  // valid until the next call or until the statement is deleted.
+  CHECKED_STATUS DmlGetDocDBTabletStats(PgStatement *handle, const PgDocDBStats **stats,
+                                        int *num_stats);
+
   // This function returns the tuple id (ybctid) of a Postgres tuple.
   CHECKED_STATUS DmlBuildYBTupleId(PgStatement *handle, const PgAttrValueDescriptor *attrs,
                                    int32_t nattrs, uint64_t *ybctid);
@@ -444,6 +455,12 @@ class PgApiImpl {
   // Local tablet-server shared memory segment handle.
   std::unique_ptr<tserver::TServerSharedObject> tserver_shared_object_;
 
+  // Segment with exchanges used to send reads to the local tablet server, if enabled.
+  std::unique_ptr<tserver::PgSharedExchangeSegment> pg_shared_exchange_segment_;
+
+  // Result of the last DmlGetDocDBTabletStats call.
+  std::vector<PgDocDBStats> docdb_tablet_stats_;
+
   scoped_refptr<PgTxnManager> pg_txn_manager_;
 
   // Mapping table of YugaByte and PostgreSQL datatypes.
@@ -16,6 +16,9 @@
 // (linked into postgres).
 
 #include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/rpc/rpc_header.pb.h"
 
 #include "yb/util/flags.h"
 #include "yb/util/flag_tags.h"
@@ -45,6 +48,15 @@ DEFINE_int32(pggate_tserver_shm_fd, -1,
 DEFINE_test_flag(bool, pggate_ignore_tserver_shm, false,
               "Ignore the shared memory of the local tablet server.");
 
+DEFINE_int32(pggate_tserver_shm_exchange_fd, -1,
+             "File descriptor of the local tablet server's shared memory segment with exchanges "
+             "used to send reads through shared memory.");
+
+DEFINE_bool(ysql_use_shared_exchange, false,
+            "Send read-only YSQL requests from postgres backends to the local tablet server "
+            "through shared memory instead of RPC.");
+TAG_FLAG(ysql_use_shared_exchange, advanced);
+
 DEFINE_int32(ysql_request_limit, 1024,
              "Maximum number of requests to be sent at once");
 
@@ -98,6 +110,33 @@ DEFINE_bool(ysql_serializable_isolation_for_ddl_txn, false,
             "By default, repeatable read isolation is used. "
             "This flag should go away once full transactional DDL is implemented.");
 
+DEFINE_int32(ysql_max_merged_groups, 100000,
+             "Max number of groups whose partial GROUP BY aggregates are merged by a YSQL scan "
+             "before they are returned to postgres. Groups seen after that may be returned "
+             "again, postgres combines rows of the same group.");
+TAG_FLAG(ysql_max_merged_groups, advanced);
+
 DEFINE_int32(ysql_select_parallelism, -1,
             "Number of read requests to issue in parallel to tablets of a table "
             "for SELECT.");
+
+DEFINE_int32(ysql_rpc_priority, yb::rpc::RpcPriority::NORMAL_PRIORITY,
+             "Priority of RPCs sent by YSQL to tablet servers, used for QoS scheduling when "
+             "rpc_enable_qos is set: 1 - low, 2 - normal, 3 - high. The RPCs are attributed to "
+             "the database they access as tenant.");
+TAG_FLAG(ysql_rpc_priority, advanced);
+
+namespace {
+
+bool ValidateYsqlRpcPriority(const char* flagname, int32_t value) {
+  if (!yb::rpc::RpcPriority_IsValid(value)) {
+    LOG(ERROR) << "Invalid value for " << flagname << ": " << value;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+__attribute__((unused))
+DEFINE_validator(ysql_rpc_priority, &ValidateYsqlRpcPriority);
@@ -22,7 +22,9 @@ DECLARE_int32(pggate_ybclient_reactor_threads);
 DECLARE_string(pggate_proxy_bind_address);
 DECLARE_string(pggate_master_addresses);
 DECLARE_int32(pggate_tserver_shm_fd);
+DECLARE_int32(pggate_tserver_shm_exchange_fd);
 DECLARE_bool(pggate_ignore_tserver_shm);
+DECLARE_bool(ysql_use_shared_exchange);
 DECLARE_int32(ysql_request_limit);
 DECLARE_int32(ysql_prefetch_limit);
 DECLARE_double(ysql_backward_prefetch_scale_factor);
@@ -31,6 +33,8 @@ DECLARE_bool(ysql_non_txn_copy);
 DECLARE_int32(ysql_max_read_restart_attempts);
 DECLARE_int32(ysql_output_buffer_size);
 DECLARE_int32(ysql_select_parallelism);
+DECLARE_int32(ysql_max_merged_groups);
+DECLARE_int32(ysql_rpc_priority);
 
 DECLARE_bool(ysql_suppress_unsupported_error);
 
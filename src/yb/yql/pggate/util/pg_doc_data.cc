@@ -24,7 +24,8 @@
 namespace yb {
 namespace pggate {
 
-Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
+template <class Buffer>
+Status WriteColumn(const QLValuePB& col_value, Buffer *buffer) {
   // Write data header.
   bool has_data = true;
   PgWireDataHeader col_header;
@@ -102,6 +103,87 @@ Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
   return Status::OK();
 }
 
+template Status WriteColumn(const QLValuePB& col_value, faststring *buffer);
+template Status WriteColumn(const QLValuePB& col_value, WriteBuffer *buffer);
+
+namespace {
+
+template <class Number>
+Number ReadColumnNumber(Slice *cursor) {
+  Number value;
+  cursor->remove_prefix(PgWire::ReadNumber(cursor, &value));
+  return value;
+}
+
+std::string ReadColumnBytes(Slice *cursor) {
+  const int64 length = ReadColumnNumber<int64>(cursor);
+  std::string value(cursor->cdata(), length);
+  cursor->remove_prefix(length);
+  return value;
+}
+
+} // namespace
+
+Status ReadColumn(InternalType type, Slice *cursor, QLValuePB *col_value) {
+  col_value->Clear();
+  if (PgDocData::ReadDataHeader(cursor).is_null()) {
+    return Status::OK();
+  }
+
+  switch (type) {
+    case InternalType::VALUE_NOT_SET:
+      break;
+    case InternalType::kBoolValue:
+      col_value->set_bool_value(ReadColumnNumber<bool>(cursor));
+      break;
+    case InternalType::kInt8Value:
+      col_value->set_int8_value(ReadColumnNumber<int8>(cursor));
+      break;
+    case InternalType::kInt16Value:
+      col_value->set_int16_value(ReadColumnNumber<int16>(cursor));
+      break;
+    case InternalType::kInt32Value:
+      col_value->set_int32_value(ReadColumnNumber<int32>(cursor));
+      break;
+    case InternalType::kInt64Value:
+      col_value->set_int64_value(ReadColumnNumber<int64>(cursor));
+      break;
+    case InternalType::kUint32Value:
+      col_value->set_uint32_value(ReadColumnNumber<uint32>(cursor));
+      break;
+    case InternalType::kUint64Value:
+      col_value->set_uint64_value(ReadColumnNumber<uint64>(cursor));
+      break;
+    case InternalType::kFloatValue:
+      col_value->set_float_value(ReadColumnNumber<float>(cursor));
+      break;
+    case InternalType::kDoubleValue:
+      col_value->set_double_value(ReadColumnNumber<double>(cursor));
+      break;
+    case InternalType::kStringValue: {
+      // Text is written with its terminating '\0'.
+      std::string value = ReadColumnBytes(cursor);
+      value.pop_back();
+      col_value->set_string_value(std::move(value));
+      break;
+    }
+    case InternalType::kBinaryValue:
+      col_value->set_binary_value(ReadColumnBytes(cursor));
+      break;
+    case InternalType::kDecimalValue: {
+      std::string value = ReadColumnBytes(cursor);
+      value.pop_back();
+      col_value->set_decimal_value(std::move(value));
+      break;
+    }
+    default:
+      return STATUS_FORMAT(NotSupported,
+          "Unexpected data type was read from DocDB result: type=$0", type);
+  }
+
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 // Read Tuple Routine in DocDB Format (wire_protocol).
 //--------------------------------------------------------------------------------------------------
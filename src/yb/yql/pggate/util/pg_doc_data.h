@@ -20,7 +20,13 @@
 namespace yb {
 namespace pggate {
 
-CHECKED_STATUS WriteColumn(const QLValuePB& col_value, faststring *buffer);
+// Buffer is either faststring or WriteBuffer.
+template <class Buffer>
+CHECKED_STATUS WriteColumn(const QLValuePB& col_value, Buffer *buffer);
+
+// Reads a column written by WriteColumn() back into a QLValuePB of the given type and moves the
+// cursor past it.
+CHECKED_STATUS ReadColumn(InternalType type, Slice *cursor, QLValuePB *col_value);
 
 class PgDocData : public PgWire {
  public:
@@ -16,6 +16,7 @@
 
 #include <bitset>
 #include "yb/util/slice.h"
+#include "yb/util/write_buffer.h"
 #include "yb/client/client.h"
 
 namespace yb {
@@ -52,31 +53,98 @@ class PgWire {
   static size_t ReadBytes(Slice *cursor, char *value, int64_t bytes);
 
   //------------------------------------------------------------------------------------------------
+  // Write functions accept either faststring or WriteBuffer. The latter is used to build responses
+  // that are sent as RPC sidecars without being copied.
+  static void WriteBytes(const void* data, size_t len, faststring *buffer) {
+    buffer->append(data, len);
+  }
+
+  static void WriteBytes(const void* data, size_t len, WriteBuffer *buffer) {
+    buffer->Append(static_cast<const char*>(data), len);
+  }
+
   // Write Numeric Data
-  template<typename num_type>
-  static void WriteInt(void (*writer)(void *, num_type), num_type value, faststring *buffer) {
+  template<typename num_type, class Buffer>
+  static void WriteInt(void (*writer)(void *, num_type), num_type value, Buffer *buffer) {
     num_type bytes;
     writer(&bytes, value);
-    buffer->append(&bytes, sizeof(num_type));
+    WriteBytes(&bytes, sizeof(num_type), buffer);
+  }
+
+  template<class Buffer>
+  static void WriteBool(bool value, Buffer *buffer) {
+    WriteBytes(&value, sizeof(bool), buffer);
+  }
+
+  template<class Buffer>
+  static void WriteInt8(int8_t value, Buffer *buffer) {
+    WriteBytes(&value, sizeof(int8_t), buffer);
+  }
+
+  template<class Buffer>
+  static void WriteUint8(uint8_t value, Buffer *buffer) {
+    WriteBytes(&value, sizeof(uint8_t), buffer);
+  }
+
+  template<class Buffer>
+  static void WriteUint16(uint16_t value, Buffer *buffer) {
+    WriteInt(NetworkByteOrder::Store16, value, buffer);
+  }
+
+  template<class Buffer>
+  static void WriteInt16(int16_t value, Buffer *buffer) {
+    WriteInt(NetworkByteOrder::Store16, static_cast<uint16>(value), buffer);
+  }
+
+  template<class Buffer>
+  static void WriteUint32(uint32_t value, Buffer *buffer) {
+    WriteInt(NetworkByteOrder::Store32, value, buffer);
+  }
+
+  template<class Buffer>
+  static void WriteInt32(int32_t value, Buffer *buffer) {
+    WriteInt(NetworkByteOrder::Store32, static_cast<uint32>(value), buffer);
+  }
+
+  template<class Buffer>
+  static void WriteUint64(uint64_t value, Buffer *buffer) {
+    WriteInt(NetworkByteOrder::Store64, value, buffer);
   }
 
-  static void WriteBool(bool value, faststring *buffer);
-  static void WriteInt8(int8_t value, faststring *buffer);
-  static void WriteUint8(uint8_t value, faststring *buffer);
-  static void WriteUint16(uint16_t value, faststring *buffer);
-  static void WriteInt16(int16_t value, faststring *buffer);
-  static void WriteUint32(uint32_t value, faststring *buffer);
-  static void WriteInt32(int32_t value, faststring *buffer);
-  static void WriteUint64(uint64_t value, faststring *buffer);
-  static void WriteInt64(int64_t value, faststring *buffer);
-  static void WriteFloat(float value, faststring *buffer);
-  static void WriteDouble(double value, faststring *buffer);
+  template<class Buffer>
+  static void WriteInt64(int64_t value, Buffer *buffer) {
+    WriteInt(NetworkByteOrder::Store64, static_cast<uint64>(value), buffer);
+  }
+
+  template<class Buffer>
+  static void WriteFloat(float value, Buffer *buffer) {
+    const uint32 int_value = *reinterpret_cast<const uint32*>(&value);
+    WriteInt(NetworkByteOrder::Store32, int_value, buffer);
+  }
+
+  template<class Buffer>
+  static void WriteDouble(double value, Buffer *buffer) {
+    const uint64 int_value = *reinterpret_cast<const uint64*>(&value);
+    WriteInt(NetworkByteOrder::Store64, int_value, buffer);
+  }
 
   // Write Text Data
-  static void WriteText(const string& value, faststring *buffer);
+  template<class Buffer>
+  static void WriteText(const string& value, Buffer *buffer) {
+    // Postgres expected text string to be null-terminated, so we have to add '\0' here.
+    // Postgres will call strlen() without using the returning byte count.
+    const uint64 length = value.size() + 1;
+    WriteInt(NetworkByteOrder::Store64, length, buffer);
+    WriteBytes(value.c_str(), length, buffer);
+  }
 
   // Write Text Data
-  static void WriteBinary(const string& value, faststring *buffer);
+  template<class Buffer>
+  static void WriteBinary(const string& value, Buffer *buffer) {
+    const uint64 length = value.size();
+    WriteInt(NetworkByteOrder::Store64, length, buffer);
+    WriteBytes(value.data(), length, buffer);
+  }
 };
 
 // Just in case we change the serialization format. Different versions of DocDB and Postgres
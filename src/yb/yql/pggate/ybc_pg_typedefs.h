@@ -214,9 +214,32 @@ typedef struct PgExecParameters {
   int rowmark = -1;
 #else
   int rowmark;
+#endif
+  // Whether DocDB should collect statistics of the reads, i.e. for EXPLAIN ANALYZE.
+#ifdef __cplusplus
+  bool collect_docdb_stats = false;
+#else
+  bool collect_docdb_stats;
 #endif
 } YBCPgExecParameters;
 
+// DocDB statistics of the reads performed by a statement.
+typedef struct PgDocDBStats {
+  // Tablet that performed the reads, NULL for statistics of all tablets.
+  const char *tablet_id;
+  // Number of tablet reads that reported statistics.
+  uint64_t num_tablet_reads;
+  uint64_t num_seeks;
+  uint64_t num_nexts;
+  uint64_t num_skipped_entries;
+  uint64_t num_intents_scanned;
+  uint64_t block_cache_hits;
+  uint64_t block_cache_misses;
+  uint64_t bloom_checks;
+  uint64_t bloom_useful;
+  uint64_t sst_files_touched;
+} YBCPgDocDBStats;
+
 typedef struct PgAttrValueDescriptor {
   int attr_num;
   uint64_t datum;
@@ -421,6 +421,10 @@ YBCStatus YBCPgDmlAppendTarget(YBCPgStatement handle, YBCPgExpr target) {
   return ToYBCStatus(pgapi->DmlAppendTarget(handle, target));
 }
 
+YBCStatus YBCPgDmlAppendGroupBy(YBCPgStatement handle, YBCPgExpr group_by) {
+  return ToYBCStatus(pgapi->DmlAppendGroupBy(handle, group_by));
+}
+
 YBCStatus YBCPgDmlBindColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value) {
   return ToYBCStatus(pgapi->DmlBindColumn(handle, attr_num, attr_value));
 }
@@ -470,6 +474,15 @@ YBCStatus YBCPgDmlExecWriteOp(YBCPgStatement handle, int32_t *rows_affected_coun
   return ToYBCStatus(pgapi->DmlExecWriteOp(handle, rows_affected_count));
 }
 
+YBCStatus YBCPgDmlGetDocDBStats(YBCPgStatement handle, YBCPgDocDBStats *stats) {
+  return ToYBCStatus(pgapi->DmlGetDocDBStats(handle, stats));
+}
+
+YBCStatus YBCPgDmlGetDocDBTabletStats(YBCPgStatement handle, const YBCPgDocDBStats **stats,
+                                      int *num_stats) {
+  return ToYBCStatus(pgapi->DmlGetDocDBTabletStats(handle, stats, num_stats));
+}
+
 YBCStatus YBCPgDmlBuildYBTupleId(YBCPgStatement handle, const YBCPgAttrValueDescriptor *attrs,
                                  int32_t nattrs, uint64_t *ybctid) {
   return ToYBCStatus(pgapi->DmlBuildYBTupleId(handle, attrs, nattrs, ybctid));
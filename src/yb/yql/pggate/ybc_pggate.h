@@ -238,6 +238,13 @@ YBCStatus YBCPgExecDropIndex(YBCPgStatement handle);
 // - INSERT / UPDATE / DELETE ... RETURNING target_expr1, target_expr2, ...
 YBCStatus YBCPgDmlAppendTarget(YBCPgStatement handle, YBCPgExpr target);
 
+// This function is for specifying the GROUP BY expressions of a SELECT with aggregate targets, so
+// that the aggregates are computed per group by DocDB.
+// - SELECT group_expr1, aggregate_expr1, ... GROUP BY group_expr1, ...
+// Partial aggregates of a group are merged in a bounded buffer, so more than one row could be
+// fetched for the same group, and the caller should combine them.
+YBCStatus YBCPgDmlAppendGroupBy(YBCPgStatement handle, YBCPgExpr group_by);
+
 // Binding Columns: Bind column with a value (expression) in a statement.
 // + This API is used to identify the rows you want to operate on. If binding columns are not
 //   there, that means you want to operate on all rows (full scan). You can view this as a
@@ -285,6 +292,15 @@ YBCStatus YBCPgDmlFetch(YBCPgStatement handle, int32_t natts, uint64_t *values,
 // Utility method that checks stmt type and calls either exec insert, update, or delete internally.
 YBCStatus YBCPgDmlExecWriteOp(YBCPgStatement handle, int32_t *rows_affected_count);
 
+// Returns DocDB statistics of the reads performed by the statement, that are collected when it is
+// executed with collect_docdb_stats set in its execution parameters.
+YBCStatus YBCPgDmlGetDocDBStats(YBCPgStatement handle, YBCPgDocDBStats *stats);
+
+// Returns DocDB statistics of the reads performed by the statement on each tablet. The returned
+// array is valid until the next call or until the statement is deleted.
+YBCStatus YBCPgDmlGetDocDBTabletStats(YBCPgStatement handle, const YBCPgDocDBStats **stats,
+                                      int *num_stats);
+
 // This function returns the tuple id (ybctid) of a Postgres tuple.
 YBCStatus YBCPgDmlBuildYBTupleId(YBCPgStatement handle, const YBCPgAttrValueDescriptor *attrs,
                                  int32_t nattrs, uint64_t *ybctid);
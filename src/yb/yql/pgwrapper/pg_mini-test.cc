@@ -47,6 +47,8 @@ DECLARE_int64(retryable_rpc_single_call_timeout_ms);
 DECLARE_uint64(max_clock_skew_usec);
 DECLARE_int64(db_write_buffer_size);
 DECLARE_bool(ysql_enable_manual_sys_table_txn_ctl);
+DECLARE_bool(ysql_enable_packed_row);
+DECLARE_int32(timestamp_history_retention_interval_sec);
 
 namespace yb {
 namespace pgwrapper {
@@ -85,6 +87,7 @@ class PgMiniTest : public YBMiniClusterTestBase<MiniCluster> {
         pg_ts->options()->fs_opts.data_paths.front() + "/pg_data",
         pg_ts->server()->GetSharedMemoryFd()));
     pg_process_conf.master_addresses = pg_ts->options()->master_addresses_flag;
+    pg_process_conf.tserver_shm_exchange_fd = pg_ts->server()->GetSharedExchangeFd();
     pg_process_conf.force_disable_log_file = true;
 
     LOG(INFO) << "Starting PostgreSQL server listening on "
@@ -975,5 +978,65 @@ TEST_F_EX(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(ManyRowsInsert), PgMiniSingleTServ
   LOG(INFO) << "Time: " << finish - start;
 }
 
+// Rows inserted with packed rows enabled are updated, compacted and read after ALTER TABLE.
+TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(PackedRow)) {
+  constexpr int kRows = 20;
+
+  FLAGS_ysql_enable_packed_row = true;
+  FLAGS_timestamp_history_retention_interval_sec = 0;
+
+  auto conn = ASSERT_RESULT(Connect());
+
+  ASSERT_OK(conn.Execute("CREATE TABLE t (key INT PRIMARY KEY, v1 INT, v2 TEXT)"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT i, i, 'value' || i FROM generate_series(1, $0) AS i", kRows));
+  ASSERT_OK(conn.Execute("UPDATE t SET v1 = -v1 WHERE key % 2 = 0"));
+  ASSERT_OK(conn.Execute("UPDATE t SET v2 = NULL WHERE key % 3 = 0"));
+  ASSERT_OK(conn.Execute("DELETE FROM t WHERE key % 5 = 0"));
+
+  auto verify = [&conn, kRows](const std::string& columns) -> Status {
+    auto res = VERIFY_RESULT(conn.FetchFormat("SELECT $0 FROM t ORDER BY key", columns));
+    int row = 0;
+    for (int key = 1; key <= kRows; ++key) {
+      if (key % 5 == 0) {
+        continue;
+      }
+      SCHECK_EQ(VERIFY_RESULT(GetInt32(res.get(), row, 0)), key, IllegalState, "Wrong key");
+      SCHECK_EQ(VERIFY_RESULT(GetInt32(res.get(), row, 1)), key % 2 == 0 ? -key : key,
+                IllegalState, Format("Wrong v1 for $0", key));
+      SCHECK_EQ(PQgetisnull(res.get(), row, 2) != 0, key % 3 == 0,
+                IllegalState, Format("Wrong v2 for $0", key));
+      if (key % 3 != 0) {
+        SCHECK_EQ(VERIFY_RESULT(GetString(res.get(), row, 2)), Format("value$0", key),
+                  IllegalState, Format("Wrong v2 for $0", key));
+      }
+      ++row;
+    }
+    SCHECK_EQ(PQntuples(res.get()), row, IllegalState, "Wrong number of rows");
+    return Status::OK();
+  };
+
+  ASSERT_OK(verify("key, v1, v2"));
+  ASSERT_OK(cluster_->FlushTablets());
+  ASSERT_OK(cluster_->CompactTablets());
+  ASSERT_OK(verify("key, v1, v2"));
+
+  // Rows packed with the old schema version are read with the new one.
+  ASSERT_OK(conn.Execute("ALTER TABLE t ADD COLUMN v3 INT"));
+  ASSERT_OK(verify("key, v1, v2"));
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT COUNT(*) FROM t WHERE v3 IS NULL")),
+            kRows - kRows / 5);
+
+  ASSERT_OK(conn.Execute("ALTER TABLE t DROP COLUMN v2"));
+  ASSERT_OK(conn.ExecuteFormat(
+      "INSERT INTO t SELECT i, i, i FROM generate_series($0, $1) AS i", kRows + 1, 2 * kRows));
+  ASSERT_OK(cluster_->FlushTablets());
+  ASSERT_OK(cluster_->CompactTablets());
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT SUM(v3) FROM t")),
+            (kRows + 1 + 2 * kRows) * kRows / 2);
+  ASSERT_EQ(ASSERT_RESULT(conn.FetchValue<int64_t>("SELECT COUNT(*) FROM t WHERE key = v1")),
+            kRows + kRows / 2 - kRows / 10);
+}
+
 } // namespace pgwrapper
 } // namespace yb
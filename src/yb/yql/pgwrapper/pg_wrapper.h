@@ -53,6 +53,10 @@ struct PgProcessConf {
   // File descriptor of the local tserver's shared memory.
   int tserver_shm_fd = -1;
 
+  // File descriptor of the local tserver's shared memory with exchanges of postgres backends, -1 if
+  // reads are not sent through shared memory.
+  int tserver_shm_exchange_fd = -1;
+
   // If this is true, we will not log to the file, even if the log file is specified.
   bool force_disable_log_file = false;
 };